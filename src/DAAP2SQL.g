@@ -125,6 +125,8 @@ expr	returns [ pANTLR3_STRING result, int valid ]
 			pANTLR3_UINT8 field;
 			pANTLR3_UINT8 val;
 			pANTLR3_UINT8 escaped;
+			char *unwild;
+			char *prefilter;
 			ANTLR3_UINT8 op;
 			int neg_op;
 			const struct dmap_query_field_map *dqfm;
@@ -132,6 +134,7 @@ expr	returns [ pANTLR3_STRING result, int valid ]
 			long long llval;
 
 			escaped = NULL;
+			prefilter = NULL;
 
 			$result = $STR.text->factory->newRaw($STR.text->factory);
 
@@ -282,6 +285,21 @@ expr	returns [ pANTLR3_STRING result, int valid ]
 					goto STR_result_valid_0; /* ABORT */
 				}
 
+				/* Wildcard match on an indexed field: the full text index can narrow
+				   down the items that the LIKE needs to check */
+				if (!neg_op && (val[0] == '*' || (val[0] && val[1] && val[strlen((char *)val) - 1] == '*')))
+				{
+					unwild = strdup((char *)val + (val[0] == '*'));
+					if (unwild)
+					{
+						if (unwild[0] && unwild[strlen(unwild) - 1] == '*')
+							unwild[strlen(unwild) - 1] = '\0';
+
+						prefilter = db_search_prefilter(dqfm->db_col, unwild);
+						free(unwild);
+					}
+				}
+
 				escaped = (pANTLR3_UINT8)db_escape_string((char *)val);
 				if (!escaped)
 				{
@@ -305,6 +323,12 @@ expr	returns [ pANTLR3_STRING result, int valid ]
 				}
 			}
 			
+			if (prefilter)
+			{
+				$result->append8($result, prefilter);
+				$result->append8($result, " AND ");
+			}
+
 			$result->append8($result, dqfm->db_col);
 
 			switch(op)
@@ -377,6 +401,9 @@ expr	returns [ pANTLR3_STRING result, int valid ]
 			if (escaped)
 				free(escaped);
 
+			if (prefilter)
+				free(prefilter);
+
 			STR_out: /* get out of here */
 				;
 		}
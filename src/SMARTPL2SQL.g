@@ -80,7 +80,7 @@ options {
 
 playlist	returns [ pANTLR3_STRING title, pANTLR3_STRING query, pANTLR3_STRING orderby, pANTLR3_STRING having, int limit ]
 @init { $title = NULL; $query = NULL; $orderby = NULL; $having = NULL; $limit = -1; }
-	:	STR '{' e = expression '}'
+	:	STR '{' e = expression[0] '}'
 		{
 			pANTLR3_UINT8 val;
 			val = $STR.text->toUTF8($STR.text)->chars;
@@ -105,9 +105,9 @@ playlist	returns [ pANTLR3_STRING title, pANTLR3_STRING query, pANTLR3_STRING or
 		}
 	;
 
-expression	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRING having, int limit ]
+expression [int negated]	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRING having, int limit ]
 @init { $result = NULL; $orderby = NULL; $having = NULL; $limit = -1; }
-	:	^(LIMIT a = expression INT)
+	:	^(LIMIT a = expression[$negated] INT)
 		{
 			$result = $a.result->factory->newRaw($a.result->factory);
 			$result->appendS($result, $a.result);
@@ -120,7 +120,7 @@ expression	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRI
 			
 			$limit = atoi((const char *)$INT.text->chars);
 		}
-	|	^(ORDERBY a = expression o = ordertag SORTDIR)
+	|	^(ORDERBY a = expression[$negated] o = ordertag SORTDIR)
 		{
 			$result = $a.result->factory->newRaw($a.result->factory);
 			$result->appendS($result, $a.result);
@@ -133,7 +133,7 @@ expression	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRI
 			$orderby->append8($orderby, " ");
 			$orderby->appendS($orderby, $SORTDIR.text->toUTF8($SORTDIR.text));
 		}
-	|	^(HAVING a = expression b = expression)
+	|	^(HAVING a = expression[$negated] b = expression[$negated])
 		{
 			$result = $a.result->factory->newRaw($a.result->factory);
 			$result->appendS($result, $a.result);
@@ -141,14 +141,14 @@ expression	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRI
 			$having = $b.result->factory->newRaw($b.result->factory);
 			$having->appendS($having, $b.result);
 		}
-	|	^(NOT a = expression)
+	|	^(NOT a = expression[!$negated])
 		{
 			$result = $a.result->factory->newRaw($a.result->factory);
 			$result->append8($result, "NOT(");
 			$result->appendS($result, $a.result);
 			$result->append8($result, ")");
 		}
-	|	^(AND a = expression b = expression)
+	|	^(AND a = expression[$negated] b = expression[$negated])
 		{
 			$result = $a.result->factory->newRaw($a.result->factory);
 			$result->append8($result, "(");
@@ -157,7 +157,7 @@ expression	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRI
 			$result->appendS($result, $b.result);
 			$result->append8($result, ")");
 		}
-	|	^(OR a = expression b = expression)
+	|	^(OR a = expression[$negated] b = expression[$negated])
 		{
 			$result = $a.result->factory->newRaw($a.result->factory);
 			$result->append8($result, "(");
@@ -170,14 +170,26 @@ expression	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRI
 		{
 			pANTLR3_UINT8 val;
 			char *tmp;
+			char *prefilter;
 			
 			val = $STR.text->toUTF8($STR.text)->chars;
 			val++;
 			val[strlen((const char *)val) - 1] = '\0';
 			
 			tmp = sqlite3_mprintf("\%q", (const char *)val);
+			/* The index only has non-NULL values, so it can't stand in for a
+			   LIKE on NULL, which matters inside NOT() */
+			prefilter = NULL;
+			if (!$negated)
+				prefilter = db_search_prefilter((const char *)$STRTAG.text->toUTF8($STRTAG.text)->chars, (const char *)val);
 			
 			$result = $STR.text->factory->newRaw($STR.text->factory);
+			if (prefilter)
+			{
+				$result->append8($result, prefilter);
+				$result->append8($result, " AND ");
+				free(prefilter);
+			}
 			$result->append8($result, "f.");
 			$result->appendS($result, $STRTAG.text->toUTF8($STRTAG.text));
 			$result->append8($result, " LIKE '\%");
@@ -210,14 +222,26 @@ expression	returns [ pANTLR3_STRING result, pANTLR3_STRING orderby, pANTLR3_STRI
 		{
 			pANTLR3_UINT8 val;
 			char *tmp;
+			char *prefilter;
 			
 			val = $STR.text->toUTF8($STR.text)->chars;
 			val++;
 			val[strlen((const char *)val) - 1] = '\0';
 			
 			tmp = sqlite3_mprintf("\%q", (const char *)val);
+			/* The index only has non-NULL values, so it can't stand in for a
+			   LIKE on NULL, which matters inside NOT() */
+			prefilter = NULL;
+			if (!$negated)
+				prefilter = db_search_prefilter((const char *)$STRTAG.text->toUTF8($STRTAG.text)->chars, (const char *)val);
 			
 			$result = $STR.text->factory->newRaw($STR.text->factory);
+			if (prefilter)
+			{
+				$result->append8($result, prefilter);
+				$result->append8($result, " AND ");
+				free(prefilter);
+			}
 			$result->append8($result, "f.");
 			$result->appendS($result, $STRTAG.text->toUTF8($STRTAG.text));
 			$result->append8($result, " LIKE '");
@@ -111,6 +111,8 @@ struct artwork_ctx {
   struct query_params qp;
   // Not to be used by handler - should the result be cached
   enum artwork_cache cache;
+  // Not to be used by handler - skip the sources that use the network
+  bool local_only;
 };
 
 /* Definition of an artwork source. Covers both item and group sources.
@@ -130,6 +132,9 @@ struct artwork_source {
 
   // When should results from the source be cached?
   enum artwork_cache cache;
+
+  // The source gets the artwork over the network
+  bool is_remote;
 };
 
 /* Since online sources of artwork have similar characteristics there generic
@@ -258,6 +263,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_HTTP),
       .media_kinds = MEDIA_KIND_MUSIC,
       .cache = NEVER,
+      .is_remote = true,
     },
     {
       .name = "pipe",
@@ -272,6 +278,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_SPOTIFY),
       .media_kinds = MEDIA_KIND_ALL,
       .cache = ON_SUCCESS | ON_FAILURE,
+      .is_remote = true,
     },
     {
       // Note that even though caching is set for this handler, it will in most
@@ -290,6 +297,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_FILE),
       .media_kinds = MEDIA_KIND_MUSIC,
       .cache = ON_SUCCESS | ON_FAILURE,
+      .is_remote = true,
     },
     {
       .name = "Spotify search web api (streams)",
@@ -297,6 +305,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_HTTP) | (1 << DATA_KIND_PIPE),
       .media_kinds = MEDIA_KIND_MUSIC,
       .cache = NEVER,
+      .is_remote = true,
     },
     {
       .name = "Discogs (files)",
@@ -304,6 +313,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_FILE),
       .media_kinds = MEDIA_KIND_MUSIC,
       .cache = ON_SUCCESS | ON_FAILURE,
+      .is_remote = true,
     },
     {
       .name = "Discogs (streams)",
@@ -311,6 +321,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_HTTP) | (1 << DATA_KIND_PIPE),
       .media_kinds = MEDIA_KIND_MUSIC,
       .cache = NEVER,
+      .is_remote = true,
     },
     {
       // The Cover Art Archive seems rather slow, so low priority
@@ -319,6 +330,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_FILE),
       .media_kinds = MEDIA_KIND_MUSIC,
       .cache = ON_SUCCESS | ON_FAILURE,
+      .is_remote = true,
     },
     {
       // The Cover Art Archive seems rather slow, so low priority
@@ -327,6 +339,7 @@ static struct artwork_source artwork_item_source[] =
       .data_kinds = (1 << DATA_KIND_HTTP) | (1 << DATA_KIND_PIPE),
       .media_kinds = MEDIA_KIND_MUSIC,
       .cache = NEVER,
+      .is_remote = true,
     },
     {
       .name = NULL,
@@ -1431,17 +1444,9 @@ source_item_cache_get(struct artwork_ctx *ctx)
 static int
 source_item_embedded_get(struct artwork_ctx *ctx)
 {
-  int artwork;
-
   DPRINTF(E_SPAM, L_ART, "Trying embedded artwork in %s\n", ctx->dbmfi->path);
 
-  if (safe_atoi32(ctx->dbmfi->artwork, &artwork) < 0)
-    {
-      DPRINTF(E_LOG, L_ART, "Error converting dbmfi artwork to number for '%s'\n", ctx->dbmfi->path);
-      return ART_E_ERROR;
-    }
-
-  if (artwork != ARTWORK_EMBEDDED)
+  if (ctx->dbmfi->artwork != ARTWORK_EMBEDDED)
     return ART_E_NONE;
 
   snprintf(ctx->path, sizeof(ctx->path), "%s", ctx->dbmfi->path);
@@ -1761,18 +1766,17 @@ process_items(struct artwork_ctx *ctx, int item_mode)
     {
       // Save the first songalbumid, might need it for process_group() if this search doesn't give anything
       if (!ctx->persistentid)
-	safe_atoi64(dbmfi.songalbumid, &ctx->persistentid);
+	ctx->persistentid = dbmfi.songalbumid;
 
       if (item_mode && !ctx->individual)
 	goto no_artwork;
 
-      ret = (safe_atoi32(dbmfi.id, &ctx->id) < 0) ||
-            (safe_atou32(dbmfi.data_kind, &ctx->data_kind) < 0) ||
-            (safe_atou32(dbmfi.media_kind, &ctx->media_kind) < 0) ||
-            (ctx->data_kind > 30);
-      if (ret)
+      ctx->id = dbmfi.id;
+      ctx->data_kind = dbmfi.data_kind;
+      ctx->media_kind = dbmfi.media_kind;
+      if (ctx->data_kind > 30)
 	{
-	  DPRINTF(E_LOG, L_ART, "Error converting dbmfi id, data_kind or media_kind to number for '%s'\n", dbmfi.path);
+	  DPRINTF(E_LOG, L_ART, "Invalid data_kind %u for '%s'\n", ctx->data_kind, dbmfi.path);
 	  continue;
 	}
 
@@ -1788,6 +1792,13 @@ process_items(struct artwork_ctx *ctx, int item_mode)
 	  if ((artwork_item_source[i].cache & ON_FAILURE) == 0)
 	    ctx->cache = NEVER;
 
+	  // Not finding anything locally doesn't mean there is no artwork
+	  if (ctx->local_only && artwork_item_source[i].is_remote)
+	    {
+	      ctx->cache = NEVER;
+	      continue;
+	    }
+
 	  DPRINTF(E_SPAM, L_ART, "Checking item source '%s'\n", artwork_item_source[i].name);
 
 	  ctx->dbmfi = &dbmfi;
@@ -1953,8 +1964,8 @@ artwork_get_item(struct evbuffer *evbuf, int id, int max_w, int max_h)
   return -1;
 }
 
-int
-artwork_get_group(struct evbuffer *evbuf, int id, int max_w, int max_h)
+static int
+group_get(struct evbuffer *evbuf, int id, int max_w, int max_h, bool local_only)
 {
   struct artwork_ctx ctx;
   int ret;
@@ -1978,6 +1989,7 @@ artwork_get_group(struct evbuffer *evbuf, int id, int max_w, int max_h)
   ctx.max_h = max_h;
   ctx.cache = ON_FAILURE;
   ctx.individual = cfg_getbool(cfg_getsec(cfg, "library"), "artwork_individual");
+  ctx.local_only = local_only;
 
   ret = process_group(&ctx);
   if (ret > 0)
@@ -1996,6 +2008,102 @@ artwork_get_group(struct evbuffer *evbuf, int id, int max_w, int max_h)
   return -1;
 }
 
+int
+artwork_get_group(struct evbuffer *evbuf, int id, int max_w, int max_h)
+{
+  return group_get(evbuf, id, max_w, max_h, false);
+}
+
+int
+artwork_prerender_groups(int after, int max)
+{
+  struct query_params qp;
+  struct db_group_info dbgri;
+  struct evbuffer *evbuf;
+  cfg_t *lib;
+  int64_t *persistentids;
+  int32_t *ids;
+  int last;
+  int size;
+  int nsizes;
+  int n;
+  int i;
+  int j;
+  int ret;
+
+  lib = cfg_getsec(cfg, "library");
+  nsizes = cfg_size(lib, "artwork_prerender_sizes");
+  if (nsizes == 0 || max <= 0)
+    return 0;
+
+  CHECK_NULL(L_ART, persistentids = calloc(max, sizeof(int64_t)));
+  CHECK_NULL(L_ART, ids = calloc(max, sizeof(int32_t)));
+
+  // Fetch the chunk first, so the query isn't open while the artwork is made
+  memset(&qp, 0, sizeof(struct query_params));
+  qp.type = Q_GROUP_ALBUMS;
+  qp.idx_type = I_FIRST;
+  qp.limit = max;
+  qp.filter = db_mprintf("g.id > %d", after);
+  qp.order = strdup("g.id");
+
+  ret = db_query_start(&qp);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_ART, "Could not start query for albums to prerender artwork for\n");
+      free_query_params(&qp, 1);
+      free(persistentids);
+      free(ids);
+      return -1;
+    }
+
+  for (n = 0; n < max && db_query_fetch_group(&qp, &dbgri) == 0 && dbgri.id; n++)
+    {
+      if (safe_atoi32(dbgri.id, &ids[n]) < 0 || safe_atoi64(dbgri.persistentid, &persistentids[n]) < 0)
+	break;
+    }
+
+  db_query_end(&qp);
+  free_query_params(&qp, 1);
+
+  if (n == 0)
+    {
+      free(persistentids);
+      free(ids);
+      return 0;
+    }
+
+  CHECK_NULL(L_ART, evbuf = evbuffer_new());
+
+  for (i = 0; i < n; i++)
+    {
+      for (j = 0; j < nsizes; j++)
+	{
+	  size = cfg_getnint(lib, "artwork_prerender_sizes", j);
+	  if (size <= 0)
+	    continue;
+
+	  ret = cache_artwork_exists(CACHE_ARTWORK_GROUP, persistentids[i], size, size);
+	  if (ret != 0)
+	    continue; // Already cached, or the cache is not available
+
+	  DPRINTF(E_SPAM, L_ART, "Prerendering artwork for group %d (size %d)\n", ids[i], size);
+
+	  group_get(evbuf, ids[i], size, size, true);
+	  evbuffer_drain(evbuf, evbuffer_get_length(evbuf));
+	}
+    }
+
+  evbuffer_free(evbuf);
+
+  last = ids[n - 1];
+
+  free(persistentids);
+  free(ids);
+
+  return last;
+}
+
 /* Checks if the file is an artwork file */
 bool
 artwork_file_is_artwork(const char *filename)
@@ -35,6 +35,20 @@ artwork_get_item(struct evbuffer *evbuf, int id, int max_w, int max_h);
 int
 artwork_get_group(struct evbuffer *evbuf, int id, int max_w, int max_h);
 
+/*
+ * Makes and caches the artwork of a chunk of albums in the sizes configured
+ * with artwork_prerender_sizes, so it is ready when clients ask for it. Albums
+ * that already have cache entries are skipped. Only local sources are used, so
+ * albums that need an online source get their artwork when a client asks.
+ *
+ * @in  after    Only albums with a group id greater than this are processed
+ * @in  max      Max number of albums to process
+ * @return       Group id of the last processed album (pass as "after" to
+ *               continue), 0 when there are no more albums, -1 on error
+ */
+int
+artwork_prerender_groups(int after, int max);
+
 /*
  * Checks if the file is an artwork file (based on user config)
  *
@@ -29,6 +29,7 @@
 #include <errno.h>
 #include <time.h>
 #include <string.h>
+#include <stdbool.h>
 #include <pthread.h>
 #ifdef HAVE_PTHREAD_NP_H
 # include <pthread_np.h>
@@ -43,20 +44,22 @@
 #include "httpd_daap.h"
 #include "db.h"
 #include "cache.h"
-#include "listener.h"
+#include "library.h"
+#include "misc.h"
 #include "commands.h"
 
 
-#define CACHE_VERSION 3
+#define CACHE_VERSION 4
+
+// Max number of DAAP replies held in memory
+#define CACHE_DAAP_ENTRIES_MAX 20
+
+// Number of hash buckets of the in-memory artwork cache, must be a power of two
+#define CACHE_ARTWORK_BUCKETS 1024
 
 
 struct cache_arg
 {
-  char *query; // daap query
-  char *ua;    // user agent
-  int is_remote;
-  int msec;
-
   const char *path;  // artwork path
   char *pathcopy;  // copy of artwork path (for async operations)
   int type;    // individual or group artwork
@@ -69,6 +72,7 @@ struct cache_arg
   int del;
 
   struct evbuffer *evbuf;
+  struct cache_blob *blob;
 };
 
 /* --- Globals --- */
@@ -95,6 +99,72 @@ struct stash
   uint8_t *data;
 } g_stash;
 
+// A gzipped DAAP reply or a rescaled artwork image. It is never modified after
+// being built, so it can be added to evbuffers by reference. Freed when the
+// last reference is dropped.
+struct cache_blob
+{
+  int refcount;
+  size_t len;
+  uint8_t *data;
+};
+
+struct cache_daap_entry
+{
+  char *query; // daap query without transient tags
+  char *ua;    // user agent
+  int is_remote;
+  int msec;
+
+  // The reply is NULL until the cache thread has built it. generation is the
+  // library generation it was built from.
+  struct cache_blob *reply;
+  unsigned int generation;
+
+  // Set if a client asked for the reply but it was stale or not built yet
+  bool wanted;
+
+  struct cache_daap_entry *prev;
+  struct cache_daap_entry *next;
+};
+
+// In-memory DAAP reply cache, most recently used first. Looked up directly by
+// the httpd threads, replies are (re)built by the cache thread.
+static struct cache_daap_entry *g_daap_entries;
+static int g_daap_nentries;
+static struct cache_daap_stats g_daap_stats;
+static pthread_mutex_t g_daap_lck;
+
+// A rescaled image (or the knowledge that there is none) in the in-memory
+// artwork cache
+struct cache_artwork_entry
+{
+  int type;
+  int64_t persistentid;
+  int max_w;
+  int max_h;
+
+  int format;              // 0 if no artwork available
+  char *path;              // Source of the image, for invalidation
+  time_t stamp;            // Corresponds to db_timestamp in the artwork table
+  struct cache_blob *blob; // NULL if no artwork available
+
+  struct cache_artwork_entry *hnext; // Next in the same hash bucket
+
+  struct cache_artwork_entry *prev;
+  struct cache_artwork_entry *next;
+};
+
+// In-memory artwork cache in front of the artwork table, most recently used
+// first. Hits are served directly in the calling thread without a round trip
+// to the cache thread.
+static struct cache_artwork_entry *g_artwork_buckets[CACHE_ARTWORK_BUCKETS];
+static struct cache_artwork_entry *g_artwork_head;
+static struct cache_artwork_entry *g_artwork_tail;
+static size_t g_artwork_size;
+static size_t g_artwork_size_max;
+static pthread_mutex_t g_artwork_lck;
+
 static int g_suspended;
 
 // The user may configure a threshold (in msec), and queries slower than
@@ -123,6 +193,267 @@ remove_tag(char *in, const char *tag)
     *(s - 1) = '\0';
 }
 
+/* Currently we are only able to pre-build and cache these reply types */
+static bool
+daap_query_is_cacheable(const char *query)
+{
+  return ( (strncmp(query, "/databases/1/containers/", strlen("/databases/1/containers/")) == 0) ||
+           (strncmp(query, "/databases/1/groups?", strlen("/databases/1/groups?")) == 0) ||
+           (strncmp(query, "/databases/1/items?", strlen("/databases/1/items?")) == 0) ||
+           (strncmp(query, "/databases/1/browse/", strlen("/databases/1/browse/")) == 0) );
+}
+
+static char *
+daap_query_normalize(const char *query)
+{
+  char *key;
+
+  key = strdup(query);
+  if (!key)
+    return NULL;
+
+  remove_tag(key, "session-id");
+  remove_tag(key, "revision-number");
+
+  return key;
+}
+
+static void
+blob_unref(struct cache_blob *blob)
+{
+  if (__atomic_sub_fetch(&blob->refcount, 1, __ATOMIC_ACQ_REL) > 0)
+    return;
+
+  free(blob->data);
+  free(blob);
+}
+
+/* Called by libevent when it is done with a blob added by reference */
+static void
+blob_cleanup_cb(const void *data, size_t datalen, void *extra)
+{
+  blob_unref(extra);
+}
+
+/* The functions below must be called with g_daap_lck locked */
+static struct cache_daap_entry *
+daap_entry_find(const char *query, const char *ua, int is_remote)
+{
+  struct cache_daap_entry *entry;
+
+  for (entry = g_daap_entries; entry; entry = entry->next)
+    {
+      if (entry->is_remote == is_remote && strcmp(entry->query, query) == 0 && strcmp(entry->ua, ua) == 0)
+	return entry;
+    }
+
+  return NULL;
+}
+
+static void
+daap_entry_unlink(struct cache_daap_entry *entry)
+{
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    g_daap_entries = entry->next;
+
+  if (entry->next)
+    entry->next->prev = entry->prev;
+
+  entry->prev = NULL;
+  entry->next = NULL;
+}
+
+static void
+daap_entry_push(struct cache_daap_entry *entry)
+{
+  entry->prev = NULL;
+  entry->next = g_daap_entries;
+  if (g_daap_entries)
+    g_daap_entries->prev = entry;
+
+  g_daap_entries = entry;
+}
+
+static void
+daap_entry_reply_set(struct cache_daap_entry *entry, struct cache_blob *reply, unsigned int generation)
+{
+  if (entry->reply)
+    {
+      g_daap_stats.size -= entry->reply->len;
+      blob_unref(entry->reply);
+    }
+
+  entry->reply = reply;
+  entry->generation = generation;
+
+  if (reply)
+    g_daap_stats.size += reply->len;
+}
+
+static void
+daap_entry_remove(struct cache_daap_entry *entry)
+{
+  daap_entry_unlink(entry);
+  daap_entry_reply_set(entry, NULL, 0);
+
+  g_daap_nentries--;
+
+  free(entry->query);
+  free(entry->ua);
+  free(entry);
+}
+
+static void
+daap_entries_purge(void)
+{
+  while (g_daap_entries)
+    daap_entry_remove(g_daap_entries);
+}
+
+static struct cache_blob *
+blob_new(struct evbuffer *evbuf)
+{
+  struct cache_blob *blob;
+
+  CHECK_NULL(L_CACHE, blob = calloc(1, sizeof(struct cache_blob)));
+
+  blob->len = evbuffer_get_length(evbuf);
+  CHECK_NULL(L_CACHE, blob->data = malloc(blob->len ? blob->len : 1));
+  evbuffer_copyout(evbuf, blob->data, blob->len);
+  blob->refcount = 1;
+
+  return blob;
+}
+
+/* The functions below must be called with g_artwork_lck locked */
+static struct cache_artwork_entry **
+artwork_bucket(int type, int64_t persistentid, int max_w, int max_h)
+{
+  uint64_t h;
+
+  h = (uint64_t)persistentid ^ ((uint64_t)type << 62) ^ ((uint64_t)max_w << 16) ^ (uint64_t)max_h;
+  h ^= h >> 32;
+  h ^= h >> 16;
+
+  return &g_artwork_buckets[h & (CACHE_ARTWORK_BUCKETS - 1)];
+}
+
+static struct cache_artwork_entry *
+artwork_entry_find(int type, int64_t persistentid, int max_w, int max_h)
+{
+  struct cache_artwork_entry *entry;
+
+  for (entry = *artwork_bucket(type, persistentid, max_w, max_h); entry; entry = entry->hnext)
+    {
+      if (entry->persistentid == persistentid && entry->type == type && entry->max_w == max_w && entry->max_h == max_h)
+	return entry;
+    }
+
+  return NULL;
+}
+
+static size_t
+artwork_entry_size(struct cache_artwork_entry *entry)
+{
+  return sizeof(struct cache_artwork_entry) + strlen(entry->path) + (entry->blob ? entry->blob->len : 0);
+}
+
+static void
+artwork_entry_unlink(struct cache_artwork_entry *entry)
+{
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    g_artwork_head = entry->next;
+
+  if (entry->next)
+    entry->next->prev = entry->prev;
+  else
+    g_artwork_tail = entry->prev;
+
+  entry->prev = NULL;
+  entry->next = NULL;
+}
+
+static void
+artwork_entry_push(struct cache_artwork_entry *entry)
+{
+  entry->prev = NULL;
+  entry->next = g_artwork_head;
+  if (g_artwork_head)
+    g_artwork_head->prev = entry;
+  else
+    g_artwork_tail = entry;
+
+  g_artwork_head = entry;
+}
+
+static void
+artwork_entry_remove(struct cache_artwork_entry *entry)
+{
+  struct cache_artwork_entry **prev;
+
+  for (prev = artwork_bucket(entry->type, entry->persistentid, entry->max_w, entry->max_h); *prev != entry; prev = &(*prev)->hnext)
+    ; // Find the pointer to the entry
+
+  *prev = entry->hnext;
+  artwork_entry_unlink(entry);
+
+  g_artwork_size -= artwork_entry_size(entry);
+
+  if (entry->blob)
+    blob_unref(entry->blob);
+  free(entry->path);
+  free(entry);
+}
+
+static void
+artwork_entry_add(int type, int64_t persistentid, int max_w, int max_h, int format, const char *path, time_t stamp, struct cache_blob *blob)
+{
+  struct cache_artwork_entry *entry;
+  struct cache_artwork_entry **bucket;
+
+  entry = artwork_entry_find(type, persistentid, max_w, max_h);
+  if (entry)
+    artwork_entry_remove(entry);
+
+  if (g_artwork_size_max == 0)
+    return;
+
+  CHECK_NULL(L_CACHE, entry = calloc(1, sizeof(struct cache_artwork_entry)));
+  CHECK_NULL(L_CACHE, entry->path = strdup(path ? path : ""));
+
+  entry->type = type;
+  entry->persistentid = persistentid;
+  entry->max_w = max_w;
+  entry->max_h = max_h;
+  entry->format = format;
+  entry->stamp = stamp;
+  entry->blob = blob;
+  if (blob)
+    __atomic_add_fetch(&blob->refcount, 1, __ATOMIC_RELAXED);
+
+  bucket = artwork_bucket(type, persistentid, max_w, max_h);
+  entry->hnext = *bucket;
+  *bucket = entry;
+  artwork_entry_push(entry);
+
+  g_artwork_size += artwork_entry_size(entry);
+
+  // Limits the size of the cache to the most recently used images
+  while (g_artwork_size > g_artwork_size_max && g_artwork_tail)
+    artwork_entry_remove(g_artwork_tail);
+}
+
+static void
+artwork_entries_purge(void)
+{
+  while (g_artwork_head)
+    artwork_entry_remove(g_artwork_head);
+}
+
 
 /* --------------------------------- MAIN --------------------------------- */
 /*                              Thread: cache                              */
@@ -130,23 +461,6 @@ remove_tag(char *in, const char *tag)
 static int
 cache_create_tables(void)
 {
-#define T_REPLIES						\
-  "CREATE TABLE IF NOT EXISTS replies ("			\
-  "   id                 INTEGER PRIMARY KEY NOT NULL,"		\
-  "   query              VARCHAR(4096) NOT NULL,"		\
-  "   reply              BLOB"					\
-  ");"
-#define T_QUERIES						\
-  "CREATE TABLE IF NOT EXISTS queries ("			\
-  "   id                 INTEGER PRIMARY KEY NOT NULL,"		\
-  "   query              VARCHAR(4096) UNIQUE NOT NULL,"	\
-  "   user_agent         VARCHAR(1024),"			\
-  "   is_remote          INTEGER DEFAULT 0,"			\
-  "   msec               INTEGER DEFAULT 0,"			\
-  "   timestamp          INTEGER DEFAULT 0"			\
-  ");"
-#define I_QUERY							\
-  "CREATE INDEX IF NOT EXISTS idx_query ON replies (query);"
 #define T_ARTWORK					\
   "CREATE TABLE IF NOT EXISTS artwork ("		\
   "   id                  INTEGER PRIMARY KEY NOT NULL,"\
@@ -176,39 +490,6 @@ cache_create_tables(void)
   int ret;
 
 
-  // Create reply cache table
-  ret = sqlite3_exec(g_db_hdl, T_REPLIES, NULL, NULL, &errmsg);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_FATAL, L_CACHE, "Error creating cache table 'replies': %s\n", errmsg);
-
-      sqlite3_free(errmsg);
-      sqlite3_close(g_db_hdl);
-      return -1;
-    }
-
-  // Create query table (the queries for which we will generate and cache replies)
-  ret = sqlite3_exec(g_db_hdl, T_QUERIES, NULL, NULL, &errmsg);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_FATAL, L_CACHE, "Error creating cache table 'queries': %s\n", errmsg);
-
-      sqlite3_free(errmsg);
-      sqlite3_close(g_db_hdl);
-      return -1;
-    }
-
-  // Create index
-  ret = sqlite3_exec(g_db_hdl, I_QUERY, NULL, NULL, &errmsg);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_FATAL, L_CACHE, "Error creating index on replies(query): %s\n", errmsg);
-
-      sqlite3_free(errmsg);
-      sqlite3_close(g_db_hdl);
-      return -1;
-    }
-
   // Create artwork table
   ret = sqlite3_exec(g_db_hdl, T_ARTWORK, NULL, NULL, &errmsg);
   if (ret != SQLITE_OK)
@@ -266,9 +547,6 @@ cache_create_tables(void)
   DPRINTF(E_DBG, L_CACHE, "Cache tables created\n");
 
   return 0;
-#undef T_REPLIES
-#undef T_QUERIES
-#undef I_QUERY
 #undef T_ARTWORK
 #undef I_ARTWORK_ID
 #undef I_ARTWORK_PATH
@@ -292,7 +570,7 @@ cache_drop_tables(void)
   int ret;
 
 
-  // Drop reply cache table
+  // Drop reply cache and query tables (only used by cache versions < 4)
   ret = sqlite3_exec(g_db_hdl, D_REPLIES, NULL, NULL, &errmsg);
   if (ret != SQLITE_OK)
     {
@@ -303,7 +581,6 @@ cache_drop_tables(void)
       return -1;
     }
 
-  // Drop query table
   ret = sqlite3_exec(g_db_hdl, D_QUERIES, NULL, NULL, &errmsg);
   if (ret != SQLITE_OK)
     {
@@ -579,323 +856,136 @@ cache_close(void)
   DPRINTF(E_DBG, L_CACHE, "Cache closed\n");
 }
 
-/* Adds the reply (stored in evbuf) to the cache */
-static int
-cache_daap_reply_add(const char *query, struct evbuffer *evbuf)
-{
-#define Q_TMPL "INSERT INTO replies (query, reply) VALUES (?, ?);"
-  sqlite3_stmt *stmt;
-  unsigned char *data;
-  size_t datalen;
-  int ret;
-
-  datalen = evbuffer_get_length(evbuf);
-  data = evbuffer_pullup(evbuf, -1);
-
-  ret = sqlite3_prepare_v2(g_db_hdl, Q_TMPL, -1, &stmt, 0);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error preparing query for cache update: %s\n", sqlite3_errmsg(g_db_hdl));
-      return -1;
-    }
-
-  sqlite3_bind_text(stmt, 1, query, -1, SQLITE_STATIC);
-  sqlite3_bind_blob(stmt, 2, data, datalen, SQLITE_STATIC);
-
-  ret = sqlite3_step(stmt);
-  if (ret != SQLITE_DONE)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error stepping query for cache update: %s\n", sqlite3_errmsg(g_db_hdl));
-      sqlite3_finalize(stmt);
-      return -1;
-    }
-
-  ret = sqlite3_finalize(stmt);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error finalizing query for cache update: %s\n", sqlite3_errmsg(g_db_hdl));
-      return -1;
-    }
-
-  //DPRINTF(E_DBG, L_CACHE, "Wrote cache reply, size %d\n", datalen);
-
-  return 0;
-#undef Q_TMPL
-}
-
-/* Adds the query to the list of queries for which we will build and cache a reply */
-static enum command_state
-cache_daap_query_add(void *arg, int *retval)
+/* Rebuilds one of the replies that clients have asked for but which were stale
+ * or not built yet. Will rearm itself if there are more replies to build, so
+ * that the rebuild is done incrementally and other commands can get through.
+ */
+static void
+cache_daap_update_cb(int fd, short what, void *arg)
 {
-#define Q_TMPL "INSERT OR REPLACE INTO queries (user_agent, is_remote, query, msec, timestamp) VALUES ('%q', %d, '%q', %d, %" PRIi64 ");"
-#define Q_CLEANUP "DELETE FROM queries WHERE id NOT IN (SELECT id FROM queries ORDER BY timestamp DESC LIMIT 20);"
-  struct cache_arg *cmdarg;
-  struct timeval delay = { 60, 0 };
+  struct timeval suspended_delay = { 2, 0 };
+  struct timeval next_delay = { 0, 0 };
+  struct cache_daap_entry *entry;
+  struct cache_blob *reply;
+  struct evbuffer *evbuf;
+  struct evbuffer *gzbuf;
+  unsigned int generation;
   char *query;
-  char *errmsg;
-  int ret;
+  char *ua;
+  int is_remote;
+  bool more;
 
-  cmdarg = arg;
-  if (!cmdarg->ua)
+  if (g_suspended)
     {
-      DPRINTF(E_LOG, L_CACHE, "Couldn't add slow query to cache, unknown user-agent\n");
-
-      goto error_add;
+      DPRINTF(E_DBG, L_CACHE, "Got a request to update DAAP cache while suspended\n");
+      evtimer_add(cache_daap_updateev, &suspended_delay);
+      return;
     }
 
-  // Currently we are only able to pre-build and cache these reply types
-  if ( (strncmp(cmdarg->query, "/databases/1/containers/", strlen("/databases/1/containers/")) != 0) &&
-       (strncmp(cmdarg->query, "/databases/1/groups?", strlen("/databases/1/groups?")) != 0) &&
-       (strncmp(cmdarg->query, "/databases/1/items?", strlen("/databases/1/items?")) != 0) &&
-       (strncmp(cmdarg->query, "/databases/1/browse/", strlen("/databases/1/browse/")) != 0) )
-    goto error_add;
+  query = NULL;
+  ua = NULL;
+  is_remote = 0;
 
-  remove_tag(cmdarg->query, "session-id");
-  remove_tag(cmdarg->query, "revision-number");
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_daap_lck));
 
-  query = sqlite3_mprintf(Q_TMPL, cmdarg->ua, cmdarg->is_remote, cmdarg->query, cmdarg->msec, (int64_t)time(NULL));
-  if (!query)
+  generation = library_generation_get();
+  for (entry = g_daap_entries; entry; entry = entry->next)
     {
-      DPRINTF(E_LOG, L_CACHE, "Out of memory making query string.\n");
+      if (!entry->wanted)
+	continue;
 
-      goto error_add;
-    }
+      entry->wanted = false;
+      if (entry->reply && entry->generation == generation)
+	continue;
 
-  ret = sqlite3_exec(g_db_hdl, query, NULL, NULL, &errmsg);
-  sqlite3_free(query);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error adding query to query list: %s\n", errmsg);
-
-      sqlite3_free(errmsg);
-      goto error_add;
+      query = strdup(entry->query);
+      ua = strdup(entry->ua);
+      is_remote = entry->is_remote;
+      break;
     }
 
-  DPRINTF(E_INFO, L_CACHE, "Slow query (%d ms) added to cache: '%s' (user-agent: '%s')\n", cmdarg->msec, cmdarg->query, cmdarg->ua);
-
-  free(cmdarg->ua);
-  free(cmdarg->query);
-
-  // Limits the size of the cache to only contain replies for 20 most recent queries
-  ret = sqlite3_exec(g_db_hdl, Q_CLEANUP, NULL, NULL, &errmsg);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error cleaning up query list before update: %s\n", errmsg);
-      sqlite3_free(errmsg);
-      *retval = -1;
-      return COMMAND_END;
-    }
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_daap_lck));
 
-  // Will set of cache regeneration after waiting a bit (so there is less risk
-  // of disturbing the user)
-  evtimer_add(cache_daap_updateev, &delay);
+  if (!query || !ua)
+    goto out;
 
-  *retval = 0;
-  return COMMAND_END;
-
- error_add:
-  if (cmdarg->ua)
-    free(cmdarg->ua);
-
-  if (cmdarg->query)
-    free(cmdarg->query);
-
-  *retval = -1;
-  return COMMAND_END;
-#undef Q_CLEANUP
-#undef Q_TMPL
-}
-
-// Gets a reply from the cache.
-// cmdarg->evbuf will be filled with the reply (gzipped)
-static enum command_state
-cache_daap_query_get(void *arg, int *retval)
-{
-#define Q_TMPL "SELECT reply FROM replies WHERE query = ?;"
-  struct cache_arg *cmdarg;
-  sqlite3_stmt *stmt;
-  char *query;
-  int datalen;
-  int ret;
+  DPRINTF(E_DBG, L_CACHE, "Building DAAP cache reply for query: %s\n", query);
 
-  cmdarg = arg;
-  query = cmdarg->query;
-  remove_tag(query, "session-id");
-  remove_tag(query, "revision-number");
+  reply = NULL;
 
-  // Look in the DB
-  ret = sqlite3_prepare_v2(g_db_hdl, Q_TMPL, -1, &stmt, 0);
-  if (ret != SQLITE_OK)
+  evbuf = daap_reply_build(query, ua, is_remote);
+  if (!evbuf)
     {
-      DPRINTF(E_LOG, L_CACHE, "Error preparing query for cache update: %s\n", sqlite3_errmsg(g_db_hdl));
-      free(query);
-      *retval = -1;
-      return COMMAND_END;
+      DPRINTF(E_LOG, L_CACHE, "Error building DAAP reply for query: %s\n", query);
+      goto publish;
     }
 
-  sqlite3_bind_text(stmt, 1, query, -1, SQLITE_STATIC);
-
-  ret = sqlite3_step(stmt);
-  if (ret != SQLITE_ROW)  
+  gzbuf = httpd_gzip_deflate(evbuf);
+  evbuffer_free(evbuf);
+  if (!gzbuf)
     {
-      if (ret != SQLITE_DONE)
-	DPRINTF(E_LOG, L_CACHE, "Error stepping query for cache update: %s\n", sqlite3_errmsg(g_db_hdl));
-      goto error_get;
+      DPRINTF(E_LOG, L_CACHE, "Error gzipping DAAP reply for query: %s\n", query);
+      goto publish;
     }
 
-  datalen = sqlite3_column_bytes(stmt, 0);
+  CHECK_NULL(L_CACHE, reply = calloc(1, sizeof(struct cache_blob)));
+  reply->refcount = 1;
+  reply->len = evbuffer_get_length(gzbuf);
+  CHECK_NULL(L_CACHE, reply->data = malloc(reply->len));
+  evbuffer_remove(gzbuf, reply->data, reply->len);
+  evbuffer_free(gzbuf);
 
-  if (!cmdarg->evbuf)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error: DAAP reply evbuffer is NULL\n");
-      goto error_get;
-    }
+ publish:
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_daap_lck));
 
-  ret = evbuffer_add(cmdarg->evbuf, sqlite3_column_blob(stmt, 0), datalen);
-  if (ret < 0)
+  // The entry may have been evicted while we were building
+  entry = daap_entry_find(query, ua, is_remote);
+  if (entry && reply)
     {
-      DPRINTF(E_LOG, L_CACHE, "Out of memory for DAAP reply evbuffer\n");
-      goto error_get;
-    }
+      daap_entry_reply_set(entry, reply, generation);
+      reply = NULL;
 
-  ret = sqlite3_finalize(stmt);
-  if (ret != SQLITE_OK)
-    DPRINTF(E_LOG, L_CACHE, "Error finalizing query for getting cache: %s\n", sqlite3_errmsg(g_db_hdl));
-
-  DPRINTF(E_INFO, L_CACHE, "Cache hit: %s\n", query);
-
-  free(query);
-
-  *retval = 0;
-  return COMMAND_END;
-
- error_get:
-  sqlite3_finalize(stmt);
-  free(query);
-  *retval = -1;
-  return COMMAND_END;
-#undef Q_TMPL
-}
-
-/* Removes the query from the cache */
-static int
-cache_daap_query_delete(const int id)
-{
-#define Q_TMPL "DELETE FROM queries WHERE id = %d;"
-  char *query;
-  char *errmsg;
-  int ret;
-
-  query = sqlite3_mprintf(Q_TMPL, id);
-
-  ret = sqlite3_exec(g_db_hdl, query, NULL, NULL, &errmsg);
-  sqlite3_free(query);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error deleting query from cache: %s\n", errmsg);
-
-      sqlite3_free(errmsg);
-      return -1;
+      // Clients who came by while we were building don't need another rebuild
+      if (generation == library_generation_get())
+	entry->wanted = false;
     }
+  else if (entry)
+    daap_entry_remove(entry);
 
-  return 0;
-#undef Q_TMPL
-}
-
-/* Here we actually update the cache by asking httpd_daap for responses
- * to the queries set for caching
- */
-static void
-cache_daap_update_cb(int fd, short what, void *arg)
-{
-  sqlite3_stmt *stmt;
-  struct evbuffer *evbuf;
-  struct evbuffer *gzbuf;
-  char *errmsg;
-  char *query;
-  int ret;
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_daap_lck));
 
-  if (g_suspended)
-    {
-      DPRINTF(E_DBG, L_CACHE, "Got a request to update DAAP cache while suspended\n");
-      return;
-    }
-
-  DPRINTF(E_LOG, L_CACHE, "Beginning DAAP cache update\n");
-
-  ret = sqlite3_exec(g_db_hdl, "DELETE FROM replies;", NULL, NULL, &errmsg);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error clearing reply cache before update: %s\n", errmsg);
-      sqlite3_free(errmsg);
-      return;
-    }
-
-  ret = sqlite3_prepare_v2(g_db_hdl, "SELECT id, user_agent, is_remote, query FROM queries;", -1, &stmt, 0);
-  if (ret != SQLITE_OK)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Error preparing for cache update: %s\n", sqlite3_errmsg(g_db_hdl));
-      return;
-    }
-
-  while ((ret = sqlite3_step(stmt)) == SQLITE_ROW)
-    {
-      query = strdup((char *)sqlite3_column_text(stmt, 3));
-
-      evbuf = daap_reply_build(query, (char *)sqlite3_column_text(stmt, 1), sqlite3_column_int(stmt, 2));
-      if (!evbuf)
-	{
-	  DPRINTF(E_LOG, L_CACHE, "Error building DAAP reply for query: %s\n", query);
-	  cache_daap_query_delete(sqlite3_column_int(stmt, 0));
-	  free(query);
-
-	  continue;
-	}
-
-      gzbuf = httpd_gzip_deflate(evbuf);
-      if (!gzbuf)
-	{
-	  DPRINTF(E_LOG, L_CACHE, "Error gzipping DAAP reply for query: %s\n", query);
-	  cache_daap_query_delete(sqlite3_column_int(stmt, 0));
-	  free(query);
-	  evbuffer_free(evbuf);
-
-	  continue;
-	}
+  if (reply)
+    blob_unref(reply);
 
-      evbuffer_free(evbuf);
-
-      cache_daap_reply_add(query, gzbuf);
+ out:
+  free(query);
+  free(ua);
 
-      free(query);
-      evbuffer_free(gzbuf);
-    }
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_daap_lck));
 
-  if (ret != SQLITE_DONE)
-    DPRINTF(E_LOG, L_CACHE, "Could not step: %s\n", sqlite3_errmsg(g_db_hdl));
+  for (entry = g_daap_entries, more = false; entry && !more; entry = entry->next)
+    more = entry->wanted;
 
-  sqlite3_finalize(stmt);
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_daap_lck));
 
-  DPRINTF(E_LOG, L_CACHE, "DAAP cache updated\n");
+  if (more)
+    evtimer_add(cache_daap_updateev, &next_delay);
 }
 
-/* Sets off an update by activating the event. The delay is because we are low
- * priority compared to other listeners of database updates.
+/* Sets off an update by activating the event. The delay is so the request that
+ * caused the update can finish first, and so requests coming in right after
+ * each other are handled together.
  */
 static enum command_state
 cache_daap_update(void *arg, int *retval)
 {
-  struct timeval delay = { 10, 0 };
+  struct timeval delay = { 1, 0 };
 
-  *retval = event_add(cache_daap_updateev, &delay);
-  return COMMAND_END;
-}
+  *retval = 0;
+  if (!evtimer_pending(cache_daap_updateev, NULL))
+    *retval = evtimer_add(cache_daap_updateev, &delay);
 
-/* Callback from filescanner thread */
-static void
-cache_daap_listener_cb(short event_mask)
-{
-  commands_exec_async(cmdbase, cache_daap_update, NULL);
+  return COMMAND_END;
 }
 
 
@@ -945,24 +1035,68 @@ cache_artwork_ping_impl(void *arg, int *retval)
 	{
 	  DPRINTF(E_LOG, L_CACHE, "Query error: %s\n", errmsg);
 
-	  goto error_ping;
-	}
-    }
+	  goto error_ping;
+	}
+    }
+
+  free(cmdarg->pathcopy);
+
+  *retval = 0;
+  return COMMAND_END;
+
+ error_ping:
+  sqlite3_free(errmsg);
+  free(cmdarg->pathcopy);
+
+  *retval = -1;
+  return COMMAND_END;
+  
+#undef Q_TMPL_PING
+#undef Q_TMPL_DEL
+}
+
+/*
+ * Updates cached timestamps to current time for all cache entries of files directly in
+ * the given directory (not in subdirectories). Used by bulk scans for directories that
+ * were not walked, because they are unchanged.
+ *
+ * @param cmdarg->pathcopy the full path to the directory
+ * @return 0 if successful, -1 if an error occurred
+ */
+static enum command_state
+cache_artwork_ping_bydirectory_impl(void *arg, int *retval)
+{
+#define Q_TMPL "UPDATE artwork SET db_timestamp = %" PRIi64 " WHERE substr(filepath, 1, %d) = '%q/' AND instr(substr(filepath, %d), '/') = 0;"
+
+  struct cache_arg *cmdarg;
+  char *query;
+  char *errmsg;
+  int len;
+  int ret;
+
+  cmdarg = arg;
+  len = strlen(cmdarg->pathcopy);
+  query = sqlite3_mprintf(Q_TMPL, (int64_t)time(NULL), len + 1, cmdarg->pathcopy, len + 2);
+
+  DPRINTF(E_DBG, L_CACHE, "Running query '%s'\n", query);
 
+  ret = sqlite3_exec(g_db_hdl, query, NULL, NULL, &errmsg);
+  sqlite3_free(query);
   free(cmdarg->pathcopy);
 
-  *retval = 0;
-  return COMMAND_END;
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_CACHE, "Query error: %s\n", errmsg);
+      sqlite3_free(errmsg);
 
- error_ping:
-  sqlite3_free(errmsg);
-  free(cmdarg->pathcopy);
+      *retval = -1;
+      return COMMAND_END;
+    }
 
-  *retval = -1;
+  *retval = 0;
   return COMMAND_END;
-  
-#undef Q_TMPL_PING
-#undef Q_TMPL_DEL
+
+#undef Q_TMPL
 }
 
 /*
@@ -1052,8 +1186,8 @@ cache_artwork_purge_cruft_impl(void *arg, int *retval)
  * @param cmdarg->max_w maximum image width
  * @param cmdarg->max_h maximum image height
  * @param cmdarg->format ART_FMT_PNG for png, ART_FMT_JPEG for jpeg or 0 if no artwork available
- * @param cmdarg->filename the full path to the artwork file (could be an jpg/png image or a media file with embedded artwork) or empty if no artwork available
- * @param cmdarg->evbuf event buffer containing the (scaled) image
+ * @param cmdarg->pathcopy the full path to the artwork file (could be an jpg/png image or a media file with embedded artwork) or empty if no artwork available
+ * @param cmdarg->blob the (scaled) image, or NULL if no artwork available
  * @return 0 if successful, -1 if an error occurred
  */
 static enum command_state
@@ -1062,8 +1196,6 @@ cache_artwork_add_impl(void *arg, int *retval)
   struct cache_arg *cmdarg;
   sqlite3_stmt *stmt;
   char *query;
-  uint8_t *data;
-  int datalen;
   int ret;
 
   cmdarg = arg;
@@ -1073,20 +1205,20 @@ cache_artwork_add_impl(void *arg, int *retval)
   if (ret != SQLITE_OK)
     {
       DPRINTF(E_LOG, L_CACHE, "Could not prepare statement: %s\n", sqlite3_errmsg(g_db_hdl));
-      *retval = -1;
-      return COMMAND_END;
+      ret = -1;
+      goto out;
     }
 
-  datalen = evbuffer_get_length(cmdarg->evbuf);
-  data = evbuffer_pullup(cmdarg->evbuf, -1);
-
   sqlite3_bind_int64(stmt, 1, cmdarg->persistentid);
   sqlite3_bind_int(stmt, 2, cmdarg->max_w);
   sqlite3_bind_int(stmt, 3, cmdarg->max_h);
   sqlite3_bind_int(stmt, 4, cmdarg->format);
-  sqlite3_bind_text(stmt, 5, cmdarg->path, -1, SQLITE_STATIC);
-  sqlite3_bind_int(stmt, 6, (uint64_t)time(NULL));
-  sqlite3_bind_blob(stmt, 7, data, datalen, SQLITE_STATIC);
+  sqlite3_bind_text(stmt, 5, cmdarg->pathcopy, -1, SQLITE_STATIC);
+  sqlite3_bind_int64(stmt, 6, (int64_t)cmdarg->mtime);
+  if (cmdarg->blob)
+    sqlite3_bind_blob(stmt, 7, cmdarg->blob->data, cmdarg->blob->len, SQLITE_STATIC);
+  else
+    sqlite3_bind_zeroblob(stmt, 7, 0);
   sqlite3_bind_int(stmt, 8, cmdarg->type);
 
   ret = sqlite3_step(stmt);
@@ -1094,19 +1226,26 @@ cache_artwork_add_impl(void *arg, int *retval)
     {
       DPRINTF(E_LOG, L_CACHE, "Error stepping query for artwork add: %s\n", sqlite3_errmsg(g_db_hdl));
       sqlite3_finalize(stmt);
-      *retval = -1;
-      return COMMAND_END;
+      ret = -1;
+      goto out;
     }
 
   ret = sqlite3_finalize(stmt);
   if (ret != SQLITE_OK)
     {
       DPRINTF(E_LOG, L_CACHE, "Error finalizing query for artwork add: %s\n", sqlite3_errmsg(g_db_hdl));
-      *retval = -1;
-      return COMMAND_END;
+      ret = -1;
+      goto out;
     }
 
-  *retval = 0;
+  ret = 0;
+
+ out:
+  if (cmdarg->blob)
+    blob_unref(cmdarg->blob);
+  free(cmdarg->pathcopy);
+
+  *retval = ret;
   return COMMAND_END;
 }
 
@@ -1114,7 +1253,7 @@ cache_artwork_add_impl(void *arg, int *retval)
  * Get the cached artwork image for the given persistentid and maximum width/height
  *
  * If there is a cached entry for the given id and width/height, the parameter cached is set to 1.
- * In this case format and data contain the cached values.
+ * In this case format, blob, pathcopy and mtime contain the cached values.
  *
  * @param cmdarg->type individual or group artwork
  * @param cmdarg->persistentid persistent itemid, songalbumid or songartistid
@@ -1122,16 +1261,20 @@ cache_artwork_add_impl(void *arg, int *retval)
  * @param cmdarg->max_h maximum image height
  * @param cmdarg->cached set by this function to 0 if no cache entry exists, otherwise 1
  * @param cmdarg->format set by this function to the format of the cache entry
- * @param cmdarg->evbuf event buffer filled by this function with the scaled image
+ * @param cmdarg->blob set by this function to the scaled image (NULL if no artwork available)
+ * @param cmdarg->pathcopy set by this function to the path of the cache entry
+ * @param cmdarg->mtime set by this function to the timestamp of the cache entry
  * @return 0 if successful, -1 if an error occurred
  */
 static enum command_state
 cache_artwork_get_impl(void *arg, int *retval)
 {
-#define Q_TMPL "SELECT a.format, a.data FROM artwork a WHERE a.type = %d AND a.persistentid = %" PRIi64 " AND a.max_w = %d AND a.max_h = %d;"
+#define Q_TMPL "SELECT a.format, a.data, a.filepath, a.db_timestamp FROM artwork a WHERE a.type = %d AND a.persistentid = %" PRIi64 " AND a.max_w = %d AND a.max_h = %d;"
   struct cache_arg *cmdarg;
+  struct cache_blob *blob;
   sqlite3_stmt *stmt;
   char *query;
+  const char *path;
   int datalen;
   int ret;
 
@@ -1175,21 +1318,20 @@ cache_artwork_get_impl(void *arg, int *retval)
 
   cmdarg->format = sqlite3_column_int(stmt, 0);
   datalen = sqlite3_column_bytes(stmt, 1);
-  if (!cmdarg->evbuf)
+  if (cmdarg->format && datalen > 0)
     {
-      DPRINTF(E_LOG, L_CACHE, "Error: Artwork evbuffer is NULL\n");
-      ret = -1;
-      goto error_get;
-    }
+      CHECK_NULL(L_CACHE, blob = calloc(1, sizeof(struct cache_blob)));
+      CHECK_NULL(L_CACHE, blob->data = malloc(datalen));
+      memcpy(blob->data, sqlite3_column_blob(stmt, 1), datalen);
+      blob->len = datalen;
+      blob->refcount = 1;
 
-  ret = evbuffer_add(cmdarg->evbuf, sqlite3_column_blob(stmt, 1), datalen);
-  if (ret < 0)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Out of memory for artwork evbuffer\n");
-      ret = -1;
-      goto error_get;
+      cmdarg->blob = blob;
     }
 
+  path = (const char *)sqlite3_column_text(stmt, 2);
+  cmdarg->pathcopy = strdup(path ? path : "");
+  cmdarg->mtime = sqlite3_column_int64(stmt, 3);
   cmdarg->cached = 1;
 
   ret = sqlite3_finalize(stmt);
@@ -1212,6 +1354,59 @@ cache_artwork_get_impl(void *arg, int *retval)
 #undef Q_TMPL
 }
 
+/*
+ * Checks if there is a cached artwork image (or a cached "no artwork") for the
+ * given persistentid and maximum width/height, without reading the image
+ *
+ * @param cmdarg->type individual or group artwork
+ * @param cmdarg->persistentid persistent itemid, songalbumid or songartistid
+ * @param cmdarg->max_w maximum image width
+ * @param cmdarg->max_h maximum image height
+ * @param cmdarg->cached set by this function to 0 if no cache entry exists, otherwise 1
+ * @return 0 if successful, -1 if an error occurred
+ */
+static enum command_state
+cache_artwork_exists_impl(void *arg, int *retval)
+{
+#define Q_TMPL "SELECT 1 FROM artwork a WHERE a.type = %d AND a.persistentid = %" PRIi64 " AND a.max_w = %d AND a.max_h = %d LIMIT 1;"
+  struct cache_arg *cmdarg;
+  sqlite3_stmt *stmt;
+  char *query;
+  int ret;
+
+  cmdarg = arg;
+  query = sqlite3_mprintf(Q_TMPL, cmdarg->type, cmdarg->persistentid, cmdarg->max_w, cmdarg->max_h);
+  if (!query)
+    {
+      DPRINTF(E_LOG, L_CACHE, "Out of memory for query string\n");
+      *retval = -1;
+      return COMMAND_END;
+    }
+
+  ret = sqlite3_prepare_v2(g_db_hdl, query, -1, &stmt, 0);
+  sqlite3_free(query);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_CACHE, "Could not prepare statement: %s\n", sqlite3_errmsg(g_db_hdl));
+      *retval = -1;
+      return COMMAND_END;
+    }
+
+  ret = sqlite3_step(stmt);
+  if (ret == SQLITE_ROW)
+    cmdarg->cached = 1;
+  else if (ret == SQLITE_DONE)
+    cmdarg->cached = 0;
+  else
+    DPRINTF(E_LOG, L_CACHE, "Could not step: %s\n", sqlite3_errmsg(g_db_hdl));
+
+  sqlite3_finalize(stmt);
+
+  *retval = (ret == SQLITE_ROW || ret == SQLITE_DONE) ? 0 : -1;
+  return COMMAND_END;
+#undef Q_TMPL
+}
+
 static enum command_state
 cache_artwork_stash_impl(void *arg, int *retval)
 {
@@ -1324,11 +1519,14 @@ cache(void *arg)
 
 /* ---------------------------- DAAP cache API  --------------------------- */
 
-/* The DAAP cache will cache raw daap replies for queries added with
+/* The DAAP cache will cache gzipped daap replies for queries added with
  * cache_daap_add(). Only some query types are supported.
  * You can't add queries where the canonical reply is not HTTP_OK, because
  * daap_request will use that as default for cache replies.
  *
+ * The replies are kept in memory and are invalidated when the library
+ * generation changes. A stale reply is only rebuilt if a client asks for it
+ * again, and the cache thread will rebuild such replies one at a time.
  */
 
 void
@@ -1344,40 +1542,151 @@ cache_daap_resume(void)
 }
 
 int
-cache_daap_get(struct evbuffer *evbuf, const char *query)
+cache_daap_get(struct evbuffer *evbuf, const char *query, const char *ua, int is_remote)
 {
-  struct cache_arg cmdarg;
+  struct cache_daap_entry *entry;
+  struct cache_blob *reply;
+  char *key;
+  bool rebuild;
+  int ret;
 
-  if (!g_initialized)
+  if (!g_initialized || !ua || !daap_query_is_cacheable(query))
     return -1;
 
-  cmdarg.query = strdup(query);
-  cmdarg.evbuf = evbuf;
+  key = daap_query_normalize(query);
+  if (!key)
+    return -1;
+
+  reply = NULL;
+  rebuild = false;
+
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_daap_lck));
+
+  entry = daap_entry_find(key, ua, is_remote);
+  if (entry && entry->reply && entry->generation == library_generation_get())
+    {
+      reply = entry->reply;
+      __atomic_add_fetch(&reply->refcount, 1, __ATOMIC_RELAXED);
+
+      daap_entry_unlink(entry);
+      daap_entry_push(entry);
+
+      g_daap_stats.hits++;
+      g_daap_stats.bytes += reply->len;
+    }
+  else
+    {
+      if (entry && !entry->wanted)
+	{
+	  entry->wanted = true;
+	  rebuild = true;
+	}
+
+      g_daap_stats.misses++;
+    }
 
-  return commands_exec_sync(cmdbase, cache_daap_query_get, NULL, &cmdarg);
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_daap_lck));
+
+  if (rebuild)
+    commands_exec_async(cmdbase, cache_daap_update, NULL);
+
+  if (!reply)
+    goto miss;
+
+  // The reply is shared, so we don't copy it, libevent will unref when done
+  ret = evbuffer_add_reference(evbuf, reply->data, reply->len, blob_cleanup_cb, reply);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_CACHE, "Out of memory for DAAP reply evbuffer\n");
+      blob_unref(reply);
+      goto miss;
+    }
+
+  DPRINTF(E_INFO, L_CACHE, "Cache hit: %s\n", key);
+
+  free(key);
+  return 0;
+
+ miss:
+  free(key);
+  return -1;
 }
 
 void
 cache_daap_add(const char *query, const char *ua, int is_remote, int msec)
 {
-  struct cache_arg *cmdarg;
+  struct cache_daap_entry *entry;
+  struct cache_daap_entry *last;
+  char *key;
 
   if (!g_initialized)
     return;
 
-  cmdarg = calloc(1, sizeof(struct cache_arg));
-  if (!cmdarg)
+  if (!ua)
     {
-      DPRINTF(E_LOG, L_CACHE, "Could not allocate cache_arg\n");
+      DPRINTF(E_LOG, L_CACHE, "Couldn't add slow query to cache, unknown user-agent\n");
       return;
     }
 
-  cmdarg->query = strdup(query);
-  cmdarg->ua = strdup(ua);
-  cmdarg->is_remote = is_remote;
-  cmdarg->msec = msec;
+  if (!daap_query_is_cacheable(query))
+    return;
+
+  key = daap_query_normalize(query);
+  if (!key)
+    return;
+
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_daap_lck));
+
+  entry = daap_entry_find(key, ua, is_remote);
+  if (entry)
+    {
+      daap_entry_unlink(entry);
+      free(key);
+    }
+  else
+    {
+      CHECK_NULL(L_CACHE, entry = calloc(1, sizeof(struct cache_daap_entry)));
+      CHECK_NULL(L_CACHE, entry->ua = strdup(ua));
+      entry->query = key;
+      entry->is_remote = is_remote;
+
+      g_daap_nentries++;
+    }
+
+  entry->msec = msec;
+  entry->wanted = true;
+  daap_entry_push(entry);
+
+  // Limits the size of the cache to only contain replies for the most recently used queries
+  if (g_daap_nentries > CACHE_DAAP_ENTRIES_MAX)
+    {
+      for (last = g_daap_entries; last->next; last = last->next)
+	; // Find the tail
+
+      daap_entry_remove(last);
+    }
+
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_daap_lck));
+
+  DPRINTF(E_INFO, L_CACHE, "Slow query (%d ms) added to cache: '%s' (user-agent: '%s')\n", msec, query, ua);
+
+  commands_exec_async(cmdbase, cache_daap_update, NULL);
+}
+
+void
+cache_daap_stats_get(struct cache_daap_stats *stats)
+{
+  memset(stats, 0, sizeof(struct cache_daap_stats));
+
+  if (!g_initialized)
+    return;
+
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_daap_lck));
 
-  commands_exec_async(cmdbase, cache_daap_query_add, cmdarg);
+  *stats = g_daap_stats;
+  stats->entries = g_daap_nentries;
+
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_daap_lck));
 }
 
 int
@@ -1404,11 +1713,26 @@ cache_daap_threshold(void)
 void
 cache_artwork_ping(const char *path, time_t mtime, int del)
 {
+  struct cache_artwork_entry *entry;
+  struct cache_artwork_entry *next;
   struct cache_arg *cmdarg;
 
   if (!g_initialized)
     return;
 
+  // Bulk scans don't delete, so this only runs for the occasional changed file
+  if (del > 0)
+    {
+      CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_artwork_lck));
+      for (entry = g_artwork_head; entry; entry = next)
+	{
+	  next = entry->next;
+	  if (entry->stamp < mtime && strcmp(entry->path, path) == 0)
+	    artwork_entry_remove(entry);
+	}
+      CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_artwork_lck));
+    }
+
   cmdarg = calloc(1, sizeof(struct cache_arg));
   if (!cmdarg)
     {
@@ -1423,6 +1747,26 @@ cache_artwork_ping(const char *path, time_t mtime, int del)
   commands_exec_async(cmdbase, cache_artwork_ping_impl, cmdarg);
 }
 
+void
+cache_artwork_ping_bydirectory(const char *path)
+{
+  struct cache_arg *cmdarg;
+
+  if (!g_initialized)
+    return;
+
+  cmdarg = calloc(1, sizeof(struct cache_arg));
+  if (!cmdarg)
+    {
+      DPRINTF(E_LOG, L_CACHE, "Could not allocate cache_arg\n");
+      return;
+    }
+
+  cmdarg->pathcopy = strdup(path);
+
+  commands_exec_async(cmdbase, cache_artwork_ping_bydirectory_impl, cmdarg);
+}
+
 /*
  * Removes all cache entries for the given path
  *
@@ -1432,11 +1776,22 @@ cache_artwork_ping(const char *path, time_t mtime, int del)
 int
 cache_artwork_delete_by_path(const char *path)
 {
+  struct cache_artwork_entry *entry;
+  struct cache_artwork_entry *next;
   struct cache_arg cmdarg;
 
   if (!g_initialized)
     return -1;
 
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_artwork_lck));
+  for (entry = g_artwork_head; entry; entry = next)
+    {
+      next = entry->next;
+      if (strcmp(entry->path, path) == 0)
+	artwork_entry_remove(entry);
+    }
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_artwork_lck));
+
   cmdarg.path = path;
 
   return commands_exec_sync(cmdbase, cache_artwork_delete_by_path_impl, NULL, &cmdarg);
@@ -1445,17 +1800,32 @@ cache_artwork_delete_by_path(const char *path)
 /*
  * Removes all cache entries with cached timestamp older than the given reference timestamp
  *
+ * Pings don't refresh the timestamps of the entries held in memory, so from
+ * memory this removes everything added before ref. They will be read from the
+ * artwork table again when requested.
+ *
  * @param ref reference timestamp
  * @return 0 if successful, -1 if an error occurred
  */
 int
 cache_artwork_purge_cruft(time_t ref)
 {
+  struct cache_artwork_entry *entry;
+  struct cache_artwork_entry *next;
   struct cache_arg cmdarg;
 
   if (!g_initialized)
     return -1;
 
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_artwork_lck));
+  for (entry = g_artwork_head; entry; entry = next)
+    {
+      next = entry->next;
+      if (entry->stamp < ref)
+	artwork_entry_remove(entry);
+    }
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_artwork_lck));
+
   cmdarg.mtime = ref;
 
   return commands_exec_sync(cmdbase, cache_artwork_purge_cruft_impl, NULL, &cmdarg);
@@ -1464,6 +1834,9 @@ cache_artwork_purge_cruft(time_t ref)
 /*
  * Adds the given (scaled) artwork image to the artwork cache
  *
+ * The image is put in the in-memory cache right away, while writing it to the
+ * artwork table is left to the cache thread.
+ *
  * @param type individual or group artwork
  * @param persistentid persistent itemid, songalbumid or songartistid
  * @param max_w maximum image width
@@ -1476,27 +1849,48 @@ cache_artwork_purge_cruft(time_t ref)
 int
 cache_artwork_add(int type, int64_t persistentid, int max_w, int max_h, int format, char *filename, struct evbuffer *evbuf)
 {
-  struct cache_arg cmdarg;
+  struct cache_arg *cmdarg;
+  struct cache_blob *blob;
+  time_t now;
 
   if (!g_initialized)
     return -1;
 
-  cmdarg.type = type;
-  cmdarg.persistentid = persistentid;
-  cmdarg.max_w = max_w;
-  cmdarg.max_h = max_h;
-  cmdarg.format = format;
-  cmdarg.path = filename;
-  cmdarg.evbuf = evbuf;
+  blob = format ? blob_new(evbuf) : NULL;
+  now = time(NULL);
+
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_artwork_lck));
+  artwork_entry_add(type, persistentid, max_w, max_h, format, filename, now, blob);
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_artwork_lck));
+
+  cmdarg = calloc(1, sizeof(struct cache_arg));
+  if (!cmdarg)
+    {
+      DPRINTF(E_LOG, L_CACHE, "Could not allocate cache_arg\n");
+      if (blob)
+	blob_unref(blob);
+      return -1;
+    }
 
-  return commands_exec_sync(cmdbase, cache_artwork_add_impl, NULL, &cmdarg);
+  cmdarg->type = type;
+  cmdarg->persistentid = persistentid;
+  cmdarg->max_w = max_w;
+  cmdarg->max_h = max_h;
+  cmdarg->format = format;
+  cmdarg->pathcopy = strdup(filename ? filename : "");
+  cmdarg->mtime = now;
+  cmdarg->blob = blob; // Our reference is handed over to the cache thread
+
+  return commands_exec_async(cmdbase, cache_artwork_add_impl, cmdarg);
 }
 
 /*
  * Get the cached artwork image for the given persistentid and maximum width/height
  *
  * If there is a cached entry for the given id and width/height, the parameter cached is set to 1.
- * In this case format and data contain the cached values.
+ * In this case format and data contain the cached values. Images held in memory
+ * are added to evbuf by reference, otherwise the image is read from the
+ * artwork table by the cache thread and then kept in memory.
  *
  * @param persistentid persistent songalbumid or songartistid
  * @param max_w maximum image width
@@ -1509,28 +1903,111 @@ cache_artwork_add(int type, int64_t persistentid, int max_w, int max_h, int form
 int
 cache_artwork_get(int type, int64_t persistentid, int max_w, int max_h, int *cached, int *format, struct evbuffer *evbuf)
 {
+  struct cache_artwork_entry *entry;
   struct cache_arg cmdarg;
+  struct cache_blob *blob;
   int ret;
 
+  *cached = 0;
+  *format = 0;
+
   if (!g_initialized)
+    return 0;
+
+  blob = NULL;
+
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_artwork_lck));
+  entry = artwork_entry_find(type, persistentid, max_w, max_h);
+  if (entry)
     {
-      *cached = 0;
-      *format = 0;
-      return 0;
+      artwork_entry_unlink(entry);
+      artwork_entry_push(entry);
+
+      *cached = 1;
+      *format = entry->format;
+      blob = entry->blob;
+      if (blob)
+	__atomic_add_fetch(&blob->refcount, 1, __ATOMIC_RELAXED);
+    }
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_artwork_lck));
+
+  if (!*cached)
+    {
+      memset(&cmdarg, 0, sizeof(struct cache_arg));
+      cmdarg.type = type;
+      cmdarg.persistentid = persistentid;
+      cmdarg.max_w = max_w;
+      cmdarg.max_h = max_h;
+
+      ret = commands_exec_sync(cmdbase, cache_artwork_get_impl, NULL, &cmdarg);
+      if (ret < 0 || !cmdarg.cached)
+	return ret;
+
+      *cached = 1;
+      *format = cmdarg.format;
+      blob = cmdarg.blob;
+
+      CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_artwork_lck));
+      artwork_entry_add(type, persistentid, max_w, max_h, cmdarg.format, cmdarg.pathcopy, cmdarg.mtime, blob);
+      CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_artwork_lck));
+
+      free(cmdarg.pathcopy);
+    }
+
+  if (!blob)
+    return 0;
+
+  // The image is shared, so we don't copy it, libevent will unref when done
+  ret = evbuffer_add_reference(evbuf, blob->data, blob->len, blob_cleanup_cb, blob);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_CACHE, "Out of memory for artwork evbuffer\n");
+      blob_unref(blob);
+      return -1;
     }
 
+  return 0;
+}
+
+/*
+ * Checks if there is a cached entry for the given persistentid and maximum
+ * width/height. Unlike cache_artwork_get() it doesn't read the image, so it
+ * can be used for checking many entries without filling up the memory.
+ *
+ * @param type individual or group artwork
+ * @param persistentid persistent itemid, songalbumid or songartistid
+ * @param max_w maximum image width
+ * @param max_h maximum image height
+ * @return 1 if cached, 0 if not cached, -1 if an error occurred
+ */
+int
+cache_artwork_exists(int type, int64_t persistentid, int max_w, int max_h)
+{
+  struct cache_arg cmdarg;
+  bool found;
+  int ret;
+
+  if (!g_initialized)
+    return -1;
+
+  CHECK_ERR(L_CACHE, pthread_mutex_lock(&g_artwork_lck));
+  found = (artwork_entry_find(type, persistentid, max_w, max_h) != NULL);
+  CHECK_ERR(L_CACHE, pthread_mutex_unlock(&g_artwork_lck));
+
+  if (found)
+    return 1;
+
+  memset(&cmdarg, 0, sizeof(struct cache_arg));
   cmdarg.type = type;
   cmdarg.persistentid = persistentid;
   cmdarg.max_w = max_w;
   cmdarg.max_h = max_h;
-  cmdarg.evbuf = evbuf;
-
-  ret = commands_exec_sync(cmdbase, cache_artwork_get_impl, NULL, &cmdarg);
 
-  *format = cmdarg.format;
-  *cached = cmdarg.cached;
+  ret = commands_exec_sync(cmdbase, cache_artwork_exists_impl, NULL, &cmdarg);
+  if (ret < 0)
+    return -1;
 
-  return ret;
+  return cmdarg.cached;
 }
 
 /*
@@ -1601,6 +2078,7 @@ cache_init(void)
     }
 
   g_cfg_threshold = cfg_getint(cfg_getsec(cfg, "general"), "cache_daap_threshold");
+  g_artwork_size_max = (size_t)cfg_getint(cfg_getsec(cfg, "general"), "cache_artwork_size") * 1024 * 1024;
   if (g_cfg_threshold == 0)
     {
       DPRINTF(E_LOG, L_CACHE, "Cache threshold set to 0, disabling cache\n");
@@ -1623,12 +2101,8 @@ cache_init(void)
 
   cmdbase = commands_base_new(evbase_cache, NULL);
 
-  ret = listener_add(cache_daap_listener_cb, LISTENER_DATABASE);
-  if (ret < 0)
-    {
-      DPRINTF(E_LOG, L_CACHE, "Could not create listener event\n");
-      goto listener_fail;
-    }
+  CHECK_ERR(L_CACHE, mutex_init(&g_daap_lck));
+  CHECK_ERR(L_CACHE, mutex_init(&g_artwork_lck));
 
   DPRINTF(E_INFO, L_CACHE, "cache thread init\n");
 
@@ -1649,8 +2123,8 @@ cache_init(void)
   return 0;
   
  thread_fail:
-  listener_remove(cache_daap_listener_cb);
- listener_fail:
+  pthread_mutex_destroy(&g_artwork_lck);
+  pthread_mutex_destroy(&g_daap_lck);
   commands_base_free(cmdbase);
  evnew_fail:
   event_base_free(evbase_cache);
@@ -1670,8 +2144,6 @@ cache_deinit(void)
 
   g_initialized = 0;
 
-  listener_remove(cache_daap_listener_cb);
-
   commands_base_destroy(cmdbase);
 
   ret = pthread_join(tid_cache, NULL);
@@ -1681,6 +2153,12 @@ cache_deinit(void)
       return;
     }
 
+  daap_entries_purge();
+  pthread_mutex_destroy(&g_daap_lck);
+
+  artwork_entries_purge();
+  pthread_mutex_destroy(&g_artwork_lck);
+
   // Free event base
   event_free(cache_daap_updateev);
   event_base_free(evbase_cache);
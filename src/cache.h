@@ -6,6 +6,15 @@
 
 /* ---------------------------- DAAP cache API  --------------------------- */
 
+struct cache_daap_stats
+{
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t bytes;  // Gzipped bytes served from the cache
+  size_t size;     // Gzipped bytes currently held by the cache
+  int entries;
+};
+
 void
 cache_daap_suspend(void);
 
@@ -13,11 +22,14 @@ void
 cache_daap_resume(void);
 
 int
-cache_daap_get(struct evbuffer *evbuf, const char *query);
+cache_daap_get(struct evbuffer *evbuf, const char *query, const char *ua, int is_remote);
 
 void
 cache_daap_add(const char *query, const char *ua, int is_remote, int msec);
 
+void
+cache_daap_stats_get(struct cache_daap_stats *stats);
+
 int
 cache_daap_threshold(void);
 
@@ -30,6 +42,9 @@ cache_daap_threshold(void);
 void
 cache_artwork_ping(const char *path, time_t mtime, int del);
 
+void
+cache_artwork_ping_bydirectory(const char *path);
+
 int
 cache_artwork_delete_by_path(const char *path);
 
@@ -42,6 +57,9 @@ cache_artwork_add(int type, int64_t persistentid, int max_w, int max_h, int form
 int
 cache_artwork_get(int type, int64_t persistentid, int max_w, int max_h, int *cached, int *format, struct evbuffer *evbuf);
 
+int
+cache_artwork_exists(int type, int64_t persistentid, int max_w, int max_h);
+
 int
 cache_artwork_stash(struct evbuffer *evbuf, const char *path, int format);
 
@@ -16,22 +16,49 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
 #include "commands.h"
 
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef HAVE_EVENTFD
+# include <sys/eventfd.h>
+#endif
+#ifdef HAVE_LINUX_FUTEX_H
+# include <linux/futex.h>
+# include <sys/syscall.h>
+#endif
 
 #include "logger.h"
 #include "misc.h"
 
+// Max number of commands executed per run of the event callback, so that a
+// burst of commands doesn't starve the other events of the loop
+#define COMMANDS_BATCH_MAX 16
+
 struct command
 {
+  // Next in the command queue (intrusive, so queueing doesn't allocate)
+  struct command *next;
+
+  // Completion of sync commands, set to 1 when the caller may return
+  uint32_t done;
+#ifndef HAVE_LINUX_FUTEX_H
   pthread_mutex_t lck;
   pthread_cond_t cond;
+#endif
 
   command_function func;
   command_function func_bh;
@@ -45,11 +72,210 @@ struct commands_base
 {
   struct event_base *evbase;
   command_exit_cb exit_cb;
+#ifdef HAVE_EVENTFD
+  int command_efd;
+#else
   int command_pipe[2];
+#endif
   struct event *command_event;
   struct command *current_cmd;
+
+  // Lock-free multiple producer/single consumer queue. Producers push to the
+  // head of a stack, and the event loop takes the whole stack at a time and
+  // moves it, in reverse order, to the batch list. The wakeup fd is only
+  // written when the stack was empty, so a burst of commands that arrive
+  // before the loop wakes up only costs one wakeup.
+  struct command *queue;
+
+  // Only accessed by the event loop thread
+  struct command *batch_head;
+  struct command *batch_tail;
+
+  // Stats (atomic)
+  uint64_t wakeups;
+  uint64_t executed;
 };
 
+
+/* ------------------------ Completion of sync commands --------------------- */
+
+#ifdef HAVE_LINUX_FUTEX_H
+static void
+completion_init(struct command *cmd)
+{
+  cmd->done = 0;
+}
+
+static void
+completion_deinit(struct command *cmd)
+{
+  return;
+}
+
+static void
+completion_wait(struct command *cmd)
+{
+  while (!__atomic_load_n(&cmd->done, __ATOMIC_ACQUIRE))
+    syscall(SYS_futex, &cmd->done, FUTEX_WAIT_PRIVATE, 0, NULL, NULL, 0);
+}
+
+// The caller may return (and cmd go out of scope) as soon as done is set, so
+// cmd must not be touched after that. Waking a futex at an address that is no
+// longer in use is harmless.
+static void
+completion_signal(struct command *cmd)
+{
+  uint32_t *done = &cmd->done;
+
+  __atomic_store_n(done, 1, __ATOMIC_RELEASE);
+  syscall(SYS_futex, done, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+#else
+static void
+completion_init(struct command *cmd)
+{
+  cmd->done = 0;
+  CHECK_ERR(L_MAIN, mutex_init(&cmd->lck));
+  CHECK_ERR(L_MAIN, pthread_cond_init(&cmd->cond, NULL));
+}
+
+static void
+completion_deinit(struct command *cmd)
+{
+  CHECK_ERR(L_MAIN, pthread_cond_destroy(&cmd->cond));
+  CHECK_ERR(L_MAIN, pthread_mutex_destroy(&cmd->lck));
+}
+
+static void
+completion_wait(struct command *cmd)
+{
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&cmd->lck));
+  while (!cmd->done)
+    CHECK_ERR(L_MAIN, pthread_cond_wait(&cmd->cond, &cmd->lck));
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&cmd->lck));
+}
+
+static void
+completion_signal(struct command *cmd)
+{
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&cmd->lck));
+  cmd->done = 1;
+  CHECK_ERR(L_MAIN, pthread_cond_signal(&cmd->cond));
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&cmd->lck));
+}
+#endif
+
+
+/* ------------------------------ Command queue ----------------------------- */
+
+static void
+wakeup_send(struct commands_base *cmdbase)
+{
+  int ret;
+
+#ifdef HAVE_EVENTFD
+  ret = eventfd_write(cmdbase->command_efd, 1);
+#else
+  ret = write(cmdbase->command_pipe[1], "", 1);
+  ret = (ret == 1) ? 0 : -1;
+#endif
+  // If the pipe is full the loop has a wakeup pending anyway
+  if (ret < 0 && errno != EAGAIN)
+    DPRINTF(E_LOG, L_MAIN, "Could not wake up command loop: %s\n", strerror(errno));
+}
+
+static void
+wakeup_clear(struct commands_base *cmdbase)
+{
+#ifdef HAVE_EVENTFD
+  eventfd_t count;
+
+  eventfd_read(cmdbase->command_efd, &count);
+#else
+  char buf[64];
+
+  while (read(cmdbase->command_pipe[0], buf, sizeof(buf)) == sizeof(buf))
+    ; /* EMPTY */
+#endif
+}
+
+// Returns true if the queue was empty, i.e. the loop must be woken up
+static bool
+queue_push(struct commands_base *cmdbase, struct command *cmd)
+{
+  struct command *head;
+
+  head = __atomic_load_n(&cmdbase->queue, __ATOMIC_RELAXED);
+  do
+    cmd->next = head;
+  while (!__atomic_compare_exchange_n(&cmdbase->queue, &head, cmd, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+  return (head == NULL);
+}
+
+// Moves what producers have queued to the end of the batch list
+static void
+batch_refill(struct commands_base *cmdbase)
+{
+  struct command *cmd;
+  struct command *next;
+  struct command *first;
+  struct command *last;
+
+  cmd = __atomic_exchange_n(&cmdbase->queue, NULL, __ATOMIC_ACQUIRE);
+  if (!cmd)
+    return;
+
+  // The stack is newest first, so reverse it
+  last = cmd;
+  first = NULL;
+  for (; cmd; cmd = next)
+    {
+      next = cmd->next;
+      cmd->next = first;
+      first = cmd;
+    }
+
+  if (cmdbase->batch_tail)
+    cmdbase->batch_tail->next = first;
+  else
+    cmdbase->batch_head = first;
+
+  cmdbase->batch_tail = last;
+}
+
+static struct command *
+batch_pop(struct commands_base *cmdbase)
+{
+  struct command *cmd;
+
+  cmd = cmdbase->batch_head;
+  if (!cmd)
+    return NULL;
+
+  cmdbase->batch_head = cmd->next;
+  if (!cmdbase->batch_head)
+    cmdbase->batch_tail = NULL;
+
+  return cmd;
+}
+
+/*
+ * Makes the event loop continue with the next commands, either right away if
+ * some are left from the current batch, or when woken up
+ */
+static void
+commands_resume(struct commands_base *cmdbase)
+{
+  if (cmdbase->batch_head)
+    event_active(cmdbase->command_event, EV_TIMEOUT, 0);
+  else
+    event_add(cmdbase->command_event, NULL);
+}
+
+
+/* ---------------------------- Command execution --------------------------- */
+
 /*
  * Asynchronous execution of the command function
  */
@@ -66,8 +292,6 @@ command_cb_async(struct commands_base *cmdbase, struct command *cmd)
     free(cmd->arg);
 
   free(cmd);
-
-  event_add(cmdbase->command_event, NULL);
 }
 
 /*
@@ -78,8 +302,6 @@ command_cb_sync(struct commands_base *cmdbase, struct command *cmd)
 {
   enum command_state cmdstate;
 
-  CHECK_ERR(L_MAIN, pthread_mutex_lock(&cmd->lck));
-
   cmdstate = cmd->func(cmd->arg, &cmd->ret);
   if (cmdstate == COMMAND_PENDING)
     {
@@ -93,11 +315,10 @@ command_cb_sync(struct commands_base *cmdbase, struct command *cmd)
       if (cmd->ret == 0 && cmd->func_bh)
 	cmd->func_bh(cmd->arg, &cmd->ret);
 
-      event_add(cmdbase->command_event, NULL);
+      commands_resume(cmdbase);
 
       // Signal the calling thread that the command execution finished
-      CHECK_ERR(L_MAIN, pthread_cond_signal(&cmd->cond));
-      CHECK_ERR(L_MAIN, pthread_mutex_unlock(&cmd->lck));
+      completion_signal(cmd);
 
       // Note if cmd->func was cmdloop_exit then cmdbase may be invalid now,
       // because commands_base_destroy() may have freed it
@@ -107,67 +328,72 @@ command_cb_sync(struct commands_base *cmdbase, struct command *cmd)
 /*
  * Event callback function
  *
- * Function is triggered by libevent if there is data to read on the command pipe (writing to the command pipe happens through
- * the send_command function).
+ * Function is triggered by libevent when the command queue has been woken up
+ * (through the send_command function), or by commands_resume() if there are
+ * commands left in the current batch.
  */
 static void
 command_cb(int fd, short what, void *arg)
 {
   struct commands_base *cmdbase;
   struct command *cmd;
-  int ret;
+  int n;
 
   cmdbase = arg;
 
-  // Get the command to execute from the pipe
-  ret = read(cmdbase->command_pipe[0], &cmd, sizeof(cmd));
-  if (ret != sizeof(cmd))
-    {
-      DPRINTF(E_LOG, L_MAIN, "Error reading command from command pipe: expected %zu bytes, read %d bytes\n", sizeof(cmd), ret);
+  __atomic_add_fetch(&cmdbase->wakeups, 1, __ATOMIC_RELAXED);
 
-      event_add(cmdbase->command_event, NULL);
-      return;
-    }
+  // Clear the wakeup before taking the queue, otherwise we could miss one
+  if (what & EV_READ)
+    wakeup_clear(cmdbase);
 
-  // Execute the command function
-  if (cmd->nonblock)
-    {
-      // Command is executed asynchronously
-      command_cb_async(cmdbase, cmd);
-    }
-  else
+  batch_refill(cmdbase);
+
+  for (n = 0; n < COMMANDS_BATCH_MAX; n++)
     {
-      // Command is executed synchronously, caller is waiting until signaled that the execution finished
+      cmd = batch_pop(cmdbase);
+      if (!cmd)
+	break;
+
+      __atomic_add_fetch(&cmdbase->executed, 1, __ATOMIC_RELAXED);
+
+      if (cmd->nonblock)
+	{
+	  // Command is executed asynchronously
+	  command_cb_async(cmdbase, cmd);
+	  continue;
+	}
+
+      // Command is executed synchronously, caller is waiting until signaled
+      // that the execution finished. We stop here, since command_cb_sync() or
+      // commands_exec_end() will resume, and after that cmdbase may be gone.
       command_cb_sync(cmdbase, cmd);
+      return;
     }
+
+  commands_resume(cmdbase);
 }
 
 /*
- * Writes the given command to the command pipe
+ * Adds the given command to the command queue
  */
 static int
 send_command(struct commands_base *cmdbase, struct command *cmd)
 {
-  int ret;
-
   if (!cmd->func)
     {
       DPRINTF(E_LOG, L_MAIN, "Programming error: send_command called with command->func NULL!\n");
       return -1;
     }
 
-  ret = write(cmdbase->command_pipe[1], &cmd, sizeof(cmd));
-  if (ret != sizeof(cmd))
-    {
-      DPRINTF(E_LOG, L_MAIN, "Bad write to command pipe (write incomplete)\n");
-      return -1;
-    }
+  if (queue_push(cmdbase, cmd))
+    wakeup_send(cmdbase);
 
   return 0;
 }
 
 /*
- * Frees the command base and closes the (internally used) pipes
+ * Frees the command base and closes the (internally used) wakeup fd
  */
 int
 commands_base_free(struct commands_base *cmdbase)
@@ -175,8 +401,12 @@ commands_base_free(struct commands_base *cmdbase)
   if (cmdbase->command_event)
     event_free(cmdbase->command_event);
 
+#ifdef HAVE_EVENTFD
+  close(cmdbase->command_efd);
+#else
   close(cmdbase->command_pipe[0]);
   close(cmdbase->command_pipe[1]);
+#endif
   free(cmdbase);
 
   return 0;
@@ -192,23 +422,36 @@ struct commands_base *
 commands_base_new(struct event_base *evbase, command_exit_cb exit_cb)
 {
   struct commands_base *cmdbase;
+  int fd;
   int ret;
 
   CHECK_NULL(L_MAIN, cmdbase = calloc(1, sizeof(struct commands_base)));
 
-#ifdef HAVE_PIPE2
-  ret = pipe2(cmdbase->command_pipe, O_CLOEXEC);
+#ifdef HAVE_EVENTFD
+  cmdbase->command_efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  ret = cmdbase->command_efd;
+  fd = cmdbase->command_efd;
 #else
+# ifdef HAVE_PIPE2
+  ret = pipe2(cmdbase->command_pipe, O_CLOEXEC | O_NONBLOCK);
+# else
   ret = pipe(cmdbase->command_pipe);
+  if (ret == 0)
+    {
+      fcntl(cmdbase->command_pipe[0], F_SETFL, O_NONBLOCK);
+      fcntl(cmdbase->command_pipe[1], F_SETFL, O_NONBLOCK);
+    }
+# endif
+  fd = cmdbase->command_pipe[0];
 #endif
   if (ret < 0)
     {
-      DPRINTF(E_LOG, L_MAIN, "Could not create command pipe: %s\n", strerror(errno));
+      DPRINTF(E_LOG, L_MAIN, "Could not create command wakeup fd: %s\n", strerror(errno));
       free(cmdbase);
       return NULL;
     }
 
-  cmdbase->command_event = event_new(evbase, cmdbase->command_pipe[0], EV_READ, command_cb, cmdbase);
+  cmdbase->command_event = event_new(evbase, fd, EV_READ, command_cb, cmdbase);
   if (!cmdbase->command_event)
     {
       DPRINTF(E_LOG, L_MAIN, "Could not create cmd event\n");
@@ -284,10 +527,9 @@ commands_exec_end(struct commands_base *cmdbase, int retvalue)
   cmdbase->current_cmd = NULL;
 
   /* Process commands again */
-  event_add(cmdbase->command_event, NULL);
+  commands_resume(cmdbase);
 
-  CHECK_ERR(L_MAIN, pthread_cond_signal(&current_cmd->cond));
-  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&current_cmd->lck));
+  completion_signal(current_cmd);
 }
 
 /*
@@ -315,10 +557,7 @@ commands_exec_sync(struct commands_base *cmdbase, command_function func, command
   cmd.arg = arg;
   cmd.nonblock = 0;
 
-  CHECK_ERR(L_MAIN, mutex_init(&cmd.lck));
-  CHECK_ERR(L_MAIN, pthread_cond_init(&cmd.cond, NULL));
-
-  CHECK_ERR(L_MAIN, pthread_mutex_lock(&cmd.lck));
+  completion_init(&cmd);
 
   ret = send_command(cmdbase, &cmd);
   if (ret < 0)
@@ -328,12 +567,10 @@ commands_exec_sync(struct commands_base *cmdbase, command_function func, command
     }
   else
     {
-      CHECK_ERR(L_MAIN, pthread_cond_wait(&cmd.cond, &cmd.lck));
+      completion_wait(&cmd);
     }
-  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&cmd.lck));
 
-  CHECK_ERR(L_MAIN, pthread_cond_destroy(&cmd.cond));
-  CHECK_ERR(L_MAIN, pthread_mutex_destroy(&cmd.lck));
+  completion_deinit(&cmd);
 
   return cmd.ret;
 }
@@ -341,6 +578,7 @@ commands_exec_sync(struct commands_base *cmdbase, command_function func, command
 /*
  * Execute the function 'func' with the given argument 'arg' in the event loop thread.
  * Triggers the function execution and immediately returns (does not wait for func to finish).
+ * Commands that are added before the event loop gets to them are executed in one batch.
  *
  * The pointer passed as argument is freed in the event loop thread after func returned.
  *
@@ -356,6 +594,9 @@ commands_exec_async(struct commands_base *cmdbase, command_function func, void *
   int ret;
 
   cmd = calloc(1, sizeof(struct command));
+  if (!cmd)
+    return -1;
+
   cmd->func = func;
   cmd->func_bh = NULL;
   cmd->arg = arg;
@@ -371,6 +612,21 @@ commands_exec_async(struct commands_base *cmdbase, command_function func, void *
   return 0;
 }
 
+/*
+ * Gets the number of times the event loop thread has been woken up to execute
+ * commands, and the number of commands it has executed. Thread safe.
+ *
+ * @param cmdbase The command base
+ * @param wakeups Number of wakeups
+ * @param executed Number of executed commands
+ */
+void
+commands_stats_get(struct commands_base *cmdbase, uint64_t *wakeups, uint64_t *executed)
+{
+  *wakeups = __atomic_load_n(&cmdbase->wakeups, __ATOMIC_RELAXED);
+  *executed = __atomic_load_n(&cmdbase->executed, __ATOMIC_RELAXED);
+}
+
 /*
  * Command to break the libevent loop
  *
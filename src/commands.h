@@ -2,6 +2,7 @@
 #ifndef SRC_COMMANDS_H_
 #define SRC_COMMANDS_H_
 
+#include <stdint.h>
 #include <event2/event.h>
 
 enum command_state {
@@ -53,4 +54,7 @@ commands_exec_async(struct commands_base *cmdbase, command_function func, void *
 void
 commands_base_destroy(struct commands_base *cmdbase);
 
+void
+commands_stats_get(struct commands_base *cmdbase, uint64_t *wakeups, uint64_t *executed);
+
 #endif /* SRC_COMMANDS_H_ */
@@ -51,6 +51,7 @@
 #include "db_init.h"
 #include "db_upgrade.h"
 #include "rng.h"
+#include "worker.h"
 
 
 #define STR(x) ((x) ? (x) : "")
@@ -58,6 +59,12 @@
 // Inotify cookies are uint32_t
 #define INOTIFY_FAKE_COOKIE ((int64_t)1 << 32)
 
+// Max number of items returned by a fuzzy search, see db_search_filter()
+#define DB_SEARCH_FUZZY_LIMIT 50
+
+// Number of prepared library queries each thread keeps, see db_stmt_cache_get()
+#define DB_STMT_CACHE_SIZE 32
+
 #define DB_TYPE_INT      1
 #define DB_TYPE_INT64    2
 #define DB_TYPE_STRING   3
@@ -140,6 +147,7 @@ struct query_clause {
   char *having;
   char *order;
   char *index;
+  char *count; // Set if the query counts its results, see db_query_count_over()
 };
 
 struct browse_clause {
@@ -288,6 +296,7 @@ static const struct col_type_map qi_cols_map[] =
 /* This list must be kept in sync with
  * - the order of the columns in the files table
  * - the name of the fields in struct db_media_file_info
+ * - mfi_cols_map, which db_query_fetch_file() uses for the column types
  */
 static const ssize_t dbmfi_cols_map[] =
   {
@@ -538,10 +547,21 @@ struct rng_ctx shuffle_rng;
 
 static char *db_path;
 static bool db_rating_updates;
+// Column index of each field of db_media_file_info by offset (-1 if not a column), set by db_init()
+static int8_t dbmfi_col_index[sizeof(struct db_media_file_info)];
+// SQLite supports the full text index files_fts, see db_search_index_init()
+static bool db_search_fts;
 
 static __thread sqlite3 *hdl;
 static __thread struct db_statements db_statements;
 
+/* Prepared library queries, most recently used first. A statement is taken
+ * out while its query is running and put back by db_query_end(). */
+static __thread sqlite3_stmt *db_stmt_cache[DB_STMT_CACHE_SIZE];
+static __thread int db_stmt_cache_n;
+static uint64_t db_stmt_cache_hits;
+static uint64_t db_stmt_cache_misses;
+
 
 /* Forward */
 static enum group_type
@@ -617,6 +637,289 @@ db_snprintf(char *s, int n, const char *fmt, ...)
   return 0;
 }
 
+/* Text fields of files that are indexed in files_fts */
+static const char *db_search_fields[] =
+  {
+    "title", "artist", "album", "album_artist", "composer", "genre",
+  };
+
+// Returns the files_fts column for field ("f.title" or "title"), or NULL if
+// the field isn't indexed
+static const char *
+db_search_field(const char *field)
+{
+  int i;
+
+  if (strncmp(field, "f.", 2) == 0)
+    field += 2;
+
+  for (i = 0; i < ARRAY_SIZE(db_search_fields); i++)
+    {
+      if (strcmp(field, db_search_fields[i]) == 0)
+	return db_search_fields[i];
+    }
+
+  return NULL;
+}
+
+// Appends value as an FTS5 string, i.e. in double quotes with any double
+// quotes inside doubled
+static void
+db_search_phrase_append(sqlite3_str *match, const char *value, size_t len)
+{
+  size_t i;
+
+  sqlite3_str_appendchar(match, 1, '"');
+  for (i = 0; i < len; i++)
+    sqlite3_str_appendchar(match, (value[i] == '"') ? 2 : 1, value[i]);
+  sqlite3_str_appendchar(match, 1, '"');
+}
+
+static void
+db_search_like_append(sqlite3_str *cond, const char *col, const char *value)
+{
+  int i;
+
+  if (col)
+    {
+      sqlite3_str_appendf(cond, "f.%s LIKE '%%%q%%'", col, value);
+      return;
+    }
+
+  sqlite3_str_appendchar(cond, 1, '(');
+  for (i = 0; i < ARRAY_SIZE(db_search_fields); i++)
+    sqlite3_str_appendf(cond, "%sf.%s LIKE '%%%q%%'", (i > 0) ? " OR " : "", db_search_fields[i], value);
+  sqlite3_str_appendchar(cond, 1, ')');
+}
+
+// Finishes a sqlite3_str into a string the caller must free()
+static char *
+db_search_str_finish(sqlite3_str *str)
+{
+  char *tmp;
+  char *ret;
+
+  if (sqlite3_str_errcode(str) != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Out of memory for search query\n");
+      sqlite3_free(sqlite3_str_finish(str));
+      return NULL;
+    }
+
+  tmp = sqlite3_str_finish(str);
+  if (!tmp)
+    return NULL; // Nothing was appended
+
+  ret = strdup(tmp);
+  sqlite3_free(tmp);
+
+  return ret;
+}
+
+// The trigram tokenizer can't match anything shorter than three characters.
+// Values with LIKE wildcards are also left to LIKE, since the index would only
+// find them literally. Without the index everything is left to LIKE.
+static bool
+db_search_is_indexable(const char *value)
+{
+  return (db_search_fts && !strpbrk(value, "%_") && u8_mbsnlen((const uint8_t *)value, strlen(value)) >= 3);
+}
+
+char *
+db_search_prefilter(const char *field, const char *value)
+{
+  sqlite3_str *match;
+  const char *col;
+  char *match_str;
+  char *ret;
+
+  col = field ? db_search_field(field) : NULL;
+  if ((field && !col) || !db_search_is_indexable(value))
+    return NULL;
+
+  match = sqlite3_str_new(NULL);
+  if (col)
+    sqlite3_str_appendf(match, "%s : ", col);
+  db_search_phrase_append(match, value, strlen(value));
+
+  match_str = db_search_str_finish(match);
+  if (!match_str)
+    return NULL;
+
+  ret = db_mprintf("f.id IN (SELECT rowid FROM files_fts WHERE files_fts MATCH '%q')", match_str);
+  free(match_str);
+
+  return ret;
+}
+
+// Length in bytes of the UTF-8 character at s, invalid bytes count as one
+static int
+db_search_charlen(const uint8_t *s, size_t n)
+{
+  int len;
+
+  len = u8_mblen(s, n);
+
+  return (len > 0) ? len : 1;
+}
+
+static char *
+db_search_filter_fuzzy(const char *col, const char *value)
+{
+  sqlite3_str *match;
+  const uint8_t *word;
+  const uint8_t *end;
+  const uint8_t *p;
+  char *match_str;
+  char *ret;
+  int len;
+  int n;
+  int i;
+
+  match = sqlite3_str_new(NULL);
+  if (col)
+    sqlite3_str_appendf(match, "%s : (", col);
+  else
+    sqlite3_str_appendchar(match, 1, '(');
+
+  // OR together every trigram of every word, so that bm25 will rank the items
+  // sharing most trigrams with the search string first
+  n = 0;
+  end = (const uint8_t *)value + strlen(value);
+  for (word = (const uint8_t *)value; word < end; word = p)
+    {
+      for (p = word; p < end && *p != ' ' && *p != '\t'; p++)
+	;
+
+      while (word < p && u8_mbsnlen(word, p - word) >= 3)
+	{
+	  for (i = 0, len = 0; i < 3; i++)
+	    len += db_search_charlen(word + len, p - word - len);
+
+	  if (n > 0)
+	    sqlite3_str_appendall(match, " OR ");
+	  db_search_phrase_append(match, (const char *)word, len);
+	  n++;
+
+	  word += db_search_charlen(word, p - word);
+	}
+
+      for (; p < end && (*p == ' ' || *p == '\t'); p++)
+	;
+    }
+
+  sqlite3_str_appendchar(match, 1, ')');
+
+  match_str = db_search_str_finish(match);
+  if (!match_str || n == 0)
+    {
+      free(match_str);
+      return NULL;
+    }
+
+  ret = db_mprintf("(f.id IN (SELECT rowid FROM files_fts WHERE files_fts MATCH '%q' ORDER BY rank LIMIT %d))", match_str, DB_SEARCH_FUZZY_LIMIT);
+  free(match_str);
+
+  return ret;
+}
+
+char *
+db_search_filter(const char *field, const char *value, enum db_search_type type)
+{
+  sqlite3_str *match;
+  sqlite3_str *cond;
+  const char *col;
+  const char *delim;
+  char *copy;
+  char *word;
+  char *ptr;
+  char *match_str;
+  char *cond_str;
+  char *ret;
+  int nwords;
+
+  col = field ? db_search_field(field) : NULL;
+  if (field && !col)
+    {
+      if (type == DB_SEARCH_FUZZY)
+	return NULL;
+
+      // Not in the full text index, so do it the slow way
+      return db_mprintf("(%s LIKE '%%%q%%')", field, value);
+    }
+
+  if (type == DB_SEARCH_FUZZY)
+    return db_search_fts ? db_search_filter_fuzzy(col, value) : NULL;
+
+  CHECK_NULL(L_DB, copy = strdup(value));
+
+  match = sqlite3_str_new(NULL);
+  cond = sqlite3_str_new(NULL);
+
+  // The LIKE conditions keep the result exactly as it would be without the
+  // index, which just narrows down the items to check. Words shorter than
+  // three characters are only checked with LIKE.
+  delim = (type == DB_SEARCH_WORDS) ? " \t" : "";
+  nwords = 0;
+  for (word = strtok_r(copy, delim, &ptr); word; word = strtok_r(NULL, delim, &ptr))
+    {
+      if (nwords > 0)
+	sqlite3_str_appendall(cond, " AND ");
+      db_search_like_append(cond, col, word);
+      nwords++;
+
+      if (!db_search_is_indexable(word))
+	continue;
+
+      if (sqlite3_str_length(match) == 0)
+	sqlite3_str_appendf(match, "%s%s(", col ? col : "", col ? " : " : "");
+      else
+	sqlite3_str_appendall(match, " AND ");
+      db_search_phrase_append(match, word, strlen(word));
+    }
+
+  // Search string was empty or just whitespace
+  if (nwords == 0)
+    db_search_like_append(cond, col, value);
+
+  if (sqlite3_str_length(match) > 0)
+    sqlite3_str_appendchar(match, 1, ')');
+
+  free(copy);
+
+  match_str = db_search_str_finish(match);
+  cond_str = db_search_str_finish(cond);
+  if (!cond_str)
+    {
+      free(match_str);
+      return NULL;
+    }
+
+  if (match_str)
+    ret = db_mprintf("(f.id IN (SELECT rowid FROM files_fts WHERE files_fts MATCH '%q') AND %s)", match_str, cond_str);
+  else
+    ret = db_mprintf("(%s)", cond_str);
+
+  free(match_str);
+  free(cond_str);
+
+  return ret;
+}
+
+char *
+db_search_order(const char *field, const char *value, enum sort_type sort)
+{
+  const char *col;
+
+  col = field ? db_search_field(field) : NULL;
+  if (!col)
+    col = "title";
+
+  // Exact matches first, then matches at the start, then the rest
+  return db_mprintf("CASE WHEN f.%s LIKE '%q' THEN 0 WHEN f.%s LIKE '%q%%' THEN 1 ELSE 2 END%s%s",
+		    col, value, col, value, (sort != S_NONE) ? ", " : "", sort_clause[sort]);
+}
+
 void
 free_pi(struct pairing_info *pi, int content_only)
 {
@@ -1268,6 +1571,70 @@ db_blocking_prepare_v2(const char *query, int len, sqlite3_stmt **stmt, const ch
   return ret;
 }
 
+/* Gets a prepared statement for query from the thread's statement cache, or
+ * prepares a new one. Library queries only differ by their bound :limit,
+ * :offset, :id and :persistentid (see db_query_bind()), so the same few
+ * statements are used over and over by clients. */
+static int
+db_stmt_cache_get(sqlite3_stmt **stmt, const char *query)
+{
+  int i;
+
+  for (i = 0; i < db_stmt_cache_n; i++)
+    {
+      if (strcmp(sqlite3_sql(db_stmt_cache[i]), query) != 0)
+	continue;
+
+      *stmt = db_stmt_cache[i];
+
+      db_stmt_cache_n--;
+      memmove(&db_stmt_cache[i], &db_stmt_cache[i + 1], (db_stmt_cache_n - i) * sizeof(sqlite3_stmt *));
+
+      __atomic_add_fetch(&db_stmt_cache_hits, 1, __ATOMIC_RELAXED);
+      return SQLITE_OK;
+    }
+
+  __atomic_add_fetch(&db_stmt_cache_misses, 1, __ATOMIC_RELAXED);
+
+  return db_blocking_prepare_v2(query, -1, stmt, NULL);
+}
+
+static void
+db_stmt_cache_put(sqlite3_stmt *stmt)
+{
+  int i;
+
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  // Nested queries of the same kind will each have had their own statement
+  for (i = 0; i < db_stmt_cache_n; i++)
+    {
+      if (strcmp(sqlite3_sql(db_stmt_cache[i]), sqlite3_sql(stmt)) == 0)
+	{
+	  sqlite3_finalize(stmt);
+	  return;
+	}
+    }
+
+  if (db_stmt_cache_n == DB_STMT_CACHE_SIZE)
+    {
+      db_stmt_cache_n--;
+      sqlite3_finalize(db_stmt_cache[db_stmt_cache_n]);
+    }
+
+  memmove(&db_stmt_cache[1], &db_stmt_cache[0], db_stmt_cache_n * sizeof(sqlite3_stmt *));
+  db_stmt_cache[0] = stmt;
+  db_stmt_cache_n++;
+}
+
+void
+db_stmt_cache_stats_get(struct db_stmt_cache_stats *stats)
+{
+  stats->hits = __atomic_load_n(&db_stmt_cache_hits, __ATOMIC_RELAXED);
+  stats->misses = __atomic_load_n(&db_stmt_cache_misses, __ATOMIC_RELAXED);
+}
+
 static int
 db_statement_run(sqlite3_stmt *stmt)
 {
@@ -1655,6 +2022,7 @@ db_free_query_clause(struct query_clause *qc)
   sqlite3_free(qc->having);
   sqlite3_free(qc->order);
   sqlite3_free(qc->index);
+  sqlite3_free(qc->count);
   free(qc);
 }
 
@@ -1700,18 +2068,15 @@ db_build_query_clause(struct query_params *qp)
   switch (qp->idx_type)
     {
       case I_FIRST:
-	qc->index = sqlite3_mprintf("LIMIT %d", qp->limit);
+	qc->index = sqlite3_mprintf("LIMIT :limit");
 	break;
 
       case I_LAST:
-	qc->index = sqlite3_mprintf("LIMIT -1 OFFSET %d", qp->results - qp->limit);
-	break;
-
       case I_SUB:
-	if (qp->limit)
-	  qc->index = sqlite3_mprintf("LIMIT %d OFFSET %d", qp->limit, qp->offset);
+	if (qp->idx_type == I_SUB && qp->limit)
+	  qc->index = sqlite3_mprintf("LIMIT :limit OFFSET :offset");
 	else
-	  qc->index = sqlite3_mprintf("LIMIT -1 OFFSET %d", qp->offset);
+	  qc->index = sqlite3_mprintf("LIMIT -1 OFFSET :offset");
 	break;
 
       case I_NONE:
@@ -1730,6 +2095,63 @@ db_build_query_clause(struct query_params *qp)
   return NULL;
 }
 
+static void
+db_query_bind(struct query_params *qp, sqlite3_stmt *stmt)
+{
+  int offset;
+  int idx;
+
+  // For I_LAST the count must be known, so it doesn't count with OVER()
+  offset = (qp->idx_type == I_LAST) ? qp->results - qp->limit : qp->offset;
+
+  idx = sqlite3_bind_parameter_index(stmt, ":limit");
+  if (idx > 0)
+    sqlite3_bind_int(stmt, idx, qp->limit);
+
+  idx = sqlite3_bind_parameter_index(stmt, ":offset");
+  if (idx > 0)
+    sqlite3_bind_int(stmt, idx, offset);
+
+  idx = sqlite3_bind_parameter_index(stmt, ":id");
+  if (idx > 0)
+    sqlite3_bind_int(stmt, idx, qp->id);
+
+  idx = sqlite3_bind_parameter_index(stmt, ":persistentid");
+  if (idx > 0)
+    sqlite3_bind_int64(stmt, idx, qp->persistentid);
+}
+
+static int
+db_query_count(struct query_params *qp, const char *count)
+{
+  sqlite3_stmt *stmt;
+  int ret;
+
+  DPRINTF(E_DBG, L_DB, "Running query '%s'\n", count);
+
+  ret = db_stmt_cache_get(&stmt, count);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
+      return -1;
+    }
+
+  db_query_bind(qp, stmt);
+
+  ret = db_blocking_step(stmt);
+  if (ret == SQLITE_ROW)
+    ret = sqlite3_column_int(stmt, 0);
+  else
+    {
+      DPRINTF(E_LOG, L_DB, "Could not step: %s (%s)\n", sqlite3_errmsg(hdl), count);
+      ret = -1;
+    }
+
+  db_stmt_cache_put(stmt);
+
+  return ret;
+}
+
 static char *
 db_build_query_check(struct query_params *qp, char *count, char *query)
 {
@@ -1739,7 +2161,7 @@ db_build_query_check(struct query_params *qp, char *count, char *query)
       goto failed;
     }
 
-  qp->results = db_get_one_int(count);
+  qp->results = db_query_count(qp, count);
   if (qp->results < 0)
     {
       DPRINTF(E_LOG, L_DB, "No results for count\n");
@@ -1756,6 +2178,43 @@ db_build_query_check(struct query_params *qp, char *count, char *query)
   return NULL;
 }
 
+/* A COUNT(*) OVER() column makes SQLite produce the whole result before the
+ * first row, so it is only used when the query is limited to a page. Other
+ * queries stream their rows and are counted with the count query. For I_LAST
+ * the count must be known before the query is bound. */
+static const char *
+db_query_count_over(struct query_params *qp)
+{
+  if (qp->idx_type == I_FIRST || (qp->idx_type == I_SUB && qp->limit))
+    return ", COUNT(*) OVER()";
+
+  return "";
+}
+
+/* Like db_build_query_check(), except the results of a paged query are counted
+ * by the query itself with the db_query_count_over() column, which
+ * db_query_start() reads from the first row. That saves running the count
+ * query, which is only kept for when the page has no rows to tell the count,
+ * i.e. a page past the end. */
+static char *
+db_build_query_window(struct query_params *qp, struct query_clause *qc, char *count, char *query)
+{
+  if (!count || !query)
+    {
+      DPRINTF(E_LOG, L_DB, "Out of memory for query string\n");
+      sqlite3_free(count);
+      sqlite3_free(query);
+      return NULL;
+    }
+
+  if (!*db_query_count_over(qp))
+    return db_build_query_check(qp, count, query);
+
+  qc->count = count;
+
+  return query;
+}
+
 static char *
 db_build_query_items(struct query_params *qp, struct query_clause *qc)
 {
@@ -1763,9 +2222,17 @@ db_build_query_items(struct query_params *qp, struct query_clause *qc)
   char *query;
 
   count = sqlite3_mprintf("SELECT COUNT(*) FROM files f %s;", qc->where);
-  query = sqlite3_mprintf("SELECT f.* FROM files f %s %s %s %s;", qc->where, qc->group, qc->order, qc->index);
 
-  return db_build_query_check(qp, count, query);
+  // The count query doesn't group, so a grouped query can't count with OVER()
+  if (qp->group)
+    {
+      query = sqlite3_mprintf("SELECT f.* FROM files f %s %s %s %s;", qc->where, qc->group, qc->order, qc->index);
+      return db_build_query_check(qp, count, query);
+    }
+
+  query = sqlite3_mprintf("SELECT f.*%s FROM files f %s %s %s;", db_query_count_over(qp), qc->where, qc->order, qc->index);
+
+  return db_build_query_window(qp, qc, count, query);
 }
 
 static char *
@@ -1802,14 +2269,14 @@ db_build_query_plitems_plain(struct query_params *qp, struct query_clause *qc)
   char *count;
   char *query;
 
-  count = sqlite3_mprintf("SELECT COUNT(*) FROM files f JOIN playlistitems pi ON f.path = pi.filepath %s AND pi.playlistid = %d;", qc->where, qp->id);
-  query = sqlite3_mprintf("SELECT f.* FROM files f JOIN playlistitems pi ON f.path = pi.filepath %s AND pi.playlistid = %d ORDER BY pi.id ASC %s;", qc->where, qp->id, qc->index);
+  count = sqlite3_mprintf("SELECT COUNT(*) FROM files f JOIN playlistitems pi ON f.path = pi.filepath %s AND pi.playlistid = :id;", qc->where);
+  query = sqlite3_mprintf("SELECT f.*%s FROM files f JOIN playlistitems pi ON f.path = pi.filepath %s AND pi.playlistid = :id ORDER BY pi.id ASC %s;", db_query_count_over(qp), qc->where, qc->index);
 
-  return db_build_query_check(qp, count, query);
+  return db_build_query_window(qp, qc, count, query);
 }
 
 static char *
-db_build_query_plitems_smart(struct query_params *qp, struct playlist_info *pli)
+db_build_query_plitems_smart(struct query_params *qp, struct query_clause *qc_outer, struct playlist_info *pli)
 {
   struct query_clause *qc;
   char *count;
@@ -1855,12 +2322,12 @@ db_build_query_plitems_smart(struct query_params *qp, struct playlist_info *pli)
   if (!qc)
     return NULL;
 
-  count = sqlite3_mprintf("SELECT COUNT(*) FROM files f %s AND %s LIMIT %d;", qc->where, pli->query, pli->query_limit);
-  query = sqlite3_mprintf("SELECT f.* FROM files f %s AND %s %s %s;", qc->where, pli->query, qc->order, qc->index);
+  count = sqlite3_mprintf("SELECT COUNT(*) FROM files f %s AND %s;", qc->where, pli->query);
+  query = sqlite3_mprintf("SELECT f.*%s FROM files f %s AND %s %s %s;", db_query_count_over(qp), qc->where, pli->query, qc->order, qc->index);
 
   db_free_query_clause(qc);
 
-  return db_build_query_check(qp, count, query);
+  return db_build_query_window(qp, qc_outer, count, query);
 }
 
 static char *
@@ -1883,7 +2350,7 @@ db_build_query_plitems(struct query_params *qp, struct query_clause *qc)
     {
       case PL_SPECIAL:
       case PL_SMART:
-	query = db_build_query_plitems_smart(qp, pli);
+	query = db_build_query_plitems_smart(qp, qc, pli);
 	break;
 
       case PL_RSS:
@@ -1952,13 +2419,13 @@ db_build_query_group_items(struct query_params *qp, struct query_clause *qc)
   switch (gt)
     {
       case G_ALBUMS:
-	count = sqlite3_mprintf("SELECT COUNT(*) FROM files f %s AND f.songalbumid = %" PRIi64 ";", qc->where, qp->persistentid);
-	query = sqlite3_mprintf("SELECT f.* FROM files f %s AND f.songalbumid = %" PRIi64 " %s %s;", qc->where, qp->persistentid, qc->order, qc->index);
+	count = sqlite3_mprintf("SELECT COUNT(*) FROM files f %s AND f.songalbumid = :persistentid;", qc->where);
+	query = sqlite3_mprintf("SELECT f.*%s FROM files f %s AND f.songalbumid = :persistentid %s %s;", db_query_count_over(qp), qc->where, qc->order, qc->index);
 	break;
 
       case G_ARTISTS:
-	count = sqlite3_mprintf("SELECT COUNT(*) FROM files f %s AND f.songartistid = %" PRIi64 ";", qc->where, qp->persistentid);
-	query = sqlite3_mprintf("SELECT f.* FROM files f %s AND f.songartistid = %" PRIi64 " %s %s;", qc->where, qp->persistentid, qc->order, qc->index);
+	count = sqlite3_mprintf("SELECT COUNT(*) FROM files f %s AND f.songartistid = :persistentid;", qc->where);
+	query = sqlite3_mprintf("SELECT f.*%s FROM files f %s AND f.songartistid = :persistentid %s %s;", db_query_count_over(qp), qc->where, qc->order, qc->index);
 	break;
 
       default:
@@ -1966,7 +2433,7 @@ db_build_query_group_items(struct query_params *qp, struct query_clause *qc)
 	return NULL;
     }
 
-  return db_build_query_check(qp, count, query);
+  return db_build_query_window(qp, qc, count, query);
 }
 
 static char *
@@ -1982,16 +2449,16 @@ db_build_query_group_dirs(struct query_params *qp, struct query_clause *qc)
     {
       case G_ALBUMS:
 	count = sqlite3_mprintf("SELECT COUNT(DISTINCT(SUBSTR(f.path, 1, LENGTH(f.path) - LENGTH(f.fname) - 1)))"
-				" FROM files f %s AND f.songalbumid = %" PRIi64 ";", qc->where, qp->persistentid);
+				" FROM files f %s AND f.songalbumid = :persistentid;", qc->where);
 	query = sqlite3_mprintf("SELECT DISTINCT(SUBSTR(f.path, 1, LENGTH(f.path) - LENGTH(f.fname) - 1))"
-				" FROM files f %s AND f.songalbumid = %" PRIi64 " %s %s;", qc->where, qp->persistentid, qc->order, qc->index);
+				" FROM files f %s AND f.songalbumid = :persistentid %s %s;", qc->where, qc->order, qc->index);
 	break;
 
       case G_ARTISTS:
 	count = sqlite3_mprintf("SELECT COUNT(DISTINCT(SUBSTR(f.path, 1, LENGTH(f.path) - LENGTH(f.fname) - 1)))"
-				" FROM files f %s AND f.songartistid = %" PRIi64 ";", qc->where, qp->persistentid);
+				" FROM files f %s AND f.songartistid = :persistentid;", qc->where);
 	query = sqlite3_mprintf("SELECT DISTINCT(SUBSTR(f.path, 1, LENGTH(f.path) - LENGTH(f.fname) - 1))"
-				" FROM files f %s AND f.songartistid = %" PRIi64 " %s %s;", qc->where, qp->persistentid, qc->order, qc->index);
+				" FROM files f %s AND f.songartistid = :persistentid %s %s;", qc->where, qc->order, qc->index);
 	break;
 
       default:
@@ -2014,9 +2481,9 @@ db_build_query_browse(struct query_params *qp, struct query_clause *qc)
   where  = browse_clause[qp->type & ~Q_F_BROWSE].where;
 
   count = sqlite3_mprintf("SELECT COUNT(*) FROM (SELECT %s FROM files f %s AND %s != '' %s);", select, qc->where, where, qc->group);
-  query = sqlite3_mprintf("SELECT %s FROM files f %s AND %s != '' %s %s %s;", select, qc->where, where, qc->group, qc->order, qc->index);
+  query = sqlite3_mprintf("SELECT %s%s FROM files f %s AND %s != '' %s %s %s;", select, db_query_count_over(qp), qc->where, where, qc->group, qc->order, qc->index);
 
-  return db_build_query_check(qp, count, query);
+  return db_build_query_window(qp, qc, count, query);
 }
 
 static char *
@@ -2043,6 +2510,7 @@ db_query_start(struct query_params *qp)
 
   qp->stmt = NULL;
   qp->results = -1;
+  qp->step_result = 0;
 
   qc = db_build_query_clause(qp);
   if (!qc)
@@ -2093,27 +2561,54 @@ db_query_start(struct query_params *qp)
 	  query = NULL;
     }
 
-  db_free_query_clause(qc);
-
   if (!query)
     {
       DPRINTF(E_LOG, L_DB, "Could not create query, unknown type %d\n", qp->type);
+      db_free_query_clause(qc);
       return -1;
     }
 
   DPRINTF(E_DBG, L_DB, "Starting query '%s'\n", query);
 
-  ret = db_blocking_prepare_v2(query, -1, &stmt, NULL);
+  ret = db_stmt_cache_get(&stmt, query);
   if (ret != SQLITE_OK)
     {
       DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
 
       sqlite3_free(query);
+      db_free_query_clause(qc);
       return -1;
     }
 
   sqlite3_free(query);
 
+  db_query_bind(qp, stmt);
+
+  // Get the count from the db_query_count_over() column of the first row
+  if (qc->count)
+    {
+      ret = db_blocking_step(stmt);
+      if (ret == SQLITE_ROW)
+	qp->results = sqlite3_column_int(stmt, sqlite3_column_count(stmt) - 1);
+      else if (ret == SQLITE_DONE && (qp->idx_type != I_SUB || qp->offset == 0))
+	qp->results = 0;
+      else if (ret == SQLITE_DONE)
+	qp->results = db_query_count(qp, qc->count);
+
+      if ((ret != SQLITE_ROW && ret != SQLITE_DONE) || qp->results < 0)
+	{
+	  DPRINTF(E_LOG, L_DB, "Could not step: %s\n", sqlite3_errmsg(hdl));
+
+	  db_stmt_cache_put(stmt);
+	  db_free_query_clause(qc);
+	  return -1;
+	}
+
+      qp->step_result = ret;
+    }
+
+  db_free_query_clause(qc);
+
   qp->stmt = stmt;
 
   return 0;
@@ -2125,10 +2620,26 @@ db_query_end(struct query_params *qp)
   if (!qp->stmt)
     return;
 
-  sqlite3_finalize(qp->stmt);
+  db_stmt_cache_put(qp->stmt);
   qp->stmt = NULL;
 }
 
+// Steps to the next row, unless db_query_start() already did
+static int
+db_query_step(struct query_params *qp)
+{
+  int ret;
+
+  if (qp->step_result)
+    {
+      ret = qp->step_result;
+      qp->step_result = 0;
+      return ret;
+    }
+
+  return db_blocking_step(qp->stmt);
+}
+
 /*
  * Utility function for running write queries (INSERT, UPDATE, DELETE). If you
  * set free to non-zero, the function will free the query. If you set
@@ -2179,6 +2690,7 @@ db_query_fetch_file(struct query_params *qp, struct db_media_file_info *dbmfi)
 {
   int ncols;
   char **strcol;
+  int64_t *intcol;
   int i;
   int ret;
 
@@ -2196,11 +2708,11 @@ db_query_fetch_file(struct query_params *qp, struct db_media_file_info *dbmfi)
       return -1;
     }
 
-  ret = db_blocking_step(qp->stmt);
+  ret = db_query_step(qp);
   if (ret == SQLITE_DONE)
     {
       DPRINTF(E_DBG, L_DB, "End of query results\n");
-      dbmfi->id = NULL;
+      dbmfi->id = 0;
       return 0;
     }
   else if (ret != SQLITE_ROW)
@@ -2218,16 +2730,53 @@ db_query_fetch_file(struct query_params *qp, struct db_media_file_info *dbmfi)
       return -1;
     }
 
+  // The column types are the same as in mfi_cols_map (sync checked by db_init)
+  dbmfi->null_cols = 0;
   for (i = 0; i < ARRAY_SIZE(dbmfi_cols_map); i++)
     {
-      strcol = (char **) ((char *)dbmfi + dbmfi_cols_map[i]);
-
-      *strcol = (char *)sqlite3_column_text(qp->stmt, i);
+      if (mfi_cols_map[i].type == DB_TYPE_STRING)
+	{
+	  strcol = (char **) ((char *)dbmfi + dbmfi_cols_map[i]);
+	  *strcol = (char *)sqlite3_column_text(qp->stmt, i);
+	}
+      else
+	{
+	  intcol = (int64_t *) ((char *)dbmfi + dbmfi_cols_map[i]);
+	  *intcol = sqlite3_column_int64(qp->stmt, i);
+	  if (*intcol == 0 && sqlite3_column_type(qp->stmt, i) == SQLITE_NULL)
+	    dbmfi->null_cols |= (uint64_t)1 << i;
+	}
     }
 
   return 0;
 }
 
+bool
+dbmfi_col_is_int(size_t offset)
+{
+  int i;
+
+  i = (offset < sizeof(dbmfi_col_index)) ? dbmfi_col_index[offset] : -1;
+
+  return (i >= 0) && (mfi_cols_map[i].type != DB_TYPE_STRING);
+}
+
+// Like before integers were fetched as text, where a NULL column was a NULL string
+bool
+dbmfi_col_is_null(struct db_media_file_info *dbmfi, size_t offset)
+{
+  int i;
+
+  i = (offset < sizeof(dbmfi_col_index)) ? dbmfi_col_index[offset] : -1;
+  if (i < 0)
+    return false;
+
+  if (mfi_cols_map[i].type == DB_TYPE_STRING)
+    return !(*(char **) ((char *)dbmfi + offset));
+
+  return (dbmfi->null_cols & ((uint64_t)1 << i));
+}
+
 int
 db_query_fetch_pl(struct query_params *qp, struct db_playlist_info *dbpli)
 {
@@ -2253,7 +2802,7 @@ db_query_fetch_pl(struct query_params *qp, struct db_playlist_info *dbpli)
       return -1;
     }
 
-  ret = db_blocking_step(qp->stmt);
+  ret = db_query_step(qp);
   if (ret == SQLITE_DONE)
     {
       DPRINTF(E_DBG, L_DB, "End of query results\n");
@@ -2317,7 +2866,7 @@ db_query_fetch_group(struct query_params *qp, struct db_group_info *dbgri)
       return -1;
     }
 
-  ret = db_blocking_step(qp->stmt);
+  ret = db_query_step(qp);
   if (ret == SQLITE_DONE)
     {
       DPRINTF(E_DBG, L_DB, "End of query results\n");
@@ -2367,7 +2916,7 @@ db_query_fetch_count(struct query_params *qp, struct filecount_info *fci)
       return -1;
     }
 
-  ret = db_blocking_step(qp->stmt);
+  ret = db_query_step(qp);
   if (ret == SQLITE_DONE)
     {
       DPRINTF(E_DBG, L_DB, "End of query results for count query\n");
@@ -2425,7 +2974,7 @@ db_query_fetch_string(struct query_params *qp, char **string)
       return -1;
     }
 
-  ret = db_blocking_step(qp->stmt);
+  ret = db_query_step(qp);
   if (ret == SQLITE_DONE)
     {
       DPRINTF(E_DBG, L_DB, "End of query results\n");
@@ -2462,7 +3011,7 @@ db_query_fetch_string_sort(struct query_params *qp, char **string, char **sortst
       return -1;
     }
 
-  ret = db_blocking_step(qp->stmt);
+  ret = db_query_step(qp);
   if (ret == SQLITE_DONE)
     {
       DPRINTF(E_DBG, L_DB, "End of query results\n");
@@ -2697,6 +3246,165 @@ db_file_ping_bypath(const char *path, time_t mtime_max)
   return db_statement_run(db_statements.files_ping);
 }
 
+/*
+ * Sets the timestamp of the given files to now, like db_file_ping() does for a
+ * single file, but with one statement per batch of ids. Used by bulk scans to
+ * mark unchanged files as seen.
+ */
+int
+db_file_ping_byids(const uint32_t *ids, int nids)
+{
+#define Q_TMPL "UPDATE files SET db_timestamp = %" PRIi64 ", disabled = 0 WHERE id IN ("
+#define DB_PING_BATCH_SIZE 500
+  sqlite3_str *str;
+  char *query;
+  int64_t now;
+  int i;
+  int ret;
+
+  now = (int64_t)time(NULL);
+
+  for (ret = 0; nids > 0 && ret == 0; ids += i, nids -= i)
+    {
+      str = sqlite3_str_new(hdl);
+      sqlite3_str_appendf(str, Q_TMPL, now);
+
+      for (i = 0; i < nids && i < DB_PING_BATCH_SIZE; i++)
+	sqlite3_str_appendf(str, (i > 0) ? ",%" PRIu32 : "%" PRIu32, ids[i]);
+
+      sqlite3_str_appendall(str, ");");
+
+      query = sqlite3_str_finish(str);
+      if (!query)
+	{
+	  DPRINTF(E_LOG, L_DB, "Out of memory for query string\n");
+	  return -1;
+	}
+
+      ret = db_query_run(query, 1, 0);
+    }
+
+  return ret;
+#undef DB_PING_BATCH_SIZE
+#undef Q_TMPL
+}
+
+/*
+ * Sets the timestamp of all files in the given directory (not recursive) to now.
+ * Used by bulk scans for directories that have not changed since the last scan.
+ */
+void
+db_file_ping_bydirectory(int dir_id)
+{
+#define Q_TMPL "UPDATE files SET db_timestamp = %" PRIi64 ", disabled = 0 WHERE directory_id = %d;"
+  char *query;
+
+  query = sqlite3_mprintf(Q_TMPL, (int64_t)time(NULL), dir_id);
+
+  db_query_run(query, 1, 0);
+#undef Q_TMPL
+}
+
+static int
+file_stamp_cmp(const void *a, const void *b)
+{
+  return strcmp(((const struct db_file_stamp *)a)->path, ((const struct db_file_stamp *)b)->path);
+}
+
+/*
+ * Gets id, path and db_timestamp of the files in the given directory, so a bulk
+ * scan can check which files are unchanged without a query per file. The
+ * result is sorted by path, see db_file_stamp_find().
+ *
+ * @out stamps  Array of file stamps, must be freed with db_file_stamps_free()
+ * @out nstamps Number of elements in stamps
+ * @in  dir_id  Directory id
+ * @return      0 on success, -1 on error
+ */
+int
+db_file_stamps_bydirectory(struct db_file_stamp **stamps, int *nstamps, int dir_id)
+{
+#define Q_TMPL "SELECT id, path, db_timestamp FROM files WHERE directory_id = ?;"
+  struct db_file_stamp *s;
+  sqlite3_stmt *stmt;
+  int size;
+  int n;
+  int ret;
+
+  *stamps = NULL;
+  *nstamps = 0;
+
+  ret = db_stmt_cache_get(&stmt, Q_TMPL);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
+      return -1;
+    }
+
+  sqlite3_bind_int(stmt, 1, dir_id);
+
+  s = NULL;
+  size = 0;
+  n = 0;
+  while ((ret = db_blocking_step(stmt)) == SQLITE_ROW)
+    {
+      if (n == size)
+	{
+	  size = size ? 2 * size : 64;
+	  CHECK_NULL(L_DB, s = realloc(s, size * sizeof(struct db_file_stamp)));
+	}
+
+      s[n].id = sqlite3_column_int(stmt, 0);
+      s[n].path = safe_strdup((char *)sqlite3_column_text(stmt, 1));
+      s[n].db_timestamp = sqlite3_column_int64(stmt, 2);
+      if (s[n].path)
+	n++;
+    }
+
+  db_stmt_cache_put(stmt);
+
+  if (ret != SQLITE_DONE)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not step: %s\n", sqlite3_errmsg(hdl));
+      db_file_stamps_free(s, n);
+      return -1;
+    }
+
+  // Sorted here, so the order matches strcmp() in db_file_stamp_find()
+  if (n > 1)
+    qsort(s, n, sizeof(struct db_file_stamp), file_stamp_cmp);
+
+  *stamps = s;
+  *nstamps = n;
+
+  return 0;
+#undef Q_TMPL
+}
+
+struct db_file_stamp *
+db_file_stamp_find(struct db_file_stamp *stamps, int nstamps, const char *path)
+{
+  struct db_file_stamp key;
+
+  if (!stamps)
+    return NULL;
+
+  key.path = (char *)path;
+
+  return bsearch(&key, stamps, nstamps, sizeof(struct db_file_stamp), file_stamp_cmp);
+}
+
+void
+db_file_stamps_free(struct db_file_stamp *stamps, int nstamps)
+{
+  int i;
+
+  for (i = 0; i < nstamps; i++)
+    free(stamps[i].path);
+
+  free(stamps);
+}
+
 void
 db_file_ping_bymatch(const char *path, int isdir)
 {
@@ -3153,9 +3861,11 @@ db_file_seek_update(int id, uint32_t seek)
 #undef Q_TMPL
 }
 
+// The id is given to the listeners, 0 if not known
 static int
-db_file_rating_update(char *query)
+db_file_rating_update(char *query, uint32_t id)
 {
+  struct listener_event_data data = { 0 };
   int ret;
 
   ret = db_query_run(query, 1, 0);
@@ -3163,7 +3873,11 @@ db_file_rating_update(char *query)
   if (ret == 0)
     {
       db_admin_setint64(DB_ADMIN_DB_MODIFIED, (int64_t) time(NULL));
-      listener_notify(LISTENER_RATING);
+
+      data.ids_all = (id == 0);
+      data.nids = (id != 0);
+      data.ids[0] = id;
+      listener_notify_data(LISTENER_RATING, &data);
     }
 
   return ((ret < 0) ? -1 : sqlite3_changes(hdl));
@@ -3177,7 +3891,7 @@ db_file_rating_update_byid(uint32_t id, uint32_t rating)
 
   query = sqlite3_mprintf(Q_TMPL, rating, id);
 
-  return db_file_rating_update(query);
+  return db_file_rating_update(query, id);
 #undef Q_TMPL
 }
 
@@ -3189,7 +3903,7 @@ db_file_rating_update_byvirtualpath(const char *virtual_path, uint32_t rating)
 
   query = sqlite3_mprintf(Q_TMPL, rating, virtual_path);
 
-  return db_file_rating_update(query);
+  return db_file_rating_update(query, 0);
 #undef Q_TMPL
 }
 
@@ -3311,6 +4025,18 @@ db_pl_ping(int id)
 #undef Q_TMPL
 }
 
+void
+db_pl_ping_bydirectory(int dir_id)
+{
+#define Q_TMPL "UPDATE playlists SET db_timestamp = %" PRIi64 ", disabled = 0 WHERE directory_id = %d;"
+  char *query;
+
+  query = sqlite3_mprintf(Q_TMPL, (int64_t)time(NULL), dir_id);
+
+  db_query_run(query, 1, 0);
+#undef Q_TMPL
+}
+
 void
 db_pl_ping_bymatch(const char *path, int isdir)
 {
@@ -4004,7 +4730,7 @@ db_directory_enum_start(struct directory_enum *de)
 
   DPRINTF(E_DBG, L_DB, "Starting enum '%s'\n", query);
 
-  ret = db_blocking_prepare_v2(query, -1, &stmt, NULL);
+  ret = db_stmt_cache_get(&stmt, query);
   if (ret != SQLITE_OK)
     {
       DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
@@ -4193,6 +4919,49 @@ db_directory_addorupdate(char *virtual_path, char *path, int disabled, int paren
   return id;
 }
 
+/*
+ * The modification time of a directory as of the last bulk scan that walked it,
+ * 0 if unknown. Adding, removing or renaming entries changes it, but modifying
+ * a file in place does not.
+ */
+time_t
+db_directory_mtime_get(int id)
+{
+#define Q_TMPL "SELECT time_modified FROM directories WHERE id = ?;"
+  sqlite3_stmt *stmt;
+  time_t mtime;
+  int ret;
+
+  ret = db_stmt_cache_get(&stmt, Q_TMPL);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
+      return 0;
+    }
+
+  sqlite3_bind_int(stmt, 1, id);
+
+  ret = db_blocking_step(stmt);
+  mtime = (ret == SQLITE_ROW) ? (time_t)sqlite3_column_int64(stmt, 0) : 0;
+
+  db_stmt_cache_put(stmt);
+
+  return mtime;
+#undef Q_TMPL
+}
+
+void
+db_directory_mtime_set(int id, time_t mtime)
+{
+#define Q_TMPL "UPDATE directories SET time_modified = %" PRIi64 " WHERE id = %d;"
+  char *query;
+
+  query = sqlite3_mprintf(Q_TMPL, (int64_t)mtime, id);
+
+  db_query_run(query, 1, 0);
+#undef Q_TMPL
+}
+
 void
 db_directory_ping_bymatch(char *virtual_path)
 {
@@ -4642,134 +5411,1110 @@ db_speaker_get(struct output_device *device, uint64_t id)
 }
 
 
-/* Queue */
+/* In-memory queue order */
 
 /*
- * Start a new transaction for modifying the queue. Returns the new queue version for the following changes.
- * After finishing all queue modifications 'queue_transaction_end' needs to be called.
+ * The queue table holds the metadata of the queue items, but the order of the
+ * items (pos and shuffle_pos) is kept in memory. Each item is a node in two
+ * implicit treaps (one for each order), where a node's position is given by the
+ * size of the subtrees to its left. This makes looking up, inserting, removing
+ * and moving an item O(log n), instead of rewriting the pos of every following
+ * row. The positions are persisted to the queue table in a batch from the worker
+ * thread (write-behind).
+ *
+ * All access goes through queue_model.lck. It must be taken before starting a
+ * database transaction, never while one is open on a queue statement. Changes
+ * made inside a queue transaction are recorded in an undo log, so a rollback can
+ * restore the order without dropping changes that are not written yet. While
+ * there are such changes, queries on the queue table read the positions through
+ * the queue_pos() SQL function, which returns them from a snapshot of the model
+ * (see db_queue_enum_start).
  */
-static int
-queue_transaction_begin()
-{
-  int queue_version = 0;
 
-  db_transaction_begin();
+#define QUEUE_ORDER_POS 0
+#define QUEUE_ORDER_SHUFFLE 1
 
-  db_admin_getint(&queue_version, DB_ADMIN_QUEUE_VERSION);
-  queue_version++;
+// Seconds to wait before writing changed positions to the queue table
+#define QUEUE_FLUSH_DELAY 1
 
-  return queue_version;
-}
+struct queue_link
+{
+  struct queue_node *left;
+  struct queue_node *right;
+  struct queue_node *parent;
+  uint32_t size;
+};
 
-/*
- * If retval == 0, updates the version of the queue in the admin table, commits the transaction
- * and notifies listener of LISTENER_QUEUE about the changes.
- * If retval < 0, rollsback the transaction.
- *
- * This function must be called after modifying the queue.
- *
- * @param retval 'retval' == 0, if modifying the queue was successful or 'retval' < 0 if an error occurred
- * @param queue_version The new queue version, for the pending modifications
- */
-static void
-queue_transaction_end(int retval, int queue_version)
+struct queue_node
 {
-  int ret;
+  uint32_t id;
+  uint32_t prio;
 
-  if (retval != 0)
-    goto error;
+  struct queue_link link[2];
 
-  ret = db_admin_setint(DB_ADMIN_QUEUE_VERSION, queue_version);
-  if (ret < 0)
-    goto error;
+  // Position in each order as currently stored in the queue table
+  int db_pos[2];
+  // Scratch space for queue_tree_number()
+  int pos[2];
 
-  db_transaction_end();
-  listener_notify(LISTENER_QUEUE);
-  return;
+  struct queue_node *hash_next;
+};
 
- error:
-  db_transaction_rollback();
-}
+enum queue_undo_type
+{
+  QUEUE_UNDO_ADD,
+  QUEUE_UNDO_REMOVE,
+  QUEUE_UNDO_MOVE,
+  QUEUE_UNDO_SHUFFLE,
+};
 
-static int
-queue_reshuffle(uint32_t item_id, int queue_version);
+struct queue_undo
+{
+  enum queue_undo_type type;
+  struct queue_node *node;
+  // Positions of the node before the change
+  uint32_t pos[2];
+  int order;
+  // The shuffle order before a QUEUE_UNDO_SHUFFLE
+  struct queue_node **nodes;
+  uint32_t nnodes;
+};
 
-static int
-queue_add_file(struct db_media_file_info *dbmfi, int pos, int shuffle_pos, int queue_version)
+struct queue_model
 {
-#define Q_TMPL "INSERT INTO queue "							\
-		    "(id, file_id, song_length, data_kind, media_kind, "		\
-		    "pos, shuffle_pos, path, virtual_path, title, "			\
-		    "artist, composer, album_artist, album, genre, songalbumid, songartistid,"	\
-		    "time_modified, artist_sort, album_sort, album_artist_sort, year, "	\
-		    "type, bitrate, samplerate, channels, "				\
-		    "track, disc, queue_version)" 					\
-		"VALUES"                                           			\
-		    "(NULL, %s, %s, %s, %s, "						\
-		    "%d, %d, %Q, %Q, %Q, "						\
-		    "%Q, %Q, %Q, %Q, %Q, %s, %s,"					\
-		    "%s, %Q, %Q, %Q, %s, "						\
-		    "%Q, %s, %s, %s, "				                        \
-		    "%s, %s, %d);"
+  pthread_mutex_t lck;
+  // Serializes writing the positions, which happens without holding lck
+  pthread_mutex_t flush_lck;
+
+  bool loaded;
+  bool dirty;
+  bool flush_scheduled;
+  // Incremented with every change, lets a flush know if it wrote the latest order
+  uint32_t changes;
+
+  // Queue version of the last change to the order, written with the positions
+  int version;
+
+  // Undo log of the current queue transaction
+  bool undo_active;
+  bool undo_dirty;
+  int undo_version;
+  struct queue_undo *undo;
+  uint32_t undo_count;
+  uint32_t undo_size;
+
+  struct queue_node *root[2];
+
+  struct queue_node **hash;
+  uint32_t hash_size;
+  uint32_t count;
 
-  char *query;
-  int ret;
+  uint32_t prio_state;
+};
 
-  query = sqlite3_mprintf(Q_TMPL,
-			  dbmfi->id, dbmfi->song_length, dbmfi->data_kind, dbmfi->media_kind,
-			  pos, shuffle_pos, dbmfi->path, dbmfi->virtual_path, dbmfi->title,
-			  dbmfi->artist, dbmfi->composer, dbmfi->album_artist, dbmfi->album, dbmfi->genre, dbmfi->songalbumid, dbmfi->songartistid,
-			  dbmfi->time_modified, dbmfi->artist_sort, dbmfi->album_sort, dbmfi->album_artist_sort, dbmfi->year,
-			  dbmfi->type, dbmfi->bitrate, dbmfi->samplerate, dbmfi->channels,
-			  dbmfi->track, dbmfi->disc, queue_version);
-  ret = db_query_run(query, 1, 0);
+static struct queue_model queue_model;
 
-  return ret;
 
-#undef Q_TMPL
+static inline uint32_t
+queue_node_size(struct queue_node *node, int order)
+{
+  return node ? node->link[order].size : 0;
 }
 
-static int
-queue_add_item(struct db_queue_item *item, int pos, int shuffle_pos, int queue_version)
+static inline void
+queue_node_update(struct queue_node *node, int order)
 {
-#define Q_TMPL "INSERT INTO queue "							\
-		    "(id, file_id, song_length, data_kind, media_kind, "		\
-		    "pos, shuffle_pos, path, virtual_path, title, "			\
-		    "artist, composer, album_artist, album, genre, songalbumid, songartistid, "	\
-		    "time_modified, artist_sort, album_sort, album_artist_sort, year, "	\
-		    "type, bitrate, samplerate, channels, "				\
-		    "track, disc, artwork_url, queue_version)" 				\
-		"VALUES"                                           			\
-		    "(NULL, %d, %d, %d, %d, "						\
-		    "%d, %d, %Q, %Q, %Q, "						\
-		    "%Q, %Q, %Q, %Q, %Q, %" PRIi64 ", %" PRIi64 ","			\
-		    "%d, %Q, %Q, %Q, %d, "						\
-		    "%Q, %" PRIu32 ", %" PRIu32 ", %" PRIu32 ", "			\
-		    "%d, %d, %Q, %d);"
+  struct queue_link *link = &node->link[order];
 
-  char *query;
-  int ret;
+  link->size = 1 + queue_node_size(link->left, order) + queue_node_size(link->right, order);
+  if (link->left)
+    link->left->link[order].parent = node;
+  if (link->right)
+    link->right->link[order].parent = node;
+}
 
-  query = sqlite3_mprintf(Q_TMPL,
-			  item->file_id, item->song_length, item->data_kind, item->media_kind,
-			  pos, shuffle_pos, item->path, item->virtual_path, item->title,
-			  item->artist, item->composer, item->album_artist, item->album, item->genre, item->songalbumid, item->songartistid,
-			  item->time_modified, item->artist_sort, item->album_sort, item->album_artist_sort, item->year,
-                          item->type, item->bitrate, item->samplerate, item->channels,
-			  item->track, item->disc, item->artwork_url, queue_version);
-  ret = db_query_run(query, 1, 0);
+static struct queue_node *
+queue_tree_merge(struct queue_node *a, struct queue_node *b, int order)
+{
+  if (!a)
+    return b;
+  if (!b)
+    return a;
 
-  return ret;
+  if (a->prio > b->prio)
+    {
+      a->link[order].right = queue_tree_merge(a->link[order].right, b, order);
+      queue_node_update(a, order);
+      return a;
+    }
 
-#undef Q_TMPL
+  b->link[order].left = queue_tree_merge(a, b->link[order].left, order);
+  queue_node_update(b, order);
+  return b;
 }
 
-int
+// Splits the tree so that the first k nodes end up in a, the rest in b
+static void
+queue_tree_split(struct queue_node *node, uint32_t k, struct queue_node **a, struct queue_node **b, int order)
+{
+  uint32_t left_size;
+
+  if (!node)
+    {
+      *a = NULL;
+      *b = NULL;
+      return;
+    }
+
+  left_size = queue_node_size(node->link[order].left, order);
+  if (left_size < k)
+    {
+      queue_tree_split(node->link[order].right, k - left_size - 1, &node->link[order].right, b, order);
+      queue_node_update(node, order);
+      *a = node;
+    }
+  else
+    {
+      queue_tree_split(node->link[order].left, k, a, &node->link[order].left, order);
+      queue_node_update(node, order);
+      *b = node;
+    }
+}
+
+static inline void
+queue_tree_setroot(struct queue_node *root, int order)
+{
+  queue_model.root[order] = root;
+  if (root)
+    root->link[order].parent = NULL;
+}
+
+static struct queue_node *
+queue_tree_at(uint32_t pos, int order)
+{
+  struct queue_node *node;
+  uint32_t left_size;
+
+  node = queue_model.root[order];
+  while (node)
+    {
+      left_size = queue_node_size(node->link[order].left, order);
+      if (pos == left_size)
+	return node;
+
+      if (pos < left_size)
+	{
+	  node = node->link[order].left;
+	}
+      else
+	{
+	  pos -= left_size + 1;
+	  node = node->link[order].right;
+	}
+    }
+
+  return NULL;
+}
+
+static uint32_t
+queue_tree_rank(struct queue_node *node, int order)
+{
+  struct queue_node *parent;
+  uint32_t rank;
+
+  rank = queue_node_size(node->link[order].left, order);
+  for (parent = node->link[order].parent; parent; node = parent, parent = parent->link[order].parent)
+    {
+      if (parent->link[order].right == node)
+	rank += queue_node_size(parent->link[order].left, order) + 1;
+    }
+
+  return rank;
+}
+
+static void
+queue_tree_insert(struct queue_node *node, uint32_t pos, int order)
+{
+  struct queue_node *a;
+  struct queue_node *b;
+
+  node->link[order].left = NULL;
+  node->link[order].right = NULL;
+  node->link[order].size = 1;
+
+  queue_tree_split(queue_model.root[order], pos, &a, &b, order);
+  queue_tree_setroot(queue_tree_merge(queue_tree_merge(a, node, order), b, order), order);
+}
+
+static void
+queue_tree_remove(struct queue_node *node, int order)
+{
+  struct queue_node *a;
+  struct queue_node *b;
+  struct queue_node *c;
+
+  queue_tree_split(queue_model.root[order], queue_tree_rank(node, order), &a, &b, order);
+  queue_tree_split(b, 1, &b, &c, order);
+  queue_tree_setroot(queue_tree_merge(a, c, order), order);
+}
+
+// Stores each node's position in the given order in node->pos[order]
+static void
+queue_tree_number(struct queue_node *node, int order, int *pos)
+{
+  for (; node; node = node->link[order].right)
+    {
+      queue_tree_number(node->link[order].left, order, pos);
+      node->pos[order] = (*pos)++;
+    }
+}
+
+static void
+queue_tree_collect(struct queue_node *node, int order, struct queue_node **nodes, uint32_t *n)
+{
+  for (; node; node = node->link[order].right)
+    {
+      queue_tree_collect(node->link[order].left, order, nodes, n);
+      nodes[(*n)++] = node;
+    }
+}
+
+static struct queue_node *
+queue_model_lookup(uint32_t id)
+{
+  struct queue_node *node;
+
+  if (!queue_model.hash_size)
+    return NULL;
+
+  for (node = queue_model.hash[id & (queue_model.hash_size - 1)]; node; node = node->hash_next)
+    {
+      if (node->id == id)
+	return node;
+    }
+
+  return NULL;
+}
+
+static void
+queue_model_hash_grow(void)
+{
+  struct queue_node **hash;
+  struct queue_node *node;
+  struct queue_node *next;
+  uint32_t size;
+  uint32_t i;
+
+  size = queue_model.hash_size ? 2 * queue_model.hash_size : 256;
+  CHECK_NULL(L_DB, hash = calloc(size, sizeof(struct queue_node *)));
+
+  for (i = 0; i < queue_model.hash_size; i++)
+    {
+      for (node = queue_model.hash[i]; node; node = next)
+	{
+	  next = node->hash_next;
+	  node->hash_next = hash[node->id & (size - 1)];
+	  hash[node->id & (size - 1)] = node;
+	}
+    }
+
+  free(queue_model.hash);
+  queue_model.hash = hash;
+  queue_model.hash_size = size;
+}
+
+static void
+queue_model_link(struct queue_node *node, uint32_t pos, uint32_t shuffle_pos)
+{
+  if (queue_model.count >= queue_model.hash_size)
+    queue_model_hash_grow();
+
+  node->hash_next = queue_model.hash[node->id & (queue_model.hash_size - 1)];
+  queue_model.hash[node->id & (queue_model.hash_size - 1)] = node;
+  queue_model.count++;
+
+  queue_tree_insert(node, MIN(pos, queue_model.count - 1), QUEUE_ORDER_POS);
+  queue_tree_insert(node, MIN(shuffle_pos, queue_model.count - 1), QUEUE_ORDER_SHUFFLE);
+}
+
+static void
+queue_model_unlink(struct queue_node *node)
+{
+  struct queue_node **prev;
+
+  queue_tree_remove(node, QUEUE_ORDER_POS);
+  queue_tree_remove(node, QUEUE_ORDER_SHUFFLE);
+
+  for (prev = &queue_model.hash[node->id & (queue_model.hash_size - 1)]; *prev; prev = &(*prev)->hash_next)
+    {
+      if (*prev == node)
+	{
+	  *prev = node->hash_next;
+	  break;
+	}
+    }
+
+  queue_model.count--;
+}
+
+// Returns a new undo log entry, or NULL if no queue transaction is open
+static struct queue_undo *
+queue_undo_push(enum queue_undo_type type, struct queue_node *node)
+{
+  struct queue_undo *undo;
+
+  if (!queue_model.undo_active)
+    return NULL;
+
+  if (queue_model.undo_count >= queue_model.undo_size)
+    {
+      queue_model.undo_size = queue_model.undo_size ? 2 * queue_model.undo_size : 64;
+      CHECK_NULL(L_DB, queue_model.undo = realloc(queue_model.undo, queue_model.undo_size * sizeof(struct queue_undo)));
+    }
+
+  undo = &queue_model.undo[queue_model.undo_count++];
+  memset(undo, 0, sizeof(struct queue_undo));
+  undo->type = type;
+  undo->node = node;
+
+  return undo;
+}
+
+static void
+queue_undo_begin(void)
+{
+  queue_model.undo_active = true;
+  queue_model.undo_count = 0;
+  queue_model.undo_dirty = queue_model.dirty;
+  queue_model.undo_version = queue_model.version;
+}
+
+static void
+queue_undo_clear(void)
+{
+  queue_model.undo_active = false;
+  queue_model.undo_count = 0;
+
+  // Don't hold on to the log of a large transaction, e.g. clearing the queue
+  if (queue_model.undo_size > 1024)
+    {
+      free(queue_model.undo);
+      queue_model.undo = NULL;
+      queue_model.undo_size = 0;
+    }
+}
+
+// The transaction was committed, so the removed nodes can go
+static void
+queue_undo_commit(void)
+{
+  struct queue_undo *undo;
+  uint32_t i;
+
+  for (i = 0; i < queue_model.undo_count; i++)
+    {
+      undo = &queue_model.undo[i];
+      if (undo->type == QUEUE_UNDO_REMOVE)
+	free(undo->node);
+      else if (undo->type == QUEUE_UNDO_SHUFFLE)
+	free(undo->nodes);
+    }
+
+  queue_undo_clear();
+}
+
+// Reverts the changes of the transaction in reverse order, leaving the order as it was at its start
+static void
+queue_undo_rollback(void)
+{
+  struct queue_undo *undo;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = queue_model.undo_count; i > 0; i--)
+    {
+      undo = &queue_model.undo[i - 1];
+      switch (undo->type)
+	{
+	  case QUEUE_UNDO_ADD:
+	    queue_model_unlink(undo->node);
+	    free(undo->node);
+	    break;
+
+	  case QUEUE_UNDO_REMOVE:
+	    queue_model_link(undo->node, undo->pos[QUEUE_ORDER_POS], undo->pos[QUEUE_ORDER_SHUFFLE]);
+	    break;
+
+	  case QUEUE_UNDO_MOVE:
+	    queue_tree_remove(undo->node, undo->order);
+	    queue_tree_insert(undo->node, undo->pos[undo->order], undo->order);
+	    break;
+
+	  case QUEUE_UNDO_SHUFFLE:
+	    queue_model.root[QUEUE_ORDER_SHUFFLE] = NULL;
+	    for (j = 0; j < undo->nnodes; j++)
+	      queue_tree_insert(undo->nodes[j], j, QUEUE_ORDER_SHUFFLE);
+	    free(undo->nodes);
+	    break;
+	}
+    }
+
+  queue_model.dirty = queue_model.undo_dirty;
+  queue_model.version = queue_model.undo_version;
+
+  // The order is back to where it was, but a snapshot taken meanwhile isn't
+  if (queue_model.undo_count > 0)
+    queue_model.changes++;
+
+  queue_undo_clear();
+}
+
+// Creates a node for the item with the given id, inserted at the given positions
+static struct queue_node *
+queue_model_add(uint32_t id, uint32_t pos, uint32_t shuffle_pos)
+{
+  struct queue_node *node;
+
+  CHECK_NULL(L_DB, node = calloc(1, sizeof(struct queue_node)));
+
+  // xorshift32, only used to balance the trees
+  queue_model.prio_state ^= queue_model.prio_state << 13;
+  queue_model.prio_state ^= queue_model.prio_state >> 17;
+  queue_model.prio_state ^= queue_model.prio_state << 5;
+
+  node->id = id;
+  node->prio = queue_model.prio_state;
+  node->db_pos[QUEUE_ORDER_POS] = -1;
+  node->db_pos[QUEUE_ORDER_SHUFFLE] = -1;
+
+  queue_model_link(node, pos, shuffle_pos);
+
+  queue_undo_push(QUEUE_UNDO_ADD, node);
+
+  return node;
+}
+
+static void
+queue_model_remove(struct queue_node *node)
+{
+  struct queue_undo *undo;
+
+  undo = queue_undo_push(QUEUE_UNDO_REMOVE, node);
+  if (undo)
+    {
+      undo->pos[QUEUE_ORDER_POS] = queue_tree_rank(node, QUEUE_ORDER_POS);
+      undo->pos[QUEUE_ORDER_SHUFFLE] = queue_tree_rank(node, QUEUE_ORDER_SHUFFLE);
+    }
+
+  queue_model_unlink(node);
+
+  // Freed when the transaction is committed
+  if (!undo)
+    free(node);
+}
+
+static void
+queue_model_move(struct queue_node *node, uint32_t pos, int order)
+{
+  struct queue_undo *undo;
+
+  undo = queue_undo_push(QUEUE_UNDO_MOVE, node);
+  if (undo)
+    {
+      undo->order = order;
+      undo->pos[order] = queue_tree_rank(node, order);
+    }
+
+  queue_tree_remove(node, order);
+  queue_tree_insert(node, MIN(pos, queue_model.count - 1), order);
+}
+
+static void
+queue_model_reset(void)
+{
+  struct queue_node *node;
+  struct queue_node *next;
+  uint32_t i;
+
+  for (i = 0; i < queue_model.hash_size; i++)
+    {
+      for (node = queue_model.hash[i]; node; node = next)
+	{
+	  next = node->hash_next;
+	  free(node);
+	}
+    }
+
+  free(queue_model.hash);
+  queue_model.hash = NULL;
+  queue_model.hash_size = 0;
+  queue_model.count = 0;
+  queue_model.root[QUEUE_ORDER_POS] = NULL;
+  queue_model.root[QUEUE_ORDER_SHUFFLE] = NULL;
+  queue_model.loaded = false;
+  queue_model.dirty = false;
+  // Also invalidates the cached snapshot
+  queue_model.changes++;
+}
+
+/*
+ * Marks the order as changed by the given queue version. The new positions are
+ * written after the transaction that made the change has been committed.
+ */
+static void
+queue_model_changed(int queue_version)
+{
+  queue_model.dirty = true;
+  queue_model.changes++;
+  queue_model.version = queue_version;
+}
+
+static int
+queue_model_cmp_shuffle(const void *a, const void *b)
+{
+  const struct queue_node *na = *(const struct queue_node **)a;
+  const struct queue_node *nb = *(const struct queue_node **)b;
+
+  if (na->db_pos[QUEUE_ORDER_SHUFFLE] != nb->db_pos[QUEUE_ORDER_SHUFFLE])
+    return (na->db_pos[QUEUE_ORDER_SHUFFLE] < nb->db_pos[QUEUE_ORDER_SHUFFLE]) ? -1 : 1;
+
+  return (na->id < nb->id) ? -1 : (na->id > nb->id);
+}
+
+/*
+ * Builds the model from the queue table. Gaps or duplicates in the stored
+ * positions are resolved by ordering by (pos, id) and renumbering, the fixed
+ * positions are written with the next flush.
+ */
+static int
+queue_model_load(void)
+{
+#define Q_TMPL "SELECT id, pos, shuffle_pos, queue_version FROM queue ORDER BY pos, id;"
+  struct queue_node **nodes;
+  struct queue_node *node;
+  sqlite3_stmt *stmt;
+  uint32_t n;
+  uint32_t i;
+  int ret;
+
+  queue_model_reset();
+
+  ret = db_blocking_prepare_v2(Q_TMPL, -1, &stmt, NULL);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
+      return -1;
+    }
+
+  while ((ret = db_blocking_step(stmt)) == SQLITE_ROW)
+    {
+      node = queue_model_add(sqlite3_column_int(stmt, 0), UINT32_MAX, UINT32_MAX);
+      node->db_pos[QUEUE_ORDER_POS] = sqlite3_column_int(stmt, 1);
+      node->db_pos[QUEUE_ORDER_SHUFFLE] = sqlite3_column_int(stmt, 2);
+
+      queue_model.version = MAX(queue_model.version, sqlite3_column_int(stmt, 3));
+    }
+
+  sqlite3_finalize(stmt);
+
+  if (ret != SQLITE_DONE)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not step: %s\n", sqlite3_errmsg(hdl));
+      queue_model_reset();
+      return -1;
+    }
+
+  // Rebuild the shuffle order from the stored shuffle positions
+  if (queue_model.count > 0)
+    {
+      CHECK_NULL(L_DB, nodes = malloc(queue_model.count * sizeof(struct queue_node *)));
+
+      n = 0;
+      queue_tree_collect(queue_model.root[QUEUE_ORDER_POS], QUEUE_ORDER_POS, nodes, &n);
+      qsort(nodes, n, sizeof(struct queue_node *), queue_model_cmp_shuffle);
+
+      queue_model.root[QUEUE_ORDER_SHUFFLE] = NULL;
+      for (i = 0; i < n; i++)
+	queue_tree_insert(nodes[i], i, QUEUE_ORDER_SHUFFLE);
+
+      free(nodes);
+    }
+
+  // Picks up any renumbering
+  queue_model.dirty = true;
+  queue_model.loaded = true;
+
+  DPRINTF(E_DBG, L_DB, "Loaded queue order with %" PRIu32 " items\n", queue_model.count);
+
+  return 0;
+
+#undef Q_TMPL
+}
+
+static int
+queue_model_prepare(void)
+{
+  if (queue_model.loaded)
+    return 0;
+
+  return queue_model_load();
+}
+
+struct queue_model_pos
+{
+  uint32_t id;
+  int pos[2];
+  // Position differs from the one stored in the queue table
+  bool moved;
+};
+
+// Stores the current positions in node->pos[], must be called with the queue lock
+static void
+queue_model_number(void)
+{
+  int pos;
+
+  pos = 0;
+  queue_tree_number(queue_model.root[QUEUE_ORDER_POS], QUEUE_ORDER_POS, &pos);
+  pos = 0;
+  queue_tree_number(queue_model.root[QUEUE_ORDER_SHUFFLE], QUEUE_ORDER_SHUFFLE, &pos);
+}
+
+/*
+ * Copies the positions of all items, or only of the moved ones, from the queue
+ * order. Must be called with the queue lock.
+ */
+static struct queue_model_pos *
+queue_model_positions(uint32_t *count, bool moved_only)
+{
+  struct queue_model_pos *positions;
+  struct queue_node *node;
+  uint32_t n;
+  uint32_t i;
+  bool moved;
+
+  queue_model_number();
+
+  CHECK_NULL(L_DB, positions = malloc(MAX(queue_model.count, 1) * sizeof(struct queue_model_pos)));
+
+  n = 0;
+  for (i = 0; i < queue_model.hash_size; i++)
+    {
+      for (node = queue_model.hash[i]; node; node = node->hash_next)
+	{
+	  moved = (node->pos[QUEUE_ORDER_POS] != node->db_pos[QUEUE_ORDER_POS] || node->pos[QUEUE_ORDER_SHUFFLE] != node->db_pos[QUEUE_ORDER_SHUFFLE]);
+	  if (moved_only && !moved)
+	    continue;
+
+	  positions[n].id = node->id;
+	  positions[n].pos[QUEUE_ORDER_POS] = node->pos[QUEUE_ORDER_POS];
+	  positions[n].pos[QUEUE_ORDER_SHUFFLE] = node->pos[QUEUE_ORDER_SHUFFLE];
+	  positions[n].moved = moved;
+	  n++;
+	}
+    }
+
+  *count = n;
+  return positions;
+}
+
+// Writes the given positions to the queue table in a transaction of its own
+static int
+queue_model_write(struct queue_model_pos *positions, uint32_t count, int queue_version)
+{
+#define Q_TMPL "UPDATE queue SET pos = ?, shuffle_pos = ?, queue_version = ? WHERE id = ?;"
+  sqlite3_stmt *stmt;
+  uint32_t i;
+  int ret;
+
+  db_transaction_begin();
+
+  ret = db_blocking_prepare_v2(Q_TMPL, -1, &stmt, NULL);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
+      db_transaction_rollback();
+      return -1;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      sqlite3_bind_int(stmt, 1, positions[i].pos[QUEUE_ORDER_POS]);
+      sqlite3_bind_int(stmt, 2, positions[i].pos[QUEUE_ORDER_SHUFFLE]);
+      sqlite3_bind_int(stmt, 3, queue_version);
+      sqlite3_bind_int(stmt, 4, positions[i].id);
+
+      ret = db_blocking_step(stmt);
+      if (ret != SQLITE_DONE)
+	{
+	  DPRINTF(E_LOG, L_DB, "Could not write queue position of item %" PRIu32 ": %s\n", positions[i].id, sqlite3_errmsg(hdl));
+	  sqlite3_finalize(stmt);
+	  db_transaction_rollback();
+	  return -1;
+	}
+
+      sqlite3_reset(stmt);
+    }
+
+  sqlite3_finalize(stmt);
+
+  db_transaction_end();
+
+  DPRINTF(E_DBG, L_DB, "Wrote %" PRIu32 " changed queue positions\n", count);
+
+  return 0;
+
+#undef Q_TMPL
+}
+
+static void
+queue_model_flush_cb(void *arg)
+{
+  db_queue_flush();
+}
+
+static inline void
+queue_lock(void)
+{
+  CHECK_ERR(L_DB, pthread_mutex_lock(&queue_model.lck));
+}
+
+static inline void
+queue_unlock(void)
+{
+  CHECK_ERR(L_DB, pthread_mutex_unlock(&queue_model.lck));
+}
+
+// Must be called with the queue lock
+static void
+queue_model_flush_schedule(void)
+{
+  if (!queue_model.dirty || queue_model.flush_scheduled)
+    return;
+
+  queue_model.flush_scheduled = true;
+  worker_execute(queue_model_flush_cb, NULL, 0, QUEUE_FLUSH_DELAY);
+}
+
+/*
+ * Writes pending changes of the queue order to the database. Normally called
+ * from the worker thread shortly after a change, and on shutdown.
+ *
+ * The moved positions are copied with the queue lock held, but written without
+ * it, so the player can keep reading the queue order. Changes made while
+ * writing keep the order dirty and are written by the next flush.
+ */
+void
+db_queue_flush(void)
+{
+  struct queue_model_pos *positions;
+  struct queue_node *node;
+  uint32_t changes;
+  uint32_t count;
+  uint32_t i;
+  int version;
+  int ret;
+
+  CHECK_ERR(L_DB, pthread_mutex_lock(&queue_model.flush_lck));
+
+  queue_lock();
+
+  queue_model.flush_scheduled = false;
+  if (!queue_model.loaded || !queue_model.dirty)
+    {
+      queue_unlock();
+      CHECK_ERR(L_DB, pthread_mutex_unlock(&queue_model.flush_lck));
+      return;
+    }
+
+  positions = queue_model_positions(&count, true);
+  changes = queue_model.changes;
+  version = queue_model.version;
+
+  queue_unlock();
+
+  ret = queue_model_write(positions, count, version);
+
+  queue_lock();
+
+  // Only mark as persisted when all writes succeeded. Items removed in the
+  // meantime are simply not found.
+  if (ret == 0)
+    {
+      for (i = 0; i < count; i++)
+	{
+	  node = queue_model_lookup(positions[i].id);
+	  if (!node)
+	    continue;
+
+	  node->db_pos[QUEUE_ORDER_POS] = positions[i].pos[QUEUE_ORDER_POS];
+	  node->db_pos[QUEUE_ORDER_SHUFFLE] = positions[i].pos[QUEUE_ORDER_SHUFFLE];
+	}
+
+      if (queue_model.changes == changes)
+	queue_model.dirty = false;
+    }
+
+  queue_unlock();
+
+  CHECK_ERR(L_DB, pthread_mutex_unlock(&queue_model.flush_lck));
+
+  free(positions);
+}
+
+
+/*
+ * Positions of the queue order at the start of a queue enumeration, sorted by
+ * id. The last one is cached (with the queue lock) until the order changes
+ * again, and shared by the enumerations that start meanwhile.
+ */
+struct queue_snapshot
+{
+  struct queue_model_pos *positions;
+  uint32_t count;
+  uint32_t changes;
+  int version;
+  int refcount;
+};
+
+static struct queue_snapshot *queue_snapshot_cached;
+static __thread struct queue_snapshot *queue_snapshot_self;
+
+static int
+queue_snapshot_cmp(const void *a, const void *b)
+{
+  const struct queue_model_pos *pa = a;
+  const struct queue_model_pos *pb = b;
+
+  return (pa->id < pb->id) ? -1 : (pa->id > pb->id);
+}
+
+static struct queue_model_pos *
+queue_snapshot_find(uint32_t id)
+{
+  struct queue_model_pos key;
+
+  if (!queue_snapshot_self)
+    return NULL;
+
+  key.id = id;
+  return bsearch(&key, queue_snapshot_self->positions, queue_snapshot_self->count, sizeof(struct queue_model_pos), queue_snapshot_cmp);
+}
+
+/*
+ * SQL function queue_pos(id, order, stored): the position of the item in the
+ * given order (0 = pos, 1 = shuffle_pos), or the stored value if there is no
+ * snapshot of the queue order. It must not take the queue lock, the caller may
+ * hold it while stepping a statement.
+ */
+static void
+queue_pos_xfunc(sqlite3_context *pv, int n, sqlite3_value **ppv)
+{
+  struct queue_model_pos *qmp;
+  int order;
+
+  qmp = queue_snapshot_find(sqlite3_value_int(ppv[0]));
+  order = sqlite3_value_int(ppv[1]);
+  if (!qmp || order < QUEUE_ORDER_POS || order > QUEUE_ORDER_SHUFFLE)
+    {
+      sqlite3_result_value(pv, ppv[2]);
+      return;
+    }
+
+  sqlite3_result_int(pv, qmp->pos[order]);
+}
+
+/*
+ * SQL function queue_pos_version(id, stored): the queue version the item will
+ * have once its position is written, i.e. the version of the last change of
+ * the order if it moved, otherwise the stored value.
+ */
+static void
+queue_pos_version_xfunc(sqlite3_context *pv, int n, sqlite3_value **ppv)
+{
+  struct queue_model_pos *qmp;
+
+  qmp = queue_snapshot_find(sqlite3_value_int(ppv[0]));
+  if (!qmp || !qmp->moved)
+    {
+      sqlite3_result_value(pv, ppv[1]);
+      return;
+    }
+
+  sqlite3_result_int(pv, queue_snapshot_self->version);
+}
+
+/* Queue */
+
+static int
+queue_version_next(void)
+{
+  int queue_version = 0;
+
+  db_admin_getint(&queue_version, DB_ADMIN_QUEUE_VERSION);
+
+  return queue_version + 1;
+}
+
+/*
+ * Locks the queue and starts a new transaction for modifying it. Returns the new queue version for the following changes,
+ * or -1 if the queue order could not be loaded.
+ * After finishing all queue modifications 'queue_transaction_end' needs to be called.
+ */
+static int
+queue_transaction_begin()
+{
+  int ret;
+
+  queue_lock();
+
+  ret = queue_model_prepare();
+  if (ret < 0)
+    {
+      queue_unlock();
+      return -1;
+    }
+
+  db_transaction_begin();
+  queue_undo_begin();
+
+  return queue_version_next();
+}
+
+/*
+ * If retval == 0, updates the version of the queue in the admin table, commits the transaction
+ * and notifies listener of LISTENER_QUEUE about the changes. Changes to the queue order are
+ * written to the queue table by the worker thread shortly after.
+ * If retval < 0, rollsback the transaction and the changes to the queue order.
+ *
+ * This function must be called after modifying the queue, it releases the queue lock.
+ *
+ * @param retval 'retval' == 0, if modifying the queue was successful or 'retval' < 0 if an error occurred
+ * @param queue_version The new queue version, for the pending modifications
+ */
+static void
+queue_transaction_end(int retval, int queue_version)
+{
+  struct listener_event_data data = { 0 };
+  int ret;
+
+  if (retval != 0)
+    goto error;
+
+  ret = db_admin_setint(DB_ADMIN_QUEUE_VERSION, queue_version);
+  if (ret < 0)
+    goto error;
+
+  db_transaction_end();
+
+  queue_undo_commit();
+  queue_model_flush_schedule();
+
+  queue_unlock();
+
+  data.queue_version = queue_version;
+  listener_notify_data(LISTENER_QUEUE, &data);
+  return;
+
+ error:
+  db_transaction_rollback();
+
+  queue_undo_rollback();
+  queue_model_flush_schedule();
+
+  queue_unlock();
+}
+
+/*
+ * Commits a queue transaction that did not change anything and releases the queue lock.
+ */
+static void
+queue_transaction_end_unchanged(void)
+{
+  db_transaction_end();
+  queue_undo_commit();
+  queue_unlock();
+}
+
+static int
+queue_reshuffle(uint32_t item_id, int queue_version);
+
+static int
+queue_add_file(struct db_media_file_info *dbmfi, int pos, int shuffle_pos, int queue_version)
+{
+#define Q_TMPL "INSERT INTO queue "							\
+		    "(id, file_id, song_length, data_kind, media_kind, "		\
+		    "pos, shuffle_pos, path, virtual_path, title, "			\
+		    "artist, composer, album_artist, album, genre, songalbumid, songartistid,"	\
+		    "time_modified, artist_sort, album_sort, album_artist_sort, year, "	\
+		    "type, bitrate, samplerate, channels, "				\
+		    "track, disc, queue_version)" 					\
+		"VALUES"                                           			\
+		    "(NULL, %" PRIi64 ", %" PRIi64 ", %" PRIi64 ", %" PRIi64 ", "	\
+		    "%d, %d, %Q, %Q, %Q, "						\
+		    "%Q, %Q, %Q, %Q, %Q, %" PRIi64 ", %" PRIi64 ","			\
+		    "%" PRIi64 ", %Q, %Q, %Q, %" PRIi64 ", "				\
+		    "%Q, %" PRIi64 ", %" PRIi64 ", %" PRIi64 ", "			\
+		    "%" PRIi64 ", %" PRIi64 ", %d);"
+
+  char *query;
+  int ret;
+
+  query = sqlite3_mprintf(Q_TMPL,
+			  dbmfi->id, dbmfi->song_length, dbmfi->data_kind, dbmfi->media_kind,
+			  pos, shuffle_pos, dbmfi->path, dbmfi->virtual_path, dbmfi->title,
+			  dbmfi->artist, dbmfi->composer, dbmfi->album_artist, dbmfi->album, dbmfi->genre, dbmfi->songalbumid, dbmfi->songartistid,
+			  dbmfi->time_modified, dbmfi->artist_sort, dbmfi->album_sort, dbmfi->album_artist_sort, dbmfi->year,
+			  dbmfi->type, dbmfi->bitrate, dbmfi->samplerate, dbmfi->channels,
+			  dbmfi->track, dbmfi->disc, queue_version);
+  ret = db_query_run(query, 1, 0);
+
+  return ret;
+
+#undef Q_TMPL
+}
+
+static int
+queue_add_item(struct db_queue_item *item, int pos, int shuffle_pos, int queue_version)
+{
+#define Q_TMPL "INSERT INTO queue "							\
+		    "(id, file_id, song_length, data_kind, media_kind, "		\
+		    "pos, shuffle_pos, path, virtual_path, title, "			\
+		    "artist, composer, album_artist, album, genre, songalbumid, songartistid, "	\
+		    "time_modified, artist_sort, album_sort, album_artist_sort, year, "	\
+		    "type, bitrate, samplerate, channels, "				\
+		    "track, disc, artwork_url, queue_version)" 				\
+		"VALUES"                                           			\
+		    "(NULL, %d, %d, %d, %d, "						\
+		    "%d, %d, %Q, %Q, %Q, "						\
+		    "%Q, %Q, %Q, %Q, %Q, %" PRIi64 ", %" PRIi64 ","			\
+		    "%d, %Q, %Q, %Q, %d, "						\
+		    "%Q, %" PRIu32 ", %" PRIu32 ", %" PRIu32 ", "			\
+		    "%d, %d, %Q, %d);"
+
+  char *query;
+  int ret;
+
+  query = sqlite3_mprintf(Q_TMPL,
+			  item->file_id, item->song_length, item->data_kind, item->media_kind,
+			  pos, shuffle_pos, item->path, item->virtual_path, item->title,
+			  item->artist, item->composer, item->album_artist, item->album, item->genre, item->songalbumid, item->songartistid,
+			  item->time_modified, item->artist_sort, item->album_sort, item->album_artist_sort, item->year,
+                          item->type, item->bitrate, item->samplerate, item->channels,
+			  item->track, item->disc, item->artwork_url, queue_version);
+  ret = db_query_run(query, 1, 0);
+
+  return ret;
+
+#undef Q_TMPL
+}
+
+int
 db_queue_update_item(struct db_queue_item *qi)
 {
 #define Q_TMPL "UPDATE queue SET "							\
 		    "file_id = %d, song_length = %d, data_kind = %d, media_kind = %d, "	\
-		    "pos = %d, shuffle_pos = %d, path = '%q', virtual_path = %Q, "	\
+		    "path = '%q', virtual_path = %Q, "					\
 		    "title = %Q, artist = %Q, album_artist = %Q, album = %Q, "		\
 		    "composer = %Q,"                                                    \
 		    "genre = %Q, time_modified = %d, "					\
@@ -4784,10 +6529,13 @@ db_queue_update_item(struct db_queue_item *qi)
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
+  // The positions are owned by the queue order model, qi->pos may be stale
   query = sqlite3_mprintf(Q_TMPL,
 			  qi->file_id, qi->song_length, qi->data_kind, qi->media_kind,
-			  qi->pos, qi->shuffle_pos, qi->path, qi->virtual_path,
+			  qi->path, qi->virtual_path,
 			  qi->title, qi->artist, qi->album_artist, qi->album,
                           qi->composer,
 			  qi->genre, qi->time_modified,
@@ -4838,77 +6586,126 @@ db_queue_add_by_queryafteritemid(struct query_params *qp, uint32_t item_id)
   return ret;
 }
 
+/*
+ * Starts adding items to the queue at the given position (-1 to add at the end of the queue).
+ *
+ * The items passed to db_queue_add_item() are only collected, db_queue_add_end() adds them to the
+ * queue in a single queue transaction. Callers may do lengthy work (e. g. requesting the items from
+ * a web api) in between without holding the queue lock or a database transaction.
+ */
 int
 db_queue_add_start(struct db_queue_add_info *queue_add_info, int pos)
 {
-  uint32_t queue_count;
-  int ret;
-
   memset(queue_add_info, 0, sizeof(struct db_queue_add_info));
-  queue_add_info->queue_version = queue_transaction_begin();
 
-  ret = db_queue_get_count(&queue_count);
-  if (ret < 0)
-    {
-      ret = -1;
-      queue_transaction_end(ret, queue_add_info->queue_version);
-      return ret;
-    }
+  queue_add_info->start_pos = pos;
 
-  queue_add_info->pos = queue_count;
-  queue_add_info->shuffle_pos = queue_count;
+  return 0;
+}
 
-  if (pos >= 0 && pos < queue_count)
-    queue_add_info->pos = pos;
+static void
+queue_add_info_free(struct db_queue_add_info *queue_add_info)
+{
+  int i;
 
-  queue_add_info->start_pos = queue_add_info->pos;
+  for (i = 0; i < queue_add_info->count; i++)
+    free_queue_item(&queue_add_info->items[i], 1);
 
-  return 0;
+  free(queue_add_info->items);
+  queue_add_info->items = NULL;
+  queue_add_info->items_size = 0;
 }
 
 int
 db_queue_add_end(struct db_queue_add_info *queue_add_info, char reshuffle, uint32_t item_id, int ret)
 {
-  char *query;
+  struct queue_node *node;
+  int queue_version;
+  int i;
 
-  // Update pos for all items from the given position
-  if (ret == 0)
+  if (ret < 0 || queue_add_info->count == 0)
+    goto out;
+
+  queue_version = queue_transaction_begin();
+  if (queue_version < 0)
     {
-      query = sqlite3_mprintf("UPDATE queue SET pos = pos + %d, queue_version = %d WHERE pos >= %d AND queue_version < %d;",
-			      queue_add_info->count, queue_add_info->queue_version, queue_add_info->start_pos, queue_add_info->queue_version);
-      ret = db_query_run(query, 1, 0);
+      ret = -1;
+      goto out;
+    }
+
+  queue_add_info->queue_version = queue_version;
+
+  // Items after the given position make room by being moved in the queue order
+  queue_add_info->pos = queue_model.count;
+  queue_add_info->shuffle_pos = queue_model.count;
+  if (queue_add_info->start_pos >= 0 && queue_add_info->start_pos < queue_model.count)
+    queue_add_info->pos = queue_add_info->start_pos;
+
+  queue_add_info->start_pos = queue_add_info->pos;
+
+  for (i = 0; i < queue_add_info->count; i++)
+    {
+      ret = queue_add_item(&queue_add_info->items[i], queue_add_info->pos, queue_add_info->shuffle_pos, queue_version);
+      if (ret < 0)
+	break;
+
+      node = queue_model_add((uint32_t) sqlite3_last_insert_rowid(hdl), queue_add_info->pos, queue_add_info->shuffle_pos);
+      node->db_pos[QUEUE_ORDER_POS] = queue_add_info->pos;
+      node->db_pos[QUEUE_ORDER_SHUFFLE] = queue_add_info->shuffle_pos;
+      queue_model_changed(queue_version);
+
+      if (queue_add_info->new_item_id == 0)
+	queue_add_info->new_item_id = (int) node->id;
+
+      queue_add_info->pos++;
+      queue_add_info->shuffle_pos++;
     }
 
   // Reshuffle after adding new items
   if (ret == 0 && reshuffle)
     {
-      ret = queue_reshuffle(item_id, queue_add_info->queue_version);
+      ret = queue_reshuffle(item_id, queue_version);
     }
 
-  queue_transaction_end(ret, queue_add_info->queue_version);
+  queue_transaction_end(ret, queue_version);
+
+ out:
+  queue_add_info_free(queue_add_info);
   return ret;
 }
 
 int
 db_queue_add_item(struct db_queue_add_info *queue_add_info, struct db_queue_item *item)
 {
-  int ret;
+  struct db_queue_item *qi;
+  char **strval;
+  int i;
 
   fixup_tags_queue_item(item);
-  ret = queue_add_item(item, queue_add_info->pos, queue_add_info->shuffle_pos, queue_add_info->queue_version);
-  if (ret == 0)
+
+  if (queue_add_info->count >= queue_add_info->items_size)
     {
-      queue_add_info->pos++;
-      queue_add_info->shuffle_pos++;
-      queue_add_info->count++;
+      queue_add_info->items_size = queue_add_info->items_size ? 2 * queue_add_info->items_size : 32;
+      CHECK_NULL(L_DB, queue_add_info->items = realloc(queue_add_info->items, queue_add_info->items_size * sizeof(struct db_queue_item)));
+    }
 
-      if (queue_add_info->new_item_id == 0)
-	queue_add_info->new_item_id = (int) sqlite3_last_insert_rowid(hdl);
+  // The caller frees its item, so keep a copy with our own strings
+  qi = &queue_add_info->items[queue_add_info->count];
+  memcpy(qi, item, sizeof(struct db_queue_item));
+
+  for (i = 0; i < ARRAY_SIZE(qi_cols_map); i++)
+    {
+      if (qi_cols_map[i].type != DB_TYPE_STRING)
+	continue;
+
+      strval = (char **) ((char *)qi + qi_cols_map[i].offset);
+      if (*strval)
+	CHECK_NULL(L_DB, *strval = strdup(*strval));
     }
 
-  return ret;
+  queue_add_info->count++;
 
-#undef Q_TMPL
+  return 0;
 }
 
 /*
@@ -4932,7 +6729,7 @@ int
 db_queue_add_by_query(struct query_params *qp, char reshuffle, uint32_t item_id, int position, int *count, int *new_item_id)
 {
   struct db_media_file_info dbmfi;
-  char *query;
+  struct queue_node *node;
   int queue_version;
   uint32_t queue_count;
   int pos;
@@ -4944,13 +6741,10 @@ db_queue_add_by_query(struct query_params *qp, char reshuffle, uint32_t item_id,
     *count = 0;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
-  ret = db_queue_get_count(&queue_count);
-  if (ret < 0)
-    {
-      ret = -1;
-      goto end_transaction;
-    }
+  queue_count = queue_model.count;
 
   ret = db_query_start(qp);
   if (ret < 0)
@@ -4961,24 +6755,15 @@ db_queue_add_by_query(struct query_params *qp, char reshuffle, uint32_t item_id,
   if (qp->results == 0)
     {
       db_query_end(qp);
-      db_transaction_end();
+      queue_transaction_end_unchanged();
       return 0;
     }
 
+  // Items after the given position make room by being moved in the queue order
   if (position < 0 || position > queue_count)
-    {
-      pos = queue_count;
-    }
+    pos = queue_count;
   else
-    {
-      pos = position;
-
-      // Update pos for all items from the given position (make room for the new items in the queue)
-      query = sqlite3_mprintf("UPDATE queue SET pos = pos + %d, queue_version = %d WHERE pos >= %d;", qp->results, queue_version, pos);
-      ret = db_query_run(query, 1, 0);
-      if (ret < 0)
-	goto end_transaction;
-    }
+    pos = position;
 
   while (((ret = db_query_fetch_file(qp, &dbmfi)) == 0) && (dbmfi.id))
     {
@@ -4986,11 +6771,16 @@ db_queue_add_by_query(struct query_params *qp, char reshuffle, uint32_t item_id,
 
       if (ret < 0)
 	{
-	  DPRINTF(E_DBG, L_DB, "Failed to add song id %s (%s)\n", dbmfi.id, dbmfi.title);
+	  DPRINTF(E_DBG, L_DB, "Failed to add song id %" PRIi64 " (%s)\n", dbmfi.id, dbmfi.title);
 	  break;
 	}
 
-      DPRINTF(E_DBG, L_DB, "Added song id %s (%s) to queue\n", dbmfi.id, dbmfi.title);
+      DPRINTF(E_DBG, L_DB, "Added song id %" PRIi64 " (%s) to queue\n", dbmfi.id, dbmfi.title);
+
+      node = queue_model_add((uint32_t) sqlite3_last_insert_rowid(hdl), pos, queue_count);
+      node->db_pos[QUEUE_ORDER_POS] = pos;
+      node->db_pos[QUEUE_ORDER_SHUFFLE] = queue_count;
+      queue_model_changed(queue_version);
 
       if (new_item_id && *new_item_id == 0)
 	*new_item_id = (int) sqlite3_last_insert_rowid(hdl);
@@ -5077,9 +6867,20 @@ db_queue_add_by_fileid(int id, char reshuffle, uint32_t item_id, int position, i
 static int
 queue_enum_start(struct query_params *qp)
 {
-#define Q_TMPL "SELECT * FROM queue f WHERE %s ORDER BY %s;"
+#define Q_TMPL "SELECT * FROM (SELECT id, file_id, queue_pos(id, 0, pos) AS pos, queue_pos(id, 1, shuffle_pos) AS shuffle_pos, "	\
+		"data_kind, media_kind, song_length, path, virtual_path, title, artist, album_artist, album, genre, "		\
+		"songalbumid, time_modified, artist_sort, album_sort, album_artist_sort, year, track, disc, artwork_url, "	\
+		"queue_pos_version(id, queue_version) AS queue_version, composer, songartistid, type, bitrate, samplerate, "	\
+		"channels FROM queue) f WHERE %s ORDER BY %s;"
+// Without a snapshot the stored positions are current, and the filter and sort can use the indexes on them
+#define Q_TMPL_STORED "SELECT id, file_id, pos, shuffle_pos, "	\
+		"data_kind, media_kind, song_length, path, virtual_path, title, artist, album_artist, album, genre, "		\
+		"songalbumid, time_modified, artist_sort, album_sort, album_artist_sort, year, track, disc, artwork_url, "	\
+		"queue_version, composer, songartistid, type, bitrate, samplerate, "	\
+		"channels FROM queue f WHERE %s ORDER BY %s;"
   sqlite3_stmt *stmt;
   char *query;
+  const char *tmpl;
   const char *orderby;
   int ret;
 
@@ -5090,10 +6891,12 @@ queue_enum_start(struct query_params *qp)
   else
     orderby = sort_clause[S_POS];
 
+  tmpl = queue_snapshot_self ? Q_TMPL : Q_TMPL_STORED;
+
   if (qp->filter)
-    query = sqlite3_mprintf(Q_TMPL, qp->filter, orderby);
+    query = sqlite3_mprintf(tmpl, qp->filter, orderby);
   else
-    query = sqlite3_mprintf(Q_TMPL, "1=1", orderby);
+    query = sqlite3_mprintf(tmpl, "1=1", orderby);
 
   if (!query)
     {
@@ -5119,9 +6922,22 @@ queue_enum_start(struct query_params *qp)
 
   return 0;
 
+#undef Q_TMPL_STORED
 #undef Q_TMPL
 }
 
+// The queue statements are prepared for each enumeration, so unlike the
+// library queries (db_query_end) they don't go in the statement cache
+static void
+queue_enum_end(struct query_params *qp)
+{
+  if (!qp->stmt)
+    return;
+
+  sqlite3_finalize(qp->stmt);
+  qp->stmt = NULL;
+}
+
 static inline char *
 strdup_if(char *str, int cond)
 {
@@ -5193,17 +7009,86 @@ queue_enum_fetch(struct query_params *qp, struct db_queue_item *queue_item, int
   return 0;
 }
 
+static void
+queue_snapshot_unref(struct queue_snapshot *snapshot)
+{
+  if (!snapshot || __atomic_sub_fetch(&snapshot->refcount, 1, __ATOMIC_ACQ_REL) > 0)
+    return;
+
+  free(snapshot->positions);
+  free(snapshot);
+}
+
+static void
+queue_snapshot_free(void)
+{
+  queue_snapshot_unref(queue_snapshot_self);
+  queue_snapshot_self = NULL;
+}
+
+/*
+ * Takes a reference to a snapshot of the queue order, made again only if the
+ * order changed since the cached one. If all positions are already written,
+ * there is no snapshot and the enumeration reads the queue table directly.
+ * Must be called with the queue lock.
+ */
+static void
+queue_snapshot_create(void)
+{
+  struct queue_snapshot *snapshot;
+
+  queue_snapshot_free();
+
+  if (!queue_model.dirty)
+    return;
+
+  snapshot = queue_snapshot_cached;
+  if (!snapshot || snapshot->changes != queue_model.changes)
+    {
+      CHECK_NULL(L_DB, snapshot = calloc(1, sizeof(struct queue_snapshot)));
+
+      snapshot->positions = queue_model_positions(&snapshot->count, false);
+      snapshot->changes = queue_model.changes;
+      snapshot->version = queue_model.version;
+      snapshot->refcount = 1;
+
+      qsort(snapshot->positions, snapshot->count, sizeof(struct queue_model_pos), queue_snapshot_cmp);
+
+      queue_snapshot_unref(queue_snapshot_cached);
+      queue_snapshot_cached = snapshot;
+    }
+
+  __atomic_add_fetch(&snapshot->refcount, 1, __ATOMIC_ACQ_REL);
+  queue_snapshot_self = snapshot;
+}
+
+/*
+ * The filter and sort may refer to the positions, which the queue table only
+ * has after the next flush. Instead of writing them now, the enumeration reads
+ * them from a snapshot of the queue order (see queue_pos()).
+ */
 int
 db_queue_enum_start(struct query_params *qp)
 {
   int ret;
 
+  queue_lock();
+  ret = queue_model_prepare();
+  if (ret == 0)
+    queue_snapshot_create();
+  queue_unlock();
+  if (ret < 0)
+    return -1;
+
   db_transaction_begin();
 
   ret = queue_enum_start(qp);
 
   if (ret < 0)
-    db_transaction_rollback();
+    {
+      db_transaction_rollback();
+      queue_snapshot_free();
+    }
 
   return ret;
 }
@@ -5211,8 +7096,9 @@ db_queue_enum_start(struct query_params *qp)
 void
 db_queue_enum_end(struct query_params *qp)
 {
-  db_query_end(qp);
+  queue_enum_end(qp);
   db_transaction_end();
+  queue_snapshot_free();
 }
 
 int
@@ -5224,35 +7110,53 @@ db_queue_enum_fetch(struct query_params *qp, struct db_queue_item *queue_item)
 int
 db_queue_get_pos(uint32_t item_id, char shuffle)
 {
-#define Q_TMPL "SELECT pos FROM queue WHERE id = %d;"
-#define Q_TMPL_SHUFFLE "SELECT shuffle_pos FROM queue WHERE id = %d;"
-
-  char *query;
+  struct queue_node *node;
   int pos;
 
-  if (shuffle)
-    query = sqlite3_mprintf(Q_TMPL_SHUFFLE, item_id);
-  else
-    query = sqlite3_mprintf(Q_TMPL, item_id);
+  queue_lock();
 
-  pos = db_get_one_int(query);
+  pos = queue_model_prepare();
+  if (pos == 0)
+    {
+      node = queue_model_lookup(item_id);
+      if (node)
+	pos = queue_tree_rank(node, shuffle ? QUEUE_ORDER_SHUFFLE : QUEUE_ORDER_POS);
+      else
+	pos = -1;
+    }
 
-  sqlite3_free(query);
+  queue_unlock();
 
   return pos;
+}
 
-#undef Q_TMPL
-#undef Q_TMPL_SHUFFLE
+// Sets the positions of a fetched queue item from the queue order
+static void
+queue_item_pos_set(struct db_queue_item *queue_item, struct queue_node *node)
+{
+  if (!node && queue_item->id > 0)
+    node = queue_model_lookup(queue_item->id);
+  if (!node)
+    return;
+
+  queue_item->pos = queue_tree_rank(node, QUEUE_ORDER_POS);
+  queue_item->shuffle_pos = queue_tree_rank(node, QUEUE_ORDER_SHUFFLE);
 }
 
 static int
-queue_fetch_byitemid(uint32_t item_id, struct db_queue_item *queue_item, int with_metadata)
+queue_fetch_bynode(struct queue_node *node, struct db_queue_item *queue_item, int with_metadata)
 {
   struct query_params qp;
   int ret;
 
+  if (!node)
+    {
+      memset(queue_item, 0, sizeof(struct db_queue_item));
+      return 0;
+    }
+
   memset(&qp, 0, sizeof(struct query_params));
-  qp.filter = sqlite3_mprintf("id = %d", item_id);
+  qp.filter = sqlite3_mprintf("id = %d", node->id);
 
   ret = queue_enum_start(&qp);
   if (ret < 0)
@@ -5262,11 +7166,21 @@ queue_fetch_byitemid(uint32_t item_id, struct db_queue_item *queue_item, int wit
     }
 
   ret = queue_enum_fetch(&qp, queue_item, with_metadata);
-  db_query_end(&qp);
+  queue_enum_end(&qp);
   sqlite3_free(qp.filter);
+
+  if (ret == 0 && queue_item->id > 0)
+    queue_item_pos_set(queue_item, node);
+
   return ret;
 }
 
+static int
+queue_fetch_byitemid(uint32_t item_id, struct db_queue_item *queue_item, int with_metadata)
+{
+  return queue_fetch_bynode(queue_model_lookup(item_id), queue_item, with_metadata);
+}
+
 struct db_queue_item *
 db_queue_fetch_byitemid(uint32_t item_id)
 {
@@ -5280,9 +7194,15 @@ db_queue_fetch_byitemid(uint32_t item_id)
       return NULL;
     }
 
-  db_transaction_begin();
-  ret = queue_fetch_byitemid(item_id, queue_item, 1);
-  db_transaction_end();
+  queue_lock();
+  ret = queue_model_prepare();
+  if (ret == 0)
+    {
+      db_transaction_begin();
+      ret = queue_fetch_byitemid(item_id, queue_item, 1);
+      db_transaction_end();
+    }
+  queue_unlock();
 
   if (ret < 0)
     {
@@ -5315,6 +7235,16 @@ db_queue_fetch_byfileid(uint32_t file_id)
       return NULL;
     }
 
+  queue_lock();
+  ret = queue_model_prepare();
+  if (ret < 0)
+    {
+      queue_unlock();
+      free_queue_item(queue_item, 0);
+      DPRINTF(E_LOG, L_DB, "Error fetching queue item by file id\n");
+      return NULL;
+    }
+
   db_transaction_begin();
 
   qp.filter = sqlite3_mprintf("file_id = %d", file_id);
@@ -5324,16 +7254,22 @@ db_queue_fetch_byfileid(uint32_t file_id)
     {
       sqlite3_free(qp.filter);
       db_transaction_end();
+      queue_unlock();
       free_queue_item(queue_item, 0);
       DPRINTF(E_LOG, L_DB, "Error fetching queue item by file id\n");
       return NULL;
     }
 
   ret = queue_enum_fetch(&qp, queue_item, 1);
-  db_query_end(&qp);
+  queue_enum_end(&qp);
   sqlite3_free(qp.filter);
   db_transaction_end();
 
+  if (ret == 0)
+    queue_item_pos_set(queue_item, NULL);
+
+  queue_unlock();
+
   if (ret < 0)
     {
       free_queue_item(queue_item, 0);
@@ -5353,26 +7289,7 @@ db_queue_fetch_byfileid(uint32_t file_id)
 static int
 queue_fetch_bypos(uint32_t pos, char shuffle, struct db_queue_item *queue_item, int with_metadata)
 {
-  struct query_params qp;
-  int ret;
-
-  memset(&qp, 0, sizeof(struct query_params));
-  if (shuffle)
-    qp.filter = sqlite3_mprintf("shuffle_pos = %d", pos);
-  else
-    qp.filter = sqlite3_mprintf("pos = %d", pos);
-
-  ret = queue_enum_start(&qp);
-  if (ret < 0)
-    {
-      sqlite3_free(qp.filter);
-      return -1;
-    }
-
-  ret = queue_enum_fetch(&qp, queue_item, with_metadata);
-  db_query_end(&qp);
-  sqlite3_free(qp.filter);
-  return ret;
+  return queue_fetch_bynode(queue_tree_at(pos, shuffle ? QUEUE_ORDER_SHUFFLE : QUEUE_ORDER_POS), queue_item, with_metadata);
 }
 
 struct db_queue_item *
@@ -5388,9 +7305,15 @@ db_queue_fetch_bypos(uint32_t pos, char shuffle)
       return NULL;
     }
 
-  db_transaction_begin();
-  ret = queue_fetch_bypos(pos, shuffle, queue_item, 1);
-  db_transaction_end();
+  queue_lock();
+  ret = queue_model_prepare();
+  if (ret == 0)
+    {
+      db_transaction_begin();
+      ret = queue_fetch_bypos(pos, shuffle, queue_item, 1);
+      db_transaction_end();
+    }
+  queue_unlock();
 
   if (ret < 0)
     {
@@ -5408,25 +7331,48 @@ db_queue_fetch_bypos(uint32_t pos, char shuffle)
   return queue_item;
 }
 
+// Returns the node at the position relative to the given item, sets *node to NULL if there is none
 static int
-queue_fetch_byposrelativetoitem(int pos, uint32_t item_id, char shuffle, struct db_queue_item *queue_item, int with_metadata)
+queue_node_byposrelativetoitem(struct queue_node **node, int pos, uint32_t item_id, char shuffle)
 {
+  struct queue_node *base;
+  int order;
   int pos_absolute;
-  int ret;
 
-  DPRINTF(E_DBG, L_DB, "Fetch by pos: pos (%d) relative to item with id (%d)\n", pos, item_id);
+  *node = NULL;
 
-  pos_absolute = db_queue_get_pos(item_id, shuffle);
-  if (pos_absolute < 0)
+  base = queue_model_lookup(item_id);
+  if (!base)
     {
+      DPRINTF(E_LOG, L_DB, "Error fetching item by pos: item with id (%d) not in queue\n", item_id);
       return -1;
     }
 
+  order = shuffle ? QUEUE_ORDER_SHUFFLE : QUEUE_ORDER_POS;
+  pos_absolute = queue_tree_rank(base, order);
+
   DPRINTF(E_DBG, L_DB, "Fetch by pos: item (%d) has absolute pos %d\n", item_id, pos_absolute);
 
   pos_absolute += pos;
+  if (pos_absolute >= 0)
+    *node = queue_tree_at(pos_absolute, order);
+
+  return 0;
+}
+
+static int
+queue_fetch_byposrelativetoitem(int pos, uint32_t item_id, char shuffle, struct db_queue_item *queue_item, int with_metadata)
+{
+  struct queue_node *node;
+  int ret;
+
+  DPRINTF(E_DBG, L_DB, "Fetch by pos: pos (%d) relative to item with id (%d)\n", pos, item_id);
+
+  ret = queue_node_byposrelativetoitem(&node, pos, item_id, shuffle);
+  if (ret < 0)
+    return -1;
 
-  ret = queue_fetch_bypos(pos_absolute, shuffle, queue_item, with_metadata);
+  ret = queue_fetch_bynode(node, queue_item, with_metadata);
 
   if (ret < 0)
     DPRINTF(E_LOG, L_DB, "Error fetching item by pos: pos (%d) relative to item with id (%d)\n", pos, item_id);
@@ -5451,11 +7397,15 @@ db_queue_fetch_byposrelativetoitem(int pos, uint32_t item_id, char shuffle)
       return NULL;
     }
 
-  db_transaction_begin();
-
-  ret = queue_fetch_byposrelativetoitem(pos, item_id, shuffle, queue_item, 1);
-
-  db_transaction_end();
+  queue_lock();
+  ret = queue_model_prepare();
+  if (ret == 0)
+    {
+      db_transaction_begin();
+      ret = queue_fetch_byposrelativetoitem(pos, item_id, shuffle, queue_item, 1);
+      db_transaction_end();
+    }
+  queue_unlock();
 
   if (ret < 0)
     {
@@ -5481,57 +7431,10 @@ db_queue_fetch_next(uint32_t item_id, char shuffle)
   return db_queue_fetch_byposrelativetoitem(1, item_id, shuffle);
 }
 
-struct db_queue_item *
-db_queue_fetch_prev(uint32_t item_id, char shuffle)
-{
-  return db_queue_fetch_byposrelativetoitem(-1, item_id, shuffle);
-}
-
-static int
-queue_fix_pos(enum sort_type sort, int queue_version)
-{
-#define Q_TMPL "UPDATE queue SET %q = %d, queue_version = %d WHERE id = %d and %q <> %d;"
-
-  struct query_params qp;
-  struct db_queue_item queue_item;
-  char *query;
-  int pos;
-  int ret;
-
-  memset(&qp, 0, sizeof(struct query_params));
-  qp.sort = sort;
-
-  ret = queue_enum_start(&qp);
-  if (ret < 0)
-    {
-      return -1;
-    }
-
-  pos = 0;
-  while ((ret = queue_enum_fetch(&qp, &queue_item, 0)) == 0 && (queue_item.id > 0))
-    {
-      if (queue_item.pos != pos)
-        {
-	  if (sort == S_SHUFFLE_POS)
-	    query = sqlite3_mprintf(Q_TMPL, "shuffle_pos", pos, queue_version, queue_item.id, "shuffle_pos", pos);
-	  else
-	    query = sqlite3_mprintf(Q_TMPL, "pos", pos, queue_version, queue_item.id, "pos", pos);
-
-	  ret = db_query_run(query, 1, 0);
-	  if (ret < 0)
-	    {
-	      DPRINTF(E_LOG, L_DB, "Failed to update item with item-id: %d\n", queue_item.id);
-	      break;
-	    }
-	}
-
-      pos++;
-    }
-
-  db_query_end(&qp);
-  return ret;
-
-#undef Q_TMPL
+struct db_queue_item *
+db_queue_fetch_prev(uint32_t item_id, char shuffle)
+{
+  return db_queue_fetch_byposrelativetoitem(-1, item_id, shuffle);
 }
 
 /*
@@ -5541,39 +7444,64 @@ queue_fix_pos(enum sort_type sort, int queue_version)
 int
 db_queue_cleanup()
 {
+#define Q_TMPL_SELECT "SELECT id FROM queue WHERE NOT file_id IN (SELECT id from files WHERE disabled = 0);"
 #define Q_TMPL "DELETE FROM queue WHERE NOT file_id IN (SELECT id from files WHERE disabled = 0);"
 
+  struct queue_node *node;
+  sqlite3_stmt *stmt;
   int queue_version;
   int deleted;
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
-  ret = db_query_run(Q_TMPL, 0, 0);
-  if (ret < 0)
-    goto end_transaction;
+  // Remove the items from the queue order, which closes the gaps they leave
+  ret = db_blocking_prepare_v2(Q_TMPL_SELECT, -1, &stmt, NULL);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not prepare statement: %s\n", sqlite3_errmsg(hdl));
+      ret = -1;
+      goto end_transaction;
+    }
 
-  deleted = sqlite3_changes(hdl);
-  if (deleted <= 0)
+  deleted = 0;
+  while ((ret = db_blocking_step(stmt)) == SQLITE_ROW)
+    {
+      node = queue_model_lookup(sqlite3_column_int(stmt, 0));
+      if (!node)
+	continue;
+
+      queue_model_remove(node);
+      queue_model_changed(queue_version);
+      deleted++;
+    }
+
+  sqlite3_finalize(stmt);
+
+  if (ret != SQLITE_DONE)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not step: %s\n", sqlite3_errmsg(hdl));
+      ret = -1;
+      goto end_transaction;
+    }
+
+  if (deleted == 0)
     {
       // Nothing to do
-      db_transaction_end();
+      queue_transaction_end_unchanged();
       return 0;
     }
 
-  // Update position of normal queue
-  ret = queue_fix_pos(S_POS, queue_version);
-  if (ret < 0)
-    goto end_transaction;
-
-  // Update position of shuffle queue
-  ret = queue_fix_pos(S_SHUFFLE_POS, queue_version);
+  ret = db_query_run(Q_TMPL, 0, 0);
 
  end_transaction:
   queue_transaction_end(ret, queue_version);
 
   return ret;
 
+#undef Q_TMPL_SELECT
 #undef Q_TMPL
 }
 
@@ -5585,55 +7513,58 @@ db_queue_cleanup()
 int
 db_queue_clear(uint32_t keep_item_id)
 {
+  struct queue_node *node;
+  struct queue_node *next;
   int queue_version;
+  uint32_t i;
   char *query;
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
   query = sqlite3_mprintf("DELETE FROM queue where id <> %d;", keep_item_id);
   ret = db_query_run(query, 1, 0);
+  if (ret < 0)
+    goto end_transaction;
 
-  if (ret == 0 && keep_item_id)
+  // The kept item ends up at position 0, which is written with the next flush
+  for (i = 0; i < queue_model.hash_size; i++)
     {
-      query = sqlite3_mprintf("UPDATE queue SET pos = 0, shuffle_pos = 0, queue_version = %d where id = %d;", queue_version, keep_item_id);
-      ret = db_query_run(query, 1, 0);
+      for (node = queue_model.hash[i]; node; node = next)
+	{
+	  next = node->hash_next;
+	  if (node->id != keep_item_id)
+	    queue_model_remove(node);
+	}
     }
 
+  queue_model_changed(queue_version);
+
+ end_transaction:
   queue_transaction_end(ret, queue_version);
 
   return ret;
 }
 
 static int
-queue_delete_item(struct db_queue_item *queue_item, int queue_version)
+queue_delete_item(struct queue_node *node, int queue_version)
 {
   char *query;
   int ret;
 
   // Remove item with the given item_id
-  query = sqlite3_mprintf("DELETE FROM queue where id = %d;", queue_item->id);
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    {
-      return -1;
-    }
-
-  // Update pos for all items after the item with given item_id
-  query = sqlite3_mprintf("UPDATE queue SET pos = pos - 1, queue_version = %d WHERE pos > %d;", queue_version, queue_item->pos);
+  query = sqlite3_mprintf("DELETE FROM queue where id = %d;", node->id);
   ret = db_query_run(query, 1, 0);
   if (ret < 0)
     {
       return -1;
     }
 
-  // Update shuffle_pos for all items after the item with given item_id
-  query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = shuffle_pos - 1, queue_version = %d WHERE shuffle_pos > %d;", queue_version, queue_item->shuffle_pos);
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    {
-      return -1;
-    }
+  // Items after it move up in both orders
+  queue_model_remove(node);
+  queue_model_changed(queue_version);
 
   return 0;
 }
@@ -5641,26 +7572,23 @@ queue_delete_item(struct db_queue_item *queue_item, int queue_version)
 int
 db_queue_delete_byitemid(uint32_t item_id)
 {
+  struct queue_node *node;
   int queue_version;
-  struct db_queue_item queue_item;
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
-  ret = queue_fetch_byitemid(item_id, &queue_item, 0);
-
-  if (ret < 0)
-    goto end_transaction;
-
-  if (queue_item.id == 0)
+  node = queue_model_lookup(item_id);
+  if (!node)
     {
-      db_transaction_end();
+      queue_transaction_end_unchanged();
       return 0;
     }
 
-  ret = queue_delete_item(&queue_item, queue_version);
+  ret = queue_delete_item(node, queue_version);
 
- end_transaction:
   queue_transaction_end(ret, queue_version);
 
   return ret;
@@ -5669,27 +7597,28 @@ db_queue_delete_byitemid(uint32_t item_id)
 int
 db_queue_delete_bypos(uint32_t pos, int count)
 {
+  struct queue_node *node;
   int queue_version;
-  char *query;
-  int to_pos;
+  int i;
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
-  // Remove item with the given item_id
-  to_pos = pos + count;
-  query = sqlite3_mprintf("DELETE FROM queue where pos >= %d AND pos < %d;", pos, to_pos);
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  ret = queue_fix_pos(S_POS, queue_version);
-  if (ret < 0)
-    goto end_transaction;
+  // Remove the items from the given pos, each following item moves up to it
+  ret = 0;
+  for (i = 0; i < count; i++)
+    {
+      node = queue_tree_at(pos, QUEUE_ORDER_POS);
+      if (!node)
+	break;
 
-  ret = queue_fix_pos(S_SHUFFLE_POS, queue_version);
+      ret = queue_delete_item(node, queue_version);
+      if (ret < 0)
+	break;
+    }
 
- end_transaction:
   queue_transaction_end(ret, queue_version);
 
   return ret;
@@ -5698,24 +7627,26 @@ db_queue_delete_bypos(uint32_t pos, int count)
 int
 db_queue_delete_byposrelativetoitem(uint32_t pos, uint32_t item_id, char shuffle)
 {
+  struct queue_node *node;
   int queue_version;
-  struct db_queue_item queue_item;
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
-  ret = queue_fetch_byposrelativetoitem(pos, item_id, shuffle, &queue_item, 0);
+  ret = queue_node_byposrelativetoitem(&node, pos, item_id, shuffle);
   if (ret < 0)
     goto end_transaction;
 
-  if (queue_item.id == 0)
+  if (!node)
     {
       // No item found
-      db_transaction_end();
+      queue_transaction_end_unchanged();
       return 0;
     }
 
-  ret = queue_delete_item(&queue_item, queue_version);
+  ret = queue_delete_item(node, queue_version);
 
  end_transaction:
   queue_transaction_end(ret, queue_version);
@@ -5734,48 +7665,25 @@ db_queue_delete_byposrelativetoitem(uint32_t pos, uint32_t item_id, char shuffle
 int
 db_queue_move_byitemid(uint32_t item_id, int pos_to, char shuffle)
 {
+  struct queue_node *node;
   int queue_version;
-  char *query;
-  int pos_from;
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
   // Find item with the given item_id
-  pos_from = db_queue_get_pos(item_id, shuffle);
-  if (pos_from < 0)
+  node = queue_model_lookup(item_id);
+  if (!node || pos_to < 0)
     {
       ret = -1;
       goto end_transaction;
     }
 
-  // Update pos for all items after the item with given item_id
-  if (shuffle)
-    query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = shuffle_pos - 1, queue_version = %d WHERE shuffle_pos > %d;", queue_version, pos_from);
-  else
-    query = sqlite3_mprintf("UPDATE queue SET pos = pos - 1, queue_version = %d WHERE pos > %d;", queue_version, pos_from);
-
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  // Update pos for all items from the given pos_to
-  if (shuffle)
-    query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = shuffle_pos + 1, queue_version = %d WHERE shuffle_pos >= %d;", queue_version, pos_to);
-  else
-    query = sqlite3_mprintf("UPDATE queue SET pos = pos + 1, queue_version = %d WHERE pos >= %d;", queue_version, pos_to);
-
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  // Update item with the given item_id
-  if (shuffle)
-    query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = %d, queue_version = %d where id = %d;", pos_to, queue_version, item_id);
-  else
-    query = sqlite3_mprintf("UPDATE queue SET pos = %d, queue_version = %d where id = %d;", pos_to, queue_version, item_id);
-
-  ret = db_query_run(query, 1, 0);
+  queue_model_move(node, pos_to, shuffle ? QUEUE_ORDER_SHUFFLE : QUEUE_ORDER_POS);
+  queue_model_changed(queue_version);
+  ret = 0;
 
  end_transaction:
   queue_transaction_end(ret, queue_version);
@@ -5793,44 +7701,27 @@ db_queue_move_byitemid(uint32_t item_id, int pos_to, char shuffle)
 int
 db_queue_move_bypos(int pos_from, int pos_to)
 {
+  struct queue_node *node;
   int queue_version;
-  struct db_queue_item queue_item;
-  char *query;
-  int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
   // Find item to move
-  ret = queue_fetch_bypos(pos_from, 0, &queue_item, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  if (queue_item.id == 0)
+  node = (pos_from >= 0) ? queue_tree_at(pos_from, QUEUE_ORDER_POS) : NULL;
+  if (!node)
     {
-      db_transaction_end();
+      queue_transaction_end_unchanged();
       return 0;
     }
 
-  // Update pos for all items after the item with given position
-  query = sqlite3_mprintf("UPDATE queue SET pos = pos - 1, queue_version = %d WHERE pos > %d;", queue_version, queue_item.pos);
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  // Update pos for all items from the given pos_to
-  query = sqlite3_mprintf("UPDATE queue SET pos = pos + 1, queue_version = %d WHERE pos >= %d;", queue_version, pos_to);
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  // Update item with the given item_id
-  query = sqlite3_mprintf("UPDATE queue SET pos = %d, queue_version = %d where id = %d;", pos_to, queue_version, queue_item.id);
-  ret = db_query_run(query, 1, 0);
+  queue_model_move(node, MAX(pos_to, 0), QUEUE_ORDER_POS);
+  queue_model_changed(queue_version);
 
- end_transaction:
-  queue_transaction_end(ret, queue_version);
+  queue_transaction_end(0, queue_version);
 
-  return ret;
+  return 0;
 }
 
 /*
@@ -5845,41 +7736,37 @@ db_queue_move_bypos(int pos_from, int pos_to)
 int
 db_queue_move_byposrelativetoitem(uint32_t from_pos, uint32_t to_offset, uint32_t item_id, char shuffle)
 {
+  struct queue_node *node;
   int queue_version;
-  struct db_queue_item queue_item;
-  char *query;
+  int order;
+  int pos_base;
   int pos_move_from;
   int pos_move_to;
-  int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
   DPRINTF(E_DBG, L_DB, "Move by pos: from %d offset %d relative to item (%d)\n", from_pos, to_offset, item_id);
 
   // Find item with the given item_id
-  ret = queue_fetch_byitemid(item_id, &queue_item, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  DPRINTF(E_DBG, L_DB, "Move by pos: base item (id=%d, pos=%d, file-id=%d)\n", queue_item.id, queue_item.pos, queue_item.file_id);
-
-  if (queue_item.id == 0)
+  node = queue_model_lookup(item_id);
+  if (!node)
     {
-      db_transaction_end();
+      queue_transaction_end_unchanged();
       return 0;
     }
 
+  order = shuffle ? QUEUE_ORDER_SHUFFLE : QUEUE_ORDER_POS;
+  pos_base = queue_tree_rank(node, order);
+
+  DPRINTF(E_DBG, L_DB, "Move by pos: base item (id=%d, pos=%d)\n", node->id, pos_base);
+
   // Calculate the position of the item to move
-  if (shuffle)
-    pos_move_from = queue_item.shuffle_pos + from_pos;
-  else
-    pos_move_from = queue_item.pos + from_pos;
+  pos_move_from = pos_base + from_pos;
 
   // Calculate the position where to move the item to
-  if (shuffle)
-    pos_move_to = queue_item.shuffle_pos + to_offset;
-  else
-    pos_move_to = queue_item.pos + to_offset;
+  pos_move_to = pos_base + to_offset;
 
   if (pos_move_to < pos_move_from)
     {
@@ -5892,50 +7779,21 @@ db_queue_move_byposrelativetoitem(uint32_t from_pos, uint32_t to_offset, uint32_
   DPRINTF(E_DBG, L_DB, "Move by pos: absolute pos: move from %d to %d\n", pos_move_from, pos_move_to);
 
   // Find item to move
-  ret = queue_fetch_bypos(pos_move_from, shuffle, &queue_item, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  DPRINTF(E_DBG, L_DB, "Move by pos: move item (id=%d, pos=%d, file-id=%d)\n", queue_item.id, queue_item.pos, queue_item.file_id);
-
-  if (queue_item.id == 0)
+  node = (pos_move_from >= 0) ? queue_tree_at(pos_move_from, order) : NULL;
+  if (!node)
     {
-      db_transaction_end();
+      queue_transaction_end_unchanged();
       return 0;
     }
 
-  // Update pos for all items after the item with given position
-  if (shuffle)
-    query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = shuffle_pos - 1, queue_version = %d WHERE shuffle_pos > %d;", queue_version, queue_item.shuffle_pos);
-  else
-    query = sqlite3_mprintf("UPDATE queue SET pos = pos - 1, queue_version = %d WHERE pos > %d;", queue_version, queue_item.pos);
-
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  // Update pos for all items from the given pos_to
-  if (shuffle)
-    query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = shuffle_pos + 1, queue_version = %d WHERE shuffle_pos >= %d;", queue_version, pos_move_to);
-  else
-    query = sqlite3_mprintf("UPDATE queue SET pos = pos + 1, queue_version = %d WHERE pos >= %d;", queue_version, pos_move_to);
-
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    goto end_transaction;
-
-  // Update item with the given item_id
-  if (shuffle)
-    query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = %d, queue_version = %d where id = %d;", pos_move_to, queue_version, queue_item.id);
-  else
-    query = sqlite3_mprintf("UPDATE queue SET pos = %d, queue_version = %d where id = %d;", pos_move_to, queue_version, queue_item.id);
+  DPRINTF(E_DBG, L_DB, "Move by pos: move item (id=%d, pos=%d)\n", node->id, pos_move_from);
 
-  ret = db_query_run(query, 1, 0);
+  queue_model_move(node, MAX(pos_move_to, 0), order);
+  queue_model_changed(queue_version);
 
- end_transaction:
-  queue_transaction_end(ret, queue_version);
+  queue_transaction_end(0, queue_version);
 
-  return ret;
+  return 0;
 }
 
 /*
@@ -5950,43 +7808,38 @@ db_queue_move_byposrelativetoitem(uint32_t from_pos, uint32_t to_offset, uint32_
 static int
 queue_reshuffle(uint32_t item_id, int queue_version)
 {
-  char *query;
-  int pos;
-  uint32_t count;
-  struct db_queue_item queue_item;
+  struct queue_node **nodes;
+  struct queue_node *node;
+  struct queue_undo *undo;
   int *shuffle_pos;
+  uint32_t count;
+  int pos;
   int len;
   int i;
-  struct query_params qp;
-  int ret;
 
   DPRINTF(E_DBG, L_DB, "Reshuffle queue after item with item-id: %d\n", item_id);
 
-  // Reset the shuffled order and mark all items as changed
-  query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = pos, queue_version = %d;", queue_version);
-  ret = db_query_run(query, 1, 0);
-  if (ret < 0)
-    return -1;
-
   pos = 0;
   if (item_id > 0)
     {
-      pos = db_queue_get_pos(item_id, 0);
-      if (pos < 0)
+      node = queue_model_lookup(item_id);
+      if (!node)
 	return -1;
 
-      pos++; // Do not reshuffle the base item
+      pos = queue_tree_rank(node, QUEUE_ORDER_POS) + 1; // Do not reshuffle the base item
     }
 
-  ret = db_queue_get_count(&count);
-  if (ret < 0)
-    return -1;
-
+  count = queue_model.count;
   len = count - pos;
 
   DPRINTF(E_DBG, L_DB, "Reshuffle %d items off %" PRIu32 " total items, starting from pos %d\n", len, count, pos);
 
-  shuffle_pos = malloc(len * sizeof(int));
+  if (count == 0)
+    return 0;
+
+  CHECK_NULL(L_DB, nodes = malloc(count * sizeof(struct queue_node *)));
+  CHECK_NULL(L_DB, shuffle_pos = malloc(MAX(len, 1) * sizeof(int)));
+
   for (i = 0; i < len; i++)
     {
       shuffle_pos[i] = i + pos;
@@ -5994,35 +7847,27 @@ queue_reshuffle(uint32_t item_id, int queue_version)
 
   shuffle_int(&shuffle_rng, shuffle_pos, len);
 
-  memset(&qp, 0, sizeof(struct query_params));
-  qp.filter = sqlite3_mprintf("pos >= %d", pos);
+  // The shuffled order is the normal order up to the base item, followed by a permutation of the rest
+  count = 0;
+  queue_tree_collect(queue_model.root[QUEUE_ORDER_POS], QUEUE_ORDER_POS, nodes, &count);
 
-  ret = queue_enum_start(&qp);
-  if (ret < 0)
+  undo = queue_undo_push(QUEUE_UNDO_SHUFFLE, NULL);
+  if (undo)
     {
-      sqlite3_free(qp.filter);
-      return -1;
+      CHECK_NULL(L_DB, undo->nodes = malloc(count * sizeof(struct queue_node *)));
+      queue_tree_collect(queue_model.root[QUEUE_ORDER_SHUFFLE], QUEUE_ORDER_SHUFFLE, undo->nodes, &undo->nnodes);
     }
 
-  i = 0;
-  while ((ret = queue_enum_fetch(&qp, &queue_item, 0)) == 0 && (queue_item.id > 0) && (i < len))
-    {
-      query = sqlite3_mprintf("UPDATE queue SET shuffle_pos = %d where id = %d;", shuffle_pos[i], queue_item.id);
-      ret = db_query_run(query, 1, 0);
-      if (ret < 0)
-	{
-	  DPRINTF(E_LOG, L_DB, "Failed to delete item with item-id: %d\n", queue_item.id);
-	  break;
-	}
-
-      i++;
-    }
+  queue_model.root[QUEUE_ORDER_SHUFFLE] = NULL;
+  for (i = 0; i < pos; i++)
+    queue_tree_insert(nodes[i], i, QUEUE_ORDER_SHUFFLE);
+  for (i = 0; i < len; i++)
+    queue_tree_insert(nodes[shuffle_pos[i]], pos + i, QUEUE_ORDER_SHUFFLE);
 
-  db_query_end(&qp);
-  sqlite3_free(qp.filter);
+  queue_model_changed(queue_version);
 
-  if (ret < 0)
-    return -1;
+  free(shuffle_pos);
+  free(nodes);
 
   return 0;
 }
@@ -6043,6 +7888,8 @@ db_queue_reshuffle(uint32_t item_id)
   int ret;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
 
   ret = queue_reshuffle(item_id, queue_version);
 
@@ -6060,6 +7907,9 @@ db_queue_inc_version()
   int queue_version;
 
   queue_version = queue_transaction_begin();
+  if (queue_version < 0)
+    return -1;
+
   queue_transaction_end(0, queue_version);
 
   return 0;
@@ -6068,16 +7918,18 @@ db_queue_inc_version()
 int
 db_queue_get_count(uint32_t *nitems)
 {
-  int ret = db_get_one_int("SELECT COUNT(*) FROM queue;");
+  int ret;
 
-  if (ret < 0)
-    return -1;
+  queue_lock();
 
-  *nitems = (uint32_t)ret;
+  ret = queue_model_prepare();
+  if (ret == 0)
+    *nitems = queue_model.count;
 
-  return 0;
-}
+  queue_unlock();
 
+  return ret;
+}
 
 /* Inotify */
 int
@@ -6804,6 +8656,18 @@ db_open(void)
       return -1;
     }
 
+  // Positions of the in-memory queue order, see queue_enum_start()
+  ret = sqlite3_create_function(hdl, "queue_pos", 3, SQLITE_UTF8, NULL, queue_pos_xfunc, NULL, NULL);
+  if (ret == SQLITE_OK)
+    ret = sqlite3_create_function(hdl, "queue_pos_version", 2, SQLITE_UTF8, NULL, queue_pos_version_xfunc, NULL, NULL);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not create queue functions: %s\n", sqlite3_errmsg(hdl));
+
+      sqlite3_close(hdl);
+      return -1;
+    }
+
 #ifdef DB_PROFILE
   sqlite3_trace_v2(hdl, SQLITE_TRACE_PROFILE, db_xprofile, NULL);
 #endif
@@ -7047,13 +8911,28 @@ void
 db_perthread_deinit(void)
 {
   sqlite3_stmt *stmt;
+  sqlite3_stmt *next;
+  const char *sql;
 
   if (!hdl)
     return;
 
-  /* Tear down anything that's in flight */
-  while ((stmt = sqlite3_next_stmt(hdl, 0)))
-    sqlite3_finalize(stmt);
+  /* Tear down anything that's in flight, including the statement cache. The
+   * statements of the files_fts virtual table belong to FTS5, which finalizes
+   * them itself when the connection is closed (they are the only ones that
+   * name the schema, e.g. 'main'.'files_fts_data').
+   */
+  db_stmt_cache_n = 0;
+  for (stmt = sqlite3_next_stmt(hdl, NULL); stmt; stmt = next)
+    {
+      next = sqlite3_next_stmt(hdl, stmt);
+
+      sql = sqlite3_sql(stmt);
+      if (sql && strstr(sql, "'main'."))
+	continue;
+
+      sqlite3_finalize(stmt);
+    }
 
   sqlite3_close(hdl);
 }
@@ -7192,12 +9071,56 @@ db_check_version(void)
 #undef Q_VACUUM
 }
 
+/*
+ * The full text index needs SQLite 3.34 built with FTS5 (for the trigram
+ * tokenizer). Without it, the library search falls back to LIKE. The admin
+ * table tracks if the index is kept up to date, so it is rebuilt when it is
+ * enabled again after running with an SQLite that could not maintain it.
+ */
+static int
+db_search_index_init(void)
+{
+  int enabled = 0;
+  int ret;
+
+  db_search_fts = db_init_fts_supported(hdl);
+  db_admin_getint(&enabled, DB_ADMIN_SEARCH_INDEX);
+
+  if (!db_search_fts)
+    {
+      DPRINTF(E_LOG, L_DB, "SQLite3 %s does not support FTS5 with the trigram tokenizer, library search will be slower\n", sqlite3_libversion());
+
+      // Triggers left by an SQLite that had FTS5 would make changes to files fail
+      ret = db_deinit_fts(hdl);
+      if (ret < 0)
+	return -1;
+
+      if (!enabled)
+	return 0;
+
+      return db_admin_setint(DB_ADMIN_SEARCH_INDEX, 0);
+    }
+
+  if (!enabled)
+    DPRINTF(E_LOG, L_DB, "Building library search index, this may take some time...\n");
+
+  ret = db_init_fts(hdl, !enabled);
+  if (ret < 0)
+    return -1;
+
+  if (enabled)
+    return 0;
+
+  return db_admin_setint(DB_ADMIN_SEARCH_INDEX, 1);
+}
+
 int
 db_init(void)
 {
   uint32_t files;
   uint32_t pls;
   int ret;
+  int i;
 
   if (ARRAY_SIZE(dbmfi_cols_map) != ARRAY_SIZE(mfi_cols_map))
     {
@@ -7205,6 +9128,17 @@ db_init(void)
       return -1;
     }
 
+  // The NULL columns of a fetched row are a bit mask, see db_query_fetch_file()
+  if (ARRAY_SIZE(dbmfi_cols_map) > 64)
+    {
+      DPRINTF(E_FATAL, L_DB, "BUG: too many columns in dbmfi column map\n");
+      return -1;
+    }
+
+  memset(dbmfi_col_index, -1, sizeof(dbmfi_col_index));
+  for (i = 0; i < ARRAY_SIZE(dbmfi_cols_map); i++)
+    dbmfi_col_index[dbmfi_cols_map[i]] = i;
+
   if (ARRAY_SIZE(dbpli_cols_map) != ARRAY_SIZE(pli_cols_map))
     {
       DPRINTF(E_FATAL, L_DB, "BUG: pli column maps are not in sync\n");
@@ -7266,6 +9200,14 @@ db_init(void)
 	}
     }
 
+  ret = db_search_index_init();
+  if (ret < 0)
+    {
+      DPRINTF(E_FATAL, L_DB, "Could not set up the library search index\n");
+      db_perthread_deinit();
+      return -1;
+    }
+
   db_set_cfg_names();
 
   CHECK_ERR(L_DB, db_files_get_count(&files, NULL, NULL));
@@ -7279,11 +9221,22 @@ db_init(void)
 
   rng_init(&shuffle_rng);
 
+  CHECK_ERR(L_DB, mutex_init(&queue_model.lck));
+  CHECK_ERR(L_DB, mutex_init(&queue_model.flush_lck));
+  queue_model.prio_state = (uint32_t)time(NULL) | 1;
+
   return 0;
 }
 
 void
 db_deinit(void)
 {
+  queue_model_reset();
+  free(queue_model.undo);
+  queue_snapshot_unref(queue_snapshot_cached);
+  queue_snapshot_cached = NULL;
+  CHECK_ERR(L_DB, pthread_mutex_destroy(&queue_model.flush_lck));
+  CHECK_ERR(L_DB, pthread_mutex_destroy(&queue_model.lck));
+
   sqlite3_shutdown();
 }
@@ -16,6 +16,12 @@ enum index_type {
   I_SUB
 };
 
+enum db_search_type {
+  DB_SEARCH_SUBSTRING,
+  DB_SEARCH_WORDS,
+  DB_SEARCH_FUZZY
+};
+
 // Keep in sync with sort_clause[]
 enum sort_type {
   S_NONE = 0,
@@ -72,6 +78,7 @@ enum query_type {
 #define DB_ADMIN_START_TIME "start_time"
 #define DB_ADMIN_LASTFM_SESSION_KEY "lastfm_sk"
 #define DB_ADMIN_SPOTIFY_REFRESH_TOKEN "spotify_refresh_token"
+#define DB_ADMIN_SEARCH_INDEX "search_index"
 
 /* Max value for media_file_info->rating (valid range is from 0 to 100) */
 #define DB_FILES_RATING_MAX 100
@@ -102,10 +109,16 @@ struct query_params {
 
   /* Private query context, keep out */
   void *stmt;
+  int step_result;
   char buf1[32];
   char buf2[32];
 };
 
+struct db_stmt_cache_stats {
+  uint64_t hits;
+  uint64_t misses;
+};
+
 struct pairing_info {
   char *remote_id;
   char *name;
@@ -329,12 +342,18 @@ struct db_group_info {
 
 #define dbgri_offsetof(field) offsetof(struct db_group_info, field)
 
+/* A row from the files table as returned by db_query_fetch_file(). Integer
+ * columns are fetched as int64_t, so that generic code (like the DMAP encoder)
+ * only needs to know if a field is text or an integer (dbmfi_col_is_int). The
+ * strings point to memory owned by sqlite and are only valid until the next
+ * fetch. A NULL integer column is 0, dbmfi_col_is_null() tells them apart.
+ */
 struct db_media_file_info {
-  char *id;
+  int64_t id;
   char *path;
   char *virtual_path;
   char *fname;
-  char *directory_id;
+  int64_t directory_id;
   char *title;
   char *artist;
   char *album;
@@ -347,52 +366,55 @@ struct db_media_file_info {
   char *conductor;
   char *grouping;
   char *url;
-  char *bitrate;
-  char *samplerate;
-  char *song_length;
-  char *file_size;
-  char *year;
-  char *date_released;
-  char *track;
-  char *total_tracks;
-  char *disc;
-  char *total_discs;
-  char *bpm;
-  char *compilation;
-  char *artwork;
-  char *rating;
-  char *play_count;
-  char *skip_count;
-  char *seek;
-  char *data_kind;
-  char *media_kind;
-  char *item_kind;
+  int64_t bitrate;
+  int64_t samplerate;
+  int64_t song_length;
+  int64_t file_size;
+  int64_t year;
+  int64_t date_released;
+  int64_t track;
+  int64_t total_tracks;
+  int64_t disc;
+  int64_t total_discs;
+  int64_t bpm;
+  int64_t compilation;
+  int64_t artwork;
+  int64_t rating;
+  int64_t play_count;
+  int64_t skip_count;
+  int64_t seek;
+  int64_t data_kind;
+  int64_t media_kind;
+  int64_t item_kind;
   char *description;
-  char *db_timestamp;
-  char *time_added;
-  char *time_modified;
-  char *time_played;
-  char *time_skipped;
-  char *disabled;
-  char *sample_count;
+  int64_t db_timestamp;
+  int64_t time_added;
+  int64_t time_modified;
+  int64_t time_played;
+  int64_t time_skipped;
+  int64_t disabled;
+  int64_t sample_count;
   char *codectype;
-  char *idx;
-  char *has_video;
-  char *contentrating;
-  char *bits_per_sample;
-  char *tv_episode_sort;
-  char *tv_season_num;
+  int64_t idx;
+  int64_t has_video;
+  int64_t contentrating;
+  int64_t bits_per_sample;
+  int64_t tv_episode_sort;
+  int64_t tv_season_num;
   char *tv_series_name;
   char *tv_episode_num_str;
   char *tv_network_name;
-  char *songartistid;
-  char *songalbumid;
+  int64_t songartistid;
+  int64_t songalbumid;
   char *title_sort;
   char *artist_sort;
   char *album_sort;
   char *album_artist_sort;
   char *composer_sort;
-  char *channels;
+  int64_t channels;
+
+  // Not a column, bit i is set if column i was NULL
+  uint64_t null_cols;
 };
 
 #define dbmfi_offsetof(field) offsetof(struct db_media_file_info, field)
@@ -443,6 +465,13 @@ struct directory_info {
   uint32_t parent_id;
 };
 
+/* Scan state of a file, see db_file_stamps_bydirectory() */
+struct db_file_stamp {
+  uint32_t id;
+  char *path;
+  int64_t db_timestamp;
+};
+
 struct directory_enum {
   int parent_id;
 
@@ -516,6 +545,10 @@ struct db_queue_add_info
   int shuffle_pos;
   int count;
   int new_item_id;
+
+  // Items added with db_queue_add_item(), written to the queue by db_queue_add_end()
+  struct db_queue_item *items;
+  int items_size;
 };
 
 char *
@@ -527,6 +560,31 @@ db_mprintf(const char *fmt, ...);
 int
 db_snprintf(char *s, int n, const char *fmt, ...);
 
+void
+db_stmt_cache_stats_get(struct db_stmt_cache_stats *stats);
+
+/* Builds a filter for items where field contains value, using the full text
+ * index if field is one of the indexed fields. If field is NULL, any of the
+ * indexed fields may match. With DB_SEARCH_WORDS each word of value must be
+ * found, in any order. DB_SEARCH_FUZZY gives the best partial matches, meant
+ * as a fallback when a search gave nothing, e.g. because of a typo. Returns
+ * NULL if no filter could be made, caller must free the result. */
+char *
+db_search_filter(const char *field, const char *value, enum db_search_type type);
+
+/* Condition selecting the items that may contain value in field (any of the
+ * indexed fields if NULL), for narrowing down a LIKE '%value%' or 'value%'
+ * that the caller still needs to apply. Returns NULL if the index can't help,
+ * caller must free the result. */
+char *
+db_search_prefilter(const char *field, const char *value);
+
+/* ORDER BY clause ranking exact matches of value in field first, then
+ * matches at the start of field, then the rest, each sorted by sort. Caller
+ * must free the result. */
+char *
+db_search_order(const char *field, const char *value, enum sort_type sort);
+
 void
 free_pi(struct pairing_info *pi, int content_only);
 
@@ -575,6 +633,13 @@ db_query_end(struct query_params *qp);
 int
 db_query_fetch_file(struct query_params *qp, struct db_media_file_info *dbmfi);
 
+/* The field of db_media_file_info is given by its dbmfi_offsetof() */
+bool
+dbmfi_col_is_int(size_t offset);
+
+bool
+dbmfi_col_is_null(struct db_media_file_info *dbmfi, size_t offset);
+
 int
 db_query_fetch_pl(struct query_params *qp, struct db_playlist_info *dbpli);
 
@@ -618,6 +683,21 @@ db_file_ping_bypath(const char *path, time_t mtime_max);
 void
 db_file_ping_bymatch(const char *path, int isdir);
 
+int
+db_file_ping_byids(const uint32_t *ids, int nids);
+
+void
+db_file_ping_bydirectory(int dir_id);
+
+int
+db_file_stamps_bydirectory(struct db_file_stamp **stamps, int *nstamps, int dir_id);
+
+struct db_file_stamp *
+db_file_stamp_find(struct db_file_stamp *stamps, int nstamps, const char *path);
+
+void
+db_file_stamps_free(struct db_file_stamp *stamps, int nstamps);
+
 char *
 db_file_path_byid(int id);
 
@@ -679,6 +759,9 @@ db_pl_get_count(uint32_t *nitems);
 void
 db_pl_ping(int id);
 
+void
+db_pl_ping_bydirectory(int dir_id);
+
 void
 db_pl_ping_bymatch(const char *path, int isdir);
 
@@ -757,6 +840,12 @@ db_directory_enum_end(struct directory_enum *de);
 int
 db_directory_addorupdate(char *virtual_path, char *path, int disabled, int parent_id);
 
+time_t
+db_directory_mtime_get(int id);
+
+void
+db_directory_mtime_set(int id, time_t mtime);
+
 void
 db_directory_ping_bymatch(char *virtual_path);
 
@@ -903,6 +992,9 @@ db_queue_get_count(uint32_t *nitems);
 int
 db_queue_get_pos(uint32_t item_id, char shuffle);
 
+void
+db_queue_flush(void);
+
 /* Inotify */
 int
 db_watch_clear(void);
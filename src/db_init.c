@@ -165,7 +165,8 @@
   "   db_timestamp        INTEGER DEFAULT 0,"			\
   "   disabled            INTEGER DEFAULT 0,"			\
   "   parent_id           INTEGER DEFAULT 0,"			\
-  "   path                VARCHAR(4096) DEFAULT NULL"		\
+  "   path                VARCHAR(4096) DEFAULT NULL,"		\
+  "   time_modified       INTEGER DEFAULT 0"			\
   ");"
 
 #define T_QUEUE								\
@@ -432,6 +433,59 @@ static const struct db_init_query db_init_trigger_queries[] =
   };
 
 
+/* Full text index over the searchable text fields of files. The trigram
+ * tokenizer makes a phrase query match any substring of at least three
+ * characters, so the index can stand in for LIKE '%...%'. The content lives
+ * in files, the index is kept in sync by the trg_files_fts_* triggers.
+ *
+ * The index is optional, since it needs SQLite 3.34 built with FTS5. It is not
+ * part of the schema, db_init_fts() creates it if SQLite supports it. */
+#define T_FILES_FTS							\
+  "CREATE VIRTUAL TABLE IF NOT EXISTS files_fts USING fts5("		\
+  "   title, artist, album, album_artist, composer, genre,"		\
+  "   content = 'files', content_rowid = 'id', tokenize = 'trigram'"	\
+  ");"
+
+#define Q_FILES_FTS_REBUILD						\
+  "INSERT INTO files_fts (files_fts) VALUES ('rebuild');"
+
+#define TRG_FILES_FTS_INSERT										\
+  "CREATE TRIGGER IF NOT EXISTS trg_files_fts_insert AFTER INSERT ON files FOR EACH ROW"				\
+  " BEGIN"												\
+  "   INSERT INTO files_fts (rowid, title, artist, album, album_artist, composer, genre)"		\
+  "     VALUES (NEW.id, NEW.title, NEW.artist, NEW.album, NEW.album_artist, NEW.composer, NEW.genre);"	\
+  " END;"
+
+#define TRG_FILES_FTS_DELETE										\
+  "CREATE TRIGGER IF NOT EXISTS trg_files_fts_delete AFTER DELETE ON files FOR EACH ROW"				\
+  " BEGIN"												\
+  "   INSERT INTO files_fts (files_fts, rowid, title, artist, album, album_artist, composer, genre)"	\
+  "     VALUES ('delete', OLD.id, OLD.title, OLD.artist, OLD.album, OLD.album_artist, OLD.composer, OLD.genre);"	\
+  " END;"
+
+#define TRG_FILES_FTS_UPDATE										\
+  "CREATE TRIGGER IF NOT EXISTS trg_files_fts_update AFTER UPDATE OF title, artist, album, album_artist, composer, genre ON files FOR EACH ROW"	\
+  " BEGIN"												\
+  "   INSERT INTO files_fts (files_fts, rowid, title, artist, album, album_artist, composer, genre)"	\
+  "     VALUES ('delete', OLD.id, OLD.title, OLD.artist, OLD.album, OLD.album_artist, OLD.composer, OLD.genre);"	\
+  "   INSERT INTO files_fts (rowid, title, artist, album, album_artist, composer, genre)"		\
+  "     VALUES (NEW.id, NEW.title, NEW.artist, NEW.album, NEW.album_artist, NEW.composer, NEW.genre);"	\
+  " END;"
+
+static const struct db_init_query db_init_fts_queries[] =
+  {
+    { T_FILES_FTS,                 "create table files_fts" },
+    { TRG_FILES_FTS_INSERT,        "create trigger trg_files_fts_insert" },
+    { TRG_FILES_FTS_DELETE,        "create trigger trg_files_fts_delete" },
+    { TRG_FILES_FTS_UPDATE,        "create trigger trg_files_fts_update" },
+  };
+
+// Without the triggers files can be changed even if SQLite can't load files_fts
+#define Q_FILES_FTS_DROP_TRIGGERS					\
+  "DROP TRIGGER IF EXISTS trg_files_fts_insert;"			\
+  "DROP TRIGGER IF EXISTS trg_files_fts_delete;"			\
+  "DROP TRIGGER IF EXISTS trg_files_fts_update;"
+
 int
 db_init_indices(sqlite3 *hdl)
 {
@@ -480,6 +534,80 @@ db_init_triggers(sqlite3 *hdl)
   return 0;
 }
 
+/* Checks if SQLite can create the full text index, i.e. has FTS5 with the
+ * trigram tokenizer. */
+bool
+db_init_fts_supported(sqlite3 *hdl)
+{
+  int ret;
+
+  ret = sqlite3_exec(hdl, "CREATE VIRTUAL TABLE temp.fts_check USING fts5(a, tokenize = 'trigram');", NULL, NULL, NULL);
+  if (ret != SQLITE_OK)
+    return false;
+
+  sqlite3_exec(hdl, "DROP TABLE temp.fts_check;", NULL, NULL, NULL);
+  return true;
+}
+
+/* Creates the full text index and its triggers, if they don't exist. With
+ * rebuild the index is rebuilt from the files table, needed if the files may
+ * have changed while the triggers were missing. */
+int
+db_init_fts(sqlite3 *hdl, bool rebuild)
+{
+  char *errmsg;
+  int i;
+  int ret;
+
+  for (i = 0; i < (sizeof(db_init_fts_queries) / sizeof(db_init_fts_queries[0])); i++)
+    {
+      DPRINTF(E_DBG, L_DB, "DB init fts query: %s\n", db_init_fts_queries[i].desc);
+
+      ret = sqlite3_exec(hdl, db_init_fts_queries[i].query, NULL, NULL, &errmsg);
+      if (ret != SQLITE_OK)
+	{
+	  DPRINTF(E_LOG, L_DB, "DB init error: %s\n", errmsg);
+
+	  sqlite3_free(errmsg);
+	  return -1;
+	}
+    }
+
+  if (!rebuild)
+    return 0;
+
+  ret = sqlite3_exec(hdl, Q_FILES_FTS_REBUILD, NULL, NULL, &errmsg);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not build full text index: %s\n", errmsg);
+
+      sqlite3_free(errmsg);
+      return -1;
+    }
+
+  return 0;
+}
+
+/* Stops maintaining the full text index. The table itself is left alone,
+ * dropping it needs FTS5. */
+int
+db_deinit_fts(sqlite3 *hdl)
+{
+  char *errmsg;
+  int ret;
+
+  ret = sqlite3_exec(hdl, Q_FILES_FTS_DROP_TRIGGERS, NULL, NULL, &errmsg);
+  if (ret != SQLITE_OK)
+    {
+      DPRINTF(E_LOG, L_DB, "Could not drop full text index triggers: %s\n", errmsg);
+
+      sqlite3_free(errmsg);
+      return -1;
+    }
+
+  return 0;
+}
+
 int
 db_init_tables(sqlite3 *hdl)
 {
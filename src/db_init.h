@@ -19,6 +19,7 @@
 #ifndef SRC_DB_INIT_H_
 #define SRC_DB_INIT_H_
 
+#include <stdbool.h>
 #include <sqlite3.h>
 
 /* Rule of thumb: Will the current version of forked-daapd work with the new
@@ -26,7 +27,7 @@
  * is a major upgrade. In other words minor version upgrades permit downgrading
  * forked-daapd after the database was upgraded. */
 #define SCHEMA_VERSION_MAJOR 21
-#define SCHEMA_VERSION_MINOR 04
+#define SCHEMA_VERSION_MINOR 06
 
 int
 db_init_indices(sqlite3 *hdl);
@@ -37,4 +38,13 @@ db_init_triggers(sqlite3 *hdl);
 int
 db_init_tables(sqlite3 *hdl);
 
+bool
+db_init_fts_supported(sqlite3 *hdl);
+
+int
+db_init_fts(sqlite3 *hdl, bool rebuild);
+
+int
+db_deinit_fts(sqlite3 *hdl);
+
 #endif /* SRC_DB_INIT_H_ */
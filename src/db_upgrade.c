@@ -1060,6 +1060,28 @@ static const struct db_upgrade_query db_upgrade_v2104_queries[] =
     { U_v2104_SCVER_MINOR,    "set schema_version_minor to 04" },
   };
 
+// The full text index files_fts is optional and not part of the schema, it is
+// created and built by db_init_fts() if SQLite supports it
+#define U_v2105_SCVER_MINOR                    \
+  "UPDATE admin SET value = '05' WHERE key = 'schema_version_minor';"
+
+static const struct db_upgrade_query db_upgrade_v2105_queries[] =
+  {
+    { U_v2105_SCVER_MINOR,    "set schema_version_minor to 05" },
+  };
+
+#define U_v2106_ALTER_DIRECTORIES_ADD_TIME_MODIFIED \
+  "ALTER TABLE directories ADD COLUMN time_modified INTEGER DEFAULT 0;"
+#define U_v2106_SCVER_MINOR                    \
+  "UPDATE admin SET value = '06' WHERE key = 'schema_version_minor';"
+
+static const struct db_upgrade_query db_upgrade_v2106_queries[] =
+  {
+    { U_v2106_ALTER_DIRECTORIES_ADD_TIME_MODIFIED, "alter table directories add column time_modified" },
+
+    { U_v2106_SCVER_MINOR,    "set schema_version_minor to 06" },
+  };
+
 
 int
 db_upgrade(sqlite3 *hdl, int db_ver)
@@ -1233,6 +1255,20 @@ db_upgrade(sqlite3 *hdl, int db_ver)
 
     case 2103:
       ret = db_generic_upgrade(hdl, db_upgrade_v2104_queries, ARRAY_SIZE(db_upgrade_v2104_queries));
+      if (ret < 0)
+	return -1;
+
+      /* FALLTHROUGH */
+
+    case 2104:
+      ret = db_generic_upgrade(hdl, db_upgrade_v2105_queries, ARRAY_SIZE(db_upgrade_v2105_queries));
+      if (ret < 0)
+	return -1;
+
+      /* FALLTHROUGH */
+
+    case 2105:
+      ret = db_generic_upgrade(hdl, db_upgrade_v2106_queries, ARRAY_SIZE(db_upgrade_v2106_queries));
       if (ret < 0)
 	return -1;
       break;
@@ -211,7 +211,7 @@ dmap_add_string(struct evbuffer *evbuf, const char *tag, const char *str)
 }
 
 void
-dmap_add_field(struct evbuffer *evbuf, const struct dmap_field *df, char *strval, int32_t intval)
+dmap_add_field(struct evbuffer *evbuf, const struct dmap_field *df, char *strval, int64_t intval)
 {
   union {
     int32_t v_i32;
@@ -390,8 +390,8 @@ dmap_encode_file_metadata(struct evbuffer *songlist, struct evbuffer *song, stru
 {
   const struct dmap_field_map *dfm;
   const struct dmap_field *df;
-  char **strval;
-  char *ptr;
+  char *strval;
+  int64_t intval;
   int32_t val;
   int want_mikd;
   int want_asdk;
@@ -458,44 +458,45 @@ dmap_encode_file_metadata(struct evbuffer *songlist, struct evbuffer *song, stru
 
       DPRINTF(E_SPAM, L_DAAP, "Investigating %s\n", df->desc);
 
-      strval = (char **) ((char *)dbmfi + dfm->mfi_offset);
-
-      if (!(*strval) || (**strval == '\0'))
-	continue;
-
       /* Here's one exception ... codectype (ascd) is actually an integer */
       if (dfm == &dfm_dmap_ascd)
 	{
-	  dmap_add_literal(song, df->tag, *strval, 4);
+	  if (dbmfi->codectype && (*dbmfi->codectype != '\0'))
+	    dmap_add_literal(song, df->tag, dbmfi->codectype, 4);
 	  continue;
 	}
 
-      val = 0;
+      /* Text fields in dbmfi are DMAP strings, the rest are integers (zeros are
+       * skipped by dmap_add_field) */
+      strval = NULL;
+      intval = 0;
+
+      if (df->type == DMAP_TYPE_STRING)
+	{
+	  strval = *(char **) ((char *)dbmfi + dfm->mfi_offset);
+	  if (!strval || (*strval == '\0'))
+	    continue;
+	}
+      else
+	intval = *(int64_t *) ((char *)dbmfi + dfm->mfi_offset);
 
       if (force_wav)
 	{
 	  switch (dfm->mfi_offset)
 	    {
 	      case dbmfi_offsetof(type):
-		ptr = "wav";
-		strval = &ptr;
+		strval = "wav";
 		break;
 
 	      case dbmfi_offsetof(bitrate):
-		val = 0;
-		ret = safe_atoi32(dbmfi->samplerate, &val);
-		if ((ret < 0) || (val == 0))
-		  val = 1411;
+		if (dbmfi->samplerate == 0)
+		  intval = 1411;
 		else
-		  val = (val * 8) / 250;
-
-		ptr = NULL;
-		strval = &ptr;
+		  intval = (dbmfi->samplerate * 8) / 250;
 		break;
 
 	      case dbmfi_offsetof(description):
-		ptr = "wav audio file";
-		strval = &ptr;
+		strval = "wav audio file";
 		break;
 
 	      default:
@@ -503,9 +504,9 @@ dmap_encode_file_metadata(struct evbuffer *songlist, struct evbuffer *song, stru
 	    }
 	}
 
-      dmap_add_field(song, df, *strval, val);
+      dmap_add_field(song, df, strval, intval);
 
-      DPRINTF(E_SPAM, L_DAAP, "Done with meta tag %s (%s)\n", df->desc, *strval);
+      DPRINTF(E_SPAM, L_DAAP, "Done with meta tag %s\n", df->desc);
     }
 
   /* Required for artwork in iTunes, set songartworkcount (asac) = 1 */
@@ -538,18 +539,10 @@ dmap_encode_file_metadata(struct evbuffer *songlist, struct evbuffer *song, stru
   if (want_mikd)
     {
       /* dmap.itemkind must come first */
-      ret = safe_atoi32(dbmfi->item_kind, &val);
-      if (ret < 0)
-	val = 2; /* music by default */
-      dmap_add_char(songlist, "mikd", val);
+      dmap_add_char(songlist, "mikd", dbmfi->item_kind);
     }
   if (want_asdk)
-    {
-      ret = safe_atoi32(dbmfi->data_kind, &val);
-      if (ret < 0)
-	val = 0;
-      dmap_add_char(songlist, "asdk", val);
-    }
+    dmap_add_char(songlist, "asdk", dbmfi->data_kind);
 
   ret = evbuffer_add_buffer(songlist, song);
   if (ret < 0)
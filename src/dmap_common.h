@@ -73,7 +73,7 @@ void
 dmap_add_string(struct evbuffer *evbuf, const char *tag, const char *str);
 
 void
-dmap_add_field(struct evbuffer *evbuf, const struct dmap_field *df, char *strval, int32_t intval);
+dmap_add_field(struct evbuffer *evbuf, const struct dmap_field *df, char *strval, int64_t intval);
 
 void
 dmap_error_make(struct evbuffer *evbuf, const char *container, const char *errmsg);
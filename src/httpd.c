@@ -74,6 +74,17 @@
 
 
 #define STREAM_CHUNK_SIZE (64 * 1024)
+// Webroot files up to this size are kept in memory, larger are sent from disk
+#define WEBROOT_CACHE_FILE_MAX (1024 * 1024)
+#define WEBROOT_CACHE_SIZE_MAX (16 * 1024 * 1024)
+// Raw files are handed to evhttp as file segments (sent with sendfile() if
+// available), so chunks can be larger without costing memory
+#define STREAM_SEGMENT_SIZE (1024 * 1024)
+// When seeking in a transcoded stream the decoder starts this much ahead of
+// the wanted position, so that it has settled when we get there
+#define STREAM_XCODE_SEEK_PREROLL_MS 1000
+// Chunked replies from workers will wait if more than this is unsent
+#define REPLY_STREAM_PENDING_MAX (4 * STREAM_CHUNK_SIZE)
 #define ERR_PAGE "<html>\n<head>\n" \
   "<title>%d %s</title>\n" \
   "</head>\n<body>\n" \
@@ -84,12 +95,126 @@
 #define HTTPD_STREAM_BPS         16
 #define HTTPD_STREAM_CHANNELS    2
 
+// Latency histogram bucket i counts requests that took less than 2^i usec
+#define HTTPD_LATENCY_BUCKETS    32
+
 
 struct content_type_map {
   char *ext;
   char *ctype;
 };
 
+// A static file from the webroot, kept in memory with a gzipped variant
+struct webroot_file {
+  char *path;
+  time_t mtime;
+  off_t size;
+  const char *ctype;
+
+  uint8_t *data;
+  size_t len;
+  char etag[32];
+
+  // NULL if the file type doesn't compress well
+  uint8_t *gzdata;
+  size_t gzlen;
+  char gzetag[32];
+
+  // The cache holds one reference, replies being sent hold the others
+  int refcount;
+
+  struct webroot_file *next;
+};
+
+enum httpd_endpoint
+{
+  HTTPD_ENDPOINT_FILE,
+  HTTPD_ENDPOINT_DACP,
+  HTTPD_ENDPOINT_DAAP,
+  HTTPD_ENDPOINT_JSONAPI,
+  HTTPD_ENDPOINT_ARTWORKAPI,
+  HTTPD_ENDPOINT_STREAMING,
+  HTTPD_ENDPOINT_OAUTH,
+  HTTPD_ENDPOINT_RSP,
+  HTTPD_ENDPOINT_MAX,
+};
+
+struct httpd_latency {
+  uint64_t max_us;
+  uint64_t buckets[HTTPD_LATENCY_BUCKETS];
+};
+
+typedef void (*httpd_request_cb)(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed);
+
+// A request that has been handed over to the worker pool
+struct httpd_job {
+  struct evhttp_request *req;
+  struct httpd_uri_parsed *uri_parsed;
+  httpd_request_cb cb;
+  enum httpd_endpoint endpoint;
+  struct timespec start;
+
+  // What the worker needs from req, copied by the httpd thread, since the
+  // worker must not touch req (see httpd_request_input_headers() etc.). The
+  // output headers are added to req when the httpd thread sends the reply.
+  struct evkeyvalq input_headers;
+  struct evkeyvalq output_headers;
+  struct evbuffer *input_buffer;
+  char *peer_address;
+  uint16_t peer_port;
+  enum evhttp_cmd_type method;
+
+  struct httpd_job *next;
+};
+
+enum httpd_deferred_type
+{
+  HTTPD_DEFERRED_REPLY,
+  HTTPD_DEFERRED_ERROR,
+  HTTPD_DEFERRED_STREAM,
+};
+
+// A reply from a worker thread that must be sent by the httpd thread
+struct httpd_deferred {
+  enum httpd_deferred_type type;
+  struct evhttp_request *req;
+  int code;
+  char *reason;
+  struct evbuffer *evbuf;
+  struct evkeyvalq headers;
+  int id;
+};
+
+// A chunked reply, see httpd_reply_stream_start(). If it is produced by a
+// worker thread, the data is queued and sent by the httpd thread.
+struct httpd_reply_stream {
+  struct evhttp_request *req;
+  int code;
+  char *reason;
+
+  bool gzip;
+  z_stream strm;
+
+  // Data ready to be sent (gzipped if required)
+  struct evbuffer *out;
+
+  bool deferred;
+  // Output headers from the worker, added to req when the reply is started
+  struct evkeyvalq headers;
+  struct event *ev;
+  pthread_mutex_t lck;
+  pthread_cond_t cond;
+  // Handed over by the worker, not yet given to evhttp
+  struct evbuffer *queue;
+  // Only used by the httpd thread
+  struct evbuffer *chunk;
+  // Bytes that are queued or in the evhttp output buffer
+  size_t pending;
+  bool started;
+  bool ended;
+  bool failed;
+};
+
 struct stream_ctx {
   struct evhttp_request *req;
   uint8_t *buf;
@@ -104,6 +229,9 @@ struct stream_ctx {
   off_t end_offset;
   int marked;
   struct transcode_ctx *xcode;
+#ifndef HAVE_LIBEVENT2_OLD
+  struct evbuffer_file_segment *seg;
+#endif
 };
 
 static const struct content_type_map ext2ctype[] =
@@ -119,6 +247,11 @@ static const struct content_type_map ext2ctype[] =
     { NULL, NULL }
   };
 
+static const char *httpd_endpoint_names[HTTPD_ENDPOINT_MAX] =
+  {
+    "file", "dacp", "daap", "jsonapi", "artworkapi", "streaming", "oauth", "rsp",
+  };
+
 static const char *http_reply_401 = "<html><head><title>401 Unauthorized</title></head><body>Authorization required</body></html>";
 
 static const char *webroot_directory;
@@ -137,6 +270,23 @@ static pthread_t tid_httpd;
 static const char *allow_origin;
 static int httpd_port;
 
+// Only used by the httpd thread, so no locking
+static struct webroot_file *webroot_cache;
+static size_t webroot_cache_size;
+
+// Worker pool for the requests that are DB-bound, see httpd_gen_cb()
+static pthread_t *tid_workers;
+static int nworkers;
+static int workers_exit;
+static pthread_mutex_t workers_lck;
+static pthread_cond_t workers_cond;
+static struct httpd_job *jobs_head;
+static struct httpd_job *jobs_tail;
+static __thread bool is_worker;
+static __thread struct httpd_job *job_current;
+
+static struct httpd_latency httpd_latency[HTTPD_ENDPOINT_MAX];
+
 #ifdef HAVE_LIBEVENT2_OLD
 struct stream_ctx *g_st;
 #endif
@@ -261,6 +411,86 @@ httpd_fixup_uri(struct evhttp_request *req)
 
 /* --------------------------- REQUEST HELPERS ------------------------------ */
 
+// Returns the job if we are the worker running the request
+static struct httpd_job *
+job_get(struct evhttp_request *req)
+{
+  if (job_current && job_current->req == req)
+    return job_current;
+
+  return NULL;
+}
+
+static void
+headers_copy(struct evkeyvalq *dst, struct evkeyvalq *src)
+{
+  struct evkeyval *header;
+
+  TAILQ_FOREACH(header, src, next)
+    evhttp_add_header(dst, header->key, header->value);
+}
+
+static void
+headers_move(struct evkeyvalq *dst, struct evkeyvalq *src)
+{
+  headers_copy(dst, src);
+  evhttp_clear_headers(src);
+}
+
+static const char *
+request_uri(struct evhttp_request *req)
+{
+  struct httpd_job *job = job_get(req);
+
+  return job ? job->uri_parsed->uri : evhttp_request_get_uri(req);
+}
+
+static int
+request_peer_get(struct evhttp_request *req, char **address, uint16_t *port)
+{
+  struct evhttp_connection *evcon;
+  struct httpd_job *job;
+
+  job = job_get(req);
+  if (job)
+    {
+      *address = job->peer_address;
+      *port = job->peer_port;
+      return 0;
+    }
+
+  evcon = evhttp_request_get_connection(req);
+  if (!evcon)
+    return -1;
+
+  evhttp_connection_get_peer(evcon, address, port);
+  return 0;
+}
+
+struct evkeyvalq *
+httpd_request_input_headers(struct evhttp_request *req)
+{
+  struct httpd_job *job = job_get(req);
+
+  return job ? &job->input_headers : evhttp_request_get_input_headers(req);
+}
+
+struct evkeyvalq *
+httpd_request_output_headers(struct evhttp_request *req)
+{
+  struct httpd_job *job = job_get(req);
+
+  return job ? &job->output_headers : evhttp_request_get_output_headers(req);
+}
+
+struct evbuffer *
+httpd_request_input_buffer(struct evhttp_request *req)
+{
+  struct httpd_job *job = job_get(req);
+
+  return job ? job->input_buffer : evhttp_request_get_input_buffer(req);
+}
+
 
 
 void
@@ -268,7 +498,7 @@ httpd_redirect_to_admin(struct evhttp_request *req)
 {
   struct evkeyvalq *headers;
 
-  headers = evhttp_request_get_output_headers(req);
+  headers = httpd_request_output_headers(req);
   evhttp_add_header(headers, "Location", "/admin.html");
 
   httpd_send_reply(req, HTTP_MOVETEMP, "Moved", NULL, HTTPD_SEND_NO_GZIP);
@@ -292,7 +522,7 @@ httpd_request_etag_matches(struct evhttp_request *req, const char *etag)
   struct evkeyvalq *output_headers;
   const char *none_match;
 
-  input_headers = evhttp_request_get_input_headers(req);
+  input_headers = httpd_request_input_headers(req);
   none_match = evhttp_find_header(input_headers, "If-None-Match");
 
   // Return not modified, if given timestamp matches "If-Modified-Since" request header
@@ -300,7 +530,7 @@ httpd_request_etag_matches(struct evhttp_request *req, const char *etag)
     return true;
 
   // Add cache headers to allow client side caching
-  output_headers = evhttp_request_get_output_headers(req);
+  output_headers = httpd_request_output_headers(req);
   evhttp_add_header(output_headers, "Cache-Control", "private,no-cache,max-age=0");
   evhttp_add_header(output_headers, "ETag", etag);
 
@@ -327,7 +557,7 @@ httpd_request_not_modified_since(struct evhttp_request *req, time_t mtime)
   const char *modified_since;
   struct tm timebuf;
 
-  input_headers = evhttp_request_get_input_headers(req);
+  input_headers = httpd_request_input_headers(req);
   modified_since = evhttp_find_header(input_headers, "If-Modified-Since");
 
   strftime(last_modified, sizeof(last_modified), "%a, %d %b %Y %H:%M:%S %Z", gmtime_r(&mtime, &timebuf));
@@ -337,7 +567,7 @@ httpd_request_not_modified_since(struct evhttp_request *req, time_t mtime)
     return true;
 
   // Add cache headers to allow client side caching
-  output_headers = evhttp_request_get_output_headers(req);
+  output_headers = httpd_request_output_headers(req);
   evhttp_add_header(output_headers, "Cache-Control", "private,no-cache,max-age=0");
   evhttp_add_header(output_headers, "Last-Modified", last_modified);
 
@@ -349,7 +579,7 @@ httpd_response_not_cachable(struct evhttp_request *req)
 {
   struct evkeyvalq *output_headers;
 
-  output_headers = evhttp_request_get_output_headers(req);
+  output_headers = httpd_request_output_headers(req);
 
   // Remove potentially set cache control headers
   evhttp_remove_header(output_headers, "Cache-Control");
@@ -360,6 +590,164 @@ httpd_response_not_cachable(struct evhttp_request *req)
   evhttp_add_header(output_headers, "Cache-Control", "no-store");
 }
 
+static void
+webroot_file_unref(struct webroot_file *wf)
+{
+  wf->refcount--;
+  if (wf->refcount > 0)
+    return;
+
+  free(wf->path);
+  free(wf->data);
+  free(wf->gzdata);
+  free(wf);
+}
+
+// Thread: httpd (evbuffer cleanup of a reply referencing a cached file)
+static void
+webroot_file_unref_cb(const void *data, size_t datalen, void *extra)
+{
+  webroot_file_unref(extra);
+}
+
+static void
+webroot_cache_remove(struct webroot_file *wf)
+{
+  struct webroot_file *prev;
+
+  if (webroot_cache == wf)
+    webroot_cache = wf->next;
+  else
+    {
+      for (prev = webroot_cache; prev && (prev->next != wf); prev = prev->next)
+	;
+      if (prev)
+	prev->next = wf->next;
+    }
+
+  webroot_cache_size -= wf->len + wf->gzlen;
+
+  webroot_file_unref(wf);
+}
+
+static void
+webroot_cache_purge(void)
+{
+  while (webroot_cache)
+    webroot_cache_remove(webroot_cache);
+}
+
+static bool
+ctype_is_compressible(const char *ctype)
+{
+  return (strncmp(ctype, "text/", strlen("text/")) == 0 || strncmp(ctype, "application/javascript", strlen("application/javascript")) == 0);
+}
+
+static struct webroot_file *
+webroot_file_load(const char *path, struct stat *sb, const char *ctype)
+{
+  struct webroot_file *wf;
+  struct evbuffer *evbuf;
+  struct evbuffer *gzbuf;
+  uint64_t hash;
+  ssize_t got;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    {
+      DPRINTF(E_LOG, L_HTTPD, "Could not open %s: %s\n", path, strerror(errno));
+      return NULL;
+    }
+
+  CHECK_NULL(L_HTTPD, wf = calloc(1, sizeof(struct webroot_file)));
+  CHECK_NULL(L_HTTPD, wf->data = malloc(sb->st_size + 1));
+
+  for (wf->len = 0; wf->len < sb->st_size; wf->len += got)
+    {
+      got = read(fd, wf->data + wf->len, sb->st_size - wf->len);
+      if (got <= 0)
+	break;
+    }
+
+  close(fd);
+
+  if (wf->len != sb->st_size)
+    {
+      DPRINTF(E_LOG, L_HTTPD, "Could not read %s into memory\n", path);
+      free(wf->data);
+      free(wf);
+      return NULL;
+    }
+
+  wf->path = strdup(path);
+  wf->mtime = sb->st_mtime;
+  wf->size = sb->st_size;
+  wf->ctype = ctype;
+  wf->refcount = 1;
+
+  // Strong ETags, since the variants are byte-for-byte the same every time
+  hash = murmur_hash64(wf->data, wf->len, 0);
+  snprintf(wf->etag, sizeof(wf->etag), "\"%016" PRIx64 "\"", hash);
+
+  if (wf->len <= 512 || !ctype_is_compressible(ctype))
+    return wf;
+
+  CHECK_NULL(L_HTTPD, evbuf = evbuffer_new());
+  evbuffer_add_reference(evbuf, wf->data, wf->len, NULL, NULL);
+
+  gzbuf = httpd_gzip_deflate(evbuf);
+  if (gzbuf && evbuffer_get_length(gzbuf) < wf->len)
+    {
+      wf->gzlen = evbuffer_get_length(gzbuf);
+      CHECK_NULL(L_HTTPD, wf->gzdata = malloc(wf->gzlen));
+      evbuffer_remove(gzbuf, wf->gzdata, wf->gzlen);
+
+      snprintf(wf->gzetag, sizeof(wf->gzetag), "\"%016" PRIx64 "-gz\"", hash);
+    }
+
+  if (gzbuf)
+    evbuffer_free(gzbuf);
+  evbuffer_free(evbuf);
+
+  return wf;
+}
+
+// Returns the cached file, (re)loading it if required. Returns NULL if the file
+// should be sent from disk.
+static struct webroot_file *
+webroot_file_get(const char *path, struct stat *sb, const char *ctype)
+{
+  struct webroot_file *wf;
+
+  for (wf = webroot_cache; wf; wf = wf->next)
+    {
+      if (strcmp(wf->path, path) != 0)
+	continue;
+
+      if (wf->mtime == sb->st_mtime && wf->size == sb->st_size)
+	return wf;
+
+      DPRINTF(E_DBG, L_HTTPD, "Webroot file %s has changed, reloading\n", path);
+
+      webroot_cache_remove(wf);
+      break;
+    }
+
+  if (sb->st_size > WEBROOT_CACHE_FILE_MAX || webroot_cache_size + 2 * sb->st_size > WEBROOT_CACHE_SIZE_MAX)
+    return NULL;
+
+  wf = webroot_file_load(path, sb, ctype);
+  if (!wf)
+    return NULL;
+
+  wf->next = webroot_cache;
+  webroot_cache = wf;
+  webroot_cache_size += wf->len + wf->gzlen;
+
+  return wf;
+}
+
 static void
 serve_file(struct evhttp_request *req, const char *uri)
 {
@@ -368,12 +756,15 @@ serve_file(struct evhttp_request *req, const char *uri)
   char deref[PATH_MAX];
   char *ctype;
   struct evbuffer *evbuf;
+  struct evkeyvalq *input_headers;
   struct evkeyvalq *output_headers;
+  struct webroot_file *wf;
   struct stat sb;
+  const char *param;
   int fd;
   int i;
-  uint8_t buf[4096];
   bool slashed;
+  bool gzip;
   int ret;
 
   /* Check authentication */
@@ -472,6 +863,65 @@ serve_file(struct evhttp_request *req, const char *uri)
       return;
     }
 
+  ctype = "application/octet-stream";
+  ext = strrchr(path, '.');
+  if (ext)
+    {
+      for (i = 0; ext2ctype[i].ext; i++)
+	{
+	  if (strcmp(ext, ext2ctype[i].ext) == 0)
+	    {
+	      ctype = ext2ctype[i].ctype;
+	      break;
+	    }
+	}
+    }
+
+  output_headers = evhttp_request_get_output_headers(req);
+
+  wf = webroot_file_get(path, &sb, ctype);
+  if (wf)
+    {
+      input_headers = evhttp_request_get_input_headers(req);
+      param = evhttp_find_header(input_headers, "Accept-Encoding");
+      gzip = wf->gzdata && param && (strstr(param, "gzip") || strstr(param, "*"));
+
+      if (wf->gzdata)
+	evhttp_add_header(output_headers, "Vary", "Accept-Encoding");
+
+      if (httpd_request_etag_matches(req, gzip ? wf->gzetag : wf->etag))
+	{
+	  httpd_send_reply(req, HTTP_NOTMODIFIED, NULL, NULL, HTTPD_SEND_NO_GZIP);
+	  return;
+	}
+
+      CHECK_NULL(L_HTTPD, evbuf = evbuffer_new());
+
+      // No copying, the reply references the cached data
+      wf->refcount++;
+      if (gzip)
+	{
+	  evhttp_add_header(output_headers, "Content-Encoding", "gzip");
+	  ret = evbuffer_add_reference(evbuf, wf->gzdata, wf->gzlen, webroot_file_unref_cb, wf);
+	}
+      else
+	ret = evbuffer_add_reference(evbuf, wf->data, wf->len, webroot_file_unref_cb, wf);
+
+      if (ret < 0)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "Could not add cached %s to reply\n", path);
+	  webroot_file_unref(wf);
+	  goto out_fail;
+	}
+
+      evhttp_add_header(output_headers, "Content-Type", ctype);
+
+      httpd_send_reply(req, HTTP_OK, "OK", evbuf, HTTPD_SEND_NO_GZIP);
+
+      evbuffer_free(evbuf);
+      return;
+    }
+
   if (httpd_request_not_modified_since(req, sb.st_mtime))
     {
       httpd_send_reply(req, HTTP_NOTMODIFIED, NULL, NULL, HTTPD_SEND_NO_GZIP);
@@ -497,84 +947,183 @@ serve_file(struct evhttp_request *req, const char *uri)
       return;
     }
 
-  ret = evbuffer_expand(evbuf, sb.st_size);
-  if (ret < 0)
-    {
-      DPRINTF(E_LOG, L_HTTPD, "Out of memory for htdocs-file\n");
-      goto out_fail;
-    }
-
-  while ((ret = read(fd, buf, sizeof(buf))) > 0)
-    evbuffer_add(evbuf, buf, ret);
-
+  // Too large for the cache, so let evhttp send it from the file (with
+  // sendfile() if available). The evbuffer takes ownership of the fd.
+  ret = evbuffer_add_file(evbuf, fd, 0, sb.st_size);
   if (ret < 0)
     {
-      DPRINTF(E_LOG, L_HTTPD, "Could not read file into evbuffer\n");
+      DPRINTF(E_LOG, L_HTTPD, "Could not add %s to reply\n", path);
       goto out_fail;
     }
 
-  ctype = "application/octet-stream";
-  ext = strrchr(path, '.');
-  if (ext)
-    {
-      for (i = 0; ext2ctype[i].ext; i++)
-	{
-	  if (strcmp(ext, ext2ctype[i].ext) == 0)
-	    {
-	      ctype = ext2ctype[i].ctype;
-	      break;
-	    }
-	}
-    }
-
-  output_headers = evhttp_request_get_output_headers(req);
   evhttp_add_header(output_headers, "Content-Type", ctype);
 
   httpd_send_reply(req, HTTP_OK, "OK", evbuf, HTTPD_SEND_NO_GZIP);
 
   evbuffer_free(evbuf);
-  close(fd);
   return;
 
  out_fail:
   httpd_send_error(req, HTTP_SERVUNAVAIL, "Internal error");
   evbuffer_free(evbuf);
-  close(fd);
 }
 
 
 /* ---------------------------- STREAM HANDLING ----------------------------- */
 
-static void
-stream_end(struct stream_ctx *st, int failed)
+/*
+ * Parses a "Range: bytes=<start>-[<end>]" or "Range: bytes=-<n>" header. For
+ * the latter, start is returned as -n. If no end is given, end is -1. Multiple
+ * ranges are not supported. Returns -1 if the header is invalid.
+ */
+static int
+range_parse(const char *param, int64_t *start, int64_t *end)
 {
-  struct evhttp_connection *evcon;
+  const char *dash;
+  char *endptr;
 
-  evcon = evhttp_request_get_connection(st->req);
+  if (strncmp(param, "bytes=", strlen("bytes=")) != 0 || strchr(param, ','))
+    return -1;
 
-  if (evcon)
-    evhttp_connection_set_closecb(evcon, NULL, NULL);
+  param += strlen("bytes=");
 
-  if (!failed)
-    evhttp_send_reply_end(st->req);
+  dash = strchr(param, '-');
+  if (!dash)
+    return -1;
 
-  evbuffer_free(st->evbuf);
-  event_free(st->ev);
+  *end = -1;
 
-  if (st->xcode)
-    transcode_cleanup(&st->xcode);
-  else
+  // Suffix range
+  if (dash == param)
     {
-      free(st->buf);
-      close(st->fd);
+      *start = strtoll(dash + 1, &endptr, 10);
+      if ((endptr == dash + 1) || (*endptr != '\0') || (*start <= 0))
+	return -1;
+
+      *start = -(*start);
+      return 0;
     }
 
-#ifdef HAVE_LIBEVENT2_OLD
-  if (g_st == st)
-    g_st = NULL;
-#endif
+  *start = strtoll(param, &endptr, 10);
+  if ((endptr != dash) || (*start < 0))
+    return -1;
 
-  free(st);
+  if (dash[1] == '\0')
+    return 0;
+
+  *end = strtoll(dash + 1, &endptr, 10);
+  if ((*endptr != '\0') || (*end < *start))
+    return -1;
+
+  return 0;
+}
+
+/*
+ * Resolves a parsed Range against the size of the content. Afterwards offset
+ * and end_offset are the first and last byte to send. Returns -1 if the range
+ * can't be satisfied.
+ */
+static int
+range_resolve(bool range, off_t size, int64_t *offset, int64_t *end_offset)
+{
+  if (!range)
+    {
+      *offset = 0;
+      *end_offset = size - 1;
+      return 0;
+    }
+
+  // Suffix range, i.e. the last -offset bytes
+  if (*offset < 0)
+    {
+      *offset = MAX(size + *offset, 0);
+      *end_offset = -1;
+    }
+
+  if (*offset >= size)
+    return -1;
+
+  if ((*end_offset < 0) || (*end_offset >= size))
+    *end_offset = size - 1;
+
+  return 0;
+}
+
+static void
+range_not_satisfiable(struct evhttp_request *req, off_t size)
+{
+  struct evkeyvalq *output_headers;
+  char buf[64];
+
+  output_headers = evhttp_request_get_output_headers(req);
+
+  snprintf(buf, sizeof(buf), "bytes */%" PRIi64, (int64_t)size);
+  evhttp_add_header(output_headers, "Content-Range", buf);
+
+  evhttp_send_reply(req, 416, "Requested Range Not Satisfiable", NULL);
+}
+
+/*
+ * Positions a transcoded stream so that its output starts at the given byte
+ * offset, instead of transcoding from the start. The bytes that
+ * transcode_seek_bytes() says must be skipped are dropped by
+ * stream_chunk_xcode_cb(), so the output is the same as the matching range of
+ * a transcode from the start.
+ */
+static int
+stream_xcode_seek(struct stream_ctx *st, int64_t offset)
+{
+  int64_t skip;
+  int ret;
+
+  ret = transcode_seek_bytes(st->xcode, offset, STREAM_XCODE_SEEK_PREROLL_MS, &skip);
+  if (ret < 0)
+    return -1;
+
+  // We pretend to be at the position that makes the consume loop drop the
+  // bytes before the offset
+  st->offset = offset - skip;
+
+  DPRINTF(E_DBG, L_HTTPD, "Transcoded stream seeked, dropping %" PRIi64 " bytes\n", skip);
+
+  return 0;
+}
+
+static void
+stream_end(struct stream_ctx *st, int failed)
+{
+  struct evhttp_connection *evcon;
+
+  evcon = evhttp_request_get_connection(st->req);
+
+  if (evcon)
+    evhttp_connection_set_closecb(evcon, NULL, NULL);
+
+  if (!failed)
+    evhttp_send_reply_end(st->req);
+
+  evbuffer_free(st->evbuf);
+  event_free(st->ev);
+
+  if (st->xcode)
+    transcode_cleanup(&st->xcode);
+  else
+    {
+      free(st->buf);
+      if (st->fd >= 0)
+	close(st->fd);
+    }
+
+#ifdef HAVE_LIBEVENT2_OLD
+  if (g_st == st)
+    g_st = NULL;
+#else
+  // The segment owns the fd, it is closed when evhttp has sent the last of it
+  if (st->seg)
+    evbuffer_file_segment_free(st->seg);
+#endif
+
+  free(st);
 }
 
 static void
@@ -624,12 +1173,22 @@ static void
 stream_chunk_xcode_cb(int fd, short event, void *arg)
 {
   struct stream_ctx *st;
+  struct evbuffer *keep;
   struct timeval tv;
+  int64_t excess;
   int xcoded;
   int ret;
 
   st = (struct stream_ctx *)arg;
 
+  if ((st->end_offset >= 0) && (st->offset > st->end_offset))
+    {
+      DPRINTF(E_INFO, L_HTTPD, "Done streaming range of transcoded file id %d\n", st->id);
+
+      stream_end(st, 0);
+      return;
+    }
+
   xcoded = transcode(st->evbuf, NULL, st->xcode, STREAM_CHUNK_SIZE);
   if (xcoded <= 0)
     {
@@ -667,102 +1226,633 @@ stream_chunk_xcode_cb(int fd, short event, void *arg)
   else
     ret = xcoded;
 
+  // Don't send more than the requested range
+  if ((st->end_offset >= 0) && (st->offset + ret > st->end_offset + 1))
+    {
+      excess = st->offset + ret - (st->end_offset + 1);
+
+      CHECK_NULL(L_HTTPD, keep = evbuffer_new());
+      evbuffer_remove_buffer(st->evbuf, keep, ret - excess);
+      evbuffer_drain(st->evbuf, evbuffer_get_length(st->evbuf));
+      evbuffer_add_buffer(st->evbuf, keep);
+      evbuffer_free(keep);
+
+      ret -= excess;
+    }
+
+#ifdef HAVE_LIBEVENT2_OLD
+  evhttp_send_reply_chunk(st->req, st->evbuf);
+
+  struct evhttp_connection *evcon = evhttp_request_get_connection(st->req);
+  struct bufferevent *bufev = evhttp_connection_get_bufferevent(evcon);
+
+  g_st = st; // Can't pass st to callback so use global - limits libevent 2.0 to a single stream
+  bufev->writecb = stream_chunk_resched_cb_wrapper;
+#else
+  evhttp_send_reply_chunk_with_cb(st->req, st->evbuf, stream_chunk_resched_cb, st);
+#endif
+
+  st->offset += ret;
+
+  stream_end_register(st);
+
+  return;
+
+ consume: /* reschedule immediately - consume up to start_offset */
+  evutil_timerclear(&tv);
+  ret = event_add(st->ev, &tv);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_HTTPD, "Could not re-add one-shot event for streaming (xcode)\n");
+
+      stream_end(st, 0);
+      return;
+    }
+}
+
+static void
+stream_chunk_raw_cb(int fd, short event, void *arg)
+{
+  struct stream_ctx *st;
+  size_t chunk_size;
+  int ret;
+
+  st = (struct stream_ctx *)arg;
+
+  if (st->offset > st->end_offset)
+    {
+      DPRINTF(E_INFO, L_HTTPD, "Done streaming file id %d\n", st->id);
+
+      stream_end(st, 0);
+      return;
+    }
+
+#ifdef HAVE_LIBEVENT2_OLD
+  chunk_size = MIN(STREAM_CHUNK_SIZE, st->end_offset + 1 - st->offset);
+
+  ret = read(st->fd, st->buf, chunk_size);
+  if (ret <= 0)
+    {
+      if (ret == 0)
+	DPRINTF(E_INFO, L_HTTPD, "Done streaming file id %d\n", st->id);
+      else
+	DPRINTF(E_LOG, L_HTTPD, "Streaming error, file id %d\n", st->id);
+
+      stream_end(st, 0);
+      return;
+    }
+
+  DPRINTF(E_DBG, L_HTTPD, "Read %d bytes; streaming file id %d\n", ret, st->id);
+
+  evbuffer_add(st->evbuf, st->buf, ret);
+
+  evhttp_send_reply_chunk(st->req, st->evbuf);
+
+  struct evhttp_connection *evcon = evhttp_request_get_connection(st->req);
+  struct bufferevent *bufev = evhttp_connection_get_bufferevent(evcon);
+
+  g_st = st; // Can't pass st to callback so use global - limits libevent 2.0 to a single stream
+  bufev->writecb = stream_chunk_resched_cb_wrapper;
+#else
+  chunk_size = MIN(STREAM_SEGMENT_SIZE, st->end_offset + 1 - st->offset);
+
+  // No copying, the data is read from the file when the socket is writable
+  ret = evbuffer_add_file_segment(st->evbuf, st->seg, st->offset, chunk_size);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_HTTPD, "Streaming error, file id %d\n", st->id);
+
+      stream_end(st, 0);
+      return;
+    }
+
+  DPRINTF(E_SPAM, L_HTTPD, "Added %zu bytes; streaming file id %d\n", chunk_size, st->id);
+
+  evhttp_send_reply_chunk_with_cb(st->req, st->evbuf, stream_chunk_resched_cb, st);
+
+  ret = chunk_size;
+#endif
+
+  st->offset += ret;
+
+  stream_end_register(st);
+}
+
+static void
+stream_fail_cb(struct evhttp_connection *evcon, void *arg)
+{
+  struct stream_ctx *st;
+
+  st = (struct stream_ctx *)arg;
+
+  DPRINTF(E_WARN, L_HTTPD, "Connection failed; stopping streaming of file ID %d\n", st->id);
+
+  /* Stop streaming */
+  event_del(st->ev);
+
+  stream_end(st, 1);
+}
+
+
+/* ------------------------------ LATENCY STATS ----------------------------- */
+
+static void
+latency_record(enum httpd_endpoint endpoint, struct timespec *start)
+{
+  struct httpd_latency *l = &httpd_latency[endpoint];
+  struct timespec now;
+  uint64_t usec;
+  uint64_t max;
+  int i;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  usec = (now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000;
+
+  for (i = 0; (i < HTTPD_LATENCY_BUCKETS - 1) && (usec >= (1ULL << i)); i++)
+    ; /* EMPTY */
+
+  // Updated from both the httpd thread and the workers
+  __atomic_add_fetch(&l->buckets[i], 1, __ATOMIC_RELAXED);
+
+  max = __atomic_load_n(&l->max_us, __ATOMIC_RELAXED);
+  while (usec > max && !__atomic_compare_exchange_n(&l->max_us, &max, usec, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ; /* EMPTY */
+}
+
+// Returns the upper bound of the bucket that holds the given percentile
+static uint64_t
+latency_percentile(uint64_t *buckets, uint64_t count, uint64_t max_us, int percentile)
+{
+  uint64_t target;
+  uint64_t sum;
+  int i;
+
+  if (count == 0)
+    return 0;
+
+  target = (count * percentile + 99) / 100;
+
+  for (i = 0, sum = 0; i < HTTPD_LATENCY_BUCKETS; i++)
+    {
+      sum += buckets[i];
+      if (sum >= target)
+	break;
+    }
+
+  return MIN(1ULL << i, max_us);
+}
+
+
+/* ---------------------------- WORKER THREADS ------------------------------ */
+
+// Thread: httpd (deferred reply from a worker)
+static void
+deferred_cb(evutil_socket_t fd, short event, void *arg)
+{
+  struct httpd_deferred *d = arg;
+
+  // The headers the worker set for the reply (an error reply has its own)
+  if (d->type != HTTPD_DEFERRED_ERROR)
+    headers_move(evhttp_request_get_output_headers(d->req), &d->headers);
+
+  switch (d->type)
+    {
+      case HTTPD_DEFERRED_REPLY:
+	evhttp_send_reply(d->req, d->code, d->reason, d->evbuf);
+	break;
+      case HTTPD_DEFERRED_ERROR:
+	httpd_send_error(d->req, d->code, d->reason);
+	break;
+      case HTTPD_DEFERRED_STREAM:
+	httpd_stream_file(d->req, d->id);
+	break;
+    }
+
+  if (d->evbuf)
+    evbuffer_free(d->evbuf);
+  evhttp_clear_headers(&d->headers);
+  free(d->reason);
+  free(d);
+}
+
+// Thread: worker. Hands over sending to the httpd thread, since evhttp must
+// only be used from there. The evbuf is drained, like evhttp_send_reply does,
+// and the output headers the worker has set go with the reply.
+static void
+deferred_send(enum httpd_deferred_type type, struct evhttp_request *req, int code, const char *reason, struct evbuffer *evbuf, int id)
+{
+  struct httpd_deferred *d;
+  struct httpd_job *job;
+  int ret;
+
+  CHECK_NULL(L_HTTPD, d = calloc(1, sizeof(struct httpd_deferred)));
+
+  d->type = type;
+  d->req = req;
+  d->code = code;
+  d->reason = safe_strdup(reason);
+  d->id = id;
+
+  TAILQ_INIT(&d->headers);
+  job = job_get(req);
+  if (job)
+    headers_move(&d->headers, &job->output_headers);
+
+  if (evbuf)
+    {
+      CHECK_NULL(L_HTTPD, d->evbuf = evbuffer_new());
+      evbuffer_add_buffer(d->evbuf, evbuf);
+    }
+
+  ret = event_base_once(evbase_httpd, -1, EV_TIMEOUT, deferred_cb, d, NULL);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_HTTPD, "Could not pass reply to httpd thread\n");
+
+      if (d->evbuf)
+	evbuffer_free(d->evbuf);
+      evhttp_clear_headers(&d->headers);
+      free(d->reason);
+      free(d);
+    }
+}
+
+static void
+job_free(struct httpd_job *job)
+{
+  evhttp_clear_headers(&job->input_headers);
+  evhttp_clear_headers(&job->output_headers);
+  if (job->input_buffer)
+    evbuffer_free(job->input_buffer);
+  free(job->peer_address);
+  httpd_uri_free(job->uri_parsed);
+  free(job);
+}
+
+static void *
+httpd_worker(void *arg)
+{
+  struct httpd_job *job;
+  int ret;
+
+  ret = db_perthread_init();
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_HTTPD, "Error: DB init failed (httpd worker)\n");
+
+      pthread_exit(NULL);
+    }
+
+  is_worker = true;
+
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&workers_lck));
+
+  while (!workers_exit)
+    {
+      job = jobs_head;
+      if (!job)
+	{
+	  CHECK_ERR(L_HTTPD, pthread_cond_wait(&workers_cond, &workers_lck));
+	  continue;
+	}
+
+      jobs_head = job->next;
+      if (!jobs_head)
+	jobs_tail = NULL;
+
+      CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&workers_lck));
+
+      job_current = job;
+      job->cb(job->req, job->uri_parsed);
+      job_current = NULL;
+
+      latency_record(job->endpoint, &job->start);
+
+      job_free(job);
+
+      CHECK_ERR(L_HTTPD, pthread_mutex_lock(&workers_lck));
+    }
+
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&workers_lck));
+
+  db_perthread_deinit();
+
+  pthread_exit(NULL);
+}
+
+// Thread: httpd. Takes ownership of uri_parsed.
+static void
+worker_job_add(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed, httpd_request_cb cb, enum httpd_endpoint endpoint, struct timespec *start)
+{
+  struct evhttp_connection *evcon;
+  struct httpd_job *job;
+  char *address;
+  uint16_t port;
+
+  CHECK_NULL(L_HTTPD, job = calloc(1, sizeof(struct httpd_job)));
+
+  job->req = req;
+  job->uri_parsed = uri_parsed;
+  job->cb = cb;
+  job->endpoint = endpoint;
+  job->start = *start;
+
+  TAILQ_INIT(&job->input_headers);
+  TAILQ_INIT(&job->output_headers);
+  headers_copy(&job->input_headers, evhttp_request_get_input_headers(req));
+
+  // The body has been read, so it can just be moved
+  CHECK_NULL(L_HTTPD, job->input_buffer = evbuffer_new());
+  evbuffer_add_buffer(job->input_buffer, evhttp_request_get_input_buffer(req));
+
+  evcon = evhttp_request_get_connection(req);
+  if (evcon)
+    {
+      evhttp_connection_get_peer(evcon, &address, &port);
+      job->peer_address = safe_strdup(address);
+      job->peer_port = port;
+    }
+
+  job->method = evhttp_request_get_command(req);
+
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&workers_lck));
+
+  if (jobs_tail)
+    jobs_tail->next = job;
+  else
+    jobs_head = job;
+  jobs_tail = job;
+
+  CHECK_ERR(L_HTTPD, pthread_cond_signal(&workers_cond));
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&workers_lck));
+}
+
+static int
+workers_start(int n)
+{
+  int ret;
+  int i;
+
+  CHECK_ERR(L_HTTPD, mutex_init(&workers_lck));
+  CHECK_ERR(L_HTTPD, pthread_cond_init(&workers_cond, NULL));
+
+  workers_exit = 0;
+  nworkers = 0;
+
+  if (n <= 0)
+    return 0;
+
+  CHECK_NULL(L_HTTPD, tid_workers = calloc(n, sizeof(pthread_t)));
+
+  for (i = 0; i < n; i++)
+    {
+      ret = pthread_create(&tid_workers[i], NULL, httpd_worker, NULL);
+      if (ret != 0)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "Could not spawn httpd worker thread: %s\n", strerror(ret));
+	  break;
+	}
+
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+      pthread_setname_np(tid_workers[i], "httpd_worker");
+#elif defined(HAVE_PTHREAD_SET_NAME_NP)
+      pthread_set_name_np(tid_workers[i], "httpd_worker");
+#endif
+      nworkers++;
+    }
+
+  DPRINTF(E_INFO, L_HTTPD, "Started %d httpd worker threads\n", nworkers);
+
+  return nworkers;
+}
+
+static void
+workers_stop(void)
+{
+  struct httpd_job *job;
+  int i;
+
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&workers_lck));
+  workers_exit = 1;
+  CHECK_ERR(L_HTTPD, pthread_cond_broadcast(&workers_cond));
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&workers_lck));
+
+  for (i = 0; i < nworkers; i++)
+    pthread_join(tid_workers[i], NULL);
+
+  // The event loop is gone, so jobs that never started will not get a reply
+  for (job = jobs_head; job; job = jobs_head)
+    {
+      jobs_head = job->next;
+      job_free(job);
+    }
+  jobs_tail = NULL;
+
+  free(tid_workers);
+  tid_workers = NULL;
+  nworkers = 0;
+
+  CHECK_ERR(L_HTTPD, pthread_cond_destroy(&workers_cond));
+  CHECK_ERR(L_HTTPD, pthread_mutex_destroy(&workers_lck));
+}
+
+
+/* ---------------------------- CHUNKED REPLIES ----------------------------- */
+
+static void
+reply_stream_free(struct httpd_reply_stream *rs)
+{
+  if (rs->gzip)
+    deflateEnd(&rs->strm);
+
+  evhttp_clear_headers(&rs->headers);
+
+  if (rs->deferred)
+    {
+      event_free(rs->ev);
+      evbuffer_free(rs->queue);
+      evbuffer_free(rs->chunk);
+      CHECK_ERR(L_HTTPD, pthread_cond_destroy(&rs->cond));
+      CHECK_ERR(L_HTTPD, pthread_mutex_destroy(&rs->lck));
+    }
+
+  evbuffer_free(rs->out);
+  free(rs->reason);
+  free(rs);
+}
+
+// Thread: httpd
+static void
+reply_stream_close_cb(struct evhttp_connection *evcon, void *arg)
+{
+  struct httpd_reply_stream *rs = arg;
+
+  DPRINTF(E_WARN, L_HTTPD, "Connection closed while sending chunked reply\n");
+
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&rs->lck));
+  rs->failed = true;
+  CHECK_ERR(L_HTTPD, pthread_cond_signal(&rs->cond));
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&rs->lck));
+}
+
+#ifndef HAVE_LIBEVENT2_OLD
+// Thread: httpd. Called when evhttp has written everything we gave it.
+static void
+reply_stream_written_cb(struct evhttp_connection *evcon, void *arg)
+{
+  struct httpd_reply_stream *rs = arg;
+
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&rs->lck));
+  rs->pending = evbuffer_get_length(rs->queue);
+  CHECK_ERR(L_HTTPD, pthread_cond_signal(&rs->cond));
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&rs->lck));
+}
+#endif
+
+// Thread: httpd. Sends what the worker has queued. The queue and the ended
+// flag are read under the same lock, so the last data is always sent before
+// the reply is ended.
+static void
+reply_stream_cb(evutil_socket_t fd, short event, void *arg)
+{
+  struct httpd_reply_stream *rs = arg;
+  struct evhttp_connection *evcon;
+  bool start;
+  bool ended;
+  bool failed;
+
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&rs->lck));
+  start = !rs->started && !rs->failed;
+  rs->started = true;
+  evbuffer_add_buffer(rs->chunk, rs->queue);
+  ended = rs->ended;
+  failed = rs->failed;
 #ifdef HAVE_LIBEVENT2_OLD
-  evhttp_send_reply_chunk(st->req, st->evbuf);
+  rs->pending = 0;
+  CHECK_ERR(L_HTTPD, pthread_cond_signal(&rs->cond));
+#endif
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&rs->lck));
 
-  struct evhttp_connection *evcon = evhttp_request_get_connection(st->req);
-  struct bufferevent *bufev = evhttp_connection_get_bufferevent(evcon);
+  // If the connection was closed then evhttp will have freed the request
+  evcon = failed ? NULL : evhttp_request_get_connection(rs->req);
 
-  g_st = st; // Can't pass st to callback so use global - limits libevent 2.0 to a single stream
-  bufev->writecb = stream_chunk_resched_cb_wrapper;
-#else
-  evhttp_send_reply_chunk_with_cb(st->req, st->evbuf, stream_chunk_resched_cb, st);
-#endif
+  if (start)
+    {
+      if (evcon)
+	evhttp_connection_set_closecb(evcon, reply_stream_close_cb, rs);
 
-  st->offset += ret;
+      headers_move(evhttp_request_get_output_headers(rs->req), &rs->headers);
+      evhttp_send_reply_start(rs->req, rs->code, rs->reason);
+    }
 
-  stream_end_register(st);
+  if (failed)
+    evbuffer_drain(rs->chunk, evbuffer_get_length(rs->chunk));
+  else if (evbuffer_get_length(rs->chunk) > 0)
+#ifdef HAVE_LIBEVENT2_OLD
+    evhttp_send_reply_chunk(rs->req, rs->chunk);
+#else
+    evhttp_send_reply_chunk_with_cb(rs->req, rs->chunk, reply_stream_written_cb, rs);
+#endif
 
-  return;
+  if (!ended)
+    return;
 
- consume: /* reschedule immediately - consume up to start_offset */
-  evutil_timerclear(&tv);
-  ret = event_add(st->ev, &tv);
-  if (ret < 0)
+  if (!failed)
     {
-      DPRINTF(E_LOG, L_HTTPD, "Could not re-add one-shot event for streaming (xcode)\n");
+      if (evcon)
+	evhttp_connection_set_closecb(evcon, NULL, NULL);
 
-      stream_end(st, 0);
-      return;
+      evhttp_send_reply_end(rs->req);
     }
+
+  reply_stream_free(rs);
 }
 
-static void
-stream_chunk_raw_cb(int fd, short event, void *arg)
+// Gzips (if required) and drains the input, output is added to rs->out
+static int
+reply_stream_deflate(struct httpd_reply_stream *rs, struct evbuffer *in, int flush)
 {
-  struct stream_ctx *st;
-  size_t chunk_size;
+  struct evbuffer_iovec iovec[1];
+  size_t len;
   int ret;
 
-  st = (struct stream_ctx *)arg;
+  len = evbuffer_get_length(in);
 
-  if (st->end_offset && (st->offset > st->end_offset))
-    {
-      stream_end(st, 0);
-      return;
-    }
+  if (!rs->gzip)
+    return evbuffer_add_buffer(rs->out, in);
 
-  if (st->end_offset && ((st->offset + STREAM_CHUNK_SIZE) > (st->end_offset + 1)))
-    chunk_size = st->end_offset + 1 - st->offset;
-  else
-    chunk_size = STREAM_CHUNK_SIZE;  
+  rs->strm.next_in = len ? evbuffer_pullup(in, -1) : NULL;
+  rs->strm.avail_in = len;
 
-  ret = read(st->fd, st->buf, chunk_size);
-  if (ret <= 0)
+  do
     {
-      if (ret == 0)
-	DPRINTF(E_INFO, L_HTTPD, "Done streaming file id %d\n", st->id);
-      else
-	DPRINTF(E_LOG, L_HTTPD, "Streaming error, file id %d\n", st->id);
+      ret = evbuffer_reserve_space(rs->out, STREAM_CHUNK_SIZE / 4, iovec, 1);
+      if (ret < 0)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "Could not reserve memory for gzipped reply\n");
+	  return -1;
+	}
 
-      stream_end(st, 0);
-      return;
+      rs->strm.next_out = iovec[0].iov_base;
+      rs->strm.avail_out = iovec[0].iov_len;
+
+      ret = deflate(&rs->strm, flush);
+      if (ret == Z_STREAM_ERROR)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "zlib error while gzipping reply\n");
+	  return -1;
+	}
+
+      iovec[0].iov_len -= rs->strm.avail_out;
+      evbuffer_commit_space(rs->out, iovec, 1);
     }
+  while (rs->strm.avail_out == 0);
 
-  DPRINTF(E_DBG, L_HTTPD, "Read %d bytes; streaming file id %d\n", ret, st->id);
+  evbuffer_drain(in, len);
 
-  evbuffer_add(st->evbuf, st->buf, ret);
+  return 0;
+}
 
-#ifdef HAVE_LIBEVENT2_OLD
-  evhttp_send_reply_chunk(st->req, st->evbuf);
+// Thread: the caller of httpd_reply_stream_add/end
+static int
+reply_stream_send(struct httpd_reply_stream *rs)
+{
+  size_t len;
+  bool failed;
 
-  struct evhttp_connection *evcon = evhttp_request_get_connection(st->req);
-  struct bufferevent *bufev = evhttp_connection_get_bufferevent(evcon);
+  len = evbuffer_get_length(rs->out);
 
-  g_st = st; // Can't pass st to callback so use global - limits libevent 2.0 to a single stream
-  bufev->writecb = stream_chunk_resched_cb_wrapper;
-#else
-  evhttp_send_reply_chunk_with_cb(st->req, st->evbuf, stream_chunk_resched_cb, st);
-#endif
+  if (!rs->deferred)
+    {
+      if (len > 0)
+	evhttp_send_reply_chunk(rs->req, rs->out);
+      return 0;
+    }
 
-  st->offset += ret;
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&rs->lck));
 
-  stream_end_register(st);
-}
+  // Backpressure, so we don't end up with the entire reply in memory
+  while (!rs->failed && (rs->pending > REPLY_STREAM_PENDING_MAX))
+    CHECK_ERR(L_HTTPD, pthread_cond_wait(&rs->cond, &rs->lck));
 
-static void
-stream_fail_cb(struct evhttp_connection *evcon, void *arg)
-{
-  struct stream_ctx *st;
+  failed = rs->failed;
+  if (failed)
+    evbuffer_drain(rs->out, len);
+  else
+    {
+      evbuffer_add_buffer(rs->queue, rs->out);
+      rs->pending += len;
+    }
 
-  st = (struct stream_ctx *)arg;
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&rs->lck));
 
-  DPRINTF(E_WARN, L_HTTPD, "Connection failed; stopping streaming of file ID %d\n", st->id);
+  if (failed)
+    return -1;
 
-  /* Stop streaming */
-  event_del(st->ev);
+  event_active(rs->ev, 0, 0);
 
-  stream_end(st, 1);
+  return 0;
 }
 
 
@@ -805,8 +1895,14 @@ httpd_gen_cb(struct evhttp_request *req, void *arg)
   struct evkeyvalq *input_headers;
   struct evkeyvalq *output_headers;
   struct httpd_uri_parsed *parsed;
+  struct timespec start;
+  enum httpd_endpoint endpoint;
+  httpd_request_cb cb;
+  bool threadsafe;
   const char *uri;
 
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
   // Clear the proxy request flag set by evhttp if the request URI was absolute.
   // It has side-effects on Connection: keep-alive
   req->flags &= ~EVHTTP_PROXY_REQUEST;
@@ -849,49 +1945,74 @@ httpd_gen_cb(struct evhttp_request *req, void *arg)
       goto serve_file;
     }
 
-  /* Dispatch protocol-specific handlers */
+  /* Dispatch protocol-specific handlers. The ones that are DB-bound and don't
+   * use the event loop are run by the worker pool, if enabled. */
+  threadsafe = false;
   if (dacp_is_request(parsed->path))
     {
-      dacp_request(req, parsed);
-      goto out;
+      endpoint = HTTPD_ENDPOINT_DACP;
+      cb = dacp_request;
     }
   else if (daap_is_request(parsed->path))
     {
-      daap_request(req, parsed);
-      goto out;
+      endpoint = HTTPD_ENDPOINT_DAAP;
+      cb = daap_request;
+      threadsafe = daap_is_threadsafe_request(parsed->path);
     }
   else if (jsonapi_is_request(parsed->path))
     {
-      jsonapi_request(req, parsed);
-      goto out;
+      endpoint = HTTPD_ENDPOINT_JSONAPI;
+      cb = jsonapi_request;
+      threadsafe = true;
     }
   else if (artworkapi_is_request(parsed->path))
     {
-      artworkapi_request(req, parsed);
-      goto out;
+      endpoint = HTTPD_ENDPOINT_ARTWORKAPI;
+      cb = artworkapi_request;
+      threadsafe = true;
     }
   else if (streaming_is_request(parsed->path))
     {
       streaming_request(req, parsed);
+
+      latency_record(HTTPD_ENDPOINT_STREAMING, &start);
       goto out;
     }
   else if (oauth_is_request(parsed->path))
     {
-      oauth_request(req, parsed);
-      goto out;
+      endpoint = HTTPD_ENDPOINT_OAUTH;
+      cb = oauth_request;
     }
   else if (rsp_is_request(parsed->path))
     {
-      rsp_request(req, parsed);
-      goto out;
+      endpoint = HTTPD_ENDPOINT_RSP;
+      cb = rsp_request;
+      threadsafe = true;
+    }
+  else
+    {
+      goto serve_file;
     }
 
+  if (threadsafe && nworkers > 0)
+    {
+      worker_job_add(req, parsed, cb, endpoint, &start);
+      return;
+    }
+
+  cb(req, parsed);
+
+  latency_record(endpoint, &start);
+  goto out;
+
+ serve_file:
   DPRINTF(E_DBG, L_HTTPD, "HTTP request: '%s'\n", parsed->uri);
 
   /* Serve web interface files */
- serve_file:
   serve_file(req, parsed->path);
 
+  latency_record(HTTPD_ENDPOINT_FILE, &start);
+
  out:
   httpd_uri_free(parsed);
 }
@@ -995,7 +2116,7 @@ struct httpd_request *
 httpd_request_parse(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed, const char *user_agent, struct httpd_uri_map *uri_map)
 {
   struct httpd_request *hreq;
-  struct evhttp_connection *evcon;
+  struct httpd_job *job;
   struct evkeyvalq *headers;
   int req_method;
   int i;
@@ -1011,16 +2132,15 @@ httpd_request_parse(struct evhttp_request *req, struct httpd_uri_parsed *uri_par
 
   if (req)
     {
-      headers = evhttp_request_get_input_headers(req);
+      headers = httpd_request_input_headers(req);
       hreq->user_agent = evhttp_find_header(headers, "User-Agent");
 
-      evcon = evhttp_request_get_connection(req);
-      if (evcon)
-	evhttp_connection_get_peer(evcon, &hreq->peer_address, &hreq->peer_port);
-      else
+      ret = request_peer_get(req, &hreq->peer_address, &hreq->peer_port);
+      if (ret < 0)
 	DPRINTF(E_LOG, L_HTTPD, "Connection to client lost or missing\n");
 
-      req_method = evhttp_request_get_command(req);
+      job = job_get(req);
+      req_method = job ? job->method : evhttp_request_get_command(req);
     }
 
   if (user_agent)
@@ -1061,53 +2181,40 @@ httpd_stream_file(struct evhttp_request *req, int id)
   struct evkeyvalq *input_headers;
   struct evkeyvalq *output_headers;
   const char *param;
-  const char *param_end;
   const char *ua;
   const char *client_codecs;
   char buf[64];
   int64_t offset;
   int64_t end_offset;
+#ifdef HAVE_LIBEVENT2_OLD
   off_t pos;
+#endif
+  int64_t xcode_end;
+  bool range;
   int transcode;
   int ret;
 
+  // Streaming runs from the event loop, so a worker must pass it on
+  if (is_worker)
+    {
+      deferred_send(HTTPD_DEFERRED_STREAM, req, 0, NULL, NULL, id);
+      return;
+    }
+
   offset = 0;
-  end_offset = 0;
+  end_offset = -1;
 
   input_headers = evhttp_request_get_input_headers(req);
 
+  range = false;
   param = evhttp_find_header(input_headers, "Range");
   if (param)
     {
       DPRINTF(E_DBG, L_HTTPD, "Found Range header: %s\n", param);
 
-      /* Start offset */
-      ret = safe_atoi64(param + strlen("bytes="), &offset);
-      if (ret < 0)
-	{
-	  DPRINTF(E_LOG, L_HTTPD, "Invalid start offset, will stream whole file (%s)\n", param);
-	  offset = 0;
-	}
-      /* End offset, if any */
-      else
-	{
-	  param_end = strchr(param, '-');
-	  if (param_end && (strlen(param_end) > 1))
-	    {
-	      ret = safe_atoi64(param_end + 1, &end_offset);
-	      if (ret < 0)
-		{
-		  DPRINTF(E_LOG, L_HTTPD, "Invalid end offset, will stream to end of file (%s)\n", param);
-		  end_offset = 0;
-		}
-
-	      if (end_offset < offset)
-		{
-		  DPRINTF(E_LOG, L_HTTPD, "End offset < start offset, will stream to end of file (%" PRIi64 " < %" PRIi64 ")\n", end_offset, offset);
-		  end_offset = 0;
-		}
-	    }
-	}
+      range = (range_parse(param, &offset, &end_offset) == 0);
+      if (!range)
+	DPRINTF(E_LOG, L_HTTPD, "Invalid or unsupported Range, will stream whole file (%s)\n", param);
     }
 
   mfi = db_file_fetch_byid(id);
@@ -1163,12 +2270,40 @@ httpd_stream_file(struct evhttp_request *req, int id)
 
       if (!evhttp_find_header(output_headers, "Content-Type"))
 	evhttp_add_header(output_headers, "Content-Type", "audio/wav");
+
+      // The size is only an estimate, so we only stop early if the client
+      // requested a specific end
+      xcode_end = range ? end_offset : -1;
+
+      ret = range_resolve(range, st->size, &offset, &end_offset);
+      if (ret < 0)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "Range start %" PRIi64 " is beyond estimated end of %s\n", offset, mfi->path);
+
+	  range_not_satisfiable(req, st->size);
+	  goto out_cleanup;
+	}
+
+      st->end_offset = (xcode_end >= 0) ? end_offset : -1;
+
+      if (range && (offset > 0))
+	{
+	  ret = stream_xcode_seek(st, offset);
+	  if (ret < 0)
+	    {
+	      DPRINTF(E_LOG, L_HTTPD, "Could not seek to byte %" PRIi64 " in transcoded %s\n", offset, mfi->path);
+
+	      evhttp_send_error(req, HTTP_SERVUNAVAIL, "Internal Server Error");
+	      goto out_cleanup;
+	    }
+	}
     }
   else
     {
       /* Stream the raw file */
       DPRINTF(E_INFO, L_HTTPD, "Preparing to stream %s\n", mfi->path);
 
+#ifdef HAVE_LIBEVENT2_OLD
       st->buf = (uint8_t *)malloc(STREAM_CHUNK_SIZE);
       if (!st->buf)
 	{
@@ -1178,6 +2313,7 @@ httpd_stream_file(struct evhttp_request *req, int id)
 
 	  goto out_free_st;
 	}
+#endif
 
       stream_cb = stream_chunk_raw_cb;
 
@@ -1202,6 +2338,16 @@ httpd_stream_file(struct evhttp_request *req, int id)
 	}
       st->size = sb.st_size;
 
+      ret = range_resolve(range, st->size, &offset, &end_offset);
+      if (ret < 0)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "Range start %" PRIi64 " is beyond end of %s\n", offset, mfi->path);
+
+	  range_not_satisfiable(req, st->size);
+	  goto out_cleanup;
+	}
+
+#ifdef HAVE_LIBEVENT2_OLD
       pos = lseek(st->fd, offset, SEEK_SET);
       if (pos == (off_t) -1)
 	{
@@ -1211,6 +2357,20 @@ httpd_stream_file(struct evhttp_request *req, int id)
 
 	  goto out_cleanup;
 	}
+#else
+      st->seg = evbuffer_file_segment_new(st->fd, 0, st->size, EVBUF_FS_CLOSE_ON_FREE);
+      if (!st->seg)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "Could not create file segment for %s\n", mfi->path);
+
+	  evhttp_send_error(req, HTTP_SERVUNAVAIL, "Internal Server Error");
+
+	  goto out_cleanup;
+	}
+
+      // Now owned by the segment
+      st->fd = -1;
+#endif
       st->offset = offset;
       st->end_offset = end_offset;
 
@@ -1283,7 +2443,7 @@ httpd_stream_file(struct evhttp_request *req, int id)
   st->stream_size = st->size;
   st->req = req;
 
-  if ((offset == 0) && (end_offset == 0))
+  if (!range)
     {
       /* If we are not decoding, send the Content-Length. We don't do
        * that if we are decoding because we can only guesstimate the
@@ -1302,25 +2462,25 @@ httpd_stream_file(struct evhttp_request *req, int id)
     }
   else
     {
-      if (offset > 0)
-	st->stream_size -= offset;
-      if (end_offset > 0)
-	st->stream_size -= (st->size - end_offset);
+      st->stream_size = end_offset + 1 - offset;
 
       DPRINTF(E_DBG, L_HTTPD, "Stream request with range %" PRIi64 "-%" PRIi64 "\n", offset, end_offset);
 
-      ret = snprintf(buf, sizeof(buf), "bytes %" PRIi64 "-%" PRIi64 "/%" PRIi64,
-		     offset, (end_offset) ? end_offset : (int64_t)st->size, (int64_t)st->size);
+      ret = snprintf(buf, sizeof(buf), "bytes %" PRIi64 "-%" PRIi64 "/%" PRIi64, offset, end_offset, (int64_t)st->size);
       if ((ret < 0) || (ret >= sizeof(buf)))
 	DPRINTF(E_LOG, L_HTTPD, "Content-Range too large for buffer, dropping\n");
       else
 	evhttp_add_header(output_headers, "Content-Range", buf);
 
-      ret = snprintf(buf, sizeof(buf), "%" PRIi64, ((end_offset) ? end_offset + 1 : (int64_t)st->size) - offset);
-      if ((ret < 0) || (ret >= sizeof(buf)))
-	DPRINTF(E_LOG, L_HTTPD, "Content-Length too large for buffer, dropping\n");
-      else
-	evhttp_add_header(output_headers, "Content-Length", buf);
+      // As above, no Content-Length when transcoding, since it is a guess
+      if (!transcode)
+	{
+	  ret = snprintf(buf, sizeof(buf), "%" PRIi64, (int64_t)st->stream_size);
+	  if ((ret < 0) || (ret >= sizeof(buf)))
+	    DPRINTF(E_LOG, L_HTTPD, "Content-Length too large for buffer, dropping\n");
+	  else
+	    evhttp_add_header(output_headers, "Content-Length", buf);
+	}
 
       evhttp_send_reply_start(req, 206, "Partial Content");
     }
@@ -1352,8 +2512,12 @@ httpd_stream_file(struct evhttp_request *req, int id)
     transcode_cleanup(&st->xcode);
   if (st->buf)
     free(st->buf);
-  if (st->fd > 0)
+  if (st->fd >= 0)
     close(st->fd);
+#ifndef HAVE_LIBEVENT2_OLD
+  if (st->seg)
+    evbuffer_file_segment_free(st->seg);
+#endif
  out_free_st:
   free(st);
  out_free_mfi:
@@ -1435,8 +2599,8 @@ httpd_send_reply(struct evhttp_request *req, int code, const char *reason, struc
   if (!req)
     return;
 
-  input_headers = evhttp_request_get_input_headers(req);
-  output_headers = evhttp_request_get_output_headers(req);
+  input_headers = httpd_request_input_headers(req);
+  output_headers = httpd_request_output_headers(req);
 
   do_gzip = ( (!(flags & HTTPD_SEND_NO_GZIP)) &&
               evbuf && (evbuffer_get_length(evbuf) > 512) &&
@@ -1452,18 +2616,136 @@ httpd_send_reply(struct evhttp_request *req, int code, const char *reason, struc
       DPRINTF(E_DBG, L_HTTPD, "Gzipping response\n");
 
       evhttp_add_header(output_headers, "Content-Encoding", "gzip");
-      evhttp_send_reply(req, code, reason, gzbuf);
+      if (is_worker)
+	deferred_send(HTTPD_DEFERRED_REPLY, req, code, reason, gzbuf, 0);
+      else
+	evhttp_send_reply(req, code, reason, gzbuf);
       evbuffer_free(gzbuf);
 
       // Drain original buffer, as would be after evhttp_send_reply()
       evbuffer_drain(evbuf, evbuffer_get_length(evbuf));
     }
+  else if (is_worker)
+    {
+      deferred_send(HTTPD_DEFERRED_REPLY, req, code, reason, evbuf, 0);
+    }
   else
     {
       evhttp_send_reply(req, code, reason, evbuf);
     }
 }
 
+struct httpd_reply_stream *
+httpd_reply_stream_start(struct evhttp_request *req, int code, const char *reason, enum httpd_send_flags flags)
+{
+  struct httpd_reply_stream *rs;
+  struct evkeyvalq *input_headers;
+  struct evkeyvalq *output_headers;
+  const char *param;
+  int ret;
+
+  if (!req)
+    return NULL;
+
+  CHECK_NULL(L_HTTPD, rs = calloc(1, sizeof(struct httpd_reply_stream)));
+  CHECK_NULL(L_HTTPD, rs->out = evbuffer_new());
+
+  rs->req = req;
+  rs->code = code;
+  rs->reason = safe_strdup(reason);
+  TAILQ_INIT(&rs->headers);
+
+  input_headers = httpd_request_input_headers(req);
+  output_headers = httpd_request_output_headers(req);
+
+  rs->gzip = ( (!(flags & HTTPD_SEND_NO_GZIP)) &&
+               (param = evhttp_find_header(input_headers, "Accept-Encoding")) &&
+               (strstr(param, "gzip") || strstr(param, "*"))
+             );
+
+  if (rs->gzip)
+    {
+      // Same gzip stream setup as httpd_gzip_deflate()
+      ret = deflateInit2(&rs->strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+      if (ret != Z_OK)
+	{
+	  DPRINTF(E_LOG, L_HTTPD, "zlib setup failed: %s\n", zError(ret));
+	  rs->gzip = false;
+	}
+    }
+
+  if (allow_origin)
+    evhttp_add_header(output_headers, "Access-Control-Allow-Origin", allow_origin);
+  if (rs->gzip)
+    evhttp_add_header(output_headers, "Content-Encoding", "gzip");
+
+  rs->deferred = is_worker;
+  if (!rs->deferred)
+    {
+      evhttp_send_reply_start(req, code, reason);
+      return rs;
+    }
+
+  // The reply is started by the httpd thread, which then adds the headers
+  headers_move(&rs->headers, output_headers);
+
+  CHECK_NULL(L_HTTPD, rs->queue = evbuffer_new());
+  CHECK_NULL(L_HTTPD, rs->chunk = evbuffer_new());
+  CHECK_NULL(L_HTTPD, rs->ev = event_new(evbase_httpd, -1, 0, reply_stream_cb, rs));
+  CHECK_ERR(L_HTTPD, mutex_init(&rs->lck));
+  CHECK_ERR(L_HTTPD, pthread_cond_init(&rs->cond, NULL));
+
+  // Get the headers out right away
+  event_active(rs->ev, 0, 0);
+
+  return rs;
+}
+
+int
+httpd_reply_stream_add(struct httpd_reply_stream *rs, struct evbuffer *evbuf)
+{
+  int ret;
+
+  ret = reply_stream_deflate(rs, evbuf, Z_NO_FLUSH);
+  if (ret < 0)
+    return -1;
+
+  if (evbuffer_get_length(rs->out) < STREAM_CHUNK_SIZE)
+    return 0;
+
+  return reply_stream_send(rs);
+}
+
+void
+httpd_reply_stream_end(struct httpd_reply_stream *rs)
+{
+  struct evbuffer *evbuf;
+
+  if (rs->gzip)
+    {
+      CHECK_NULL(L_HTTPD, evbuf = evbuffer_new());
+      reply_stream_deflate(rs, evbuf, Z_FINISH);
+      evbuffer_free(evbuf);
+    }
+
+  reply_stream_send(rs);
+
+  if (!rs->deferred)
+    {
+      evhttp_send_reply_end(rs->req);
+      reply_stream_free(rs);
+      return;
+    }
+
+  // From here the httpd thread owns rs, and will free it. It may already be
+  // running reply_stream_cb() for earlier data, so the event must be activated
+  // before we let go of the lock, otherwise rs could be freed under us.
+  CHECK_ERR(L_HTTPD, pthread_mutex_lock(&rs->lck));
+  rs->ended = true;
+  event_active(rs->ev, 0, 0);
+  CHECK_ERR(L_HTTPD, pthread_mutex_unlock(&rs->lck));
+}
+
 // This is a modified version of evhttp_send_error (credit libevent)
 void
 httpd_send_error(struct evhttp_request* req, int error, const char* reason)
@@ -1471,6 +2753,12 @@ httpd_send_error(struct evhttp_request* req, int error, const char* reason)
   struct evkeyvalq *output_headers;
   struct evbuffer *evbuf;
 
+  if (is_worker)
+    {
+      deferred_send(HTTPD_DEFERRED_ERROR, req, error, reason, NULL, 0);
+      return;
+    }
+
   if (!allow_origin)
     {
       evhttp_send_error(req, error, reason);
@@ -1500,28 +2788,25 @@ httpd_send_error(struct evhttp_request* req, int error, const char* reason)
 bool
 httpd_admin_check_auth(struct evhttp_request *req)
 {
-  struct evhttp_connection *evcon;
   char *addr;
   uint16_t port;
   const char *passwd;
   int ret;
 
-  evcon = evhttp_request_get_connection(req);
-  if (!evcon)
+  ret = request_peer_get(req, &addr, &port);
+  if (ret < 0 || !addr)
     {
       DPRINTF(E_LOG, L_HTTPD, "Connection to client lost or missing\n");
       return false;
     }
 
-  evhttp_connection_get_peer(evcon, &addr, &port);
-
   if (peer_address_is_trusted(addr))
     return true;
 
   passwd = cfg_getstr(cfg_getsec(cfg, "general"), "admin_password");
   if (!passwd)
     {
-      DPRINTF(E_LOG, L_HTTPD, "Web interface request to '%s' denied: No password set in the config\n", evhttp_request_get_uri(req));
+      DPRINTF(E_LOG, L_HTTPD, "Web interface request to '%s' denied: No password set in the config\n", request_uri(req));
 
       httpd_send_error(req, 403, "Forbidden");
       return false;
@@ -1532,7 +2817,7 @@ httpd_admin_check_auth(struct evhttp_request *req)
   ret = httpd_basic_auth(req, "admin", passwd, PACKAGE " web interface");
   if (ret != 0)
     {
-      DPRINTF(E_LOG, L_HTTPD, "Web interface request to '%s' denied: Incorrect password\n", evhttp_request_get_uri(req));
+      DPRINTF(E_LOG, L_HTTPD, "Web interface request to '%s' denied: Incorrect password\n", request_uri(req));
 
       // httpd_basic_auth has sent a reply
       return false;
@@ -1554,7 +2839,7 @@ httpd_basic_auth(struct evhttp_request *req, const char *user, const char *passw
   char *authpwd;
   int ret;
 
-  headers = evhttp_request_get_input_headers(req);
+  headers = httpd_request_input_headers(req);
   auth = evhttp_find_header(headers, "Authorization");
   if (!auth)
     {
@@ -1630,7 +2915,7 @@ httpd_basic_auth(struct evhttp_request *req, const char *user, const char *passw
       return -1;
     }
 
-  headers = evhttp_request_get_output_headers(req);
+  headers = httpd_request_output_headers(req);
   evhttp_add_header(headers, "WWW-Authenticate", header);
 
   evbuffer_add(evbuf, http_reply_401, strlen(http_reply_401));
@@ -1642,6 +2927,40 @@ httpd_basic_auth(struct evhttp_request *req, const char *user, const char *passw
   return -1;
 }
 
+int
+httpd_latency_stats_get(struct httpd_latency_stats *stats, int size, int *threads)
+{
+  struct httpd_latency *l;
+  uint64_t buckets[HTTPD_LATENCY_BUCKETS];
+  uint64_t count;
+  int i;
+  int j;
+
+  for (i = 0; (i < HTTPD_ENDPOINT_MAX) && (i < size); i++)
+    {
+      l = &httpd_latency[i];
+
+      // Not an atomic snapshot, but good enough for statistics
+      for (j = 0, count = 0; j < HTTPD_LATENCY_BUCKETS; j++)
+	{
+	  buckets[j] = __atomic_load_n(&l->buckets[j], __ATOMIC_RELAXED);
+	  count += buckets[j];
+	}
+
+      stats[i].endpoint = httpd_endpoint_names[i];
+      stats[i].requests = count;
+      stats[i].max_us = __atomic_load_n(&l->max_us, __ATOMIC_RELAXED);
+      stats[i].p50_us = latency_percentile(buckets, count, stats[i].max_us, 50);
+      stats[i].p90_us = latency_percentile(buckets, count, stats[i].max_us, 90);
+      stats[i].p99_us = latency_percentile(buckets, count, stats[i].max_us, 99);
+    }
+
+  if (threads)
+    *threads = nworkers;
+
+  return i;
+}
+
 /* Thread: main */
 int
 httpd_init(const char *webroot)
@@ -1817,6 +3136,8 @@ httpd_init(const char *webroot)
 
   evhttp_set_gencb(evhttpd, httpd_gen_cb, NULL);
 
+  workers_start(cfg_getint(cfg_getsec(cfg, "general"), "httpd_threads"));
+
   ret = pthread_create(&tid_httpd, NULL, httpd, NULL);
   if (ret != 0)
     {
@@ -1834,6 +3155,7 @@ httpd_init(const char *webroot)
   return 0;
 
  thread_fail:
+  workers_stop();
  bind_fail:
   evhttp_free(evhttpd);
  evhttpd_fail:
@@ -1902,6 +3224,8 @@ httpd_deinit(void)
       return;
     }
 
+  workers_stop();
+
   streaming_deinit();
 #ifdef HAVE_LIBWEBSOCKETS
   websocket_deinit();
@@ -1920,5 +3244,6 @@ httpd_deinit(void)
 #endif
   event_free(exitev);
   evhttp_free(evhttpd);
+  webroot_cache_purge();
   event_base_free(evbase_httpd);
 }
@@ -3,6 +3,7 @@
 #define __HTTPD_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <regex.h>
 #include <time.h>
 #include <event2/http.h>
@@ -101,6 +102,21 @@ httpd_request_parse(struct evhttp_request *req, struct httpd_uri_parsed *uri_par
 void
 httpd_stream_file(struct evhttp_request *req, int id);
 
+/*
+ * Request handlers must use these instead of evhttp_request_get_input_headers()
+ * etc. If the handler runs in a worker thread, they return copies made by the
+ * httpd thread, since evhttp must only be used from there, and the output
+ * headers are added to req when the httpd thread sends the reply.
+ */
+struct evkeyvalq *
+httpd_request_input_headers(struct evhttp_request *req);
+
+struct evkeyvalq *
+httpd_request_output_headers(struct evhttp_request *req);
+
+struct evbuffer *
+httpd_request_input_buffer(struct evhttp_request *req);
+
 bool
 httpd_request_not_modified_since(struct evhttp_request *req, time_t mtime);
 
@@ -135,6 +151,41 @@ httpd_gzip_deflate(struct evbuffer *in);
 void
 httpd_send_reply(struct evhttp_request *req, int code, const char *reason, struct evbuffer *evbuf, enum httpd_send_flags flags);
 
+/*
+ * Starts a chunked reply, for replies that are too large to be built in memory
+ * first. Data given to httpd_reply_stream_add() is gzipped on the fly (if the
+ * client accepts it and flags allow it) and sent in chunks. When called from a
+ * worker thread, adding will wait while the client is behind, so memory use is
+ * bounded by the chunk size. When called from the httpd thread (httpd_threads
+ * is 0) it can't wait, so the whole reply is queued in evhttp, though gzipped
+ * and without a copy of the uncompressed reply. The reply must always be
+ * finished with httpd_reply_stream_end(), also if adding fails. Should be
+ * thread safe.
+ *
+ * @in  req      The evhttp request struct
+ * @in  code     HTTP code, e.g. 200
+ * @in  reason   A brief explanation of the error - if NULL the standard meaning
+                 of the error code will be used
+ * @in  flags    See flags above
+ * @return       Stream handle, or NULL if req is NULL
+ */
+struct httpd_reply_stream *
+httpd_reply_stream_start(struct evhttp_request *req, int code, const char *reason, enum httpd_send_flags flags);
+
+/*
+ * Adds data to a chunked reply, the evbuf is drained.
+ *
+ * @return       0 on success, -1 if the connection was closed or on error
+ */
+int
+httpd_reply_stream_add(struct httpd_reply_stream *rs, struct evbuffer *evbuf);
+
+/*
+ * Sends what remains and ends the chunked reply. Frees rs.
+ */
+void
+httpd_reply_stream_end(struct httpd_reply_stream *rs);
+
 /*
  * This is a substitute for evhttp_send_error that should be used whenever an
  * error may be returned to a browser. It will set CORS headers as appropriate,
@@ -162,6 +213,31 @@ httpd_admin_check_auth(struct evhttp_request *req);
 int
 httpd_basic_auth(struct evhttp_request *req, const char *user, const char *passwd, const char *realm);
 
+struct httpd_latency_stats
+{
+  const char *endpoint;
+  uint64_t requests;
+  uint64_t p50_us;
+  uint64_t p90_us;
+  uint64_t p99_us;
+  uint64_t max_us;
+};
+
+/*
+ * Request latency per endpoint (dacp, daap, jsonapi etc.), measured from when
+ * the request is received until the handler is done with it. For requests
+ * that are left hanging by the handler (e.g. DAAP update) the time until the
+ * reply is made is not included. The percentiles are approximate (power of two
+ * buckets).
+ *
+ * @out stats    Array that will be filled with the stats
+ * @in  size     Size of the array
+ * @out threads  Number of httpd worker threads (may be NULL)
+ * @return       Number of endpoints in stats
+ */
+int
+httpd_latency_stats_get(struct httpd_latency_stats *stats, int size, int *threads);
+
 int
 httpd_init(const char *webroot);
 
@@ -21,8 +21,10 @@
 #endif
 
 #include <regex.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
 
 #include "httpd_artworkapi.h"
@@ -63,8 +65,10 @@ static int
 response_process(struct httpd_request *hreq, int format)
 {
   struct evkeyvalq *headers;
+  char etag[21];
+  size_t len;
 
-  headers = evhttp_request_get_output_headers(hreq->req);
+  headers = httpd_request_output_headers(hreq->req);
 
   if (format == ART_FMT_PNG)
     evhttp_add_header(headers, "Content-Type", "image/png");
@@ -73,6 +77,13 @@ response_process(struct httpd_request *hreq, int format)
   else
     return HTTP_NOCONTENT;
 
+  // The image usually comes from the artwork cache as a single chunk, so the
+  // pullup doesn't copy. Clients that have the image won't get it again.
+  len = evbuffer_get_length(hreq->reply);
+  snprintf(etag, sizeof(etag), "\"%" PRIx64 "\"", murmur_hash64(evbuffer_pullup(hreq->reply, -1), len, 0));
+  if (httpd_request_etag_matches(hreq->req, etag))
+    return HTTP_NOTMODIFIED;
+
   return HTTP_OK;
 }
 
@@ -37,6 +37,7 @@
 #include <inttypes.h>
 #include <time.h>
 #include <ctype.h>
+#include <pthread.h>
 
 #include <uninorm.h>
 #include <unistd.h>
@@ -73,6 +74,11 @@ extern struct event_base *evbase_httpd;
 /* Update requests refresh interval in seconds */
 #define DAAP_UPDATE_REFRESH  0
 
+/* Song lists with at least this many items are sent as a chunked reply */
+#define DAAP_SONGLIST_STREAM_MIN 5000
+/* Encoded songs are passed to the chunked reply in pieces of this size */
+#define DAAP_SONGLIST_CHUNK_SIZE (16 * 1024)
+
 /* Database number for the Radio item */
 #define DAAP_DB_RADIO 2
 
@@ -122,8 +128,11 @@ static char *default_meta_plsongs = "dmap.itemkind,dmap.itemid,dmap.itemname,dma
 static char *default_meta_pl = "dmap.itemid,dmap.itemname,dmap.persistentid,com.apple.itunes.smart-playlist";
 static char *default_meta_group = "dmap.itemname,dmap.persistentid,daap.songalbumartist";
 
-/* DAAP session tracking */
+/* DAAP session tracking, requests may be handled by httpd worker threads so
+ * the list is protected by a lock. Handlers only get a copy of the session.
+ */
 static struct daap_session *daap_sessions;
+static pthread_mutex_t daap_sessions_lck;
 
 /* Update requests */
 static int current_rev;
@@ -185,6 +194,30 @@ daap_session_get(int id)
   return NULL;
 }
 
+/* Copies the session with the given id to *session and refreshes its mtime.
+ * Returns -1 if not found.
+ */
+static int
+daap_session_copy(struct daap_session *session, int id)
+{
+  struct daap_session *s;
+
+  CHECK_ERR(L_DAAP, pthread_mutex_lock(&daap_sessions_lck));
+
+  s = daap_session_get(id);
+  if (s)
+    {
+      s->mtime = time(NULL);
+
+      *session = *s;
+      session->next = NULL;
+    }
+
+  CHECK_ERR(L_DAAP, pthread_mutex_unlock(&daap_sessions_lck));
+
+  return s ? 0 : -1;
+}
+
 /* Removes stale sessions and also drops the oldest sessions if DAAP_SESSION_MAX
  * will otherwise be exceeded
  */
@@ -738,7 +771,7 @@ daap_request_authorize(struct httpd_request *hreq)
 	  return -1;
 	}
 
-      session->mtime = time(NULL);
+      // Session mtime was refreshed by daap_session_copy()
       return 0;
     }
 
@@ -799,7 +832,7 @@ daap_reply_server_info(struct httpd_request *hreq)
   mpro = 2 << 16 | 10;
   apro = 3 << 16 | 12;
 
-  headers = evhttp_request_get_input_headers(hreq->req);
+  headers = httpd_request_input_headers(hreq->req);
   if (headers && (clientver = evhttp_find_header(headers, "Client-DAAP-Version")))
     {
       if (strcmp(clientver, "1.0") == 0)
@@ -919,6 +952,7 @@ daap_reply_login(struct httpd_request *hreq)
   struct pairing_info pi;
   const char *param;
   int request_session_id;
+  int session_id;
   int ret;
 
   CHECK_ERR(L_DAAP, evbuffer_expand(hreq->reply, 32));
@@ -967,8 +1001,12 @@ daap_reply_login(struct httpd_request *hreq)
   else
     request_session_id = 0;
 
+  CHECK_ERR(L_DAAP, pthread_mutex_lock(&daap_sessions_lck));
   session = daap_session_add(adhoc->is_remote, request_session_id);
-  if (!session)
+  session_id = session ? session->id : 0;
+  CHECK_ERR(L_DAAP, pthread_mutex_unlock(&daap_sessions_lck));
+
+  if (!session_id)
     {
       dmap_error_make(hreq->reply, "mlog", "Could not start session");
       return DAAP_REPLY_ERROR;
@@ -976,7 +1014,7 @@ daap_reply_login(struct httpd_request *hreq)
 
   dmap_add_container(hreq->reply, "mlog", 24);
   dmap_add_int(hreq->reply, "mstt", 200);          /* 12 */
-  dmap_add_int(hreq->reply, "mlid", session->id);  /* 12 */
+  dmap_add_int(hreq->reply, "mlid", session_id);   /* 12 */
 
   return DAAP_REPLY_OK;
 }
@@ -984,10 +1022,15 @@ daap_reply_login(struct httpd_request *hreq)
 static enum daap_reply_result
 daap_reply_logout(struct httpd_request *hreq)
 {
-  if (!hreq->extra_data)
+  struct daap_session *session = hreq->extra_data;
+
+  if (!session)
     return DAAP_REPLY_FORBIDDEN;
 
-  daap_session_remove(hreq->extra_data);
+  // hreq->extra_data is just a copy, so remove the real session
+  CHECK_ERR(L_DAAP, pthread_mutex_lock(&daap_sessions_lck));
+  daap_session_remove(daap_session_get(session->id));
+  CHECK_ERR(L_DAAP, pthread_mutex_unlock(&daap_sessions_lck));
 
   hreq->extra_data = NULL;
 
@@ -1176,26 +1219,218 @@ daap_reply_dblist(struct httpd_request *hreq)
   return DAAP_REPLY_OK;
 }
 
+enum songlist_mode
+{
+  // Build the entire song list in the songlist evbuffer
+  SONGLIST_BUILD,
+  // Only find the length of the encoded song list
+  SONGLIST_MEASURE,
+  // Encode and send the song list via a chunked reply
+  SONGLIST_SEND,
+};
+
+/*
+ * Encodes the songs of a started query. Except when sending, the sort headers
+ * are also built. Returns the number of songs, -100 on out of memory and -1 on
+ * other errors. The total length of the encoded songs is returned in len.
+ */
+static int
+songlist_encode(struct httpd_request *hreq, struct query_params *qp, enum songlist_mode mode, struct evbuffer *songlist, struct evbuffer *song, const struct dmap_field **meta, int nmeta, int sort_headers, struct sort_ctx *sctx, struct httpd_reply_stream *rs, size_t *len)
+{
+  struct db_media_file_info dbmfi;
+  struct evkeyvalq *headers;
+  struct daap_session *s;
+  const char *client_codecs;
+  char *last_codectype;
+  size_t songlist_len;
+  int nsongs;
+  int transcode;
+  int ret;
+
+  s = hreq->extra_data;
+
+  client_codecs = NULL;
+  if (!s->is_remote && hreq->req)
+    {
+      headers = httpd_request_input_headers(hreq->req);
+      client_codecs = evhttp_find_header(headers, "Accept-Codecs");
+    }
+
+  *len = 0;
+  nsongs = 0;
+  transcode = 0;
+  last_codectype = NULL;
+  while (((ret = db_query_fetch_file(qp, &dbmfi)) == 0) && (dbmfi.id))
+    {
+      nsongs++;
+
+      if (!dbmfi.codectype)
+	{
+	  DPRINTF(E_LOG, L_DAAP, "Cannot transcode '%s', codec type is unknown\n", dbmfi.fname);
+
+	  transcode = 0;
+	}
+      else if (s->is_remote)
+	{
+	  transcode = 1;
+	}
+      else if (!last_codectype || (strcmp(last_codectype, dbmfi.codectype) != 0))
+	{
+	  transcode = transcode_needed(hreq->user_agent, client_codecs, dbmfi.codectype);
+
+	  free(last_codectype);
+	  last_codectype = strdup(dbmfi.codectype);
+	}
+
+      songlist_len = evbuffer_get_length(songlist);
+
+      ret = dmap_encode_file_metadata(songlist, song, &dbmfi, meta, nmeta, sort_headers, transcode);
+      if (ret < 0)
+	{
+	  DPRINTF(E_LOG, L_DAAP, "Failed to encode song metadata\n");
+
+	  ret = -100;
+	  break;
+	}
+
+      *len += evbuffer_get_length(songlist) - songlist_len;
+
+      if (mode == SONGLIST_MEASURE)
+	evbuffer_drain(songlist, evbuffer_get_length(songlist));
+      else if (mode == SONGLIST_SEND && evbuffer_get_length(songlist) >= DAAP_SONGLIST_CHUNK_SIZE)
+	{
+	  ret = httpd_reply_stream_add(rs, songlist);
+	  if (ret < 0)
+	    break;
+	}
+
+      if (sort_headers && mode != SONGLIST_SEND)
+	{
+	  ret = daap_sort_build(sctx, dbmfi.title_sort);
+	  if (ret < 0)
+	    {
+	      DPRINTF(E_LOG, L_DAAP, "Could not add sort header to DAAP song list reply\n");
+
+	      ret = -100;
+	      break;
+	    }
+   	}
+
+      DPRINTF(E_SPAM, L_DAAP, "Done with song\n");
+    }
+
+  free(last_codectype);
+
+  if (ret < 0)
+    return ret;
+
+  return nsongs;
+}
+
+static void
+songlist_header_add(struct evbuffer *evbuf, const char *tag, struct query_params *qp, int nsongs, size_t len, struct sort_ctx *sctx, int sort_headers)
+{
+  if (sort_headers)
+    dmap_add_container(evbuf, tag, len + evbuffer_get_length(sctx->headerlist) + 61);
+  else
+    dmap_add_container(evbuf, tag, len + 53);
+
+  dmap_add_int(evbuf, "mstt", 200);        /* 12 */
+  dmap_add_char(evbuf, "muty", 0);         /* 9 */
+  dmap_add_int(evbuf, "mtco", qp->results); /* 12 */
+  dmap_add_int(evbuf, "mrco", nsongs);     /* 12 */
+  dmap_add_container(evbuf, "mlcl", len); /* 8 */
+}
+
+static void
+songlist_sort_headers_add(struct evbuffer *evbuf, struct sort_ctx *sctx, int sort_headers)
+{
+  if (!sort_headers)
+    return;
+
+  dmap_add_container(evbuf, "mshl", evbuffer_get_length(sctx->headerlist)); /* 8 */
+
+  CHECK_ERR(L_DAAP, evbuffer_add_buffer(evbuf, sctx->headerlist));
+}
+
+/*
+ * Large song lists are sent as a chunked reply, so that we don't need to keep
+ * the whole list in memory. Since DMAP containers start with their length, the
+ * songs are encoded twice: First to measure, then to send. Both passes run in
+ * the same read transaction, so they see the same library. Returns
+ * DAAP_REPLY_NONE if the reply was started, since it can then no longer be
+ * replaced with an error reply.
+ */
+static enum daap_reply_result
+songlist_stream(struct httpd_request *hreq, struct query_params *qp, const char *tag, struct evbuffer *songlist, struct evbuffer *song, const struct dmap_field **meta, int nmeta, int sort_headers, struct sort_ctx *sctx)
+{
+  struct httpd_reply_stream *rs;
+  size_t len;
+  size_t sent_len;
+  int nsongs;
+  int ret;
+
+  nsongs = songlist_encode(hreq, qp, SONGLIST_MEASURE, songlist, song, meta, nmeta, sort_headers, sctx, NULL, &len);
+  db_query_end(qp);
+  if (nsongs < 0)
+    {
+      dmap_error_make(hreq->reply, tag, (nsongs == -100) ? "Out of memory" : "Error fetching query results");
+      return DAAP_REPLY_ERROR;
+    }
+
+  if (sort_headers)
+    daap_sort_finalize(sctx);
+
+  ret = db_query_start(qp);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_DAAP, "Could not restart query\n");
+
+      dmap_error_make(hreq->reply, tag, "Could not start query");
+      return DAAP_REPLY_ERROR;
+    }
+
+  DPRINTF(E_DBG, L_DAAP, "Streaming song list, %d songs, %zu bytes\n", nsongs, len);
+
+  rs = httpd_reply_stream_start(hreq->req, HTTP_OK, "OK", 0);
+
+  songlist_header_add(songlist, tag, qp, nsongs, len, sctx, sort_headers);
+
+  ret = songlist_encode(hreq, qp, SONGLIST_SEND, songlist, song, meta, nmeta, sort_headers, sctx, rs, &sent_len);
+  db_query_end(qp);
+  if (ret < 0)
+    DPRINTF(E_LOG, L_DAAP, "Song list reply to '%s' was aborted\n", hreq->peer_address);
+  else if (ret != nsongs || sent_len != len)
+    DPRINTF(E_LOG, L_DAAP, "Bug! Song list changed while streaming (%d/%d songs, %zu/%zu bytes)\n", ret, nsongs, sent_len, len);
+  else
+    {
+      songlist_sort_headers_add(songlist, sctx, sort_headers);
+      httpd_reply_stream_add(rs, songlist);
+    }
+
+  // If aborted the client gets a truncated reply, which it will reject due to
+  // the container length
+  httpd_reply_stream_end(rs);
+
+  return DAAP_REPLY_NONE;
+}
+
 static enum daap_reply_result
 daap_reply_songlist_generic(struct httpd_request *hreq, int playlist)
 {
   struct query_params qp;
-  struct db_media_file_info dbmfi;
   struct evbuffer *song;
   struct evbuffer *songlist;
-  struct evkeyvalq *headers;
   struct daap_session *s;
   const struct dmap_field **meta;
   struct sort_ctx *sctx;
+  enum daap_reply_result result;
   const char *param;
-  const char *client_codecs;
   const char *tag;
-  char *last_codectype;
   size_t len;
   int nmeta;
   int sort_headers;
   int nsongs;
-  int transcode;
   int ret;
 
   DPRINTF(E_DBG, L_DAAP, "Fetching song list for playlist %d\n", playlist);
@@ -1252,83 +1487,52 @@ daap_reply_songlist_generic(struct httpd_request *hreq, int playlist)
       nmeta = 0;
     }
 
+  // A large list may be streamed, which requires the query to be run twice on
+  // the same data
+  if (hreq->req)
+    db_transaction_begin();
+
   ret = db_query_start(&qp);
   if (ret < 0)
     {
       DPRINTF(E_LOG, L_DAAP, "Could not start query\n");
 
+      if (hreq->req)
+	db_transaction_end();
       free(meta);
       dmap_error_make(hreq->reply, tag, "Could not start query");
       goto error;
     }
 
-  client_codecs = NULL;
-  if (!s->is_remote && hreq->req)
+  if (hreq->req && qp.results >= DAAP_SONGLIST_STREAM_MIN)
     {
-      headers = evhttp_request_get_input_headers(hreq->req);
-      client_codecs = evhttp_find_header(headers, "Accept-Codecs");
-    }
-
-  nsongs = 0;
-  last_codectype = NULL;
-  while (((ret = db_query_fetch_file(&qp, &dbmfi)) == 0) && (dbmfi.id))
-    {
-      nsongs++;
-
-      if (!dbmfi.codectype)
-	{
-	  DPRINTF(E_LOG, L_DAAP, "Cannot transcode '%s', codec type is unknown\n", dbmfi.fname);
-
-	  transcode = 0;
-	}
-      else if (s->is_remote)
-	{
-	  transcode = 1;
-	}
-      else if (!last_codectype || (strcmp(last_codectype, dbmfi.codectype) != 0))
-	{
-	  transcode = transcode_needed(hreq->user_agent, client_codecs, dbmfi.codectype);
-
-	  free(last_codectype);
-	  last_codectype = strdup(dbmfi.codectype);
-	}
-
-      ret = dmap_encode_file_metadata(songlist, song, &dbmfi, meta, nmeta, sort_headers, transcode);
-      if (ret < 0)
-	{
-	  DPRINTF(E_LOG, L_DAAP, "Failed to encode song metadata\n");
-
-	  ret = -100;
-	  break;
-	}
-
-      if (sort_headers)
-	{
-	  ret = daap_sort_build(sctx, dbmfi.title_sort);
-	  if (ret < 0)
-	    {
-	      DPRINTF(E_LOG, L_DAAP, "Could not add sort header to DAAP song list reply\n");
+      result = songlist_stream(hreq, &qp, tag, songlist, song, meta, nmeta, sort_headers, sctx);
 
-	      ret = -100;
-	      break;
-	    }
-   	}
+      db_transaction_end();
+      free(meta);
+      daap_sort_context_free(sctx);
+      evbuffer_free(song);
+      evbuffer_free(songlist);
+      free_query_params(&qp, 1);
 
-      DPRINTF(E_SPAM, L_DAAP, "Done with song\n");
+      return result;
     }
 
+  nsongs = songlist_encode(hreq, &qp, SONGLIST_BUILD, songlist, song, meta, nmeta, sort_headers, sctx, NULL, &len);
+
   DPRINTF(E_DBG, L_DAAP, "Done with song list, %d songs\n", nsongs);
 
-  free(last_codectype);
   free(meta);
   db_query_end(&qp);
+  if (hreq->req)
+    db_transaction_end();
 
-  if (ret == -100)
+  if (nsongs == -100)
     {
       dmap_error_make(hreq->reply, tag, "Out of memory");
       goto error;
     }
-  else if (ret < 0)
+  else if (nsongs < 0)
     {
       DPRINTF(E_LOG, L_DAAP, "Error fetching results\n");
       dmap_error_make(hreq->reply, tag, "Error fetching query results");
@@ -1336,30 +1540,14 @@ daap_reply_songlist_generic(struct httpd_request *hreq, int playlist)
     }
 
   /* Add header to evbuf, add songlist to evbuf */
-  len = evbuffer_get_length(songlist);
   if (sort_headers)
-    {
-      daap_sort_finalize(sctx);
-      dmap_add_container(hreq->reply, tag, len + evbuffer_get_length(sctx->headerlist) + 61);
-    }
-  else
-    dmap_add_container(hreq->reply, tag, len + 53);
+    daap_sort_finalize(sctx);
 
-  dmap_add_int(hreq->reply, "mstt", 200);        /* 12 */
-  dmap_add_char(hreq->reply, "muty", 0);         /* 9 */
-  dmap_add_int(hreq->reply, "mtco", qp.results); /* 12 */
-  dmap_add_int(hreq->reply, "mrco", nsongs);     /* 12 */
-  dmap_add_container(hreq->reply, "mlcl", len); /* 8 */
+  songlist_header_add(hreq->reply, tag, &qp, nsongs, len, sctx, sort_headers);
 
   CHECK_ERR(L_DAAP, evbuffer_add_buffer(hreq->reply, songlist));
 
-  if (sort_headers)
-    {
-      len = evbuffer_get_length(sctx->headerlist);
-      dmap_add_container(hreq->reply, "mshl", len); /* 8 */
-
-      CHECK_ERR(L_DAAP, evbuffer_add_buffer(hreq->reply, sctx->headerlist));
-    }
+  songlist_sort_headers_add(hreq->reply, sctx, sort_headers);
 
   daap_sort_context_free(sctx);
   evbuffer_free(song);
@@ -2043,7 +2231,7 @@ daap_reply_extra_data(struct httpd_request *hreq)
 	goto no_artwork;
     }
 
-  headers = evhttp_request_get_output_headers(hreq->req);
+  headers = httpd_request_output_headers(hreq->req);
   evhttp_remove_header(headers, "Content-Type");
   evhttp_add_header(headers, "Content-Type", ctype);
   snprintf(clen, sizeof(clen), "%ld", (long)len);
@@ -2272,7 +2460,10 @@ daap_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed)
       return;
     }
 
-  // Check if we have a session and point hreq->extra_data to it
+  // Check if we have a session and point hreq->extra_data to a copy of it
+  memset(&session, 0, sizeof(struct daap_session));
+  hreq->extra_data = &session;
+
   param = evhttp_find_header(hreq->query, "session-id");
   if (param)
     {
@@ -2280,16 +2471,12 @@ daap_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed)
       if (ret < 0)
 	DPRINTF(E_LOG, L_DAAP, "Ignoring non-numeric session id in DAAP request: '%s'\n", uri_parsed->uri);
       else
-	hreq->extra_data = daap_session_get(id);
+	daap_session_copy(&session, id);
     }
 
-  // Create an ad-hoc session, which is a way of passing is_remote to the handler, even though no real session exists
-  if (!hreq->extra_data)
-    {
-      memset(&session, 0, sizeof(struct daap_session));
-      session.is_remote = (evhttp_find_header(hreq->query, "pairing-guid") != NULL);
-      hreq->extra_data = &session;
-    }
+  // If not found this is an ad-hoc session, which is a way of passing is_remote to the handler, even though no real session exists
+  if (!session.id)
+    session.is_remote = (evhttp_find_header(hreq->query, "pairing-guid") != NULL);
 
   ret = daap_request_authorize(hreq);
   if (ret < 0)
@@ -2299,7 +2486,7 @@ daap_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed)
     }
 
   // Set reply headers
-  headers = evhttp_request_get_output_headers(req);
+  headers = httpd_request_output_headers(req);
   evhttp_add_header(headers, "Accept-Ranges", "bytes");
   evhttp_add_header(headers, "DAAP-Server", "forked-daapd/" VERSION);
   // Content-Type for all replies, even the actual audio streaming. Note that
@@ -2311,12 +2498,12 @@ daap_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed)
   CHECK_NULL(L_DAAP, hreq->reply = evbuffer_new());
 
   // Try the cache
-  ret = cache_daap_get(hreq->reply, uri_parsed->uri);
+  ret = cache_daap_get(hreq->reply, uri_parsed->uri, hreq->user_agent, session.is_remote);
   if (ret == 0)
     {
       // The cache will return the data gzipped, so httpd_send_reply won't need to do it
       evhttp_add_header(headers, "Content-Encoding", "gzip");
-      httpd_send_reply(req, HTTP_OK, "OK", hreq->reply, HTTPD_SEND_NO_GZIP); // TODO not all want this reply
+      httpd_send_reply(req, HTTP_OK, "OK", hreq->reply, HTTPD_SEND_NO_GZIP);
 
       evbuffer_free(hreq->reply);
       free(hreq);
@@ -2371,16 +2558,21 @@ daap_is_request(const char *path)
 }
 
 int
-daap_session_is_valid(int id)
+daap_is_threadsafe_request(const char *path)
 {
-  struct daap_session *session;
+  // Update requests are left hanging on the httpd event loop
+  if (strcmp(path, "/update") == 0)
+    return 0;
 
-  session = daap_session_get(id);
+  return 1;
+}
 
-  if (session)
-    session->mtime = time(NULL);
+int
+daap_session_is_valid(int id)
+{
+  struct daap_session session;
 
-  return session ? 1 : 0;
+  return (daap_session_copy(&session, id) == 0) ? 1 : 0;
 }
 
 // Thread: Cache
@@ -2443,6 +2635,8 @@ daap_init(void)
   current_rev = 2;
   update_requests = NULL;
 
+  CHECK_ERR(L_DAAP, mutex_init(&daap_sessions_lck));
+
   for (i = 0; daap_handlers[i].handler; i++)
     {
       ret = regcomp(&daap_handlers[i].preg, daap_handlers[i].regexp, REG_EXTENDED | REG_NOSUB);
@@ -2475,6 +2669,8 @@ daap_deinit(void)
       daap_session_free(s);
     }
 
+  CHECK_ERR(L_DAAP, pthread_mutex_destroy(&daap_sessions_lck));
+
   for (ur = update_requests; update_requests; ur = update_requests)
     {
       update_requests = ur->next;
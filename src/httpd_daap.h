@@ -16,6 +16,9 @@ daap_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed);
 int
 daap_is_request(const char *path);
 
+int
+daap_is_threadsafe_request(const char *path);
+
 int
 daap_session_is_valid(int id);
 
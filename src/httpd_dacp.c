@@ -52,6 +52,10 @@
 
 #define DACP_VOLUME_STEP 5
 
+/* How long a playstatusupdate reply can be reused while playing, since the
+ * remaining time in it gets old */
+#define DACP_STATUS_REPLY_MAX_AGE_MS 1000
+
 /* httpd event base, from httpd.c */
 extern struct event_base *evbase_httpd;
 
@@ -61,6 +65,20 @@ struct dacp_update_request {
   struct dacp_update_request *next;
 };
 
+/* A playstatusupdate reply. It is built once per revision and never modified,
+ * so it can be added by reference to the replies of all clients that need it.
+ * Freed when the last reference is dropped.
+ */
+struct dacp_status_reply {
+  int refcount;
+  int rev;
+  int playing;
+  struct timespec expires;
+
+  size_t len;
+  uint8_t *data;
+};
+
 typedef void (*dacp_propget)(struct evbuffer *evbuf, struct player_status *status, struct db_queue_item *queue_item);
 typedef void (*dacp_propset)(const char *value, struct httpd_request *hreq);
 
@@ -145,6 +163,9 @@ static int current_rev;
 /* Play status update requests */
 static struct dacp_update_request *update_requests;
 
+/* Reply for current_rev, NULL until someone asks for it */
+static struct dacp_status_reply *status_reply;
+
 /* Seek timer */
 static struct event *seek_timer;
 static int seek_target;
@@ -255,13 +276,7 @@ find_first_song_id(const char *query)
 
   if (((ret = db_query_fetch_file(&qp, &dbmfi)) == 0) && (dbmfi.id))
     {
-      ret = safe_atoi32(dbmfi.id, &id);
-      if (ret < 0)
-	{
-	  DPRINTF(E_LOG, L_DACP, "Invalid song id in query result!\n");
-
-	  goto no_result;
-	}
+      id = dbmfi.id;
 
       DPRINTF(E_DBG, L_DACP, "Found index song (id %d)\n", id);
       ret = 1;
@@ -645,7 +660,7 @@ dacp_request_authorize(struct httpd_request *hreq)
 /* ---------------------- UPDATE REQUESTS HANDLERS -------------------------- */
 
 static int
-make_playstatusupdate(struct evbuffer *evbuf)
+make_playstatusupdate(struct evbuffer *evbuf, int *play_status)
 {
   struct player_status status;
   struct db_queue_item *queue_item = NULL;
@@ -705,7 +720,104 @@ make_playstatusupdate(struct evbuffer *evbuf)
 
   evbuffer_free(psu);
 
-  DPRINTF(E_DBG, L_DACP, "Replying to playstatusupdate with status %d and current_rev %d\n", status.status, current_rev);
+  DPRINTF(E_DBG, L_DACP, "Made playstatusupdate with status %d and current_rev %d\n", status.status, current_rev);
+
+  *play_status = status.status;
+
+  return 0;
+}
+
+static void
+status_reply_unref(struct dacp_status_reply *reply)
+{
+  if (__atomic_sub_fetch(&reply->refcount, 1, __ATOMIC_ACQ_REL) > 0)
+    return;
+
+  free(reply->data);
+  free(reply);
+}
+
+/* Called by libevent when it is done with a reply added by reference */
+static void
+status_reply_cleanup_cb(const void *data, size_t datalen, void *extra)
+{
+  status_reply_unref(extra);
+}
+
+static void
+status_reply_expire(void)
+{
+  if (!status_reply)
+    return;
+
+  status_reply_unref(status_reply);
+  status_reply = NULL;
+}
+
+/* Returns the reply for current_rev, only building it if we don't have it yet
+ * or if the playing time in it is too old. The reply is owned by status_reply,
+ * so the caller must take a reference with status_reply_add().
+ */
+static struct dacp_status_reply *
+status_reply_get(void)
+{
+  struct dacp_status_reply *reply;
+  struct evbuffer *evbuf;
+  struct timespec now;
+  struct timespec max_age = { 0, DACP_STATUS_REPLY_MAX_AGE_MS * 1000000L };
+  int play_status;
+  int ret;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  reply = status_reply;
+  if (reply && reply->rev == current_rev && (!reply->playing || timespec_cmp(now, reply->expires) < 0))
+    return reply;
+
+  status_reply_expire();
+
+  CHECK_NULL(L_DACP, evbuf = evbuffer_new());
+
+  ret = make_playstatusupdate(evbuf, &play_status);
+  if (ret < 0)
+    {
+      evbuffer_free(evbuf);
+      return NULL;
+    }
+
+  CHECK_NULL(L_DACP, reply = calloc(1, sizeof(struct dacp_status_reply)));
+
+  reply->len = evbuffer_get_length(evbuf);
+  CHECK_NULL(L_DACP, reply->data = malloc(reply->len));
+  evbuffer_remove(evbuf, reply->data, reply->len);
+  evbuffer_free(evbuf);
+
+  reply->refcount = 1;
+  reply->rev = current_rev;
+  reply->playing = (play_status == PLAY_PLAYING);
+  reply->expires = timespec_add(now, max_age);
+
+  status_reply = reply;
+
+  return reply;
+}
+
+static int
+status_reply_add(struct evbuffer *evbuf, struct dacp_status_reply *reply)
+{
+  int ret;
+
+  __atomic_add_fetch(&reply->refcount, 1, __ATOMIC_RELAXED);
+
+  // The reply is shared, so we don't copy it, libevent will unref when done
+  ret = evbuffer_add_reference(evbuf, reply->data, reply->len, status_reply_cleanup_cb, reply);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_DACP, "Out of memory for playstatusupdate evbuffer\n");
+
+      status_reply_unref(reply);
+      return -1;
+    }
 
   return 0;
 }
@@ -714,11 +826,10 @@ static void
 playstatusupdate_cb(int fd, short what, void *arg)
 {
   struct dacp_update_request *ur;
+  struct dacp_status_reply *reply;
   struct evbuffer *evbuf;
-  struct evbuffer *update;
   struct evhttp_connection *evcon;
-  uint8_t *buf;
-  size_t len;
+  int nclients;
   int ret;
 
 #ifdef HAVE_EVENTFD
@@ -739,18 +850,17 @@ playstatusupdate_cb(int fd, short what, void *arg)
 
   current_rev++;
 
+  // Drop the reply for the old revision, the new one is built when needed
+  status_reply_expire();
+
   if (!update_requests)
     goto readd;
 
-  CHECK_NULL(L_DACP, evbuf = evbuffer_new());
-  CHECK_NULL(L_DACP, update = evbuffer_new());
-
-  ret = make_playstatusupdate(update);
-  if (ret < 0)
-    goto out_free_update;
-
-  len = evbuffer_get_length(update);
+  reply = status_reply_get();
+  if (!reply)
+    goto readd;
 
+  nclients = 0;
   for (ur = update_requests; update_requests; ur = update_requests)
     {
       update_requests = ur->next;
@@ -759,31 +869,30 @@ playstatusupdate_cb(int fd, short what, void *arg)
       if (evcon)
 	evhttp_connection_set_closecb(evcon, NULL, NULL);
 
-      // Only copy buffer if we actually need to reuse it
-      if (ur->next)
-	{
-	  buf = evbuffer_pullup(update, -1);
-	  evbuffer_add(evbuf, buf, len);
-	  httpd_send_reply(ur->req, HTTP_OK, "OK", evbuf, 0);
-	}
+      CHECK_NULL(L_DACP, evbuf = evbuffer_new());
+
+      ret = status_reply_add(evbuf, reply);
+      if (ret < 0)
+	httpd_send_error(ur->req, 500, "Internal Server Error");
       else
-	httpd_send_reply(ur->req, HTTP_OK, "OK", update, 0);
+	httpd_send_reply(ur->req, HTTP_OK, "OK", evbuf, 0);
 
+      evbuffer_free(evbuf);
       free(ur);
+      nclients++;
     }
 
- out_free_update:
-  evbuffer_free(update);
-  evbuffer_free(evbuf);
+  DPRINTF(E_DBG, L_DACP, "Sent playstatusupdate with current_rev %d to %d clients\n", current_rev, nclients);
+
  readd:
   ret = event_add(updateev, NULL);
   if (ret < 0)
     DPRINTF(E_LOG, L_DACP, "Couldn't re-add event for playstatusupdate\n");
 }
 
-/* Thread: player */
+/* Thread: listener */
 static void
-dacp_playstatus_update_handler(short event_mask)
+dacp_playstatus_update_handler(short event_mask, const struct listener_event_data *data)
 {
   int ret;
 
@@ -2236,6 +2345,7 @@ static int
 dacp_reply_playstatusupdate(struct httpd_request *hreq)
 {
   struct dacp_update_request *ur;
+  struct dacp_status_reply *reply;
   struct evhttp_connection *evcon;
   struct bufferevent *bufev;
   const char *param;
@@ -2269,7 +2379,8 @@ dacp_reply_playstatusupdate(struct httpd_request *hreq)
   // to use when he calls again.
   if (reqd_rev != current_rev)
     {
-      ret = make_playstatusupdate(hreq->reply);
+      reply = status_reply_get();
+      ret = reply ? status_reply_add(hreq->reply, reply) : -1;
       if (ret < 0)
 	httpd_send_error(hreq->req, 500, "Internal Server Error");
       else
@@ -2900,6 +3011,7 @@ dacp_init(void)
 
   current_rev = 2;
   update_requests = NULL;
+  status_reply = NULL;
 
   dummy_mfi.id = DB_MEDIA_FILE_NON_PERSISTENT_ID;
   dummy_mfi.title = CFG_NAME_UNKNOWN_TITLE;
@@ -3010,6 +3122,8 @@ dacp_deinit(void)
       free(ur);
     }
 
+  status_reply_expire();
+
   event_free(updateev);
 
 #ifdef HAVE_EVENTFD
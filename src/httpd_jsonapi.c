@@ -42,15 +42,18 @@
 #include <time.h>
 
 #include "httpd_jsonapi.h"
+#include "cache.h"
 #include "conffile.h"
 #include "db.h"
 #ifdef LASTFM
 # include "lastfm.h"
 #endif
+#include "input.h"
 #include "library.h"
 #include "logger.h"
 #include "misc.h"
 #include "misc_json.h"
+#include "outputs.h"
 #include "player.h"
 #include "remote_pairing.h"
 #include "settings.h"
@@ -112,10 +115,19 @@ safe_json_add_int_from_string(json_object *obj, const char *key, const char *val
     json_object_object_add(obj, key, json_object_new_int(intval));
 }
 
+// Left out if the column is NULL, like when the integers were fetched as text
 static inline void
-safe_json_add_time_from_string(json_object *obj, const char *key, const char *value)
+safe_json_add_int_from_dbmfi(json_object *obj, const char *key, struct db_media_file_info *dbmfi, size_t offset)
+{
+  if (dbmfi_col_is_null(dbmfi, offset))
+    return;
+
+  json_object_object_add(obj, key, json_object_new_int(*(int64_t *) ((char *)dbmfi + offset)));
+}
+
+static inline void
+safe_json_add_time(json_object *obj, const char *key, uint32_t value)
 {
-  uint32_t tmp;
   time_t timestamp;
   struct tm tm;
   char result[32];
@@ -123,19 +135,10 @@ safe_json_add_time_from_string(json_object *obj, const char *key, const char *va
   if (!value)
     return;
 
-  if (safe_atou32(value, &tmp) != 0)
-    {
-      DPRINTF(E_LOG, L_WEB, "Error converting timestamp to uint32_t: %s\n", value);
-      return;
-    }
-
-  if (!tmp)
-    return;
-
-  timestamp = tmp;
+  timestamp = value;
   if (gmtime_r(&timestamp, &tm) == NULL)
     {
-      DPRINTF(E_LOG, L_WEB, "Error converting timestamp to gmtime: %s\n", value);
+      DPRINTF(E_LOG, L_WEB, "Error converting timestamp to gmtime: %" PRIu32 "\n", value);
       return;
     }
 
@@ -145,12 +148,9 @@ safe_json_add_time_from_string(json_object *obj, const char *key, const char *va
 }
 
 static inline void
-safe_json_add_date_from_string(json_object *obj, const char *key, const char *value)
+safe_json_add_time_from_string(json_object *obj, const char *key, const char *value)
 {
   uint32_t tmp;
-  time_t timestamp;
-  struct tm tm;
-  char result[32];
 
   if (!value)
     return;
@@ -161,13 +161,23 @@ safe_json_add_date_from_string(json_object *obj, const char *key, const char *va
       return;
     }
 
-  if (!tmp)
+  safe_json_add_time(obj, key, tmp);
+}
+
+static inline void
+safe_json_add_date(json_object *obj, const char *key, uint32_t value)
+{
+  time_t timestamp;
+  struct tm tm;
+  char result[32];
+
+  if (!value)
     return;
 
-  timestamp = tmp;
+  timestamp = value;
   if (localtime_r(&timestamp, &tm) == NULL)
     {
-      DPRINTF(E_LOG, L_WEB, "Error converting timestamp to localtime: %s\n", value);
+      DPRINTF(E_LOG, L_WEB, "Error converting timestamp to localtime: %" PRIu32 "\n", value);
       return;
     }
 
@@ -176,6 +186,23 @@ safe_json_add_date_from_string(json_object *obj, const char *key, const char *va
   json_object_object_add(obj, key, json_object_new_string(result));
 }
 
+static inline void
+safe_json_add_date_from_string(json_object *obj, const char *key, const char *value)
+{
+  uint32_t tmp;
+
+  if (!value)
+    return;
+
+  if (safe_atou32(value, &tmp) != 0)
+    {
+      DPRINTF(E_LOG, L_WEB, "Error converting timestamp to uint32_t: %s\n", value);
+      return;
+    }
+
+  safe_json_add_date(obj, key, tmp);
+}
+
 static json_object *
 artist_to_json(struct db_group_info *dbgri)
 {
@@ -274,58 +301,52 @@ track_to_json(struct db_media_file_info *dbmfi)
   json_object *item;
   char uri[100];
   char artwork_url[100];
-  int intval;
   int ret;
 
   item = json_object_new_object();
 
-  safe_json_add_int_from_string(item, "id", dbmfi->id);
+  json_object_object_add(item, "id", json_object_new_int(dbmfi->id));
   safe_json_add_string(item, "title", dbmfi->title);
   safe_json_add_string(item, "title_sort", dbmfi->title_sort);
   safe_json_add_string(item, "artist", dbmfi->artist);
   safe_json_add_string(item, "artist_sort", dbmfi->artist_sort);
   safe_json_add_string(item, "album", dbmfi->album);
   safe_json_add_string(item, "album_sort", dbmfi->album_sort);
-  safe_json_add_string(item, "album_id", dbmfi->songalbumid);
+  safe_json_add_string_from_int64(item, "album_id", dbmfi->songalbumid);
   safe_json_add_string(item, "album_artist", dbmfi->album_artist);
   safe_json_add_string(item, "album_artist_sort", dbmfi->album_artist_sort);
-  safe_json_add_string(item, "album_artist_id", dbmfi->songartistid);
+  safe_json_add_string_from_int64(item, "album_artist_id", dbmfi->songartistid);
   safe_json_add_string(item, "composer", dbmfi->composer);
   safe_json_add_string(item, "genre", dbmfi->genre);
-  safe_json_add_int_from_string(item, "year", dbmfi->year);
-  safe_json_add_int_from_string(item, "track_number", dbmfi->track);
-  safe_json_add_int_from_string(item, "disc_number", dbmfi->disc);
-  safe_json_add_int_from_string(item, "length_ms", dbmfi->song_length);
-
-  safe_json_add_int_from_string(item, "rating", dbmfi->rating);
-  safe_json_add_int_from_string(item, "play_count", dbmfi->play_count);
-  safe_json_add_int_from_string(item, "skip_count", dbmfi->skip_count);
-  safe_json_add_time_from_string(item, "time_played", dbmfi->time_played);
-  safe_json_add_time_from_string(item, "time_skipped", dbmfi->time_skipped);
-  safe_json_add_time_from_string(item, "time_added", dbmfi->time_added);
-  safe_json_add_date_from_string(item, "date_released", dbmfi->date_released);
-  safe_json_add_int_from_string(item, "seek_ms", dbmfi->seek);
+  safe_json_add_int_from_dbmfi(item, "year", dbmfi, dbmfi_offsetof(year));
+  safe_json_add_int_from_dbmfi(item, "track_number", dbmfi, dbmfi_offsetof(track));
+  safe_json_add_int_from_dbmfi(item, "disc_number", dbmfi, dbmfi_offsetof(disc));
+  safe_json_add_int_from_dbmfi(item, "length_ms", dbmfi, dbmfi_offsetof(song_length));
+
+  safe_json_add_int_from_dbmfi(item, "rating", dbmfi, dbmfi_offsetof(rating));
+  safe_json_add_int_from_dbmfi(item, "play_count", dbmfi, dbmfi_offsetof(play_count));
+  safe_json_add_int_from_dbmfi(item, "skip_count", dbmfi, dbmfi_offsetof(skip_count));
+  safe_json_add_time(item, "time_played", dbmfi->time_played);
+  safe_json_add_time(item, "time_skipped", dbmfi->time_skipped);
+  safe_json_add_time(item, "time_added", dbmfi->time_added);
+  safe_json_add_date(item, "date_released", dbmfi->date_released);
+  safe_json_add_int_from_dbmfi(item, "seek_ms", dbmfi, dbmfi_offsetof(seek));
 
   safe_json_add_string(item, "type", dbmfi->type);
-  safe_json_add_int_from_string(item, "samplerate", dbmfi->samplerate);
-  safe_json_add_int_from_string(item, "bitrate", dbmfi->bitrate);
-  safe_json_add_int_from_string(item, "channels", dbmfi->channels);
+  safe_json_add_int_from_dbmfi(item, "samplerate", dbmfi, dbmfi_offsetof(samplerate));
+  safe_json_add_int_from_dbmfi(item, "bitrate", dbmfi, dbmfi_offsetof(bitrate));
+  safe_json_add_int_from_dbmfi(item, "channels", dbmfi, dbmfi_offsetof(channels));
 
-  ret = safe_atoi32(dbmfi->media_kind, &intval);
-  if (ret == 0)
-    safe_json_add_string(item, "media_kind", db_media_kind_label(intval));
-
-  ret = safe_atoi32(dbmfi->data_kind, &intval);
-  if (ret == 0)
-    safe_json_add_string(item, "data_kind", db_data_kind_label(intval));
+  safe_json_add_string(item, "media_kind", db_media_kind_label(dbmfi->media_kind));
+  safe_json_add_string(item, "data_kind", db_data_kind_label(dbmfi->data_kind));
 
   safe_json_add_string(item, "path", dbmfi->path);
 
-  ret = snprintf(uri, sizeof(uri), "%s:%s:%s", "library", "track", dbmfi->id);
+  ret = snprintf(uri, sizeof(uri), "%s:%s:%" PRIi64, "library", "track", dbmfi->id);
   if (ret < sizeof(uri))
     json_object_object_add(item, "uri", json_object_new_string(uri));
 
-  ret = snprintf(artwork_url, sizeof(artwork_url), "/artwork/item/%s", dbmfi->id);
+  ret = snprintf(artwork_url, sizeof(artwork_url), "/artwork/item/%" PRIi64, dbmfi->id);
   if (ret < sizeof(artwork_url))
     json_object_object_add(item, "artwork_url", json_object_new_string(artwork_url));
 
@@ -814,6 +835,127 @@ jsonapi_reply_config(struct httpd_request *hreq)
   return HTTP_OK;
 }
 
+/*
+ * Endpoint to retrieve server statistics, e.g. request latency
+ */
+static int
+jsonapi_reply_stats(struct httpd_request *hreq)
+{
+  struct httpd_latency_stats stats[16];
+  struct cache_daap_stats cache_stats;
+  struct db_stmt_cache_stats stmt_stats;
+  struct input_transition_stats input_stats;
+  struct outputs_writer_stats writer_stats[8];
+  struct outputs_send_stats send_stats[32];
+  json_object *jreply;
+  json_object *jhttpd;
+  json_object *jcache;
+  json_object *jstmt;
+  json_object *jinput;
+  json_object *jwriters;
+  json_object *jwriter;
+  json_object *jsenders;
+  json_object *jsender;
+  json_object *jendpoints;
+  json_object *jendpoint;
+  int threads;
+  int n;
+  int i;
+
+  n = httpd_latency_stats_get(stats, ARRAY_SIZE(stats), &threads);
+
+  CHECK_NULL(L_WEB, jendpoints = json_object_new_array());
+  for (i = 0; i < n; i++)
+    {
+      CHECK_NULL(L_WEB, jendpoint = json_object_new_object());
+      json_object_object_add(jendpoint, "endpoint", json_object_new_string(stats[i].endpoint));
+      json_object_object_add(jendpoint, "requests", json_object_new_int64(stats[i].requests));
+      json_object_object_add(jendpoint, "p50_us", json_object_new_int64(stats[i].p50_us));
+      json_object_object_add(jendpoint, "p90_us", json_object_new_int64(stats[i].p90_us));
+      json_object_object_add(jendpoint, "p99_us", json_object_new_int64(stats[i].p99_us));
+      json_object_object_add(jendpoint, "max_us", json_object_new_int64(stats[i].max_us));
+      json_object_array_add(jendpoints, jendpoint);
+    }
+
+  CHECK_NULL(L_WEB, jhttpd = json_object_new_object());
+  json_object_object_add(jhttpd, "threads", json_object_new_int(threads));
+  json_object_object_add(jhttpd, "endpoints", jendpoints);
+
+  cache_daap_stats_get(&cache_stats);
+
+  CHECK_NULL(L_WEB, jcache = json_object_new_object());
+  json_object_object_add(jcache, "entries", json_object_new_int(cache_stats.entries));
+  json_object_object_add(jcache, "size", json_object_new_int64(cache_stats.size));
+  json_object_object_add(jcache, "hits", json_object_new_int64(cache_stats.hits));
+  json_object_object_add(jcache, "misses", json_object_new_int64(cache_stats.misses));
+  json_object_object_add(jcache, "bytes", json_object_new_int64(cache_stats.bytes));
+
+  db_stmt_cache_stats_get(&stmt_stats);
+
+  CHECK_NULL(L_WEB, jstmt = json_object_new_object());
+  json_object_object_add(jstmt, "hits", json_object_new_int64(stmt_stats.hits));
+  json_object_object_add(jstmt, "misses", json_object_new_int64(stmt_stats.misses));
+
+  input_transition_stats_get(&input_stats);
+
+  CHECK_NULL(L_WEB, jinput = json_object_new_object());
+  json_object_object_add(jinput, "transitions", json_object_new_int64(input_stats.transitions));
+  json_object_object_add(jinput, "prerolled", json_object_new_int64(input_stats.prerolled));
+  json_object_object_add(jinput, "underruns", json_object_new_int64(input_stats.underruns));
+  json_object_object_add(jinput, "gap_last_ms", json_object_new_int64(input_stats.gap_last_ms));
+  json_object_object_add(jinput, "gap_max_ms", json_object_new_int64(input_stats.gap_max_ms));
+
+  n = outputs_writer_stats_get(writer_stats, ARRAY_SIZE(writer_stats));
+
+  CHECK_NULL(L_WEB, jwriters = json_object_new_array());
+  for (i = 0; i < n; i++)
+    {
+      CHECK_NULL(L_WEB, jwriter = json_object_new_object());
+      json_object_object_add(jwriter, "output", json_object_new_string(writer_stats[i].name));
+      json_object_object_add(jwriter, "queue_depth", json_object_new_int(writer_stats[i].depth));
+      json_object_object_add(jwriter, "queue_depth_max", json_object_new_int(writer_stats[i].depth_max));
+      json_object_object_add(jwriter, "frames", json_object_new_int64(writer_stats[i].frames));
+      json_object_object_add(jwriter, "overruns", json_object_new_int64(writer_stats[i].overruns));
+      json_object_object_add(jwriter, "resyncs", json_object_new_int64(writer_stats[i].resyncs));
+      json_object_object_add(jwriter, "write_last_us", json_object_new_int64(writer_stats[i].write_last_us));
+      json_object_object_add(jwriter, "write_avg_us", json_object_new_int64(writer_stats[i].write_avg_us));
+      json_object_object_add(jwriter, "write_max_us", json_object_new_int64(writer_stats[i].write_max_us));
+      json_object_array_add(jwriters, jwriter);
+    }
+
+  n = outputs_send_stats_get(send_stats, ARRAY_SIZE(send_stats));
+
+  CHECK_NULL(L_WEB, jsenders = json_object_new_array());
+  for (i = 0; i < n; i++)
+    {
+      CHECK_NULL(L_WEB, jsender = json_object_new_object());
+      json_object_object_add(jsender, "output", json_object_new_string(send_stats[i].type_name));
+      json_object_object_add(jsender, "device", json_object_new_string(send_stats[i].devname));
+      json_object_object_add(jsender, "packets", json_object_new_int64(send_stats[i].packets));
+      json_object_object_add(jsender, "bytes", json_object_new_int64(send_stats[i].bytes));
+      json_object_object_add(jsender, "syscalls", json_object_new_int64(send_stats[i].syscalls));
+      json_object_object_add(jsender, "eagain", json_object_new_int64(send_stats[i].eagain));
+      json_object_object_add(jsender, "errors", json_object_new_int64(send_stats[i].errors));
+      json_object_object_add(jsender, "send_avg_us", json_object_new_int64(send_stats[i].latency_avg_us));
+      json_object_object_add(jsender, "send_max_us", json_object_new_int64(send_stats[i].latency_max_us));
+      json_object_array_add(jsenders, jsender);
+    }
+
+  CHECK_NULL(L_WEB, jreply = json_object_new_object());
+  json_object_object_add(jreply, "httpd", jhttpd);
+  json_object_object_add(jreply, "daap_cache", jcache);
+  json_object_object_add(jreply, "db_statement_cache", jstmt);
+  json_object_object_add(jreply, "input_transitions", jinput);
+  json_object_object_add(jreply, "output_writers", jwriters);
+  json_object_object_add(jreply, "output_senders", jsenders);
+
+  CHECK_ERRNO(L_WEB, evbuffer_add_printf(hreq->reply, "%s", json_object_to_json_string(jreply)));
+
+  jparse_free(jreply);
+
+  return HTTP_OK;
+}
+
 static json_object *
 option_get_json(struct settings_option *option)
 {
@@ -1028,7 +1170,7 @@ jsonapi_reply_settings_option_put(struct httpd_request *hreq)
       return HTTP_NOTFOUND;
     }
 
-  in_evbuf = evhttp_request_get_input_buffer(hreq->req);
+  in_evbuf = httpd_request_input_buffer(hreq->req);
   request = jparse_obj_from_evbuffer(in_evbuf);
   if (!request)
     {
@@ -1267,7 +1409,7 @@ jsonapi_reply_spotify_login(struct httpd_request *hreq)
 
   DPRINTF(E_DBG, L_WEB, "Received Spotify login request\n");
 
-  in_evbuf = evhttp_request_get_input_buffer(hreq->req);
+  in_evbuf = httpd_request_input_buffer(hreq->req);
 
   request = jparse_obj_from_evbuffer(in_evbuf);
   if (!request)
@@ -1371,7 +1513,7 @@ jsonapi_reply_lastfm_login(struct httpd_request *hreq)
 
   DPRINTF(E_DBG, L_WEB, "Received LastFM login request\n");
 
-  in_evbuf = evhttp_request_get_input_buffer(hreq->req);
+  in_evbuf = httpd_request_input_buffer(hreq->req);
   request = jparse_obj_from_evbuffer(in_evbuf);
   if (!request)
     {
@@ -1452,7 +1594,7 @@ jsonapi_reply_pairing_pair(struct httpd_request *hreq)
   const char* pin;
   int ret;
 
-  evbuf = evhttp_request_get_input_buffer(hreq->req);
+  evbuf = httpd_request_input_buffer(hreq->req);
   request = jparse_obj_from_evbuffer(evbuf);
   if (!request)
     {
@@ -1619,7 +1761,7 @@ jsonapi_reply_outputs_put_byid(struct httpd_request *hreq)
       return HTTP_BADREQUEST;
     }
 
-  in_evbuf = evhttp_request_get_input_buffer(hreq->req);
+  in_evbuf = httpd_request_input_buffer(hreq->req);
   request = jparse_obj_from_evbuffer(in_evbuf);
   if (!request)
     {
@@ -1699,16 +1841,29 @@ jsonapi_reply_outputs_toggle_byid(struct httpd_request *hreq)
 /*
  * Endpoint "/api/outputs"
  */
-static int
-jsonapi_reply_outputs(struct httpd_request *hreq)
+/*
+ * All outputs as returned by GET /api/outputs
+ */
+json_object *
+jsonapi_outputs_to_json(void)
 {
   json_object *outputs;
-  json_object *jreply;
 
   outputs = json_object_new_array();
 
   player_speaker_enumerate(speaker_enum_cb, outputs);
 
+  return outputs;
+}
+
+static int
+jsonapi_reply_outputs(struct httpd_request *hreq)
+{
+  json_object *outputs;
+  json_object *jreply;
+
+  outputs = jsonapi_outputs_to_json();
+
   jreply = json_object_new_object();
   json_object_object_add(jreply, "outputs", outputs);
 
@@ -1726,7 +1881,7 @@ jsonapi_reply_verification(struct httpd_request *hreq)
   json_object* request;
   const char* message;
 
-  in_evbuf = evhttp_request_get_input_buffer(hreq->req);
+  in_evbuf = httpd_request_input_buffer(hreq->req);
   request = jparse_obj_from_evbuffer(in_evbuf);
   if (!request)
     {
@@ -1757,7 +1912,7 @@ jsonapi_reply_outputs_set(struct httpd_request *hreq)
   int nspk, i, ret;
   uint64_t *ids;
 
-  in_evbuf = evhttp_request_get_input_buffer(hreq->req);
+  in_evbuf = httpd_request_input_buffer(hreq->req);
   request = jparse_obj_from_evbuffer(in_evbuf);
   if (!request)
     {
@@ -2054,8 +2209,13 @@ jsonapi_reply_player_seek(struct httpd_request *hreq)
   return HTTP_NOCONTENT;
 }
 
-static int
-jsonapi_reply_player(struct httpd_request *hreq)
+/*
+ * Player status as returned by GET /api/player. If no item is playing, the
+ * first item of the queue is looked up in the db, unless lookup_queue is false,
+ * then NULL is returned instead.
+ */
+json_object *
+jsonapi_player_to_json(bool lookup_queue)
 {
   struct player_status status;
   struct db_queue_item *queue_item;
@@ -2063,6 +2223,9 @@ jsonapi_reply_player(struct httpd_request *hreq)
 
   player_get_status(&status);
 
+  if (!status.item_id && !lookup_queue)
+    return NULL;
+
   reply = json_object_new_object();
 
   switch (status.status)
@@ -2125,6 +2288,16 @@ jsonapi_reply_player(struct httpd_request *hreq)
 	}
     }
 
+  return reply;
+}
+
+static int
+jsonapi_reply_player(struct httpd_request *hreq)
+{
+  json_object *reply;
+
+  reply = jsonapi_player_to_json(true);
+
   CHECK_ERRNO(L_WEB, evbuffer_add_printf(hreq->reply, "%s", json_object_to_json_string(reply)));
 
   jparse_free(reply);
@@ -3965,6 +4138,23 @@ jsonapi_reply_library_add(struct httpd_request *hreq)
   return HTTP_OK;
 }
 
+// Filter for a search in field, optionally restricted to a media kind
+static char *
+search_filter(const char *field, const char *param_query, enum db_search_type type, enum media_kind media_kind)
+{
+  char *match;
+  char *filter;
+
+  match = db_search_filter(field, param_query, type);
+  if (!match || !media_kind)
+    return match;
+
+  filter = db_mprintf("(%s AND f.media_kind = %d)", match, media_kind);
+  free(match);
+
+  return filter;
+}
+
 static int
 search_tracks(json_object *reply, struct httpd_request *hreq, const char *param_query, struct smartpl *smartpl_expression, enum media_kind media_kind)
 {
@@ -3990,10 +4180,8 @@ search_tracks(json_object *reply, struct httpd_request *hreq, const char *param_
 
   if (param_query)
     {
-      if (media_kind)
-	query_params.filter = db_mprintf("(f.title LIKE '%%%q%%' AND f.media_kind = %d)", param_query, media_kind);
-      else
-	query_params.filter = db_mprintf("(f.title LIKE '%%%q%%')", param_query);
+      query_params.filter = search_filter("title", param_query, DB_SEARCH_WORDS, media_kind);
+      query_params.order = db_search_order("title", param_query, query_params.sort);
     }
   else
     {
@@ -4012,6 +4200,19 @@ search_tracks(json_object *reply, struct httpd_request *hreq, const char *param_
   if (ret < 0)
     goto out;
 
+  // Nothing found, so try again with the closest matches in case of a typo
+  if (total == 0 && param_query)
+    {
+      free(query_params.filter);
+      query_params.filter = search_filter("title", param_query, DB_SEARCH_FUZZY, media_kind);
+      if (query_params.filter)
+	{
+	  ret = fetch_tracks(&query_params, items, &total);
+	  if (ret < 0)
+	    goto out;
+	}
+    }
+
   json_object_object_add(type, "total", json_object_new_int(total));
   json_object_object_add(type, "offset", json_object_new_int(query_params.offset));
   json_object_object_add(type, "limit", json_object_new_int(query_params.limit));
@@ -4051,10 +4252,8 @@ search_artists(json_object *reply, struct httpd_request *hreq, const char *param
 
   if (param_query)
     {
-      if (media_kind)
-	query_params.filter = db_mprintf("(f.album_artist LIKE '%%%q%%' AND f.media_kind = %d)", param_query, media_kind);
-      else
-	query_params.filter = db_mprintf("(f.album_artist LIKE '%%%q%%')", param_query);
+      query_params.filter = search_filter("album_artist", param_query, DB_SEARCH_WORDS, media_kind);
+      query_params.order = db_search_order("album_artist", param_query, query_params.sort);
     }
   else
     {
@@ -4074,6 +4273,19 @@ search_artists(json_object *reply, struct httpd_request *hreq, const char *param
   if (ret < 0)
     goto out;
 
+  // Nothing found, so try again with the closest matches in case of a typo
+  if (total == 0 && param_query)
+    {
+      free(query_params.filter);
+      query_params.filter = search_filter("album_artist", param_query, DB_SEARCH_FUZZY, media_kind);
+      if (query_params.filter)
+	{
+	  ret = fetch_artists(&query_params, items, &total);
+	  if (ret < 0)
+	    goto out;
+	}
+    }
+
   json_object_object_add(type, "total", json_object_new_int(total));
   json_object_object_add(type, "offset", json_object_new_int(query_params.offset));
   json_object_object_add(type, "limit", json_object_new_int(query_params.limit));
@@ -4113,10 +4325,8 @@ search_albums(json_object *reply, struct httpd_request *hreq, const char *param_
 
   if (param_query)
     {
-      if (media_kind)
-	query_params.filter = db_mprintf("(f.album LIKE '%%%q%%' AND f.media_kind = %d)", param_query, media_kind);
-      else
-	query_params.filter = db_mprintf("(f.album LIKE '%%%q%%')", param_query);
+      query_params.filter = search_filter("album", param_query, DB_SEARCH_WORDS, media_kind);
+      query_params.order = db_search_order("album", param_query, query_params.sort);
     }
   else
     {
@@ -4136,6 +4346,19 @@ search_albums(json_object *reply, struct httpd_request *hreq, const char *param_
   if (ret < 0)
     goto out;
 
+  // Nothing found, so try again with the closest matches in case of a typo
+  if (total == 0 && param_query)
+    {
+      free(query_params.filter);
+      query_params.filter = search_filter("album", param_query, DB_SEARCH_FUZZY, media_kind);
+      if (query_params.filter)
+	{
+	  ret = fetch_albums(&query_params, items, &total);
+	  if (ret < 0)
+	    goto out;
+	}
+    }
+
   json_object_object_add(type, "total", json_object_new_int(total));
   json_object_object_add(type, "offset", json_object_new_int(query_params.offset));
   json_object_object_add(type, "limit", json_object_new_int(query_params.limit));
@@ -4303,6 +4526,7 @@ jsonapi_reply_library_backup(struct httpd_request *hreq)
 static struct httpd_uri_map adm_handlers[] =
   {
     { EVHTTP_REQ_GET,    "^/api/config$",                                jsonapi_reply_config },
+    { EVHTTP_REQ_GET,    "^/api/stats$",                                 jsonapi_reply_stats },
     { EVHTTP_REQ_GET,    "^/api/settings$",                              jsonapi_reply_settings_get },
     { EVHTTP_REQ_GET,    "^/api/settings/[A-Za-z0-9_]+$",                jsonapi_reply_settings_category_get },
     { EVHTTP_REQ_GET,    "^/api/settings/[A-Za-z0-9_]+/[A-Za-z0-9_]+$",  jsonapi_reply_settings_option_get },
@@ -4412,7 +4636,7 @@ jsonapi_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed)
   switch (status_code)
     {
       case HTTP_OK:                  /* 200 OK */
-	headers = evhttp_request_get_output_headers(req);
+	headers = httpd_request_output_headers(req);
 	evhttp_add_header(headers, "Content-Type", "application/json");
 	httpd_send_reply(req, status_code, "OK", hreq->reply, HTTPD_SEND_NO_GZIP);
 	break;
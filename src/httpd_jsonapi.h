@@ -2,6 +2,9 @@
 #ifndef __HTTPD_JSONAPI_H__
 #define __HTTPD_JSONAPI_H__
 
+#include <stdbool.h>
+#include <json.h>
+
 #include "httpd.h"
 
 int
@@ -16,4 +19,10 @@ jsonapi_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed)
 int
 jsonapi_is_request(const char *path);
 
+json_object *
+jsonapi_player_to_json(bool lookup_queue);
+
+json_object *
+jsonapi_outputs_to_json(void);
+
 #endif /* !__HTTPD_JSONAPI_H__ */
@@ -25,6 +25,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <string.h>
 #include <sys/queue.h>
 #include <sys/types.h>
@@ -197,7 +198,7 @@ rsp_send_error(struct evhttp_request *req, char *errmsg)
       return;
     }
 
-  headers = evhttp_request_get_output_headers(req);
+  headers = httpd_request_output_headers(req);
   evhttp_add_header(headers, "Content-Type", "text/xml; charset=utf-8");
   evhttp_add_header(headers, "Connection", "close");
 
@@ -280,7 +281,7 @@ rsp_send_reply(struct evhttp_request *req, mxml_node_t *reply)
       return;
     }
 
-  headers = evhttp_request_get_output_headers(req);
+  headers = httpd_request_output_headers(req);
   evhttp_add_header(headers, "Content-Type", "text/xml; charset=utf-8");
   evhttp_add_header(headers, "Connection", "close");
 
@@ -489,7 +490,7 @@ rsp_reply_playlist(struct httpd_request *hreq)
   int mode;
   int records;
   int transcode;
-  int32_t bitrate;
+  int64_t intval;
   int i;
   int ret;
 
@@ -574,7 +575,7 @@ rsp_reply_playlist(struct httpd_request *hreq)
   /* Items block (all items) */
   while (((ret = db_query_fetch_file(&qp, &dbmfi)) == 0) && (dbmfi.id))
     {
-      headers = evhttp_request_get_input_headers(hreq->req);
+      headers = httpd_request_input_headers(hreq->req);
 
       ua = evhttp_find_header(headers, "User-Agent");
       client_codecs = evhttp_find_header(headers, "Accept-Codecs");
@@ -589,6 +590,20 @@ rsp_reply_playlist(struct httpd_request *hreq)
 	  if (!(rsp_fields[i].flags & mode))
 	    continue;
 
+	  if (dbmfi_col_is_int(rsp_fields[i].offset))
+	    {
+	      if (dbmfi_col_is_null(&dbmfi, rsp_fields[i].offset))
+		continue;
+
+	      intval = *(int64_t *) ((char *)&dbmfi + rsp_fields[i].offset);
+	      if (transcode && rsp_fields[i].offset == dbmfi_offsetof(bitrate))
+		intval = (dbmfi.samplerate == 0) ? 1411 : (dbmfi.samplerate * 8) / 250;
+
+	      node = mxmlNewElement(item, rsp_fields[i].field);
+	      mxmlNewTextf(node, 0, "%" PRIi64, intval);
+	      continue;
+	    }
+
 	  strval = (char **) ((char *)&dbmfi + rsp_fields[i].offset);
 
 	  if (!(*strval) || (strlen(*strval) == 0))
@@ -606,17 +621,6 @@ rsp_reply_playlist(struct httpd_request *hreq)
 		    mxmlNewText(node, 0, "wav");
 		    break;
 
-		  case dbmfi_offsetof(bitrate):
-		    bitrate = 0;
-		    ret = safe_atoi32(dbmfi.samplerate, &bitrate);
-		    if ((ret < 0) || (bitrate == 0))
-		      bitrate = 1411;
-		    else
-		      bitrate = (bitrate * 8) / 250;
-
-		    mxmlNewTextf(node, 0, "%d", bitrate);
-		    break;
-
 		  case dbmfi_offsetof(description):
 		    mxmlNewText(node, 0, "wav audio file");
 		    break;
@@ -25,12 +25,14 @@
 #include <string.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
 
 #include <uninorm.h>
 #include <unistd.h>
 #include <pthread.h>
 
 #include <event2/event.h>
+#include <event2/bufferevent.h>
 
 #include "httpd_streaming.h"
 #include "logger.h"
@@ -48,33 +50,96 @@ extern struct event_base *evbase_httpd;
 #define STREAMING_SILENCE_INTERVAL 1
 // How many bytes we try to read at a time from the httpd pipe
 #define STREAMING_READ_SIZE STOB(352, 16, 2)
+// Size we ask for for the pipe from the player, so short httpd stalls don't
+// result in "Streaming pipe full" (Linux only)
+#define STREAMING_PIPE_SIZE (256 * 1024)
 
 #define STREAMING_MP3_SAMPLE_RATE 44100
 #define STREAMING_MP3_BPS         16
 #define STREAMING_MP3_CHANNELS    2
 #define STREAMING_MP3_BIT_RATE    192000
 
+// Opus only supports 48000 (and some lower rates)
+#define STREAMING_OPUS_SAMPLE_RATE 48000
+
+// Max number of encoded chunks kept for each format, must be a power of two
+#define STREAMING_RING_SIZE 1024
+// Seconds of encoded audio kept for each format. Listeners that fall further
+// behind skip ahead.
+#define STREAMING_BACKLOG_SECS 5
+// Seconds of audio a new listener gets right away, so playback can start fast
+#define STREAMING_BURST_SECS 2
+// Max bytes waiting in a listener's connection before we hold back
+#define STREAMING_SESSION_QUEUE_MAX (64 * 1024)
+
+
+// A piece of encoded audio, shared by the listeners of a format. Every
+// reference from a listener's connection holds a refcount.
+struct streaming_chunk {
+  int refcount;
+  uint8_t *data;
+  size_t len;
+  size_t sync;  // Where in the chunk a new listener can start (Ogg page)
+  int samples;  // Input samples, for measuring the backlog
+};
+
+// Each format is encoded once, no matter how many listeners it has
+struct streaming_format {
+  const char *name;
+  const char *path;
+  const char *content_type;
+  enum transcode_profile profile;
+  bool icy;         // Supports ICY metadata
+  bool send_header; // New listeners must get the stream header first
+  bool ogg;         // Listeners must start at a page, header resent on restart
+
+  struct media_quality quality;
+  struct encode_ctx *encode_ctx;
+  bool not_supported;
+  int nsessions;
+
+  // Output from the encoder, not yet in the ring
+  struct evbuffer *encoded;
+  uint8_t *header;
+  size_t header_len;
+
+  // Holds chunks with sequence numbers ring_first to ring_next - 1
+  struct streaming_chunk *ring[STREAMING_RING_SIZE];
+  uint64_t ring_first;
+  uint64_t ring_next;
+  int ring_samples;
+};
 
-// Linked list of mp3 streaming requests
+static struct streaming_format streaming_formats[] =
+  {
+    { "mp3",  "/stream.mp3",  "audio/mpeg", XCODE_MP3,   .icy = true },
+    { "ogg",  "/stream.ogg",  "audio/ogg",  XCODE_OGG,   .send_header = true, .ogg = true },
+    { "flac", "/stream.flac", "audio/flac", XCODE_FLAC,  .send_header = true },
+    { "wav",  "/stream.wav",  "audio/wav",  XCODE_PCM16, .send_header = true },
+  };
+
+// Linked list of streaming requests
 struct streaming_session {
   struct evhttp_request *req;
+  struct streaming_format *format;
   struct streaming_session *next;
 
   bool     require_icy; // Client requested icy meta
   size_t   bytes_sent;  // Audio bytes sent since last metablock
+  uint64_t seq;         // Next chunk to send
+  bool     need_header; // Stream header must be sent before the next chunk
+  bool     need_sync;   // Next chunk must be sent from its sync point
 };
 static pthread_mutex_t streaming_sessions_lck;
 static struct streaming_session *streaming_sessions;
 
-// Means we're not able to encode to mp3
+// Means we're not able to decode the input from the player
 static bool streaming_not_supported;
 
 // Interval for sending silence when playback is paused
 static struct timeval streaming_silence_tv = { STREAMING_SILENCE_INTERVAL, 0 };
 
-// Input buffer, output buffer and encoding ctx for transcode
-static struct encode_ctx *streaming_encode_ctx;
-static struct evbuffer *streaming_encoded_data;
+// Input quality, and the configured output quality
 static struct media_quality streaming_quality_in;
 static struct media_quality streaming_quality_out = { STREAMING_MP3_SAMPLE_RATE, STREAMING_MP3_BPS, STREAMING_MP3_CHANNELS, STREAMING_MP3_BIT_RATE };
 
@@ -99,6 +164,324 @@ static unsigned short streaming_icy_metaint = STREAMING_ICY_METAINT_DEFAULT;
 static unsigned streaming_icy_clients;
 static char *streaming_icy_title;
 
+static uint8_t streaming_icy_meta[STREAMING_ICY_METALEN_MAX+1];
+static unsigned streaming_icy_metalen;
+
+
+/* ------------------------------ Encoded chunks ---------------------------- */
+
+static void
+chunk_unref(struct streaming_chunk *chunk)
+{
+  if (__atomic_sub_fetch(&chunk->refcount, 1, __ATOMIC_ACQ_REL) > 0)
+    return;
+
+  free(chunk->data);
+  free(chunk);
+}
+
+/* Called by libevent when it is done with a chunk added by reference */
+static void
+chunk_cleanup_cb(const void *data, size_t datalen, void *extra)
+{
+  chunk_unref(extra);
+}
+
+static int
+chunk_add(struct evbuffer *evbuf, struct streaming_chunk *chunk, size_t offset, size_t len)
+{
+  int ret;
+
+  __atomic_add_fetch(&chunk->refcount, 1, __ATOMIC_RELAXED);
+
+  ret = evbuffer_add_reference(evbuf, chunk->data + offset, len, chunk_cleanup_cb, chunk);
+  if (ret < 0)
+    chunk_unref(chunk);
+
+  return ret;
+}
+
+static struct streaming_chunk *
+ring_get(struct streaming_format *format, uint64_t seq)
+{
+  return format->ring[seq & (STREAMING_RING_SIZE - 1)];
+}
+
+static void
+ring_drop_oldest(struct streaming_format *format)
+{
+  struct streaming_chunk *chunk;
+
+  chunk = ring_get(format, format->ring_first);
+  format->ring_samples -= chunk->samples;
+  format->ring_first++;
+
+  chunk_unref(chunk);
+}
+
+static void
+ring_clear(struct streaming_format *format)
+{
+  while (format->ring_first != format->ring_next)
+    ring_drop_oldest(format);
+}
+
+// Moves what the encoder has produced into a new chunk at the end of the ring
+static int
+ring_push(struct streaming_format *format, int samples)
+{
+  struct streaming_chunk *chunk;
+  uint8_t *page;
+  size_t len;
+  int backlog;
+
+  len = evbuffer_get_length(format->encoded);
+  if (len == 0)
+    return 0;
+
+  CHECK_NULL(L_STREAMING, chunk = calloc(1, sizeof(struct streaming_chunk)));
+  CHECK_NULL(L_STREAMING, chunk->data = malloc(len));
+
+  evbuffer_remove(format->encoded, chunk->data, len);
+  chunk->len = len;
+  chunk->samples = samples;
+  chunk->refcount = 1;
+
+  if (format->ogg)
+    {
+      page = memmem(chunk->data, len, "OggS", 4);
+      chunk->sync = page ? page - chunk->data : len;
+    }
+
+  if (format->ring_next - format->ring_first == STREAMING_RING_SIZE)
+    ring_drop_oldest(format);
+
+  format->ring[format->ring_next & (STREAMING_RING_SIZE - 1)] = chunk;
+  format->ring_next++;
+  format->ring_samples += samples;
+
+  backlog = STREAMING_BACKLOG_SECS * streaming_quality_in.sample_rate;
+  while (format->ring_next - format->ring_first > 1 && format->ring_samples - ring_get(format, format->ring_first)->samples >= backlog)
+    ring_drop_oldest(format);
+
+  return 1;
+}
+
+// Where a new listener should start, gives it STREAMING_BURST_SECS of audio
+static uint64_t
+ring_burst_start(struct streaming_format *format)
+{
+  uint64_t seq;
+  int samples;
+  int burst;
+
+  burst = STREAMING_BURST_SECS * streaming_quality_in.sample_rate;
+
+  for (seq = format->ring_next, samples = 0; seq > format->ring_first; seq--)
+    {
+      samples += ring_get(format, seq - 1)->samples;
+      if (samples > burst)
+	break;
+    }
+
+  return seq;
+}
+
+
+/* --------------------------------- Encoding ------------------------------- */
+
+static void
+wav_header_make(uint8_t header[44], struct media_quality *quality)
+{
+  uint32_t block_align;
+
+  block_align = quality->channels * quality->bits_per_sample / 8;
+
+  // Lengths are unknown, so they are set to the max like other streamers do
+  memcpy(header, "RIFF", 4);
+  header[4] = header[5] = header[6] = header[7] = 0xff;
+  memcpy(header + 8, "WAVEfmt ", 8);
+  header[16] = 16; header[17] = 0; header[18] = 0; header[19] = 0;
+  header[20] = 1; header[21] = 0;
+  header[22] = quality->channels; header[23] = 0;
+  header[24] = quality->sample_rate & 0xff;
+  header[25] = (quality->sample_rate >> 8) & 0xff;
+  header[26] = (quality->sample_rate >> 16) & 0xff;
+  header[27] = (quality->sample_rate >> 24) & 0xff;
+  header[28] = (quality->sample_rate * block_align) & 0xff;
+  header[29] = ((quality->sample_rate * block_align) >> 8) & 0xff;
+  header[30] = ((quality->sample_rate * block_align) >> 16) & 0xff;
+  header[31] = ((quality->sample_rate * block_align) >> 24) & 0xff;
+  header[32] = block_align; header[33] = 0;
+  header[34] = quality->bits_per_sample; header[35] = 0;
+  memcpy(header + 36, "data", 4);
+  header[40] = header[41] = header[42] = header[43] = 0xff;
+}
+
+// Sets up (or restarts, if the input quality changed) the encoder of a format
+static int
+format_encode_start(struct streaming_format *format)
+{
+  struct streaming_session *session;
+  struct decode_ctx *decode_ctx;
+  bool restart;
+  int ret;
+
+  restart = (format->encode_ctx != NULL);
+
+  transcode_encode_cleanup(&format->encode_ctx);
+  evbuffer_drain(format->encoded, -1);
+  free(format->header);
+  format->header = NULL;
+  format->header_len = 0;
+
+  decode_ctx = NULL;
+  if (streaming_quality_in.bits_per_sample == 16)
+    decode_ctx = transcode_decode_setup_raw(XCODE_PCM16, &streaming_quality_in);
+  else if (streaming_quality_in.bits_per_sample == 24)
+    decode_ctx = transcode_decode_setup_raw(XCODE_PCM24, &streaming_quality_in);
+  else if (streaming_quality_in.bits_per_sample == 32)
+    decode_ctx = transcode_decode_setup_raw(XCODE_PCM32, &streaming_quality_in);
+
+  if (!decode_ctx)
+    return -1;
+
+  format->encode_ctx = transcode_encode_setup(format->profile, &format->quality, decode_ctx, NULL, 0, 0);
+  transcode_decode_cleanup(&decode_ctx);
+  if (!format->encode_ctx)
+    {
+      DPRINTF(E_LOG, L_STREAMING, "Will not be able to stream %s, libav does not support the encoding: %d/%d/%d @ %d\n",
+	format->name, format->quality.sample_rate, format->quality.bits_per_sample, format->quality.channels, format->quality.bit_rate);
+      format->not_supported = true;
+      return -1;
+    }
+
+  format->not_supported = false;
+
+  if (format->profile == XCODE_PCM16)
+    {
+      CHECK_NULL(L_STREAMING, format->header = malloc(44));
+      wav_header_make(format->header, &format->quality);
+      format->header_len = 44;
+      return 0;
+    }
+
+  ret = transcode_encode_header(format->encoded, format->encode_ctx);
+  if (ret <= 0 || !format->send_header)
+    {
+      evbuffer_drain(format->encoded, -1);
+      return 0;
+    }
+
+  CHECK_NULL(L_STREAMING, format->header = malloc(ret));
+  evbuffer_remove(format->encoded, format->header, ret);
+  format->header_len = ret;
+
+  // This makes a chained Ogg stream, so current listeners need the new header,
+  // and new listeners can't use the old chunks
+  if (restart && format->ogg)
+    {
+      ring_clear(format);
+
+      pthread_mutex_lock(&streaming_sessions_lck);
+      for (session = streaming_sessions; session; session = session->next)
+	{
+	  if (session->format != format)
+	    continue;
+
+	  session->need_header = true;
+	  session->need_sync = true;
+	}
+      pthread_mutex_unlock(&streaming_sessions_lck);
+    }
+
+  return 0;
+}
+
+static void
+format_encode_stop(struct streaming_format *format)
+{
+  transcode_encode_cleanup(&format->encode_ctx);
+  evbuffer_drain(format->encoded, -1);
+  ring_clear(format);
+
+  free(format->header);
+  format->header = NULL;
+  format->header_len = 0;
+}
+
+static int
+encode_frame(struct streaming_format *format, transcode_frame *frame)
+{
+  int ret;
+
+  if (!format->encode_ctx)
+    {
+      ret = format_encode_start(format);
+      if (ret < 0)
+	return -1;
+    }
+
+  return transcode_encode(format->encoded, format->encode_ctx, frame, 0);
+}
+
+// Encodes the input once for each format that has listeners
+static int
+encode_buffer(uint8_t *buffer, size_t size)
+{
+  struct streaming_format *format;
+  transcode_frame *frame;
+  int samples;
+  int i;
+
+  if (streaming_not_supported)
+    {
+      DPRINTF(E_LOG, L_STREAMING, "Streaming unsupported\n");
+      return -1;
+    }
+
+  if (streaming_quality_in.channels == 0)
+    {
+      DPRINTF(E_LOG, L_STREAMING, "Streaming quality is zero (%d/%d/%d)\n", streaming_quality_in.sample_rate, streaming_quality_in.bits_per_sample, streaming_quality_in.channels);
+      return -1;
+    }
+
+  samples = BTOS(size, streaming_quality_in.bits_per_sample, streaming_quality_in.channels);
+
+  frame = transcode_frame_new(buffer, size, samples, &streaming_quality_in);
+  if (!frame)
+    {
+      DPRINTF(E_LOG, L_STREAMING, "Could not convert raw PCM to frame\n");
+      return -1;
+    }
+
+  for (i = 0; i < ARRAY_SIZE(streaming_formats); i++)
+    {
+      format = &streaming_formats[i];
+      if (format->nsessions > 0 && !format->not_supported)
+	encode_frame(format, frame);
+    }
+
+  transcode_frame_free(frame);
+
+  return samples;
+}
+
+
+/* -------------------------------- Sessions -------------------------------- */
+
+static void
+session_remove(struct streaming_session *session)
+{
+  if (session->require_icy)
+    --streaming_icy_clients;
+
+  session->format->nsessions--;
+  if (session->format->nsessions == 0)
+    format_encode_stop(session->format);
+
+  free(session);
+}
 
 static void
 streaming_close_cb(struct evhttp_connection *evcon, void *arg)
@@ -112,7 +495,7 @@ streaming_close_cb(struct evhttp_connection *evcon, void *arg)
   this = (struct streaming_session *)arg;
 
   evhttp_connection_get_peer(evcon, &address, &port);
-  DPRINTF(E_INFO, L_STREAMING, "Stopping mp3 streaming to %s:%d\n", address, (int)port);
+  DPRINTF(E_INFO, L_STREAMING, "Stopping streaming to %s:%d\n", address, (int)port);
 
   pthread_mutex_lock(&streaming_sessions_lck);
   if (!streaming_sessions)
@@ -145,13 +528,10 @@ streaming_close_cb(struct evhttp_connection *evcon, void *arg)
   else
     prev->next = session->next;
 
-  if (session->require_icy)
-    --streaming_icy_clients;
-
   // Valgrind says libevent doesn't free the request on disconnect (even though it owns it - libevent bug?),
   // so we do it with a reply end
   evhttp_send_reply_end(session->req);
-  free(session);
+  session_remove(session);
 
   if (!streaming_sessions)
     {
@@ -163,17 +543,25 @@ streaming_close_cb(struct evhttp_connection *evcon, void *arg)
   pthread_mutex_unlock(&streaming_sessions_lck);
 }
 
+// Closes the sessions of the given format, or all sessions if format is NULL
 static void
-streaming_end(void)
+streaming_end(struct streaming_format *format)
 {
   struct streaming_session *session;
+  struct streaming_session **prev;
   struct evhttp_connection *evcon;
   char *address;
   ev_uint16_t port;
 
   pthread_mutex_lock(&streaming_sessions_lck);
-  for (session = streaming_sessions; streaming_sessions; session = streaming_sessions)
+  for (prev = &streaming_sessions; (session = *prev); )
     {
+      if (format && session->format != format)
+	{
+	  prev = &session->next;
+	  continue;
+	}
+
       evcon = evhttp_request_get_connection(session->req);
       if (evcon)
 	{
@@ -183,92 +571,53 @@ streaming_end(void)
 	}
       evhttp_send_reply_end(session->req);
 
-      streaming_sessions = session->next;
-      free(session);
+      *prev = session->next;
+      session_remove(session);
     }
-  pthread_mutex_unlock(&streaming_sessions_lck);
 
-  event_del(streamingev);
-  event_del(metaev);
+  if (!streaming_sessions)
+    {
+      event_del(streamingev);
+      event_del(metaev);
+    }
+  pthread_mutex_unlock(&streaming_sessions_lck);
 }
 
 static void
 streaming_meta_cb(evutil_socket_t fd, short event, void *arg)
 {
   struct media_quality quality;
-  struct decode_ctx *decode_ctx;
+  struct streaming_format *format;
   int ret;
-
-  transcode_encode_cleanup(&streaming_encode_ctx);
+  int i;
 
   ret = read(fd, &quality, sizeof(struct media_quality));
   if (ret != sizeof(struct media_quality))
     goto error;
 
-  decode_ctx = NULL;
-  if (quality.bits_per_sample == 16)
-    decode_ctx = transcode_decode_setup_raw(XCODE_PCM16, &quality);
-  else if (quality.bits_per_sample == 24)
-    decode_ctx = transcode_decode_setup_raw(XCODE_PCM24, &quality);
-  else if (quality.bits_per_sample == 32)
-    decode_ctx = transcode_decode_setup_raw(XCODE_PCM32, &quality);
-
-  if (!decode_ctx)
+  if (quality.bits_per_sample != 16 && quality.bits_per_sample != 24 && quality.bits_per_sample != 32)
     goto error;
 
-  streaming_encode_ctx = transcode_encode_setup(XCODE_MP3, &streaming_quality_out, decode_ctx, NULL, 0, 0);
-  transcode_decode_cleanup(&decode_ctx);
-  if (!streaming_encode_ctx)
-    {
-      DPRINTF(E_LOG, L_STREAMING, "Will not be able to stream MP3, libav does not support MP3 encoding: %d/%d/%d @ %d\n", streaming_quality_out.sample_rate, streaming_quality_out.bits_per_sample, streaming_quality_out.channels, streaming_quality_out.bit_rate);
-      streaming_not_supported = 1;
-      streaming_end();
-      return;
-    }
-
   streaming_quality_in = quality;
   streaming_not_supported = 0;
 
-  return;
-
- error:
-  DPRINTF(E_LOG, L_STREAMING, "Unknown or unsupported quality of input data (%d/%d/%d), cannot MP3 encode\n", quality.sample_rate, quality.bits_per_sample, quality.channels);
-  streaming_not_supported = 1;
-  streaming_end();
-}
-
-static int
-encode_buffer(uint8_t *buffer, size_t size)
-{
-  transcode_frame *frame;
-  int samples;
-  int ret;
-
-  if (streaming_not_supported)
-    {
-      DPRINTF(E_LOG, L_STREAMING, "Streaming unsupported\n");
-      return -1;
-    }
-
-  if (streaming_quality_in.channels == 0)
+  for (i = 0; i < ARRAY_SIZE(streaming_formats); i++)
     {
-      DPRINTF(E_LOG, L_STREAMING, "Streaming quality is zero (%d/%d/%d)\n", streaming_quality_in.sample_rate, streaming_quality_in.bits_per_sample, streaming_quality_in.channels);
-      return -1;
-    }
-
-  samples = BTOS(size, streaming_quality_in.bits_per_sample, streaming_quality_in.channels);
+      format = &streaming_formats[i];
+      if (format->nsessions == 0)
+	continue;
 
-  frame = transcode_frame_new(buffer, size, samples, &streaming_quality_in);
-  if (!frame)
-    {
-      DPRINTF(E_LOG, L_STREAMING, "Could not convert raw PCM to frame\n");
-      return -1;
+      ret = format_encode_start(format);
+      if (ret < 0)
+	streaming_end(format);
     }
 
-  ret = transcode_encode(streaming_encoded_data, streaming_encode_ctx, frame, 0);
-  transcode_frame_free(frame);
+  return;
 
-  return ret;
+ error:
+  DPRINTF(E_LOG, L_STREAMING, "Unknown or unsupported quality of input data (%d/%d/%d), cannot encode\n", quality.sample_rate, quality.bits_per_sample, quality.channels);
+  streaming_not_supported = 1;
+  streaming_end(NULL);
 }
 
 /* We know that the icymeta is limited to 1+255*16 (ie 4081) bytes so caller must
@@ -322,29 +671,6 @@ streaming_icy_meta_create(uint8_t buf[STREAMING_ICY_METALEN_MAX+1], const char *
   return buf;
 }
 
-static uint8_t *
-streaming_icy_meta_splice(const uint8_t *data, size_t datalen, off_t offset, size_t *len)
-{
-  uint8_t  meta[STREAMING_ICY_METALEN_MAX+1];  // Buffer, of max sz, for the created icymeta
-  unsigned metalen;     // How much of the buffer is in use
-  uint8_t *buf;         // Client returned buffer; contains the audio (from data) spliced w/meta (from meta)
-
-  if (data == NULL || datalen == 0)
-    return NULL;
-
-  memset(meta, 0, sizeof(meta));
-  streaming_icy_meta_create(meta, streaming_icy_title, &metalen);
-
-  *len = datalen + metalen;
-  // DPRINTF(E_DBG, L_STREAMING, "splicing meta, audio block=%d bytes, offset=%d, metalen=%d new buflen=%d\n", datalen, offset, metalen, *len);
-  buf = malloc(*len);
-  memcpy(buf,                data, offset);
-  memcpy(buf+offset,         &meta[0], metalen);
-  memcpy(buf+offset+metalen, data+offset, datalen-offset);
-
-  return buf;
-}
-
 static void
 streaming_player_status_update()
 {
@@ -377,22 +703,116 @@ streaming_player_status_update()
 	    }
 	  free_queue_item(queue_item, 0);
 	}
+
+      // The meta block is the same for all clients, so only create it once
+      streaming_icy_meta_create(streaming_icy_meta, streaming_icy_title, &streaming_icy_metalen);
+    }
+}
+
+/* Adds the chunk to the session's output, splicing in the ICY meta block every
+ * streaming_icy_metaint bytes if the client wants that
+ */
+static void
+session_chunk_add(struct evbuffer *evbuf, struct streaming_session *session, struct streaming_chunk *chunk, size_t offset)
+{
+  size_t len;
+
+  if (!session->require_icy)
+    {
+      chunk_add(evbuf, chunk, offset, chunk->len - offset);
+      return;
+    }
+
+  while (offset < chunk->len)
+    {
+      len = streaming_icy_metaint - session->bytes_sent;
+      if (len > chunk->len - offset)
+	len = chunk->len - offset;
+
+      chunk_add(evbuf, chunk, offset, len);
+      offset += len;
+      session->bytes_sent += len;
+
+      if (session->bytes_sent == streaming_icy_metaint)
+	{
+	  evbuffer_add(evbuf, streaming_icy_meta, streaming_icy_metalen);
+	  session->bytes_sent = 0;
+	}
     }
 }
 
+/* Sends the session what it hasn't had yet from the ring of its format, except
+ * if the client is not keeping up, then the data stays in the ring for later
+ */
+static void
+session_send(struct evbuffer *evbuf, struct streaming_session *session)
+{
+  struct streaming_format *format = session->format;
+  struct streaming_chunk *chunk;
+  struct evhttp_connection *evcon;
+  struct bufferevent *bufev;
+  size_t queued;
+  size_t offset;
+
+  evcon = evhttp_request_get_connection(session->req);
+  if (!evcon)
+    return;
+
+  // Without the header the client can't use the data, so wait for it
+  if (session->need_header)
+    {
+      if (!format->header)
+	return;
+
+      evbuffer_add(evbuf, format->header, format->header_len);
+      session->need_header = false;
+    }
+
+  bufev = evhttp_connection_get_bufferevent(evcon);
+  queued = evbuffer_get_length(bufferevent_get_output(bufev));
+
+  if (session->seq < format->ring_first)
+    {
+      DPRINTF(E_DBG, L_STREAMING, "Client of %s stream is lagging, skipping %" PRIu64 " chunks\n", format->name, format->ring_first - session->seq);
+      session->seq = format->ring_first;
+      session->need_sync = format->ogg;
+    }
+
+  for (; session->seq < format->ring_next && queued < STREAMING_SESSION_QUEUE_MAX; session->seq++)
+    {
+      chunk = ring_get(format, session->seq);
+
+      offset = 0;
+      if (session->need_sync)
+	{
+	  if (chunk->sync == chunk->len)
+	    continue;
+
+	  offset = chunk->sync;
+	  session->need_sync = false;
+	}
+
+      session_chunk_add(evbuf, session, chunk, offset);
+      queued += chunk->len - offset;
+    }
+
+  if (evbuffer_get_length(evbuf) > 0)
+    evhttp_send_reply_chunk(session->req, evbuf);
+}
+
 static void
 streaming_send_cb(evutil_socket_t fd, short event, void *arg)
 {
+  struct streaming_format *format;
   struct streaming_session *session;
   struct evbuffer *evbuf;
   uint8_t rawbuf[STREAMING_READ_SIZE];
-  uint8_t *buf;
-  uint8_t *splice_buf = NULL;
-  size_t splice_len;
-  size_t count;
-  int overflow;
-  int len;
+  int samples;
+  int pushed;
   int ret;
+  int i;
+
+  samples = 0;
 
   // Player wrote data to the pipe (EV_READ)
   if (event & EV_READ)
@@ -412,6 +832,8 @@ streaming_send_cb(evutil_socket_t fd, short event, void *arg)
 	  ret = encode_buffer(rawbuf, ret);
 	  if (ret < 0)
 	    return;
+
+	  samples += ret;
 	}
     }
   // Event timed out, let's see what the player is doing and send silence if it is paused
@@ -430,10 +852,22 @@ streaming_send_cb(evutil_socket_t fd, short event, void *arg)
       ret = encode_buffer(rawbuf, sizeof(rawbuf));
       if (ret < 0)
 	return;
+
+      samples += ret;
     }
 
-  len = evbuffer_get_length(streaming_encoded_data);
-  if (len == 0)
+  // Each format's output goes into the ring once, then to all its sessions
+  pushed = 0;
+  for (i = 0; i < ARRAY_SIZE(streaming_formats); i++)
+    {
+      format = &streaming_formats[i];
+      if (format->not_supported && format->nsessions > 0)
+	streaming_end(format);
+      else if (format->nsessions > 0)
+	pushed += ring_push(format, samples);
+    }
+
+  if (!pushed)
     return;
 
   // Send data
@@ -441,56 +875,16 @@ streaming_send_cb(evutil_socket_t fd, short event, void *arg)
   pthread_mutex_lock(&streaming_sessions_lck);
   for (session = streaming_sessions; session; session = session->next)
     {
-      // Does this session want ICY meta data and is it time to send?
-      count = session->bytes_sent+len;
-      if (session->require_icy && count > streaming_icy_metaint)
-	{
-	  overflow = count%streaming_icy_metaint;
-	  buf = evbuffer_pullup(streaming_encoded_data, -1);
-
-	  // DPRINTF(E_DBG, L_STREAMING, "session=%x sent=%ld len=%ld overflow=%ld\n", session, session->bytes_sent, len, overflow);
-
-	  // Splice the 'icy title' in with the encoded audio data
-	  splice_len = 0;
-	  splice_buf = streaming_icy_meta_splice(buf, len, len-overflow, &splice_len);
-
-	  evbuffer_add(evbuf, splice_buf, splice_len);
-
-	  free(splice_buf);
-	  splice_buf = NULL;
-
-	  evhttp_send_reply_chunk(session->req, evbuf);
-
-	  if (session->next == NULL)
-	    {
-	      // We're the last session, drop the contents of the encoded buffer
-	      evbuffer_drain(streaming_encoded_data, len);
-	    }
-	  session->bytes_sent = overflow;
-	}
-      else
-	{
-	  if (session->next)
-	    {
-	      buf = evbuffer_pullup(streaming_encoded_data, -1);
-	      evbuffer_add(evbuf, buf, len);
-	      evhttp_send_reply_chunk(session->req, evbuf);
-	    }
-	  else
-	    {
-	      evhttp_send_reply_chunk(session->req, streaming_encoded_data);
-	    }
-	  session->bytes_sent += len;
-	}
+      session_send(evbuf, session);
     }
   pthread_mutex_unlock(&streaming_sessions_lck);
 
   evbuffer_free(evbuf);
 }
 
-// Thread: player (not fully thread safe, but hey...)
+// Thread: listener (not fully thread safe, but hey...)
 static void
-player_change_cb(short event_mask)
+player_change_cb(short event_mask, const struct listener_event_data *data)
 {
   streaming_player_changed = 1;
 }
@@ -533,12 +927,33 @@ streaming_write(struct output_buffer *obuf)
     }
 }
 
+static struct streaming_format *
+streaming_format_find(const char *path)
+{
+  char *ptr;
+  int i;
+
+  ptr = strrchr(path, '/');
+  if (!ptr)
+    return NULL;
+
+  for (i = 0; i < ARRAY_SIZE(streaming_formats); i++)
+    {
+      if (strcasecmp(ptr, streaming_formats[i].path) == 0)
+	return &streaming_formats[i];
+    }
+
+  return NULL;
+}
+
 int
 streaming_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parsed)
 {
   struct streaming_session *session;
+  struct streaming_format *format;
   struct evhttp_connection *evcon;
   struct evkeyvalq *output_headers;
+  struct evbuffer *evbuf;
   cfg_t *lib;
   const char *name;
   char *address;
@@ -546,28 +961,41 @@ streaming_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parse
   const char *param;
   bool require_icy = false;
   char buf[9];
+  int ret;
 
-  if (streaming_not_supported)
+  format = streaming_format_find(uri_parsed->path);
+  if (!format || streaming_not_supported || format->not_supported)
     {
-      DPRINTF(E_LOG, L_STREAMING, "Got MP3 streaming request, but cannot encode to MP3\n");
+      DPRINTF(E_LOG, L_STREAMING, "Got %s streaming request, but cannot encode to %s\n", format ? format->name : "unknown", format ? format->name : "it");
 
       evhttp_send_error(req, HTTP_NOTFOUND, "Not Found");
       return -1;
     }
 
+  // If we know the input we can check right away that we can encode it
+  if (format->nsessions == 0 && streaming_quality_in.channels)
+    {
+      ret = format_encode_start(format);
+      if (ret < 0)
+	{
+	  evhttp_send_error(req, HTTP_NOTFOUND, "Not Found");
+	  return -1;
+	}
+    }
+
   evcon = evhttp_request_get_connection(req);
   evhttp_connection_get_peer(evcon, &address, &port);
   param = evhttp_find_header( evhttp_request_get_input_headers(req), "Icy-MetaData");
-  if (param && strcmp(param, "1") == 0)
+  if (format->icy && param && strcmp(param, "1") == 0)
     require_icy = true;
 
-  DPRINTF(E_INFO, L_STREAMING, "Beginning mp3 streaming (with icy=%d, icy_metaint=%d) to %s:%d\n", require_icy, streaming_icy_metaint, address, (int)port);
+  DPRINTF(E_INFO, L_STREAMING, "Beginning %s streaming (with icy=%d, icy_metaint=%d) to %s:%d\n", format->name, require_icy, streaming_icy_metaint, address, (int)port);
 
   lib = cfg_getsec(cfg, "library");
   name = cfg_getstr(lib, "name");
 
   output_headers = evhttp_request_get_output_headers(req);
-  evhttp_add_header(output_headers, "Content-Type", "audio/mpeg");
+  evhttp_add_header(output_headers, "Content-Type", format->content_type);
   evhttp_add_header(output_headers, "Server", "forked-daapd/" VERSION);
   evhttp_add_header(output_headers, "Cache-Control", "no-cache");
   evhttp_add_header(output_headers, "Pragma", "no-cache");
@@ -602,11 +1030,22 @@ streaming_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parse
     }
 
   session->req = req;
+  session->format = format;
   session->next = streaming_sessions;
   session->require_icy = require_icy;
   session->bytes_sent = 0;
+  session->seq = ring_burst_start(format);
+  session->need_header = format->send_header;
+  session->need_sync = format->ogg;
   streaming_sessions = session;
 
+  format->nsessions++;
+
+  // New listeners get the header and then a burst of what is in the ring
+  CHECK_NULL(L_STREAMING, evbuf = evbuffer_new());
+  session_send(evbuf, session);
+  evbuffer_free(evbuf);
+
   pthread_mutex_unlock(&streaming_sessions_lck);
 
   evhttp_connection_set_closecb(evcon, streaming_close_cb, session);
@@ -617,21 +1056,17 @@ streaming_request(struct evhttp_request *req, struct httpd_uri_parsed *uri_parse
 int
 streaming_is_request(const char *path)
 {
-  char *ptr;
-
-  ptr = strrchr(path, '/');
-  if (ptr && (strcasecmp(ptr, "/stream.mp3") == 0))
-    return 1;
-
-  return 0;
+  return (streaming_format_find(path) != NULL);
 }
 
 int
 streaming_init(void)
 {
+  struct streaming_format *format;
   int ret;
   cfg_t *cfgsec;
   int val;
+  int i;
 
   cfgsec = cfg_getsec(cfg, "streaming");
 
@@ -665,6 +1100,19 @@ streaming_init(void)
   else
     DPRINTF(E_INFO, L_STREAMING, "Unsupported icy_metaint=%d, supported range: 4096..131072, defaulting to %d\n", val, streaming_icy_metaint);
 
+  for (i = 0; i < ARRAY_SIZE(streaming_formats); i++)
+    {
+      format = &streaming_formats[i];
+
+      format->quality = streaming_quality_out;
+      if (format->profile == XCODE_OGG)
+	format->quality.sample_rate = STREAMING_OPUS_SAMPLE_RATE;
+      else if (format->profile != XCODE_MP3)
+	format->quality.bit_rate = 0;
+
+      CHECK_NULL(L_STREAMING, format->encoded = evbuffer_new());
+    }
+
   pthread_mutex_init(&streaming_sessions_lck, NULL);
 
   // Non-blocking because otherwise httpd and player thread may deadlock
@@ -684,6 +1132,12 @@ streaming_init(void)
       goto error;
     }
 
+#ifdef F_SETPIPE_SZ
+  ret = fcntl(streaming_pipe[1], F_SETPIPE_SZ, STREAMING_PIPE_SIZE);
+  if (ret < 0)
+    DPRINTF(E_DBG, L_STREAMING, "Could not increase size of streaming pipe: %s\n", strerror(errno));
+#endif
+
 #ifdef HAVE_PIPE2
   ret = pipe2(streaming_meta, O_CLOEXEC | O_NONBLOCK);
 #else
@@ -708,14 +1162,13 @@ streaming_init(void)
       goto error;
     }
 
-  // Initialize buffer for encoded mp3 audio and event for pipe reading
-  CHECK_NULL(L_STREAMING, streaming_encoded_data = evbuffer_new());
-
+  // Initialize events for pipe reading
   CHECK_NULL(L_STREAMING, streamingev = event_new(evbase_httpd, streaming_pipe[0], EV_TIMEOUT | EV_READ | EV_PERSIST, streaming_send_cb, NULL));
   CHECK_NULL(L_STREAMING, metaev = event_new(evbase_httpd, streaming_meta[0], EV_READ | EV_PERSIST, streaming_meta_cb, NULL));
 
   streaming_icy_clients = 0;
   streaming_icy_title = NULL;
+  streaming_icy_meta_create(streaming_icy_meta, NULL, &streaming_icy_metalen);
 
   return 0;
 
@@ -731,7 +1184,9 @@ streaming_init(void)
 void
 streaming_deinit(void)
 {
-  streaming_end();
+  int i;
+
+  streaming_end(NULL);
 
   event_free(metaev);
   event_free(streamingev);
@@ -744,8 +1199,12 @@ streaming_deinit(void)
   close(streaming_meta[0]);
   close(streaming_meta[1]);
 
-  transcode_encode_cleanup(&streaming_encode_ctx);
-  evbuffer_free(streaming_encoded_data);
+  for (i = 0; i < ARRAY_SIZE(streaming_formats); i++)
+    {
+      format_encode_stop(&streaming_formats[i]);
+      evbuffer_free(streaming_formats[i].encoded);
+    }
+
   free(streaming_icy_title);
 
   pthread_mutex_destroy(&streaming_sessions_lck);
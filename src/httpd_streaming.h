@@ -5,10 +5,11 @@
 #include "httpd.h"
 #include "outputs.h"
 
-/* httpd_streaming takes care of incoming requests to /stream.mp3
- * It will receive decoded audio from the player, and encode it, and
- * stream it to one or more clients. It will not be available
- * if a suitable ffmpeg/libav encoder is not present at runtime.
+/* httpd_streaming takes care of incoming requests to /stream.mp3, /stream.ogg
+ * (Opus), /stream.flac and /stream.wav. It will receive decoded audio from the
+ * player, encode it once for each format that has clients, and stream it to
+ * them. A format will not be available if a suitable ffmpeg/libav encoder is
+ * not present at runtime.
  */
 
 void
@@ -45,10 +45,22 @@
 // Disallow further writes to the buffer when its size exceeds this threshold.
 // The below gives us room to buffer 2 seconds of 48000/16/2 audio.
 #define INPUT_BUFFER_THRESHOLD STOB(96000, 16, 2)
+// Size of the ring holding the pcm data, must be a power of two. Writes are
+// refused at INPUT_BUFFER_THRESHOLD, but EOF and error writes are always
+// accepted, so there must be room for one of those on top of the threshold.
+#define INPUT_BUFFER_SIZE (1 << 20)
+// Max number of markers in the marker ring, must be a power of two
+#define INPUT_MARKERS_MAX 128
+// Max number of markers that a single input_write() can add
+#define INPUT_MARKERS_PER_WRITE 4
 // How long (in nsec) to wait when the input buffer is full before looping
 #define INPUT_LOOP_TIMEOUT_NSEC 10000000
 // How long (in sec) to keep an input open without the player reading from it
 #define INPUT_OPEN_TIMEOUT 600
+// Max amount of pcm that is decoded ahead for the next item, about 1 sec
+#define INPUT_PREROLL_SIZE STOB(48000, 16, 2)
+
+#define CACHELINE_SIZE 64
 
 //#define DEBUG_INPUT 1
 // For testing http stream underruns
@@ -82,22 +94,70 @@ struct marker
   // Type of marker
   enum input_flags flag;
 
+  // Flush generation of the producer when the marker was added
+  uint32_t gen;
+
   // Data associated with the marker, e.g. quality or metadata struct
   void *data;
-
-  // Reverse linked list, yay!
-  struct marker *prev;
 };
 
+/*
+ * The input buffer is a single-producer/single-consumer ring shared by the
+ * input thread (or spotify thread), which writes, and the player thread, which
+ * reads. The player never takes a lock, it only needs to see the positions
+ * published by the writer and vice versa. All positions are absolute byte
+ * counts since startup, so they never wrap and never need to be reset.
+ *
+ * Markers (quality changes, EOF, metadata etc.) go into a separate ring. A
+ * marker is always added before the data it refers to is published, and the
+ * positions of the markers in the ring are ascending, so the reader just needs
+ * to check the oldest marker when reading.
+ *
+ * When the producer flushes, it may already have written more than the reader
+ * knows of, and the markers of what it writes next start at the flush position.
+ * So markers carry the flush generation they were added in, and the reader
+ * discards the markers of earlier generations, not those up to the position.
+ */
 struct input_buffer
 {
+  // Written by the producer: how much pcm data has been written, the number of
+  // markers added, and the position up to which the reader must discard data
+  // because the producer flushed the buffer. flush_gen counts the flushes, and
+  // flush_seq is a seqlock so the reader gets a flush_pos and flush_gen pair.
+  uint64_t write_pos __attribute__((aligned(CACHELINE_SIZE)));
+  uint32_t marker_head;
+  uint32_t flush_seq;
+  uint64_t flush_pos;
+  uint32_t flush_gen;
+
+  // Written by the consumer: how much has been handed to the player, how much
+  // the player is done with (i.e. may be overwritten), and the number of
+  // markers read. If the player flushes, the producer must reset its quality.
+  uint64_t read_pos __attribute__((aligned(CACHELINE_SIZE)));
+  uint64_t release_pos;
+  uint32_t marker_tail;
+  bool quality_reset;
+
+  // The last flush generation the consumer has handled, only used by the
+  // consumer
+  uint32_t read_gen;
+
   // Raw pcm stream data
-  struct evbuffer *evbuf;
+  uint8_t *data;
+
+  // Ring of markers, see above
+  struct marker markers[INPUT_MARKERS_MAX];
+
+  // Position of the last marker that was added, only used by the producer
+  uint64_t marker_last_pos;
+
+  // Position where the current source was opened, only used by the producer
+  uint64_t open_pos;
 
-  // If an input makes a write with a flag or a changed sample rate etc, we add
-  // a marker to head, and when we read we check from the tail to see if there
-  // are updates to the player.
-  struct marker *marker_tail;
+  // Used by input_read_ptr() if the data requested wraps around the end of the
+  // ring, only used by the consumer
+  uint8_t *readbuf;
+  size_t readbuf_size;
 
   // Optional callback to player if buffer is full
   input_cb full_cb;
@@ -106,12 +166,8 @@ struct input_buffer
   struct media_quality cur_write_quality;
   struct media_quality cur_read_quality;
 
-  size_t bytes_written;
-  size_t bytes_read;
-
-  // Locks for sharing the buffer between input and player thread
-  pthread_mutex_t mutex;
-  pthread_cond_t cond;
+  // Serializes the writers (input and spotify thread), the reader never takes it
+  pthread_mutex_t write_mutex;
 };
 
 struct input_arg
@@ -120,6 +176,31 @@ struct input_arg
   int seek_ms;
 };
 
+/*
+ * The next item in the queue, as told by the player. When the current item is
+ * close to its end, the input thread opens the next item and decodes the start
+ * of it into the preroll buffer. When the player then asks for the next item,
+ * it can be appended to the input buffer right after the end of the current
+ * one, without waiting for it to be opened.
+ */
+struct input_preroll
+{
+  // Queue item id of the next item, 0 if none
+  uint32_t item_id;
+
+  // Set when the source has been set up (it may have ended since)
+  bool ready;
+  struct input_source source;
+
+  // Pre-decoded pcm of the source, its quality and the flags it wrote
+  struct evbuffer *evbuf;
+  struct media_quality quality;
+  short flags;
+
+  // Set while the source is being read, so input_write() diverts to evbuf
+  bool writing;
+};
+
 /* --- Globals --- */
 // Input thread
 static pthread_t tid_input;
@@ -133,6 +214,21 @@ static bool input_initialized;
 // The source we are reading now
 static struct input_source input_now_reading;
 
+// Position (in ms) in the source we are reading now where reading started
+static int input_now_reading_start_ms;
+
+// The next source, maybe opened and pre-decoded ahead of time
+static struct input_preroll input_preroll;
+
+// How long (in ms) before the end of the current item the next is opened, 0
+// means the next item is opened when the player asks for it
+static int input_preopen_ms;
+
+// Transition metrics, input_eof_ts is set when an item ended and cleared when
+// data of the next item arrives
+static struct input_transition_stats input_transition_stats;
+static struct timespec input_eof_ts;
+
 // Input buffer
 static struct input_buffer input_buffer;
 
@@ -224,151 +320,345 @@ metadata_get(struct input_source *source)
 }
 
 static void
-marker_free(struct marker *marker)
+marker_data_free(struct marker *marker)
 {
-  if (!marker)
-    return;
-
   if (marker->flag == INPUT_FLAG_METADATA && marker->data)
     metadata_free(marker->data, 0);
 
   if (marker->flag == INPUT_FLAG_QUALITY && marker->data)
     free(marker->data);
-
-  free(marker);
 }
 
+// Thread: producer. Adds the markers to the marker ring, sorted by position.
+// The marker ring must have room for them, see input_write().
 static void
-marker_add(size_t pos, short flag, void *flagdata)
+markers_add(struct marker *new_markers, int n)
 {
-  struct marker *insert;
-  struct marker *compare;
+  struct marker tmp;
   struct marker *marker;
+  uint32_t head;
+  int i;
+  int j;
 
-  CHECK_NULL(L_PLAYER, marker = calloc(1, sizeof(struct marker)));
-
-  marker->pos = pos;
-  marker->flag = flag;
-  marker->data = flagdata;
-
-  // We want the list to be ordered by pos, so we reverse through it and compare
-  // each element with pos. Only if the element's pos is less than or equal to
-  // pos do we keep reversing. If no reversing is possible then we insert as new
-  // tail.
-  insert = NULL;
-  compare = input_buffer.marker_tail;
-
-  while (compare && compare->pos <= pos)
+  // Insertion sort, there are at most INPUT_MARKERS_PER_WRITE
+  for (i = 1; i < n; i++)
     {
-      insert = compare;
-      compare = compare->prev;
+      tmp = new_markers[i];
+      for (j = i; j > 0 && new_markers[j - 1].pos > tmp.pos; j--)
+	new_markers[j] = new_markers[j - 1];
+      new_markers[j] = tmp;
     }
 
-  if (insert)
-    {
-      marker->prev = insert->prev;
-      insert->prev = marker;
-    }
-  else
+  head = input_buffer.marker_head;
+
+  for (i = 0; i < n; i++)
     {
-      marker->prev = input_buffer.marker_tail;
-      input_buffer.marker_tail = marker;
+      marker = &input_buffer.markers[head % INPUT_MARKERS_MAX];
+      *marker = new_markers[i];
+      marker->gen = input_buffer.flush_gen;
+
+      // Only a START_NEXT can be placed behind a previous marker, and it is ok
+      // to move that up a bit, since it is only a hint to the player
+      if (marker->pos < input_buffer.marker_last_pos)
+	marker->pos = input_buffer.marker_last_pos;
+
+      input_buffer.marker_last_pos = marker->pos;
+      head++;
     }
+
+  __atomic_store_n(&input_buffer.marker_head, head, __ATOMIC_RELEASE);
 }
 
+// Thread: producer. Called before the data of the write is published, with
+// write_pos being the position after the write.
 static void
-markers_set(short flags, size_t write_size)
+markers_set(short flags, size_t write_size, uint64_t write_pos)
 {
+  struct marker new_markers[INPUT_MARKERS_PER_WRITE];
   struct media_quality *quality;
   struct input_metadata *metadata;
+  uint64_t release_pos;
+  int n;
+
+  memset(new_markers, 0, sizeof(new_markers));
+  n = 0;
 
   if (flags & INPUT_FLAG_QUALITY)
     {
       quality = malloc(sizeof(struct media_quality));
       *quality = input_buffer.cur_write_quality;
-      marker_add(input_buffer.bytes_written - write_size, INPUT_FLAG_QUALITY, quality);
+      new_markers[n].pos = write_pos - write_size;
+      new_markers[n].flag = INPUT_FLAG_QUALITY;
+      new_markers[n].data = quality;
+      n++;
     }
 
   if (flags & (INPUT_FLAG_EOF | INPUT_FLAG_ERROR))
     {
+      release_pos = __atomic_load_n(&input_buffer.release_pos, __ATOMIC_ACQUIRE);
+
       // This controls when the player will open the next track in the queue
-      if (input_buffer.bytes_read + INPUT_BUFFER_THRESHOLD < input_buffer.bytes_written)
+      if (release_pos + INPUT_BUFFER_THRESHOLD < write_pos)
 	// The player's read is behind, tell it to open when it reaches where
 	// we are minus the buffer size
-	marker_add(input_buffer.bytes_written - INPUT_BUFFER_THRESHOLD, INPUT_FLAG_START_NEXT, NULL);
+	new_markers[n].pos = write_pos - INPUT_BUFFER_THRESHOLD;
       else
 	// The player's read is close to our write, so open right away
-	marker_add(input_buffer.bytes_read, INPUT_FLAG_START_NEXT, NULL);
+	new_markers[n].pos = release_pos;
 
-      marker_add(input_buffer.bytes_written, flags & (INPUT_FLAG_EOF | INPUT_FLAG_ERROR), NULL);
+      new_markers[n].flag = INPUT_FLAG_START_NEXT;
+      n++;
+
+      new_markers[n].pos = write_pos;
+      new_markers[n].flag = flags & (INPUT_FLAG_EOF | INPUT_FLAG_ERROR);
+      n++;
     }
 
   if (flags & INPUT_FLAG_METADATA)
     {
       metadata = metadata_get(&input_now_reading);
       if (metadata)
-	marker_add(input_buffer.bytes_written, INPUT_FLAG_METADATA, metadata);
+	{
+	  new_markers[n].pos = write_pos;
+	  new_markers[n].flag = INPUT_FLAG_METADATA;
+	  new_markers[n].data = metadata;
+	  n++;
+	}
     }
+
+  markers_add(new_markers, n);
 }
 
 static inline void
 buffer_full_cb(void)
 {
-  if (!input_buffer.full_cb)
+  input_cb cb;
+
+  cb = __atomic_exchange_n(&input_buffer.full_cb, NULL, __ATOMIC_ACQ_REL);
+  if (!cb)
     return;
 
-  input_buffer.full_cb();
-  input_buffer.full_cb = NULL;
+  cb();
 }
 
+// Thread: producer. How much data the player hasn't consumed yet
+static inline size_t
+buffer_length(void)
+{
+  return input_buffer.write_pos - __atomic_load_n(&input_buffer.release_pos, __ATOMIC_ACQUIRE);
+}
 
-/* ------------------------- INPUT SOURCE HANDLING -------------------------- */
-
+// Thread: producer. Copies the data from evbuf to the ring, the caller must
+// make sure there is room for it.
 static void
-clear(struct input_source *source)
+buffer_copy_in(struct evbuffer *evbuf, size_t len)
 {
-  free(source->path);
-  memset(source, 0, sizeof(struct input_source));
+  size_t offset;
+  size_t chunk;
+
+  offset = input_buffer.write_pos & (INPUT_BUFFER_SIZE - 1);
+  chunk = MIN(len, INPUT_BUFFER_SIZE - offset);
+
+  evbuffer_remove(evbuf, input_buffer.data + offset, chunk);
+  if (len > chunk)
+    evbuffer_remove(evbuf, input_buffer.data, len - chunk);
 }
 
-static void
-flush(short *flagptr)
+// Thread: consumer. Tells the producer that the player is done with everything
+// it got until now.
+static inline void
+buffer_release(void)
+{
+  __atomic_store_n(&input_buffer.release_pos, input_buffer.read_pos, __ATOMIC_RELEASE);
+}
+
+// Thread: consumer. Discards data up to pos, and the markers up to pos or, if
+// by_gen is set, the markers added before the producer's flush number gen.
+// Returns an OR of the flags of the discarded markers.
+static short
+buffer_discard(uint64_t pos, bool by_gen, uint32_t gen)
 {
   struct marker *marker;
+  uint32_t head;
+  uint32_t tail;
   short flags;
-  size_t len;
 
-  pthread_mutex_lock(&input_buffer.mutex);
-
-  // We will return an OR of all the unread marker flags
   flags = 0;
-  for (marker = input_buffer.marker_tail; marker; marker = input_buffer.marker_tail)
+
+  head = __atomic_load_n(&input_buffer.marker_head, __ATOMIC_ACQUIRE);
+  tail = input_buffer.marker_tail;
+
+  for (; tail != head; tail++)
     {
+      marker = &input_buffer.markers[tail % INPUT_MARKERS_MAX];
+      if (by_gen ? ((int32_t)(marker->gen - gen) >= 0) : (marker->pos > pos))
+	break;
+
       flags |= marker->flag;
-      input_buffer.marker_tail = marker->prev;
-      marker_free(marker);
+      marker_data_free(marker);
     }
 
-  len = evbuffer_get_length(input_buffer.evbuf);
+  __atomic_store_n(&input_buffer.marker_tail, tail, __ATOMIC_RELEASE);
 
-  evbuffer_drain(input_buffer.evbuf, len);
+  if (pos > input_buffer.read_pos)
+    input_buffer.read_pos = pos;
 
-  memset(&input_buffer.cur_read_quality, 0, sizeof(struct media_quality));
-  memset(&input_buffer.cur_write_quality, 0, sizeof(struct media_quality));
+  buffer_release();
+
+  return flags;
+}
 
-  input_buffer.bytes_read = 0;
-  input_buffer.bytes_written = 0;
 
-  input_buffer.full_cb = NULL;
+// Thread: producer. Records the time it took from the end of the previous item
+// until data of the next item arrived. Must be called with write_mutex locked.
+static void
+transition_record(void)
+{
+  struct timespec now;
+  size_t buffered;
+  uint32_t gap_ms;
 
-  pthread_mutex_unlock(&input_buffer.mutex);
+  clock_gettime(CLOCK_MONOTONIC, &now);
 
-#ifdef DEBUG_INPUT
-  DPRINTF(E_DBG, L_PLAYER, "Flushing %zu bytes with flags %d\n", len, flags);
+  gap_ms = (now.tv_sec - input_eof_ts.tv_sec) * 1000 + (now.tv_nsec - input_eof_ts.tv_nsec) / 1000000;
+  buffered = buffer_length();
+
+  input_transition_stats.transitions++;
+  if (buffered == 0)
+    input_transition_stats.underruns++;
+  input_transition_stats.gap_last_ms = gap_ms;
+  if (gap_ms > input_transition_stats.gap_max_ms)
+    input_transition_stats.gap_max_ms = gap_ms;
+
+  DPRINTF(E_DBG, L_PLAYER, "Transition to next item took %" PRIu32 " ms, player had %zu bytes left\n", gap_ms, buffered);
+
+  memset(&input_eof_ts, 0, sizeof(struct timespec));
+}
+
+// Thread: producer. Must be called with write_mutex locked. If force is set the
+// data is written even if the buffer is above the threshold.
+static int
+buffer_write(struct evbuffer *evbuf, struct media_quality *quality, short flags, bool force)
+{
+  uint32_t markers_used;
+  bool read_end;
+  size_t len;
+  int ret;
+
+  // The player flushed, so it needs to get the quality again
+  if (__atomic_exchange_n(&input_buffer.quality_reset, false, __ATOMIC_ACQ_REL))
+    memset(&input_buffer.cur_write_quality, 0, sizeof(struct media_quality));
+
+  read_end = (flags & (INPUT_FLAG_EOF | INPUT_FLAG_ERROR));
+  if (read_end)
+    {
+      buffer_full_cb();
+      input_now_reading.open = false;
+    }
+
+  markers_used = input_buffer.marker_head - __atomic_load_n(&input_buffer.marker_tail, __ATOMIC_ACQUIRE);
+
+  if ((buffer_length() > INPUT_BUFFER_THRESHOLD && evbuf) || (markers_used > INPUT_MARKERS_MAX - INPUT_MARKERS_PER_WRITE))
+    {
+      buffer_full_cb();
+
+      // In case of EOF or error the input is always allowed to write, even if the
+      // buffer is full. There is no point in holding back the input in that case.
+      if (!read_end && !force)
+	return EAGAIN;
+
+      // Should never happen, since the reader is draining the markers
+      if (markers_used > INPUT_MARKERS_MAX - INPUT_MARKERS_PER_WRITE)
+	{
+	  DPRINTF(E_LOG, L_PLAYER, "Bug! Input marker buffer is full, stopping\n");
+	  input_stop();
+	  return -1;
+	}
+    }
+
+  if (quality && !quality_is_equal(quality, &input_buffer.cur_write_quality))
+    {
+      input_buffer.cur_write_quality = *quality;
+      flags |= INPUT_FLAG_QUALITY;
+    }
+
+  ret = 0;
+  len = 0;
+  if (evbuf)
+    {
+      len = evbuffer_get_length(evbuf);
+#ifdef DEBUG_UNDERRUN
+      // Starves the player so it underruns after a few minutes
+      debug_underrun_trigger++;
+      if (debug_underrun_trigger % 10 == 0)
+	{
+	  DPRINTF(E_DBG, L_PLAYER, "Underrun debug mode: Dropping audio buffer length %zu\n", len);
+	  evbuffer_drain(evbuf, len);
+	  len = 0;
+	}
 #endif
+      if (len > INPUT_BUFFER_SIZE - buffer_length())
+	{
+	  DPRINTF(E_LOG, L_PLAYER, "Error adding stream data to input buffer (no room for %zu bytes), stopping\n", len);
+	  evbuffer_drain(evbuf, len);
+	  len = 0;
+	  input_stop();
+	  flags |= INPUT_FLAG_ERROR;
+	  ret = -1;
+	}
+    }
+
+  if (len > 0 && input_eof_ts.tv_sec != 0)
+    transition_record();
+
+  // The markers must be in place before the reader can see the data
+  if (flags)
+    markers_set(flags, len, input_buffer.write_pos + len);
+
+  if (len > 0)
+    {
+      buffer_copy_in(evbuf, len);
+      __atomic_store_n(&input_buffer.write_pos, input_buffer.write_pos + len, __ATOMIC_RELEASE);
+    }
+
+  if (read_end)
+    clock_gettime(CLOCK_MONOTONIC, &input_eof_ts);
+
+  return ret;
+}
+
+
+/* ------------------------- INPUT SOURCE HANDLING -------------------------- */
+
+static void
+clear(struct input_source *source)
+{
+  free(source->path);
+  memset(source, 0, sizeof(struct input_source));
+}
+
+// Thread: input. Tells the player to discard everything written until now.
+static void
+flush(void)
+{
+  pthread_mutex_lock(&input_buffer.write_mutex);
+
+  seqlock_write_begin(&input_buffer.flush_seq);
+  __atomic_store_n(&input_buffer.flush_pos, input_buffer.write_pos, __ATOMIC_RELAXED);
+  __atomic_store_n(&input_buffer.flush_gen, input_buffer.flush_gen + 1, __ATOMIC_RELAXED);
+  seqlock_write_end(&input_buffer.flush_seq);
+  __atomic_store_n(&input_buffer.full_cb, NULL, __ATOMIC_RELEASE);
+
+  memset(&input_buffer.cur_write_quality, 0, sizeof(struct media_quality));
 
-  if (flagptr)
-    *flagptr = flags;
+  // What comes next is not a continuation, so it doesn't count as a transition
+  memset(&input_eof_ts, 0, sizeof(struct timespec));
+
+  pthread_mutex_unlock(&input_buffer.write_mutex);
+
+#ifdef DEBUG_INPUT
+  DPRINTF(E_DBG, L_PLAYER, "Flush requested at %" PRIu64 "\n", input_buffer.write_pos);
+#endif
 }
 
 static void
@@ -384,7 +674,7 @@ stop(void)
   if (inputs[type]->stop && input_now_reading.open)
     inputs[type]->stop(&input_now_reading);
 
-  flush(NULL);
+  flush();
 
   clear(&input_now_reading);
 }
@@ -450,6 +740,148 @@ setup(struct input_source *source, struct db_queue_item *queue_item, int seek_ms
   return -1;
 }
 
+/* ------------------------ PREROLL OF THE NEXT ITEM ------------------------ */
+/*                                Thread: input                               */
+
+static void
+preroll_clear(void)
+{
+  if (input_preroll.source.open && inputs[input_preroll.source.type]->stop)
+    inputs[input_preroll.source.type]->stop(&input_preroll.source);
+
+  clear(&input_preroll.source);
+
+  evbuffer_drain(input_preroll.evbuf, evbuffer_get_length(input_preroll.evbuf));
+  memset(&input_preroll.quality, 0, sizeof(struct media_quality));
+  input_preroll.flags = 0;
+  input_preroll.ready = false;
+}
+
+// Called via input_write() when the prerolled source writes
+static int
+preroll_write(struct evbuffer *evbuf, struct media_quality *quality, short flags)
+{
+  // The quality is only given once to the input buffer, so if it changes while
+  // prerolling we drop what we have (it can only be the very start of the item)
+  if (quality && input_preroll.quality.channels && !quality_is_equal(quality, &input_preroll.quality))
+    {
+      DPRINTF(E_DBG, L_PLAYER, "Quality of next item changed during preroll, dropping %zu bytes\n", evbuffer_get_length(input_preroll.evbuf));
+      evbuffer_drain(input_preroll.evbuf, evbuffer_get_length(input_preroll.evbuf));
+    }
+
+  if (quality)
+    input_preroll.quality = *quality;
+
+  if (evbuf)
+    evbuffer_add_buffer(input_preroll.evbuf, evbuf);
+
+  input_preroll.flags |= flags;
+
+  return 0;
+}
+
+// Opens the next item ahead of time. Only done for files and http streams,
+// the other inputs can't have two items open at the same time.
+static void
+preroll_open(void)
+{
+  struct db_queue_item *queue_item;
+  int type;
+  int ret;
+
+  queue_item = db_queue_fetch_byitemid(input_preroll.item_id);
+  if (!queue_item)
+    goto fail;
+
+  type = map_data_kind(queue_item->data_kind);
+  if (type != INPUT_TYPE_FILE && type != INPUT_TYPE_HTTP)
+    {
+      free_queue_item(queue_item, 0);
+      goto fail;
+    }
+
+  DPRINTF(E_DBG, L_PLAYER, "Opening next item ahead of time: '%s' (item id %" PRIu32 ")\n", queue_item->path, queue_item->id);
+
+  ret = setup(&input_preroll.source, queue_item, 0);
+  free_queue_item(queue_item, 0);
+  if (ret < 0)
+    goto fail;
+
+  input_preroll.ready = true;
+  return;
+
+ fail:
+  // Not trying again, the item will be opened when the player asks for it
+  input_preroll.item_id = 0;
+}
+
+// Called from the read loop of the current source. When the current source is
+// less than input_preopen_ms from its end, this opens the next item, and after
+// that it decodes the start of the next item, up to INPUT_PREROLL_SIZE.
+static void
+preroll_run(void)
+{
+  struct media_quality *quality;
+  uint64_t written_ms;
+  int ret;
+
+  if (!input_preroll.item_id || input_preopen_ms <= 0)
+    return;
+
+  if (!input_preroll.ready)
+    {
+      quality = &input_buffer.cur_write_quality;
+      if (input_now_reading.len_ms == 0 || quality->sample_rate == 0 || quality->channels == 0)
+	return;
+
+      written_ms = input_now_reading_start_ms + 1000 * BTOS(input_buffer.write_pos - input_buffer.open_pos, quality->bits_per_sample, quality->channels) / quality->sample_rate;
+      if (written_ms + input_preopen_ms < input_now_reading.len_ms)
+	return;
+
+      preroll_open();
+      return;
+    }
+
+  if (!input_preroll.source.open || !inputs[input_preroll.source.type]->play)
+    return;
+
+  if (evbuffer_get_length(input_preroll.evbuf) >= INPUT_PREROLL_SIZE)
+    return;
+
+  input_preroll.writing = true;
+  ret = inputs[input_preroll.source.type]->play(&input_preroll.source);
+  input_preroll.writing = false;
+  if (ret < 0)
+    input_preroll.source.open = false; // Backend closed it, see play()
+}
+
+// Makes the prerolled source the current one, and appends what was decoded
+// ahead of time to the input buffer, so it directly follows the end of the
+// previous item. Returns -1 if the item was not prerolled.
+static int
+preroll_promote(uint32_t item_id)
+{
+  if (!input_preroll.ready || input_preroll.item_id != item_id)
+    return -1;
+
+  DPRINTF(E_DBG, L_PLAYER, "Starting next item from preroll (%zu bytes): '%s' (item id %" PRIu32 ")\n",
+    evbuffer_get_length(input_preroll.evbuf), input_preroll.source.path, item_id);
+
+  clear(&input_now_reading);
+  input_now_reading = input_preroll.source;
+  memset(&input_preroll.source, 0, sizeof(struct input_source));
+
+  pthread_mutex_lock(&input_buffer.write_mutex);
+  input_transition_stats.prerolled++;
+  buffer_write(input_preroll.evbuf, input_preroll.quality.channels ? &input_preroll.quality : NULL, input_preroll.flags, true);
+  pthread_mutex_unlock(&input_buffer.write_mutex);
+
+  input_preroll.item_id = 0;
+  preroll_clear();
+
+  return 0;
+}
+
 static enum command_state
 start(void *arg, int *retval)
 {
@@ -457,10 +889,12 @@ start(void *arg, int *retval)
   struct db_queue_item *queue_item;
   int ret;
 
+  input_buffer.open_pos = input_buffer.write_pos;
+
   // If we are asked to start the item that is currently open we can just seek
   if (input_now_reading.open && cmdarg->item_id == input_now_reading.item_id)
     {
-      flush(NULL);
+      flush();
 
       ret = seek(&input_now_reading, cmdarg->seek_ms);
       if (ret < 0)
@@ -471,6 +905,16 @@ start(void *arg, int *retval)
       if (input_now_reading.open)
 	stop();
 
+      // The next item may have been opened and decoded ahead of time
+      if (cmdarg->seek_ms == 0 && preroll_promote(cmdarg->item_id) == 0)
+	{
+	  ret = 0;
+	  goto started;
+	}
+
+      input_preroll.item_id = 0;
+      preroll_clear();
+
       // Get the queue_item from the db
       queue_item = db_queue_fetch_byitemid(cmdarg->item_id);
       if (!queue_item)
@@ -485,9 +929,12 @@ start(void *arg, int *retval)
 	goto error;
     }
 
+ started:
   DPRINTF(E_DBG, L_PLAYER, "Starting input read loop for item '%s' (item id %" PRIu32 "), seek %d\n",
     input_now_reading.path, input_now_reading.item_id, cmdarg->seek_ms);
 
+  input_now_reading_start_ms = (ret > 0) ? ret : 0;
+
   event_add(input_open_timeout_ev, &input_open_timeout);
   event_active(input_ev, 0, 0);
 
@@ -526,6 +973,24 @@ stop_cmd(void *arg, int *retval)
 {
   stop();
 
+  input_preroll.item_id = 0;
+  preroll_clear();
+
+  *retval = 0;
+  return COMMAND_END;
+}
+
+static enum command_state
+preopen(void *arg, int *retval)
+{
+  struct input_arg *cmdarg = arg;
+
+  if (cmdarg->item_id != input_preroll.item_id)
+    {
+      preroll_clear();
+      input_preroll.item_id = cmdarg->item_id;
+    }
+
   *retval = 0;
   return COMMAND_END;
 }
@@ -533,12 +998,15 @@ stop_cmd(void *arg, int *retval)
 static void
 timeout_cb(int fd, short what, void *arg)
 {
-  if (input_buffer.bytes_read > 0)
+  if (__atomic_load_n(&input_buffer.release_pos, __ATOMIC_ACQUIRE) > input_buffer.open_pos)
     return;
 
   DPRINTF(E_WARN, L_PLAYER, "Timed out after %d sec without any reading from input source\n", INPUT_OPEN_TIMEOUT);
 
   stop();
+
+  input_preroll.item_id = 0;
+  preroll_clear();
 }
 
 
@@ -549,67 +1017,15 @@ timeout_cb(int fd, short what, void *arg)
 int
 input_write(struct evbuffer *evbuf, struct media_quality *quality, short flags)
 {
-  bool read_end;
-  size_t len;
   int ret;
 
-  pthread_mutex_lock(&input_buffer.mutex);
-
-  read_end = (flags & (INPUT_FLAG_EOF | INPUT_FLAG_ERROR));
-  if (read_end)
-    {
-      buffer_full_cb();
-      input_now_reading.open = false;
-    }
-
-  if ((evbuffer_get_length(input_buffer.evbuf) > INPUT_BUFFER_THRESHOLD) && evbuf)
-    {
-      buffer_full_cb();
-
-      // In case of EOF or error the input is always allowed to write, even if the
-      // buffer is full. There is no point in holding back the input in that case.
-      if (!read_end)
-	{
-	  pthread_mutex_unlock(&input_buffer.mutex);
-	  return EAGAIN;
-	}
-    }
-
-  if (quality && !quality_is_equal(quality, &input_buffer.cur_write_quality))
-    {
-      input_buffer.cur_write_quality = *quality;
-      flags |= INPUT_FLAG_QUALITY;
-    }
-
-  ret = 0;
-  len = 0;
-  if (evbuf)
-    {
-      len = evbuffer_get_length(evbuf);
-#ifdef DEBUG_UNDERRUN
-      // Starves the player so it underruns after a few minutes
-      debug_underrun_trigger++;
-      if (debug_underrun_trigger % 10 == 0)
-	{
-	  DPRINTF(E_DBG, L_PLAYER, "Underrun debug mode: Dropping audio buffer length %zu\n", len);
-	  evbuffer_drain(evbuf, len);
-	  len = 0;
-	}
-#endif
-      input_buffer.bytes_written += len;
-      ret = evbuffer_add_buffer(input_buffer.evbuf, evbuf);
-      if (ret < 0)
-	{
-	  DPRINTF(E_LOG, L_PLAYER, "Error adding stream data to input buffer, stopping\n");
-	  input_stop();
-	  flags |= INPUT_FLAG_ERROR;
-	}
-    }
-
-  if (flags)
-    markers_set(flags, len);
+  // The next item is being decoded ahead of time, see preroll_run()
+  if (pthread_equal(pthread_self(), tid_input) && input_preroll.writing)
+    return preroll_write(evbuf, quality, flags);
 
-  pthread_mutex_unlock(&input_buffer.mutex);
+  pthread_mutex_lock(&input_buffer.write_mutex);
+  ret = buffer_write(evbuf, quality, flags, false);
+  pthread_mutex_unlock(&input_buffer.write_mutex);
 
   return ret;
 }
@@ -617,14 +1033,8 @@ input_write(struct evbuffer *evbuf, struct media_quality *quality, short flags)
 int
 input_wait(void)
 {
-  struct timespec ts;
-
-  pthread_mutex_lock(&input_buffer.mutex);
+  nanosleep(&input_loop_timeout, NULL);
 
-  ts = timespec_reltoabs(input_loop_timeout);
-  pthread_cond_timedwait(&input_buffer.cond, &input_buffer.mutex, &ts);
-
-  pthread_mutex_unlock(&input_buffer.mutex);
   return 0;
 }
 
@@ -661,26 +1071,18 @@ input(void *arg)
 static int
 wait_buffer_ready(void)
 {
-  struct timespec ts;
-
-  pthread_mutex_lock(&input_buffer.mutex);
-
-  // Is the buffer full? Then wait for a read or for loop_timeout to elapse
-  if (evbuffer_get_length(input_buffer.evbuf) > INPUT_BUFFER_THRESHOLD)
+  // Is the buffer full? Then give the player time to read. There is no point
+  // in being woken up by the player, it reads at a fixed pace anyway.
+  if (buffer_length() > INPUT_BUFFER_THRESHOLD)
     {
       buffer_full_cb();
 
-      ts = timespec_reltoabs(input_loop_timeout);
-      pthread_cond_timedwait(&input_buffer.cond, &input_buffer.mutex, &ts);
+      nanosleep(&input_loop_timeout, NULL);
 
-      if (evbuffer_get_length(input_buffer.evbuf) > INPUT_BUFFER_THRESHOLD)
-	{
-	  pthread_mutex_unlock(&input_buffer.mutex);
-	  return -1;
-	}
+      if (buffer_length() > INPUT_BUFFER_THRESHOLD)
+	return -1;
     }
 
-  pthread_mutex_unlock(&input_buffer.mutex);
   return 0;
 }
 
@@ -691,10 +1093,14 @@ play(evutil_socket_t fd, short flags, void *arg)
   int ret;
 
   // Spotify runs in its own thread, so no reading is done by the input thread,
-  // thus there is no reason to activate input_ev
-  if (!inputs[input_now_reading.type]->play)
+  // thus there is no reason to activate input_ev. We also get here if a
+  // prerolled item that already ended was started.
+  if (!inputs[input_now_reading.type]->play || !input_now_reading.open)
     return;
 
+  // Opens and decodes the start of the next item when we get close to the end
+  preroll_run();
+
   // If the buffer is full we wait until either the player has consumed enough
   // data or INPUT_LOOP_TIMEOUT has elapsed (so we don't hang the input event
   // thread when the player doesn't consume data quickly). If the return is
@@ -712,6 +1118,12 @@ play(evutil_socket_t fd, short flags, void *arg)
   if (ret < 0)
     {
       input_now_reading.open = false;
+
+      // If the item ended before we got to open the next (e.g. the length was
+      // unknown), we do it now, while the player has the buffer to play
+      if (input_preroll.item_id && input_preopen_ms > 0 && !input_preroll.ready)
+	preroll_open();
+
       return; // Error or EOF, so don't come back
     }
 
@@ -723,39 +1135,86 @@ play(evutil_socket_t fd, short flags, void *arg)
 /*                                Thread: player                              */
 
 int
-input_read(void *data, size_t size, short *flag, void **flagdata)
+input_read_ptr(uint8_t **data, size_t size, short *flag, void **flagdata)
 {
   struct marker *marker;
-  int len;
+  uint64_t write_pos;
+  uint64_t flush_pos;
+  uint32_t flush_gen;
+  uint32_t seq;
+  uint32_t head;
+  size_t offset;
+  size_t chunk;
+  size_t len;
 
   *flag = 0;
+  *data = NULL;
+
+  // Whatever we handed out in the previous read has now been consumed
+  buffer_release();
+
+  // Did the producer flush?
+  do
+    {
+      seq = seqlock_read_begin(&input_buffer.flush_seq);
+      flush_pos = __atomic_load_n(&input_buffer.flush_pos, __ATOMIC_RELAXED);
+      flush_gen = __atomic_load_n(&input_buffer.flush_gen, __ATOMIC_RELAXED);
+    }
+  while (seqlock_read_retry(&input_buffer.flush_seq, seq));
+
+  if (flush_gen != input_buffer.read_gen)
+    {
+      buffer_discard(flush_pos, true, flush_gen);
+      input_buffer.read_gen = flush_gen;
+    }
 
-  pthread_mutex_lock(&input_buffer.mutex);
+  write_pos = __atomic_load_n(&input_buffer.write_pos, __ATOMIC_ACQUIRE);
 
   // First we check if there is a marker in the requested samples. If there is,
   // we only return data up until that marker. That way we don't have to deal
   // with multiple markers, and we don't return data that contains mixed sample
   // rates, bits per sample or an EOF in the middle.
-  marker = input_buffer.marker_tail;
-  if (marker && marker->pos <= input_buffer.bytes_read + size)
+  head = __atomic_load_n(&input_buffer.marker_head, __ATOMIC_ACQUIRE);
+  if (input_buffer.marker_tail != head)
     {
-      *flag = marker->flag;
-      *flagdata = marker->data;
+      marker = &input_buffer.markers[input_buffer.marker_tail % INPUT_MARKERS_MAX];
+      if (marker->pos <= input_buffer.read_pos + size && marker->pos <= write_pos)
+	{
+	  *flag = marker->flag;
+	  *flagdata = marker->data;
 
-      size = marker->pos - input_buffer.bytes_read;
-      input_buffer.marker_tail = marker->prev;
-      free(marker);
+	  // A START_NEXT marker may point to data that was already read
+	  size = (marker->pos > input_buffer.read_pos) ? marker->pos - input_buffer.read_pos : 0;
+	  __atomic_store_n(&input_buffer.marker_tail, input_buffer.marker_tail + 1, __ATOMIC_RELEASE);
+	}
     }
 
-  len = evbuffer_remove(input_buffer.evbuf, data, size);
-  if (len < 0)
+  len = MIN(size, write_pos - input_buffer.read_pos);
+  if (len == 0)
+    return 0;
+
+  offset = input_buffer.read_pos & (INPUT_BUFFER_SIZE - 1);
+  chunk = INPUT_BUFFER_SIZE - offset;
+
+  if (len <= chunk)
+    {
+      *data = input_buffer.data + offset;
+    }
+  else
     {
-      DPRINTF(E_LOG, L_PLAYER, "Error reading stream data from input buffer\n");
-      *flag = INPUT_FLAG_ERROR;
-      goto out_unlock;
+      // Wraps around the end of the ring, so we have to copy (rare)
+      if (input_buffer.readbuf_size < len)
+	{
+	  CHECK_NULL(L_PLAYER, input_buffer.readbuf = realloc(input_buffer.readbuf, len));
+	  input_buffer.readbuf_size = len;
+	}
+
+      memcpy(input_buffer.readbuf, input_buffer.data + offset, chunk);
+      memcpy(input_buffer.readbuf + chunk, input_buffer.data, len - chunk);
+      *data = input_buffer.readbuf;
     }
 
-  input_buffer.bytes_read += len;
+  input_buffer.read_pos += len;
 
 #ifdef DEBUG_INPUT
   // Logs if flags present or each 10 seconds
@@ -768,24 +1227,29 @@ input_read(void *data, size_t size, short *flag, void **flagdata)
   if (*flag || (debug_elapsed > 10 * one_sec_size))
     {
       debug_elapsed = 0;
-      DPRINTF(E_DBG, L_PLAYER, "READ %zu bytes (%d/%d/%d), WROTE %zu bytes (%d/%d/%d), SIZE %zu (=%zu), FLAGS %04x\n",
-        input_buffer.bytes_read,
+      DPRINTF(E_DBG, L_PLAYER, "READ %" PRIu64 " bytes (%d/%d/%d), WROTE %" PRIu64 " bytes, SIZE %" PRIu64 ", FLAGS %04x\n",
+        input_buffer.read_pos,
         input_buffer.cur_read_quality.sample_rate,
         input_buffer.cur_read_quality.bits_per_sample,
         input_buffer.cur_read_quality.channels,
-        input_buffer.bytes_written,
-        input_buffer.cur_write_quality.sample_rate,
-        input_buffer.cur_write_quality.bits_per_sample,
-        input_buffer.cur_write_quality.channels,
-        evbuffer_get_length(input_buffer.evbuf),
-        input_buffer.bytes_written - input_buffer.bytes_read,
+        write_pos,
+        write_pos - input_buffer.read_pos,
         *flag);
     }
 #endif
 
- out_unlock:
-  pthread_cond_signal(&input_buffer.cond);
-  pthread_mutex_unlock(&input_buffer.mutex);
+  return len;
+}
+
+int
+input_read(void *data, size_t size, short *flag, void **flagdata)
+{
+  uint8_t *ptr;
+  int len;
+
+  len = input_read_ptr(&ptr, size, flag, flagdata);
+  if (len > 0)
+    memcpy(data, ptr, len);
 
   return len;
 }
@@ -793,10 +1257,7 @@ input_read(void *data, size_t size, short *flag, void **flagdata)
 void
 input_buffer_full_cb(input_cb cb)
 {
-  pthread_mutex_lock(&input_buffer.mutex);
-  input_buffer.full_cb = cb;
-
-  pthread_mutex_unlock(&input_buffer.mutex);
+  __atomic_store_n(&input_buffer.full_cb, cb, __ATOMIC_RELEASE);
 }
 
 int
@@ -842,11 +1303,45 @@ input_stop(void)
   commands_exec_async(cmdbase, stop_cmd, NULL);
 }
 
+void
+input_preopen(uint32_t item_id)
+{
+  struct input_arg *cmdarg;
+
+  CHECK_NULL(L_PLAYER, cmdarg = malloc(sizeof(struct input_arg)));
+
+  cmdarg->item_id = item_id;
+  cmdarg->seek_ms = 0;
+
+  commands_exec_async(cmdbase, preopen, cmdarg);
+}
+
+void
+input_transition_stats_get(struct input_transition_stats *stats)
+{
+  pthread_mutex_lock(&input_buffer.write_mutex);
+  *stats = input_transition_stats;
+  pthread_mutex_unlock(&input_buffer.write_mutex);
+}
+
 void
 input_flush(short *flags)
 {
-  // Flush should be thread safe
-  flush(flags);
+  short discarded;
+
+  discarded = buffer_discard(__atomic_load_n(&input_buffer.write_pos, __ATOMIC_ACQUIRE), false, 0);
+
+  memset(&input_buffer.cur_read_quality, 0, sizeof(struct media_quality));
+
+  __atomic_store_n(&input_buffer.full_cb, NULL, __ATOMIC_RELEASE);
+  __atomic_store_n(&input_buffer.quality_reset, true, __ATOMIC_RELEASE);
+
+#ifdef DEBUG_INPUT
+  DPRINTF(E_DBG, L_PLAYER, "Flushing input buffer with flags %d\n", discarded);
+#endif
+
+  if (flags)
+    *flags = discarded;
 }
 
 void
@@ -863,13 +1358,15 @@ input_init(void)
   int i;
 
   // Prepare input buffer
-  pthread_mutex_init(&input_buffer.mutex, NULL);
-  pthread_cond_init(&input_buffer.cond, NULL);
+  pthread_mutex_init(&input_buffer.write_mutex, NULL);
 
   CHECK_NULL(L_PLAYER, evbase_input = event_base_new());
-  CHECK_NULL(L_PLAYER, input_buffer.evbuf = evbuffer_new());
+  CHECK_NULL(L_PLAYER, input_buffer.data = malloc(INPUT_BUFFER_SIZE));
   CHECK_NULL(L_PLAYER, input_ev = event_new(evbase_input, -1, EV_PERSIST, play, NULL));
   CHECK_NULL(L_PLAYER, input_open_timeout_ev = evtimer_new(evbase_input, timeout_cb, NULL));
+  CHECK_NULL(L_PLAYER, input_preroll.evbuf = evbuffer_new());
+
+  input_preopen_ms = cfg_getint(cfg_getsec(cfg, "general"), "input_preopen_ms");
 
   no_input = 1;
   for (i = 0; inputs[i]; i++)
@@ -916,9 +1413,10 @@ input_init(void)
  thread_fail:
   commands_base_free(cmdbase);
  input_fail:
+  evbuffer_free(input_preroll.evbuf);
   event_free(input_open_timeout_ev);
   event_free(input_ev);
-  evbuffer_free(input_buffer.evbuf);
+  free(input_buffer.data);
   event_base_free(evbase_input);
   return -1;
 }
@@ -951,12 +1449,16 @@ input_deinit(void)
       return;
     }
 
-  pthread_cond_destroy(&input_buffer.cond);
-  pthread_mutex_destroy(&input_buffer.mutex);
+  // Frees the data of any markers the player didn't read
+  buffer_discard(input_buffer.write_pos, true, input_buffer.flush_gen + 1);
+
+  pthread_mutex_destroy(&input_buffer.write_mutex);
 
+  evbuffer_free(input_preroll.evbuf);
   event_free(input_open_timeout_ev);
   event_free(input_ev);
-  evbuffer_free(input_buffer.evbuf);
+  free(input_buffer.readbuf);
+  free(input_buffer.data);
   event_base_free(evbase_input);
 }
 
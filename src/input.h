@@ -70,6 +70,19 @@ struct input_source
 
 typedef int (*input_cb)(void);
 
+struct input_transition_stats
+{
+  // Number of times data of a new item followed the end of the previous item
+  uint64_t transitions;
+  // Number of those where the new item had been opened ahead of time
+  uint64_t prerolled;
+  // Number of those where the player had nothing left to play
+  uint64_t underruns;
+  // Time from the end of an item until data of the next item arrived
+  uint32_t gap_last_ms;
+  uint32_t gap_max_ms;
+};
+
 struct input_metadata
 {
   // queue_item id
@@ -166,6 +179,21 @@ input_wait(void);
 int
 input_read(void *data, size_t size, short *flag, void **flagdata);
 
+/*
+ * Same as input_read(), but without copying: returns a pointer to the data in
+ * the input buffer. The data must not be modified, and it is only valid until
+ * the next call to input_read(), input_read_ptr() or input_flush(). Should only
+ * be called by the player thread. Will not block or take any locks.
+ *
+ * @out data     Pointer to the data, NULL if no data was read
+ * @in  size     Max number of bytes to read
+ * @out flag     Flag INPUT_FLAG_*
+ * @out flagdata Data associated with the flag, e.g. quality or metadata struct
+ * @return       Number of bytes read, -1 on error
+ */
+int
+input_read_ptr(uint8_t **data, size_t size, short *flag, void **flagdata);
+
 /*
  * Player can set this to get a callback from the input when the input buffer
  * is full. The player may use this to resume playback after an underrun.
@@ -212,9 +240,28 @@ input_resume(uint32_t item_id, int seek_ms);
 void
 input_stop(void);
 
+/*
+ * Tells the input which item comes after the one it is reading now, so it can
+ * be opened and start decoding before the current item ends (as configured by
+ * input_preopen_ms). When the player then calls input_start() for the item, it
+ * will continue right after the current. Non-blocking.
+ *
+ * @in  item_id  Queue item id of the next item, 0 if there is none
+ */
+void
+input_preopen(uint32_t item_id);
+
+/*
+ * Gets the statistics of the transitions from one item to the next
+ *
+ * @out stats    The statistics
+ */
+void
+input_transition_stats_get(struct input_transition_stats *stats);
+
 /*
  * Flush input buffer. Output flags will be the same as input_read(). Call with
- * null pointer is valid.
+ * null pointer is valid. Should only be called by the player thread.
  */
 void
 input_flush(short *flags);
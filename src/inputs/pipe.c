@@ -870,7 +870,6 @@ pipelist_create(void)
   struct pipe *head;
   struct pipe *pipe;
   char filter[32];
-  int id;
   int ret;
 
   memset(&qp, 0, sizeof(struct query_params));
@@ -886,11 +885,7 @@ pipelist_create(void)
   head = NULL;
   while (((ret = db_query_fetch_file(&qp, &dbmfi)) == 0) && (dbmfi.id))
     {
-      ret = safe_atoi32(dbmfi.id, &id);
-      if (ret < 0)
-	continue;
-
-      pipe = pipe_create(dbmfi.path, id, PIPE_PCM, pipe_read_cb);
+      pipe = pipe_create(dbmfi.path, dbmfi.id, PIPE_PCM, pipe_read_cb);
       pipelist_add(&head, pipe);
     }
 
@@ -903,7 +898,7 @@ pipelist_create(void)
 // the pipe thread to watch the pipes. If no pipes in library, it will shut down
 // the pipe thread.
 static void
-pipe_listener_cb(short event_mask)
+pipe_listener_cb(short event_mask, const struct listener_event_data *data)
 {
   union pipe_arg *cmdarg;
 
@@ -1049,7 +1044,7 @@ init(void)
   pipe_autostart = cfg_getbool(cfg_getsec(cfg, "library"), "pipe_autostart");
   if (pipe_autostart)
     {
-      pipe_listener_cb(0);
+      pipe_listener_cb(0, NULL);
       CHECK_ERR(L_PLAYER, listener_add(pipe_listener_cb, LISTENER_DATABASE));
     }
 
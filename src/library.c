@@ -39,6 +39,7 @@
 #include <event2/event.h>
 
 #include "library.h"
+#include "artwork.h"
 #include "cache.h"
 #include "commands.h"
 #include "conffile.h"
@@ -47,6 +48,7 @@
 #include "misc.h"
 #include "listener.h"
 #include "player.h"
+#include "worker.h"
 
 #define LIBRARY_MAX_CALLBACKS 16
 
@@ -116,9 +118,25 @@ static struct event *updateev;
 static unsigned int deferred_update_notifications;
 static short deferred_update_events;
 
+// Incremented (atomically) on every change to the library tables, so caches
+// of data derived from the library can tell if what they hold is stale
+static unsigned int library_generation;
+
 // Stores callbacks that backends may have requested
 static struct library_callback_register library_cb_register[LIBRARY_MAX_CALLBACKS];
 
+// After scans, album artwork is prerendered by the worker thread in chunks of
+// this many albums, so that its other jobs get a turn in between. A new scan
+// bumps the generation, which stops the current run (atomic).
+#define LIBRARY_PRERENDER_CHUNK 10
+static int library_prerender_gen;
+
+struct prerender_arg
+{
+  int gen;
+  int after;
+};
+
 
 /* ------------------- CALLED BY LIBRARY SOURCE MODULES -------------------- */
 
@@ -273,6 +291,44 @@ purge_cruft(time_t start)
   cache_artwork_purge_cruft(start);
 }
 
+// Thread: worker
+static void
+prerender_cb(void *arg)
+{
+  struct prerender_arg *pa = arg;
+  int ret;
+
+  // Restarted when the scan is done
+  if (library_is_exiting() || library_is_scanning() || pa->gen != __atomic_load_n(&library_prerender_gen, __ATOMIC_ACQUIRE))
+    return;
+
+  ret = artwork_prerender_groups(pa->after, LIBRARY_PRERENDER_CHUNK);
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_LIB, "Error prerendering artwork, stopping\n");
+      return;
+    }
+  else if (ret == 0)
+    {
+      DPRINTF(E_DBG, L_LIB, "Artwork prerendering completed\n");
+      return;
+    }
+
+  pa->after = ret;
+  worker_execute(prerender_cb, pa, sizeof(struct prerender_arg), 0);
+}
+
+static void
+prerender_start(void)
+{
+  struct prerender_arg pa;
+
+  pa.gen = __atomic_add_fetch(&library_prerender_gen, 1, __ATOMIC_RELEASE);
+  pa.after = 0;
+
+  worker_execute(prerender_cb, &pa, sizeof(struct prerender_arg), 0);
+}
+
 static enum command_state
 rescan(void *arg, int *ret)
 {
@@ -311,6 +367,8 @@ rescan(void *arg, int *ret)
   else
     listener_notify(LISTENER_UPDATE);
 
+  prerender_start();
+
   *ret = 0;
   return COMMAND_END;
 }
@@ -353,6 +411,8 @@ metarescan(void *arg, int *ret)
   else
     listener_notify(LISTENER_UPDATE);
 
+  prerender_start();
+
   *ret = 0;
   return COMMAND_END;
 }
@@ -395,6 +455,8 @@ fullrescan(void *arg, int *ret)
   else
     listener_notify(LISTENER_UPDATE);
 
+  prerender_start();
+
   *ret = 0;
   return COMMAND_END;
 }
@@ -670,6 +732,8 @@ initscan()
     listener_notify(LISTENER_UPDATE | LISTENER_DATABASE);
   else
     listener_notify(LISTENER_UPDATE);
+
+  prerender_start();
 }
 
 bool
@@ -696,6 +760,11 @@ library_update_trigger(short update_events)
   short *events;
   int ret;
 
+  // Bumped right away (not when the DATABASE event is emitted) so that nobody
+  // will be served stale data during the notification delay
+  if (update_events & LISTENER_DATABASE)
+    __atomic_add_fetch(&library_generation, 1, __ATOMIC_RELEASE);
+
   pthread_t current_thread = pthread_self();
   if (pthread_equal(current_thread, tid_library))
     {
@@ -710,6 +779,12 @@ library_update_trigger(short update_events)
     }
 }
 
+unsigned int
+library_generation_get(void)
+{
+  return __atomic_load_n(&library_generation, __ATOMIC_ACQUIRE);
+}
+
 int
 library_playlist_item_add(const char *vp_playlist, const char *vp_item)
 {
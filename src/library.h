@@ -183,6 +183,15 @@ library_set_scanning(bool is_scanning);
 void
 library_update_trigger(short update_events);
 
+/*
+ * Returns the library generation, which is incremented every time
+ * library_update_trigger() is called with LISTENER_DATABASE. Something derived
+ * from the library at generation X is stale if the generation is no longer X.
+ * It is safe to call this function from any thread.
+ */
+unsigned int
+library_generation_get(void);
+
 int
 library_playlist_item_add(const char *vp_playlist, const char *vp_item);
 
@@ -26,6 +26,7 @@
 #include <libgen.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <unistd.h>
 #include <string.h>
 #include <time.h>
@@ -150,6 +151,84 @@ static int counter;
 static int incomingfiles_idx;
 static uint32_t incomingfiles_buffer[INCOMINGFILES_BUFFER_SIZE];
 
+/* Bulk scans are run as a pipeline: the scan thread walks the directories and
+ * queues files that need a metadata scan, a pool of worker threads runs
+ * scan_metadata_ffmpeg() on them, and the scan thread picks up the results and
+ * saves them to the library (all db writes stay on the scan thread, so they
+ * are still batched in the transactions started by bulk_scan()). With
+ * filescan_threads = 1 the pipeline is not used and files are scanned inline.
+ */
+#define SCAN_PIPELINE_THREADS_MAX 32
+#define SCAN_PIPELINE_JOBS_PER_THREAD 8
+#define SCAN_PIPELINE_STATS_INTERVAL 5
+
+struct scan_job {
+  struct media_file_info mfi;
+  char *file;
+  time_t mtime;
+  bool is_bulkscan;
+  int ret;
+
+  struct scan_job *next;
+};
+
+struct scan_job_list {
+  struct scan_job *head;
+  struct scan_job *tail;
+  int count;
+};
+
+struct scan_pipeline {
+  pthread_t tid[SCAN_PIPELINE_THREADS_MAX];
+  int nthreads;
+
+  pthread_mutex_t lck;
+  pthread_cond_t work_cond;
+  pthread_cond_t done_cond;
+
+  // Jobs waiting for a worker, jobs being scanned and jobs waiting to be saved
+  struct scan_job_list work;
+  struct scan_job_list done;
+  int active;
+  int max_inflight;
+  bool stop;
+
+  // Throughput counters
+  struct timespec start;
+  struct timespec last_stats;
+  uint64_t files_scanned;
+  uint64_t files_failed;
+  int work_depth_max;
+  int done_depth_max;
+};
+
+static struct scan_pipeline *scan_pipeline;
+
+/* A no-change rescan should not cost a database write per file. While a bulk
+ * scan walks a directory, the stamps (id, path, db_timestamp) of the files the
+ * library has for it are loaded with one query, and unchanged files are only
+ * collected and marked as seen in batches. With filescan_skip_unchanged_dirs,
+ * directories whose mtime matches the one stored by the last bulk scan are not
+ * read at all, see process_directory_unchanged(). The new mtimes are stored
+ * when the whole scan (including deferred playlists) has completed.
+ */
+#define SEEN_BATCH_SIZE 1000
+
+struct dir_mtime {
+  int id;
+  time_t mtime;
+};
+
+static struct db_file_stamp *dir_stamps;
+static int dir_nstamps;
+
+static uint32_t seen_ids[SEEN_BATCH_SIZE];
+static int seen_nids;
+
+static struct dir_mtime *dir_mtimes;
+static int dir_mtimes_count;
+static int dir_mtimes_size;
+
 /* Forward */
 static void
 bulk_scan(int flags);
@@ -564,6 +643,384 @@ process_deferred_playlists(void)
     }
 }
 
+/* ------------------------- Bulk scan pipeline -------------------------- */
+
+static void
+scan_job_push(struct scan_job_list *list, struct scan_job *job)
+{
+  job->next = NULL;
+
+  if (list->tail)
+    list->tail->next = job;
+  else
+    list->head = job;
+
+  list->tail = job;
+  list->count++;
+}
+
+static struct scan_job *
+scan_job_pop(struct scan_job_list *list)
+{
+  struct scan_job *job;
+
+  job = list->head;
+  if (!job)
+    return NULL;
+
+  list->head = job->next;
+  if (!list->head)
+    list->tail = NULL;
+
+  list->count--;
+
+  return job;
+}
+
+static void
+scan_job_free(struct scan_job *job)
+{
+  free_mfi(&job->mfi, 1);
+  free(job->file);
+  free(job);
+}
+
+static void
+regular_file_save(struct media_file_info *mfi, const char *file, time_t mtime, bool is_bulkscan)
+{
+  library_media_save(mfi);
+
+  cache_artwork_ping(file, mtime, !is_bulkscan);
+  // TODO [artworkcache] If entry in artwork cache exists for no artwork available, delete the entry if media file has embedded artwork
+}
+
+/* Thread: scan worker */
+static void *
+scan_worker(void *arg)
+{
+  struct scan_pipeline *sp = arg;
+  struct scan_job *job;
+
+  for (;;)
+    {
+      CHECK_ERR(L_SCAN, pthread_mutex_lock(&sp->lck));
+
+      while (!sp->work.head && !sp->stop)
+	CHECK_ERR(L_SCAN, pthread_cond_wait(&sp->work_cond, &sp->lck));
+
+      if (sp->stop)
+	{
+	  CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+	  break;
+	}
+
+      job = scan_job_pop(&sp->work);
+      sp->active++;
+
+      CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+
+      job->ret = scan_metadata_ffmpeg(&job->mfi, job->file);
+
+      CHECK_ERR(L_SCAN, pthread_mutex_lock(&sp->lck));
+
+      sp->active--;
+      sp->files_scanned++;
+      scan_job_push(&sp->done, job);
+      if (sp->done.count > sp->done_depth_max)
+	sp->done_depth_max = sp->done.count;
+
+      CHECK_ERR(L_SCAN, pthread_cond_signal(&sp->done_cond));
+      CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+    }
+
+  pthread_exit(NULL);
+}
+
+/* Thread: scan
+ *
+ * Saves the files that the workers have finished scanning. If wait_all is set
+ * it will also wait for all queued files to be scanned and saved.
+ */
+static void
+scan_pipeline_save(struct scan_pipeline *sp, bool wait_all)
+{
+  struct scan_job *job;
+  struct scan_job_list done;
+
+  for (;;)
+    {
+      CHECK_ERR(L_SCAN, pthread_mutex_lock(&sp->lck));
+
+      while (wait_all && !sp->done.head && (sp->work.head || sp->active > 0))
+	CHECK_ERR(L_SCAN, pthread_cond_wait(&sp->done_cond, &sp->lck));
+
+      done = sp->done;
+      memset(&sp->done, 0, sizeof(struct scan_job_list));
+
+      CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+
+      if (!done.head)
+	break;
+
+      while ((job = scan_job_pop(&done)))
+	{
+	  if (job->ret < 0)
+	    sp->files_failed++;
+	  else if (!library_is_exiting())
+	    regular_file_save(&job->mfi, job->file, job->mtime, job->is_bulkscan);
+
+	  scan_job_free(job);
+	}
+
+      if (!wait_all || library_is_exiting())
+	break;
+    }
+}
+
+/* Thread: scan
+ *
+ * Queues a file for metadata scanning, takes ownership of the content of mfi.
+ * Blocks if the workers are behind, meanwhile saving results as they come in.
+ */
+static void
+scan_pipeline_submit(struct scan_pipeline *sp, struct media_file_info *mfi, const char *file, time_t mtime, bool is_bulkscan)
+{
+  struct scan_job *job;
+  bool save_pending;
+
+  CHECK_NULL(L_SCAN, job = calloc(1, sizeof(struct scan_job)));
+  CHECK_NULL(L_SCAN, job->file = strdup(file));
+
+  job->mfi = *mfi;
+  job->mtime = mtime;
+  job->is_bulkscan = is_bulkscan;
+
+  scan_pipeline_save(sp, false);
+
+  CHECK_ERR(L_SCAN, pthread_mutex_lock(&sp->lck));
+
+  while (sp->work.count + sp->active + sp->done.count >= sp->max_inflight)
+    {
+      save_pending = (sp->done.head != NULL);
+      if (save_pending)
+	{
+	  CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+	  scan_pipeline_save(sp, false);
+	  CHECK_ERR(L_SCAN, pthread_mutex_lock(&sp->lck));
+	  continue;
+	}
+
+      CHECK_ERR(L_SCAN, pthread_cond_wait(&sp->done_cond, &sp->lck));
+    }
+
+  scan_job_push(&sp->work, job);
+  if (sp->work.count > sp->work_depth_max)
+    sp->work_depth_max = sp->work.count;
+
+  CHECK_ERR(L_SCAN, pthread_cond_signal(&sp->work_cond));
+  CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+}
+
+static double
+scan_pipeline_elapsed(struct scan_pipeline *sp)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (now.tv_sec - sp->start.tv_sec) + (now.tv_nsec - sp->start.tv_nsec) / 1000000000.0;
+}
+
+/* Thread: scan */
+static void
+scan_pipeline_stats_log(struct scan_pipeline *sp)
+{
+  double elapsed;
+  int work_depth;
+  int active;
+  int done_depth;
+  uint64_t files_scanned;
+
+  CHECK_ERR(L_SCAN, pthread_mutex_lock(&sp->lck));
+  work_depth = sp->work.count;
+  active = sp->active;
+  done_depth = sp->done.count;
+  files_scanned = sp->files_scanned;
+  CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+
+  elapsed = scan_pipeline_elapsed(sp);
+
+  DPRINTF(E_INFO, L_SCAN, "Scan pipeline: %.1f files/s, %d queued (max %d), %d scanning, %d waiting to be saved (max %d)\n",
+	  (elapsed > 0) ? files_scanned / elapsed : 0.0, work_depth, sp->work_depth_max, active, done_depth, sp->done_depth_max);
+}
+
+/* Thread: scan */
+static struct scan_pipeline *
+scan_pipeline_start(void)
+{
+  struct scan_pipeline *sp;
+  int nthreads;
+  int i;
+  int ret;
+
+  nthreads = cfg_getint(cfg_getsec(cfg, "library"), "filescan_threads");
+  if (nthreads == 0)
+    nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+
+  if (nthreads <= 1)
+    return NULL;
+
+  if (nthreads > SCAN_PIPELINE_THREADS_MAX)
+    {
+      DPRINTF(E_WARN, L_SCAN, "Limiting number of scan threads to %d (configured %d)\n", SCAN_PIPELINE_THREADS_MAX, nthreads);
+      nthreads = SCAN_PIPELINE_THREADS_MAX;
+    }
+
+  CHECK_NULL(L_SCAN, sp = calloc(1, sizeof(struct scan_pipeline)));
+
+  CHECK_ERR(L_SCAN, mutex_init(&sp->lck));
+  CHECK_ERR(L_SCAN, pthread_cond_init(&sp->work_cond, NULL));
+  CHECK_ERR(L_SCAN, pthread_cond_init(&sp->done_cond, NULL));
+
+  sp->max_inflight = nthreads * SCAN_PIPELINE_JOBS_PER_THREAD;
+  clock_gettime(CLOCK_MONOTONIC, &sp->start);
+
+  for (i = 0; i < nthreads; i++)
+    {
+      ret = pthread_create(&sp->tid[i], NULL, scan_worker, sp);
+      if (ret != 0)
+	{
+	  DPRINTF(E_LOG, L_SCAN, "Could not spawn scan worker thread: %s\n", strerror(ret));
+	  break;
+	}
+
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+      pthread_setname_np(sp->tid[i], "scan");
+#elif defined(HAVE_PTHREAD_SET_NAME_NP)
+      pthread_set_name_np(sp->tid[i], "scan");
+#endif
+
+      sp->nthreads++;
+    }
+
+  if (sp->nthreads == 0)
+    {
+      CHECK_ERR(L_SCAN, pthread_cond_destroy(&sp->done_cond));
+      CHECK_ERR(L_SCAN, pthread_cond_destroy(&sp->work_cond));
+      CHECK_ERR(L_SCAN, pthread_mutex_destroy(&sp->lck));
+      free(sp);
+      return NULL;
+    }
+
+  DPRINTF(E_INFO, L_SCAN, "Bulk scan will use %d metadata scanner threads\n", sp->nthreads);
+
+  return sp;
+}
+
+/* Thread: scan */
+static void
+scan_pipeline_stop(struct scan_pipeline *sp)
+{
+  struct scan_job *job;
+  double elapsed;
+  int i;
+
+  if (!sp)
+    return;
+
+  scan_pipeline_save(sp, true);
+
+  CHECK_ERR(L_SCAN, pthread_mutex_lock(&sp->lck));
+  sp->stop = true;
+  CHECK_ERR(L_SCAN, pthread_cond_broadcast(&sp->work_cond));
+  CHECK_ERR(L_SCAN, pthread_mutex_unlock(&sp->lck));
+
+  for (i = 0; i < sp->nthreads; i++)
+    pthread_join(sp->tid[i], NULL);
+
+  // Only left if we are exiting
+  while ((job = scan_job_pop(&sp->work)))
+    scan_job_free(job);
+  while ((job = scan_job_pop(&sp->done)))
+    scan_job_free(job);
+
+  elapsed = scan_pipeline_elapsed(sp);
+
+  DPRINTF(E_LOG, L_SCAN, "Scan pipeline scanned %" PRIu64 " files (%" PRIu64 " failed) in %.f sec, %.1f files/s\n",
+	  sp->files_scanned, sp->files_failed, elapsed, (elapsed > 0) ? sp->files_scanned / elapsed : 0.0);
+
+  CHECK_ERR(L_SCAN, pthread_cond_destroy(&sp->done_cond));
+  CHECK_ERR(L_SCAN, pthread_cond_destroy(&sp->work_cond));
+  CHECK_ERR(L_SCAN, pthread_mutex_destroy(&sp->lck));
+  free(sp);
+}
+
+static void
+seen_flush(void)
+{
+  if (seen_nids == 0)
+    return;
+
+  db_file_ping_byids(seen_ids, seen_nids);
+  seen_nids = 0;
+}
+
+/* Checks a file against the stamps of the directory being walked. Returns 1 if
+ * the file is unchanged (it will be marked as seen), 0 if it was modified, and
+ * -1 if it is not known from the directory.
+ */
+static int
+seen_check(const char *file, time_t mtime)
+{
+  struct db_file_stamp *stamp;
+
+  stamp = db_file_stamp_find(dir_stamps, dir_nstamps, file);
+  if (!stamp)
+    return -1;
+
+  if (stamp->db_timestamp < mtime)
+    return 0;
+
+  seen_ids[seen_nids++] = stamp->id;
+  if (seen_nids == SEEN_BATCH_SIZE)
+    seen_flush();
+
+  return 1;
+}
+
+static void
+dir_mtime_defer(int id, time_t mtime)
+{
+  if (dir_mtimes_count == dir_mtimes_size)
+    {
+      dir_mtimes_size = dir_mtimes_size ? 2 * dir_mtimes_size : 256;
+      CHECK_NULL(L_SCAN, dir_mtimes = realloc(dir_mtimes, dir_mtimes_size * sizeof(struct dir_mtime)));
+    }
+
+  dir_mtimes[dir_mtimes_count].id = id;
+  dir_mtimes[dir_mtimes_count].mtime = mtime;
+  dir_mtimes_count++;
+}
+
+static void
+dir_mtimes_save(bool save)
+{
+  int i;
+
+  if (save && dir_mtimes_count > 0)
+    {
+      db_transaction_begin();
+      for (i = 0; i < dir_mtimes_count; i++)
+	db_directory_mtime_set(dir_mtimes[i].id, dir_mtimes[i].mtime);
+      db_transaction_end();
+    }
+
+  free(dir_mtimes);
+  dir_mtimes = NULL;
+  dir_mtimes_count = 0;
+  dir_mtimes_size = 0;
+}
+
 static void
 process_regular_file(const char *file, struct stat *sb, int type, int flags, int dir_id)
 {
@@ -576,7 +1033,9 @@ process_regular_file(const char *file, struct stat *sb, int type, int flags, int
   // - note if mtime is 0 then we always scan the file
   if (!(flags & F_SCAN_METARESCAN))
     {
-      ret = db_file_ping_bypath(file, sb->st_mtime);
+      ret = seen_check(file, sb->st_mtime);
+      if (ret < 0)
+	ret = db_file_ping_bypath(file, sb->st_mtime);
       if ((sb->st_mtime != 0) && (ret != 0))
         return;
     }
@@ -622,6 +1081,14 @@ process_regular_file(const char *file, struct stat *sb, int type, int flags, int
 	  mfi.album_artist = safe_strdup(cfg_getstr(cfg_getsec(cfg, "library"), "compilation_artist"));
 	}
 
+      // During bulk scans the metadata is read by the scan workers, and the
+      // file will be saved when the result is collected
+      if (scan_pipeline && is_bulkscan)
+	{
+	  scan_pipeline_submit(scan_pipeline, &mfi, file, sb->st_mtime, is_bulkscan);
+	  return;
+	}
+
       ret = scan_metadata_ffmpeg(&mfi, file);
       if (ret < 0)
 	{
@@ -630,10 +1097,7 @@ process_regular_file(const char *file, struct stat *sb, int type, int flags, int
 	}
     }
 
-  library_media_save(&mfi);
-
-  cache_artwork_ping(file, sb->st_mtime, !is_bulkscan);
-  // TODO [artworkcache] If entry in artwork cache exists for no artwork available, delete the entry if media file has embedded artwork
+  regular_file_save(&mfi, file, sb->st_mtime, is_bulkscan);
 
   free_mfi(&mfi, 1);
 }
@@ -653,6 +1117,8 @@ process_file(char *file, struct stat *sb, enum file_type file_type, int scan_typ
 	if ((flags & F_SCAN_BULK) && (counter % 200 == 0))
 	  {
 	    DPRINTF(E_LOG, L_SCAN, "Scanned %d files...\n", counter);
+	    if (scan_pipeline)
+	      scan_pipeline_stats_log(scan_pipeline);
 	    db_transaction_end();
 	    db_transaction_begin();
 	  }
@@ -815,6 +1281,38 @@ read_attributes(char *resolved_path, const char *path, struct stat *sb, int *is_
   return 0;
 }
 
+/* The directory has the same mtime as in the last bulk scan, so no entries were
+ * added, removed or renamed. Its files and playlists are just marked as seen,
+ * and its known subdirectories are stacked to be checked themselves.
+ */
+static void
+process_directory_unchanged(char *path, int dir_id)
+{
+  struct directory_enum de;
+  struct directory_info di;
+  char *subdir;
+
+  DPRINTF(E_DBG, L_SCAN, "Directory %s is unchanged since last scan, skipping its files\n", path);
+
+  db_file_ping_bydirectory(dir_id);
+  db_pl_ping_bydirectory(dir_id);
+  cache_artwork_ping_bydirectory(path);
+
+  memset(&de, 0, sizeof(struct directory_enum));
+  de.parent_id = dir_id;
+
+  if (db_directory_enum_start(&de) < 0)
+    return;
+
+  while ((db_directory_enum_fetch(&de, &di) == 0) && (di.id > 0))
+    {
+      subdir = di.path ? di.path : di.virtual_path + strlen("/file:");
+      push_dir(&dirstack, subdir, dir_id);
+    }
+
+  db_directory_enum_end(&de);
+}
+
 static void
 process_directory(char *path, int parent_id, int flags)
 {
@@ -829,6 +1327,7 @@ process_directory(char *path, int parent_id, int flags)
   int scan_type;
   enum file_type file_type;
   char virtual_path[PATH_MAX];
+  time_t dir_mtime;
   int dir_id;
   int ret;
 
@@ -854,6 +1353,23 @@ process_directory(char *path, int parent_id, int flags)
       DPRINTF(E_LOG, L_SCAN, "Insert or update of directory failed '%s'\n", virtual_path);
     }
 
+  dir_mtime = 0;
+  if ((dir_id > 0) && (flags & F_SCAN_BULK) && !(flags & (F_SCAN_FAST | F_SCAN_METARESCAN)))
+    {
+      if (cfg_getbool(cfg_getsec(cfg, "library"), "filescan_skip_unchanged_dirs") && (fstat(dirfd(dirp), &sb) == 0))
+	{
+	  dir_mtime = sb.st_mtime;
+	  if ((dir_mtime != 0) && (dir_mtime == db_directory_mtime_get(dir_id)))
+	    {
+	      closedir(dirp);
+	      process_directory_unchanged(path, dir_id);
+	      goto watch;
+	    }
+	}
+
+      db_file_stamps_bydirectory(&dir_stamps, &dir_nstamps, dir_id);
+    }
+
   /* Check if compilation and/or podcast directory */
   scan_type = 0;
   if (check_speciallib(path, "compilations"))
@@ -926,6 +1442,14 @@ process_directory(char *path, int parent_id, int flags)
 
   closedir(dirp);
 
+  db_file_stamps_free(dir_stamps, dir_nstamps);
+  dir_stamps = NULL;
+  dir_nstamps = 0;
+
+  if (dir_mtime != 0)
+    dir_mtime_defer(dir_id, dir_mtime);
+
+ watch:
   memset(&wi, 0, sizeof(struct watch_info));
 
   // Add inotify watch (for FreeBSD we limit the flags so only dirs will be
@@ -1039,6 +1563,9 @@ bulk_scan(int flags)
   lib = cfg_getsec(cfg, "library");
   counter = 0;
 
+  if (!(flags & F_SCAN_FAST))
+    scan_pipeline = scan_pipeline_start();
+
   ndirs = cfg_size(lib, "directories");
   for (i = 0; i < ndirs; i++)
     {
@@ -1070,17 +1597,35 @@ bulk_scan(int flags)
       db_transaction_begin();
 
       process_directories(deref, parent_id, flags);
+
+      // Make sure everything queued for this directory is saved before commit
+      seen_flush();
+      if (scan_pipeline)
+	scan_pipeline_save(scan_pipeline, true);
+
       db_transaction_end();
 
       free(deref);
 
       if (library_is_exiting())
-	return;
+	break;
+    }
+
+  scan_pipeline_stop(scan_pipeline);
+  scan_pipeline = NULL;
+
+  if (library_is_exiting())
+    {
+      dir_mtimes_save(false);
+      return;
     }
 
   if (!(flags & F_SCAN_FAST) && playlists)
     process_deferred_playlists();
 
+  // Only now all files of the walked directories are saved, so the next scan can skip them
+  dir_mtimes_save(!library_is_exiting());
+
   if (library_is_exiting())
     return;
 
@@ -1948,7 +2493,6 @@ playlist_add_files(FILE *fp, int pl_id, const char *virtual_path)
 {
   struct query_params qp;
   struct db_media_file_info dbmfi;
-  uint32_t data_kind;
   const char *path;
   struct media_file_info mfi;
   int ret;
@@ -1967,8 +2511,7 @@ playlist_add_files(FILE *fp, int pl_id, const char *virtual_path)
     {
       while (((ret = db_query_fetch_file(&qp, &dbmfi)) == 0) && (dbmfi.id))
         {
-	  if ((safe_atou32(dbmfi.data_kind, &data_kind) < 0)
-	      || (data_kind == DATA_KIND_PIPE))
+	  if (dbmfi.data_kind == DATA_KIND_PIPE)
 	    {
 	      DPRINTF(E_WARN, L_SCAN, "Item '%s' not added to playlist (id = %d), unsupported data kind\n", dbmfi.path, pl_id);
 	      continue;
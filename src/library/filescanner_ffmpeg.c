@@ -45,8 +45,9 @@ struct metadata_map {
   int (*handler_function)(struct media_file_info *, char *);
 };
 
-// Used for passing errors to DPRINTF (can't count on av_err2str being present)
-static char errbuf[64];
+// Used for passing errors to DPRINTF (can't count on av_err2str being present),
+// thread local because bulk scans may run several metadata scanners at once
+static __thread char errbuf[64];
 
 static inline char *
 err2str(int errnum)
@@ -16,79 +16,485 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef HAVE_PTHREAD_NP_H
+# include <pthread_np.h>
+#endif
+
+#include <event2/event.h>
 
 #include "listener.h"
+#include "logger.h"
+#include "misc.h"
+#include "db.h"
+#include "commands.h"
+
+/*
+ * Events are delivered by the listener thread, so the thread raising an event
+ * (player, library, worker...) never runs listener code. Each listener has its
+ * own pending event mask and payload, so events that are raised while the
+ * listener has not yet been called are merged. Events of a type are delivered
+ * to a listener at most once per coalescing window (see below). If the window
+ * has passed since the last delivery, the event is delivered right away,
+ * otherwise when the window expires.
+ */
+
+// Number of event types in enum listener_event_type
+#define LISTENER_NEVENTS 12
 
 struct listener
 {
   notify notify_cb;
   short events;
+
+  // Events and payload waiting to be delivered, protected by listener_lck
+  short pending;
+  struct listener_event_data data;
+
+  // Only used by the listener thread
+  uint64_t delivered_ms[LISTENER_NEVENTS];
+  struct event *timer;
+
   struct listener *next;
 };
 
-struct listener *listener_list = NULL;
+// Coalescing window in milliseconds per event type, indexed by bit number.
+// Events that clients are waiting for (player, volume...) are not held back,
+// but library changes during a scan are.
+static const int listener_window_ms[LISTENER_NEVENTS] =
+{
+  0,    // LISTENER_PLAYER
+  100,  // LISTENER_QUEUE
+  0,    // LISTENER_VOLUME
+  0,    // LISTENER_SPEAKER
+  0,    // LISTENER_OPTIONS
+  1000, // LISTENER_DATABASE
+  1000, // LISTENER_STORED_PLAYLIST
+  0,    // LISTENER_UPDATE
+  0,    // LISTENER_PAIRING
+  0,    // LISTENER_SPOTIFY
+  0,    // LISTENER_LASTFM
+  1000, // LISTENER_RATING
+};
+
+static pthread_t tid_listener;
+static struct event_base *evbase_listener;
+static struct commands_base *cmdbase;
+
+// Protects the list and the pending events of the listeners
+static pthread_mutex_t listener_lck;
+static struct listener *listener_list;
+static bool dispatch_scheduled;
+
+
+/* ------------------------------- HELPERS ---------------------------------- */
+
+static uint64_t
+now_ms(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void
+data_ids_add(struct listener_event_data *dst, const struct listener_event_data *src)
+{
+  int i;
+  int j;
+
+  if (dst->ids_all)
+    return;
+
+  if (!src || src->ids_all)
+    {
+      dst->ids_all = true;
+      return;
+    }
+
+  for (i = 0; i < src->nids; i++)
+    {
+      for (j = 0; j < dst->nids && dst->ids[j] != src->ids[i]; j++)
+	;
+
+      if (j < dst->nids)
+	continue;
+
+      if (dst->nids == LISTENER_IDS_MAX)
+	{
+	  dst->ids_all = true;
+	  return;
+	}
+
+      dst->ids[dst->nids++] = src->ids[i];
+    }
+}
+
+// Must be called with listener_lck held
+static void
+data_merge(struct listener_event_data *dst, short event_mask, const struct listener_event_data *src)
+{
+  if (event_mask & LISTENER_QUEUE)
+    dst->queue_version = src ? src->queue_version : 0;
+
+  if (event_mask & (LISTENER_DATABASE | LISTENER_RATING))
+    data_ids_add(dst, src);
+}
+
+// Must be called with listener_lck held
+static void
+data_clear(struct listener_event_data *data, short pending)
+{
+  if (!(pending & LISTENER_QUEUE))
+    data->queue_version = 0;
+
+  if (!(pending & (LISTENER_DATABASE | LISTENER_RATING)))
+    {
+      data->ids_all = false;
+      data->nids = 0;
+    }
+}
+
+
+/* ------------------------------ DISPATCHING ------------------------------- */
+/*                             Thread: listener                               */
+
+static void
+listener_dispatch(struct listener *listener, uint64_t now)
+{
+  struct listener_event_data data;
+  struct timeval tv;
+  uint64_t due;
+  uint64_t next_due;
+  short deliver;
+  int i;
+
+  deliver = 0;
+  next_due = UINT64_MAX;
+
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&listener_lck));
+
+  for (i = 0; i < LISTENER_NEVENTS; i++)
+    {
+      if (!(listener->pending & (1 << i)))
+	continue;
+
+      due = listener->delivered_ms[i] + listener_window_ms[i];
+      if (listener->delivered_ms[i] == 0 || due <= now)
+	deliver |= (1 << i);
+      else if (due < next_due)
+	next_due = due;
+    }
+
+  if (deliver)
+    {
+      data = listener->data;
+      listener->pending &= ~deliver;
+      data_clear(&listener->data, listener->pending);
+    }
+
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&listener_lck));
+
+  if (deliver)
+    {
+      for (i = 0; i < LISTENER_NEVENTS; i++)
+	{
+	  if (deliver & (1 << i))
+	    listener->delivered_ms[i] = now;
+	}
+
+      listener->notify_cb(deliver, &data);
+    }
+
+  if (next_due != UINT64_MAX)
+    {
+      tv.tv_sec = (next_due - now) / 1000;
+      tv.tv_usec = ((next_due - now) % 1000) * 1000;
+      evtimer_add(listener->timer, &tv);
+    }
+}
+
+// Listeners are only removed by this thread, and listener_add() only inserts
+// at the head, so the list can be walked without holding the lock
+static void
+dispatch_all(void)
+{
+  struct listener *listener;
+  uint64_t now;
+
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&listener_lck));
+  dispatch_scheduled = false;
+  listener = listener_list;
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&listener_lck));
+
+  now = now_ms();
+
+  for (; listener; listener = listener->next)
+    listener_dispatch(listener, now);
+}
+
+static void
+timer_cb(int fd, short what, void *arg)
+{
+  listener_dispatch(arg, now_ms());
+}
+
+static enum command_state
+dispatch(void *arg, int *retval)
+{
+  dispatch_all();
+
+  *retval = 0;
+  return COMMAND_END;
+}
+
+static enum command_state
+remove_listener(void *arg, int *retval)
+{
+  notify notify_cb = *(notify *)arg;
+  struct listener *listener;
+  struct listener *prev;
+
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&listener_lck));
+
+  prev = NULL;
+  for (listener = listener_list; listener; listener = listener->next)
+    {
+      if (listener->notify_cb == notify_cb)
+	break;
+
+      prev = listener;
+    }
+
+  if (listener)
+    {
+      if (prev)
+	prev->next = listener->next;
+      else
+	listener_list = listener->next;
+    }
+
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&listener_lck));
+
+  if (!listener)
+    {
+      *retval = -1;
+      return COMMAND_END;
+    }
+
+  event_free(listener->timer);
+  free(listener);
+
+  *retval = 0;
+  return COMMAND_END;
+}
+
+static void *
+listener_thread(void *arg)
+{
+  int ret;
+
+  // Some listeners query the db (e.g. the pipe input)
+  ret = db_perthread_init();
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_MAIN, "Error: DB init failed (listener thread)\n");
+      pthread_exit(NULL);
+    }
+
+  event_base_dispatch(evbase_listener);
+
+  db_perthread_deinit();
+
+  pthread_exit(NULL);
+}
+
+
+/* ---------------------------------- API ----------------------------------- */
 
 int
 listener_add(notify notify_cb, short events)
 {
   struct listener *listener;
 
-  listener = (struct listener*)malloc(sizeof(struct listener));
+  if (!evbase_listener)
+    {
+      DPRINTF(E_LOG, L_MAIN, "Bug! Listener added before listener_init()\n");
+      return -1;
+    }
+
+  listener = calloc(1, sizeof(struct listener));
   if (!listener)
     {
       return -1;
     }
   listener->notify_cb = notify_cb;
   listener->events = events;
+
+  listener->timer = evtimer_new(evbase_listener, timer_cb, listener);
+  if (!listener->timer)
+    {
+      free(listener);
+      return -1;
+    }
+
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&listener_lck));
   listener->next = listener_list;
   listener_list = listener;
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&listener_lck));
 
   return 0;
 }
 
 int
 listener_remove(notify notify_cb)
+{
+  int ret;
+
+  // Removing in the listener thread makes sure the callback isn't running
+  if (cmdbase)
+    ret = commands_exec_sync(cmdbase, remove_listener, NULL, &notify_cb);
+  else
+    remove_listener(&notify_cb, &ret);
+
+  return ret;
+}
+
+void
+listener_notify_data(short event_mask, const struct listener_event_data *data)
 {
   struct listener *listener;
-  struct listener *prev;
+  struct commands_base *base;
+  bool wakeup;
+
+  wakeup = false;
+
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&listener_lck));
+
+  base = cmdbase;
+  if (!base)
+    {
+      CHECK_ERR(L_MAIN, pthread_mutex_unlock(&listener_lck));
+      return;
+    }
 
-  prev = NULL;
   for (listener = listener_list; listener; listener = listener->next)
     {
-      if (listener->notify_cb == notify_cb)
-	break;
+      if (!(event_mask & listener->events))
+	continue;
 
-      prev = listener;
+      listener->pending |= (event_mask & listener->events);
+      data_merge(&listener->data, event_mask & listener->events, data);
+
+      if (!dispatch_scheduled)
+	{
+	  dispatch_scheduled = true;
+	  wakeup = true;
+	}
     }
 
-  if (!listener)
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&listener_lck));
+
+  // Only wake the listener thread if it doesn't already have a dispatch coming
+  if (wakeup)
+    commands_exec_async(base, dispatch, NULL);
+}
+
+void
+listener_notify(short event_mask)
+{
+  listener_notify_data(event_mask, NULL);
+}
+
+int
+listener_init(void)
+{
+  int ret;
+
+  CHECK_ERR(L_MAIN, mutex_init(&listener_lck));
+
+  listener_list = NULL;
+  dispatch_scheduled = false;
+
+  evbase_listener = event_base_new();
+  if (!evbase_listener)
     {
-      return -1;
+      DPRINTF(E_LOG, L_MAIN, "Could not create an event base\n");
+      goto evbase_fail;
     }
 
-  if (prev)
-    prev->next = listener->next;
-  else
-    listener_list = listener->next;
+  cmdbase = commands_base_new(evbase_listener, NULL);
+
+  ret = pthread_create(&tid_listener, NULL, listener_thread, NULL);
+  if (ret != 0)
+    {
+      DPRINTF(E_LOG, L_MAIN, "Could not spawn listener thread: %s\n", strerror(ret));
+
+      goto thread_fail;
+    }
+
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+  pthread_setname_np(tid_listener, "listener");
+#elif defined(HAVE_PTHREAD_SET_NAME_NP)
+  pthread_set_name_np(tid_listener, "listener");
+#endif
 
-  free(listener);
   return 0;
+
+ thread_fail:
+  commands_base_free(cmdbase);
+  cmdbase = NULL;
+  event_base_free(evbase_listener);
+  evbase_listener = NULL;
+
+ evbase_fail:
+  CHECK_ERR(L_MAIN, pthread_mutex_destroy(&listener_lck));
+  return -1;
 }
 
 void
-listener_notify(short event_mask)
+listener_deinit(void)
 {
+  struct commands_base *base;
   struct listener *listener;
+  int ret;
 
-  listener = listener_list;
-  while (listener)
+  // Events raised from now on are dropped
+  CHECK_ERR(L_MAIN, pthread_mutex_lock(&listener_lck));
+  base = cmdbase;
+  cmdbase = NULL;
+  CHECK_ERR(L_MAIN, pthread_mutex_unlock(&listener_lck));
+
+  commands_base_destroy(base);
+
+  ret = pthread_join(tid_listener, NULL);
+  if (ret != 0)
     {
-      if (event_mask & listener->events)
-	listener->notify_cb(event_mask & listener->events);
-      listener = listener->next;
+      DPRINTF(E_FATAL, L_MAIN, "Could not join listener thread: %s\n", strerror(ret));
+      return;
     }
+
+  // Normally all listeners have been removed by now
+  for (listener = listener_list; listener_list; listener = listener_list)
+    {
+      listener_list = listener->next;
+      event_free(listener->timer);
+      free(listener);
+    }
+
+  event_base_free(evbase_listener);
+  evbase_listener = NULL;
+
+  CHECK_ERR(L_MAIN, pthread_mutex_destroy(&listener_lck));
 }
@@ -2,6 +2,9 @@
 #ifndef __LISTENER_H__
 #define __LISTENER_H__
 
+#include <stdbool.h>
+#include <stdint.h>
+
 enum listener_event_type
 {
   /* The player has been started, stopped or seeked */
@@ -30,14 +33,39 @@ enum listener_event_type
   LISTENER_RATING = (1 << 11),
 };
 
-typedef void (*notify)(short event_mask);
+/* Max number of changed item ids that an event can carry */
+#define LISTENER_IDS_MAX 16
+
+/*
+ * Payload that comes with an event. If the same event is raised several times
+ * before it is delivered, the payloads are merged: the latest queue version
+ * is kept, and the changed ids are collected (so they may include ids that
+ * were also given with an earlier delivery).
+ */
+struct listener_event_data
+{
+  /* LISTENER_QUEUE: The queue version after the change, 0 if not known */
+  int queue_version;
+  /* LISTENER_DATABASE and LISTENER_RATING: Ids of the changed files. If ids_all
+   * is set, the ids were not given or there were too many, so anything may
+   * have changed. */
+  bool ids_all;
+  int nids;
+  uint32_t ids[LISTENER_IDS_MAX];
+};
+
+/*
+ * Callback for events. It is called from the listener thread, never from the
+ * thread that raised the event. The data is only valid during the call.
+ */
+typedef void (*notify)(short event_mask, const struct listener_event_data *data);
 
 /*
- * Registers the given callback function to the given event types.
- * This function is not thread safe. Listeners must be added once at startup.
+ * Registers the given callback function to the given event types. Should be
+ * called after listener_init().
  *
- * @param notify_cb Callback function (should be a non-blocking function,
- *        especially when the event is from the player)
+ * @param notify_cb Callback function (should be a non-blocking function, since
+ *        it will hold up delivery of events to other listeners)
  * @param event_mask Event mask, one or more of LISTENER_*
  * @return 0 on success, -1 on failure
  */
@@ -45,8 +73,8 @@ int
 listener_add(notify notify_cb, short event_mask);
 
 /*
- * Removes the given callback function
- * This function is not thread safe. Listeners must be removed once at shutdown.
+ * Removes the given callback function. When this returns, the callback is not
+ * running and it will not be called again.
  *
  * @param notify_cb Callback function
  * @return 0 on success, -1 if the callback was not registered
@@ -55,8 +83,10 @@ int
 listener_remove(notify notify_cb);
 
 /*
- * Calls the callback function of the registered listeners listening for the
- * given type of event.
+ * Queues the event for the registered listeners listening for the given type
+ * of event, and returns without waiting for them. Events of some types (e.g.
+ * LISTENER_DATABASE) are only delivered to each listener once per coalescing
+ * window, events raised in the meantime are merged into one. Thread safe.
  *
  * @param event_mask Event mask, one or more of LISTENER_*
  *
@@ -64,4 +94,19 @@ listener_remove(notify notify_cb);
 void
 listener_notify(short event_mask);
 
+/*
+ * Same as listener_notify(), but with a payload for the listeners.
+ *
+ * @param event_mask Event mask, one or more of LISTENER_*
+ * @param data       Payload, see struct listener_event_data
+ */
+void
+listener_notify_data(short event_mask, const struct listener_event_data *data);
+
+int
+listener_init(void);
+
+void
+listener_deinit(void);
+
 #endif /* !__LISTENER_H__ */
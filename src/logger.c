@@ -27,8 +27,12 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 #include <time.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
 #include <sys/stat.h>
 
 #include <event2/event.h>
@@ -40,6 +44,22 @@
 
 #define LOGGER_REPEAT_MAX 10
 
+/* Size of the per-thread ring buffers used when logging asynchronously, must
+ * be a power of two. Each record takes a header plus the formatted message.
+ */
+#define LOGGER_RING_SIZE (64 * 1024)
+#define LOGGER_MSG_MAX 2048
+#define LOGGER_RECORD_PAD 0xff
+#define LOGGER_ALIGN(x) (((x) + 7) & ~7)
+
+#if defined(CLOCK_REALTIME_COARSE)
+# define LOGGER_CLOCK CLOCK_REALTIME_COARSE
+#elif defined(CLOCK_REALTIME_FAST)
+# define LOGGER_CLOCK CLOCK_REALTIME_FAST
+#else
+# define LOGGER_CLOCK CLOCK_REALTIME
+#endif
+
 /* We need our own check to avoid nested locking or recursive calls */
 #define LOGGER_CHECK_ERR(f) \
   do { int lerr; lerr = f; if (lerr != 0) { \
@@ -60,6 +80,51 @@ static FILE *logfile;
 static char *labels[] = { "config", "daap", "db", "httpd", "http", "main", "mdns", "misc", "rsp", "scan", "xcode", "event", "remote", "dacp", "ffmpeg", "artwork", "player", "raop", "laudio", "dmap", "dbperf", "spotify", "lastfm", "cache", "mpd", "stream", "cast", "fifo", "lib", "web" };
 static char *severities[] = { "FATAL", "LOG", "WARN", "INFO", "DEBUG", "SPAM" };
 
+/* Asynchronous logging: each thread that logs gets a single producer/single
+ * consumer ring, where it stores the formatted message and a timestamp. The
+ * writer thread merges the rings by sequence number, applies the repeat
+ * suppression and does the actual file and console output.
+ */
+struct logger_record
+{
+  uint64_t seq;
+  struct timespec ts;
+  uint16_t len;
+  uint8_t severity;
+  uint8_t domain;
+};
+
+struct logger_ring
+{
+  char *buf;
+
+  // Written by the producer, read by the writer
+  uint32_t head;
+  uint32_t dropped;
+  int orphaned;
+
+  // Written by the writer, read by the producer
+  uint32_t tail;
+
+  // Only touched by the writer
+  uint32_t dropped_reported;
+
+  struct logger_ring *next;
+};
+
+static int logger_async;
+static pthread_t tid_logger;
+static pthread_key_t logger_ring_key;
+static int logger_ring_key_created;
+static pthread_mutex_t logger_rings_lck;
+static struct logger_ring *logger_rings;
+static uint64_t logger_seq;
+static int logger_exit;
+static int logger_writer_sleeping;
+static int logger_pipe[2] = { -1, -1 };
+static __thread struct logger_ring *logger_ring_self;
+static __thread int logger_is_writer;
+
 
 static int
 set_logdomains(char *domains)
@@ -111,39 +176,31 @@ repeat_count(const char *fmt)
 }
 
 static void
-vlogger_writer(int severity, int domain, const char *fmt, va_list args)
+logger_output(int severity, int domain, const char *content, const struct timespec *ts)
 {
-  va_list ap;
-  char content[2048];
-  char stamp[32];
-  time_t t;
+  static time_t stamp_sec = -1;
+  static char stamp[32];
   struct tm timebuf;
   int ret;
 
-  va_copy(ap, args);
-  ret = vsnprintf(content, sizeof(content), fmt, ap);
-  if (ret < 0)
-    strcpy(content, "(LOGGING SKIPPED - error printing log message)\n");
-  else if (ret >= sizeof(content))
-    strcpy(content + sizeof(content) - 8, "...\n");
-  va_end(ap);
-
   ret = repeat_count(content);
   if (ret == LOGGER_REPEAT_MAX)
-    strcpy(content, "(LOGGING SKIPPED - above log message is repeating)\n");
+    content = "(LOGGING SKIPPED - above log message is repeating)\n";
   else if (ret > LOGGER_REPEAT_MAX)
     return;
 
   if (logfile)
     {
-      t = time(NULL);
-      ret = strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", localtime_r(&t, &timebuf));
-      if (ret == 0)
-	stamp[0] = '\0';
+      // Only redo the (comparatively expensive) time formatting when needed
+      if (ts->tv_sec != stamp_sec)
+	{
+	  stamp_sec = ts->tv_sec;
+	  ret = strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", localtime_r(&stamp_sec, &timebuf));
+	  if (ret == 0)
+	    stamp[0] = '\0';
+	}
 
       fprintf(logfile, "[%s] [%5s] %8s: %s", stamp, severities[severity], labels[domain], content);
-
-      fflush(logfile);
     }
 
   if (console)
@@ -152,6 +209,45 @@ vlogger_writer(int severity, int domain, const char *fmt, va_list args)
     }
 }
 
+static int
+logger_format(char *content, size_t size, const char *fmt, va_list args)
+{
+  va_list ap;
+  int ret;
+
+  va_copy(ap, args);
+  ret = vsnprintf(content, size, fmt, ap);
+  if (ret < 0)
+    {
+      strcpy(content, "(LOGGING SKIPPED - error printing log message)\n");
+      ret = strlen(content);
+    }
+  else if (ret >= size)
+    {
+      strcpy(content + size - 8, "...\n");
+      ret = size - 8 + 4;
+    }
+  va_end(ap);
+
+  return ret;
+}
+
+static void
+vlogger_writer(int severity, int domain, const char *fmt, va_list args)
+{
+  char content[LOGGER_MSG_MAX];
+  struct timespec ts;
+
+  logger_format(content, sizeof(content), fmt, args);
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  logger_output(severity, domain, content, &ts);
+
+  if (logfile)
+    fflush(logfile);
+}
+
 static void
 vlogger_fatal(const char *fmt, ...)
 {
@@ -162,9 +258,283 @@ vlogger_fatal(const char *fmt, ...)
   va_end(ap);
 }
 
+/* ---------------------------- Asynchronous logging ------------------------ */
+
+static void
+logger_ring_release(void *arg)
+{
+  struct logger_ring *ring = arg;
+
+  // The writer frees the ring once it has drained it
+  logger_ring_self = NULL;
+  __atomic_store_n(&ring->orphaned, 1, __ATOMIC_RELEASE);
+}
+
+static struct logger_ring *
+logger_ring_get(void)
+{
+  struct logger_ring *ring;
+
+  if (logger_ring_self)
+    return logger_ring_self;
+
+  ring = calloc(1, sizeof(struct logger_ring));
+  if (!ring)
+    return NULL;
+
+  ring->buf = malloc(LOGGER_RING_SIZE);
+  if (!ring->buf)
+    {
+      free(ring);
+      return NULL;
+    }
+
+  pthread_setspecific(logger_ring_key, ring);
+
+  LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_rings_lck));
+  ring->next = logger_rings;
+  logger_rings = ring;
+  LOGGER_CHECK_ERR(pthread_mutex_unlock(&logger_rings_lck));
+
+  logger_ring_self = ring;
+
+  return ring;
+}
+
+static void
+logger_wakeup(void)
+{
+  int ret;
+
+  // Pairs with the fence in logger_writer_thread(), so either the writer sees
+  // our record before going to sleep, or we see that it is sleeping
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  if (!__atomic_load_n(&logger_writer_sleeping, __ATOMIC_RELAXED))
+    return;
+
+  if (!__atomic_exchange_n(&logger_writer_sleeping, 0, __ATOMIC_SEQ_CST))
+    return;
+
+  ret = write(logger_pipe[1], "", 1);
+  if (ret < 0)
+    return; // Pipe full means the writer is being woken anyway
+}
+
+/* Producer side, never blocks. If the ring is full the message is dropped and
+ * counted, the writer reports the count once there is room again.
+ */
+static void
+logger_ring_push(struct logger_ring *ring, int severity, int domain, const char *fmt, va_list args)
+{
+  struct logger_record *rec;
+  char content[LOGGER_MSG_MAX];
+  uint32_t head;
+  uint32_t tail;
+  uint32_t offset;
+  uint32_t to_end;
+  uint32_t need;
+  uint32_t pad;
+  int len;
+
+  len = logger_format(content, sizeof(content), fmt, args);
+
+  need = LOGGER_ALIGN(sizeof(struct logger_record) + len + 1);
+
+  head = ring->head;
+  tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+  // Records are never split, so skip the end of the buffer if it is too short
+  offset = head & (LOGGER_RING_SIZE - 1);
+  to_end = LOGGER_RING_SIZE - offset;
+  pad = (to_end < need) ? to_end : 0;
+
+  if (head + pad + need - tail > LOGGER_RING_SIZE)
+    {
+      __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+      return;
+    }
+
+  if (pad >= sizeof(struct logger_record))
+    {
+      rec = (struct logger_record *)(ring->buf + offset);
+      rec->severity = LOGGER_RECORD_PAD;
+    }
+
+  rec = (struct logger_record *)(ring->buf + ((head + pad) & (LOGGER_RING_SIZE - 1)));
+  rec->seq = __atomic_fetch_add(&logger_seq, 1, __ATOMIC_RELAXED);
+  clock_gettime(LOGGER_CLOCK, &rec->ts);
+  rec->len = len;
+  rec->severity = severity;
+  rec->domain = domain;
+  memcpy(rec + 1, content, len + 1);
+
+  __atomic_store_n(&ring->head, head + pad + need, __ATOMIC_RELEASE);
+
+  logger_wakeup();
+}
+
+/* Consumer side, must hold logger_lck */
+static struct logger_record *
+logger_ring_peek(struct logger_ring *ring)
+{
+  struct logger_record *rec;
+  uint32_t head;
+  uint32_t offset;
+  uint32_t to_end;
+
+  head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+  while (ring->tail != head)
+    {
+      offset = ring->tail & (LOGGER_RING_SIZE - 1);
+      to_end = LOGGER_RING_SIZE - offset;
+      rec = (struct logger_record *)(ring->buf + offset);
+
+      if (to_end >= sizeof(struct logger_record) && rec->severity != LOGGER_RECORD_PAD)
+	return rec;
+
+      __atomic_store_n(&ring->tail, ring->tail + to_end, __ATOMIC_RELEASE);
+    }
+
+  return NULL;
+}
+
+static void
+logger_ring_consume(struct logger_ring *ring, struct logger_record *rec)
+{
+  __atomic_store_n(&ring->tail, ring->tail + LOGGER_ALIGN(sizeof(struct logger_record) + rec->len + 1), __ATOMIC_RELEASE);
+}
+
+static bool
+logger_rings_pending(void)
+{
+  struct logger_ring *ring;
+  bool pending = false;
+
+  LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_rings_lck));
+  for (ring = logger_rings; ring && !pending; ring = ring->next)
+    pending = (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != __atomic_load_n(&ring->tail, __ATOMIC_RELAXED));
+  LOGGER_CHECK_ERR(pthread_mutex_unlock(&logger_rings_lck));
+
+  return pending;
+}
+
+/* Writes out everything queued in the rings, oldest first. Must hold
+ * logger_lck, which makes whoever calls this the single consumer.
+ */
+static void
+logger_drain(void)
+{
+  struct logger_ring **prev;
+  struct logger_ring *ring;
+  struct logger_ring *best_ring;
+  struct logger_record *rec;
+  struct logger_record *best;
+  struct timespec ts;
+  char content[128];
+  uint32_t dropped;
+  int n;
+
+  LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_rings_lck));
+
+  for (n = 0; ; n++)
+    {
+      best = NULL;
+      best_ring = NULL;
+      for (ring = logger_rings; ring; ring = ring->next)
+	{
+	  rec = logger_ring_peek(ring);
+	  if (rec && (!best || rec->seq < best->seq))
+	    {
+	      best = rec;
+	      best_ring = ring;
+	    }
+	}
+
+      if (!best)
+	break;
+
+      logger_output(best->severity, best->domain, (const char *)(best + 1), &best->ts);
+      logger_ring_consume(best_ring, best);
+    }
+
+  for (prev = &logger_rings; (ring = *prev); )
+    {
+      dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+      if (dropped != ring->dropped_reported)
+	{
+	  snprintf(content, sizeof(content), "(LOGGING SKIPPED - %u messages dropped, log buffer full)\n", dropped - ring->dropped_reported);
+	  clock_gettime(LOGGER_CLOCK, &ts);
+	  logger_output(E_LOG, L_MISC, content, &ts);
+	  ring->dropped_reported = dropped;
+	  n++;
+	}
+
+      if (__atomic_load_n(&ring->orphaned, __ATOMIC_ACQUIRE) && !logger_ring_peek(ring))
+	{
+	  *prev = ring->next;
+	  free(ring->buf);
+	  free(ring);
+	  continue;
+	}
+
+      prev = &ring->next;
+    }
+
+  LOGGER_CHECK_ERR(pthread_mutex_unlock(&logger_rings_lck));
+
+  if (n > 0 && logfile)
+    fflush(logfile);
+}
+
+static void *
+logger_writer_thread(void *arg)
+{
+  struct pollfd pfd;
+  char buf[64];
+  bool exiting;
+  int ret;
+
+  // Anything the writer logs itself goes directly to the output
+  logger_is_writer = 1;
+
+  pfd.fd = logger_pipe[0];
+  pfd.events = POLLIN;
+
+  for (;;)
+    {
+      exiting = __atomic_load_n(&logger_exit, __ATOMIC_ACQUIRE);
+
+      LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_lck));
+      logger_drain();
+      LOGGER_CHECK_ERR(pthread_mutex_unlock(&logger_lck));
+
+      if (exiting)
+	break;
+
+      __atomic_store_n(&logger_writer_sleeping, 1, __ATOMIC_SEQ_CST);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+      if (!logger_rings_pending() && !__atomic_load_n(&logger_exit, __ATOMIC_ACQUIRE))
+	{
+	  // The timeout makes sure drop counts get reported eventually
+	  ret = poll(&pfd, 1, 1000);
+	  if (ret > 0)
+	    while (read(logger_pipe[0], buf, sizeof(buf)) > 0)
+	      ;
+	}
+
+      __atomic_store_n(&logger_writer_sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+
+  pthread_exit(NULL);
+}
+
 static void
 vlogger(int severity, int domain, const char *fmt, va_list args)
 {
+  struct logger_ring *ring;
 
   if(! logger_initialized)
     {
@@ -176,13 +546,23 @@ vlogger(int severity, int domain, const char *fmt, va_list args)
   if (!((1 << domain) & logdomains) || (severity > threshold))
     return;
 
-  LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_lck));
-
   if (!logfile && !console)
+    return;
+
+  if (__atomic_load_n(&logger_async, __ATOMIC_ACQUIRE))
     {
-      LOGGER_CHECK_ERR(pthread_mutex_unlock(&logger_lck));
-      return;
+      if (severity != E_FATAL && !logger_is_writer && (ring = logger_ring_get()))
+	{
+	  logger_ring_push(ring, severity, domain, fmt, args);
+	  return;
+	}
+
+      // Keep the order, e.g. so a fatal message comes last
+      LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_lck));
+      logger_drain();
     }
+  else
+    LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_lck));
 
   vlogger_writer(severity, domain, fmt, args);
 
@@ -380,9 +760,108 @@ logger_init(char *file, char *domains, int severity)
   return 0;
 }
 
+/* Moves file and console output to a separate thread. Must be called after
+ * forking, since the writer thread does not survive that.
+ */
+int
+logger_async_start(void)
+{
+  int ret;
+
+  if (!logger_initialized || logger_async)
+    return 0;
+
+#ifdef HAVE_PIPE2
+  ret = pipe2(logger_pipe, O_CLOEXEC | O_NONBLOCK);
+#else
+  if ( pipe(logger_pipe) < 0 ||
+       fcntl(logger_pipe[0], F_SETFL, O_NONBLOCK) < 0 ||
+       fcntl(logger_pipe[1], F_SETFL, O_NONBLOCK) < 0 ||
+       fcntl(logger_pipe[0], F_SETFD, FD_CLOEXEC) < 0 ||
+       fcntl(logger_pipe[1], F_SETFD, FD_CLOEXEC) < 0 )
+    ret = -1;
+  else
+    ret = 0;
+#endif
+  if (ret < 0)
+    {
+      DPRINTF(E_LOG, L_MISC, "Could not create logger pipe: %s\n", strerror(errno));
+      goto pipe_fail;
+    }
+
+  if (!logger_ring_key_created)
+    {
+      ret = pthread_key_create(&logger_ring_key, logger_ring_release);
+      if (ret != 0)
+	{
+	  DPRINTF(E_LOG, L_MISC, "Could not create logger thread key: %s\n", strerror(ret));
+	  goto key_fail;
+	}
+
+      CHECK_ERR(L_MISC, mutex_init(&logger_rings_lck));
+      logger_ring_key_created = 1;
+    }
+
+  logger_exit = 0;
+
+  ret = pthread_create(&tid_logger, NULL, logger_writer_thread, NULL);
+  if (ret != 0)
+    {
+      DPRINTF(E_LOG, L_MISC, "Could not spawn logger thread: %s\n", strerror(ret));
+      goto key_fail;
+    }
+
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+  pthread_setname_np(tid_logger, "logger");
+#elif defined(HAVE_PTHREAD_SET_NAME_NP)
+  pthread_set_name_np(tid_logger, "logger");
+#endif
+
+  __atomic_store_n(&logger_async, 1, __ATOMIC_RELEASE);
+
+  return 0;
+
+ key_fail:
+  close(logger_pipe[0]);
+  close(logger_pipe[1]);
+ pipe_fail:
+  return -1;
+}
+
+static void
+logger_async_stop(void)
+{
+  int ret;
+
+  if (!logger_async)
+    return;
+
+  // New messages are written directly from now on
+  __atomic_store_n(&logger_async, 0, __ATOMIC_RELEASE);
+
+  __atomic_store_n(&logger_exit, 1, __ATOMIC_RELEASE);
+  ret = write(logger_pipe[1], "", 1);
+  if (ret < 0)
+    fprintf(stderr, "Could not wake logger thread: %s\n", strerror(errno));
+
+  CHECK_ERR(L_MISC, pthread_join(tid_logger, NULL));
+
+  // Pick up anything that was queued while the writer was exiting
+  LOGGER_CHECK_ERR(pthread_mutex_lock(&logger_lck));
+  logger_drain();
+  LOGGER_CHECK_ERR(pthread_mutex_unlock(&logger_lck));
+
+  close(logger_pipe[0]);
+  close(logger_pipe[1]);
+  logger_pipe[0] = -1;
+  logger_pipe[1] = -1;
+}
+
 void
 logger_deinit(void)
 {
+  logger_async_stop();
+
   if (logfile)
     {
       fclose(logfile);
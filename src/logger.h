@@ -81,6 +81,9 @@ logger_detach(void);
 int
 logger_init(char *file, char *domains, int severity);
 
+int
+logger_async_start(void);
+
 void
 logger_deinit(void);
 
@@ -71,6 +71,7 @@ GCRY_THREAD_OPTION_PTHREAD_IMPL;
 #include "remote_pairing.h"
 #include "player.h"
 #include "worker.h"
+#include "listener.h"
 #include "library.h"
 #ifdef LASTFM
 # include "lastfm.h"
@@ -731,6 +732,14 @@ main(int argc, char **argv)
       goto daemon_fail;
     }
 
+  /* Start the log writer thread (after forking) */
+  if (cfg_getbool(cfg_getsec(cfg, "general"), "log_async"))
+    {
+      ret = logger_async_start();
+      if (ret < 0)
+	DPRINTF(E_LOG, L_MAIN, "Could not start asynchronous logging, will log synchronously\n");
+    }
+
   /* Initialize event base (after forking) */
   CHECK_NULL(L_MAIN, evbase_main = event_base_new());
 
@@ -769,6 +778,16 @@ main(int argc, char **argv)
       goto db_fail;
     }
 
+  /* Spawn listener thread, which delivers events between the modules */
+  ret = listener_init();
+  if (ret != 0)
+    {
+      DPRINTF(E_FATAL, L_MAIN, "Listener thread failed to start\n");
+
+      ret = EXIT_FAILURE;
+      goto listener_fail;
+    }
+
   /* Spawn worker thread */
   ret = worker_init();
   if (ret != 0)
@@ -956,7 +975,12 @@ main(int argc, char **argv)
   worker_deinit();
 
  worker_fail:
+  DPRINTF(E_LOG, L_MAIN, "Listener deinit\n");
+  listener_deinit();
+
+ listener_fail:
   DPRINTF(E_LOG, L_MAIN, "Database deinit\n");
+  db_queue_flush();
   db_perthread_deinit();
   db_deinit();
 
@@ -35,6 +35,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <limits.h>
+#include <sched.h>
 #include <sys/param.h>
 #ifndef CLOCK_REALTIME
 #include <sys/time.h>
@@ -1391,6 +1392,39 @@ mutex_init(pthread_mutex_t *mutex)
   return err;
 }
 
+// Readers spin while a write is in progress, so writes must be short (e.g. a
+// memcpy). There can only be one writer at a time.
+void
+seqlock_write_begin(uint32_t *seq)
+{
+  __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void
+seqlock_write_end(uint32_t *seq)
+{
+  __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t
+seqlock_read_begin(uint32_t *seq)
+{
+  uint32_t val;
+
+  while ((val = __atomic_load_n(seq, __ATOMIC_ACQUIRE)) & 1)
+    sched_yield();
+
+  return val;
+}
+
+bool
+seqlock_read_retry(uint32_t *seq, uint32_t val)
+{
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return (__atomic_load_n(seq, __ATOMIC_RELAXED) != val);
+}
+
 void
 log_fatal_err(int domain, const char *func, int line, int err)
 {
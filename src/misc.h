@@ -226,6 +226,22 @@ timespec_reltoabs(struct timespec relative);
 int
 mutex_init(pthread_mutex_t *mutex);
 
+/* Sequence lock, for data that is written by one thread and read by others
+   without blocking the writer. A reader copies the data between
+   seqlock_read_begin() and seqlock_read_retry(), and starts over if the
+   latter returns true. */
+void
+seqlock_write_begin(uint32_t *seq);
+
+void
+seqlock_write_end(uint32_t *seq);
+
+uint32_t
+seqlock_read_begin(uint32_t *seq);
+
+bool
+seqlock_read_retry(uint32_t *seq, uint32_t val);
+
 /* Check that the function returns 0, logging a fatal error referencing
    returned error (type errno) if it fails, and aborts the process.
    Example: CHECK_ERR(L_MAIN, my_function()); */
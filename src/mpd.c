@@ -601,23 +601,12 @@ static int
 mpd_add_db_media_file_info(struct evbuffer *evbuf, struct db_media_file_info *dbmfi)
 {
   char modified[32];
-  uint32_t time_modified;
   uint32_t songlength;
   int ret;
 
-  if (safe_atou32(dbmfi->time_modified, &time_modified) != 0)
-    {
-      DPRINTF(E_LOG, L_MPD, "Error converting time modified to uint32_t: %s\n", dbmfi->time_modified);
-      return -1;
-    }
-
-  mpd_time(modified, sizeof(modified), time_modified);
+  mpd_time(modified, sizeof(modified), dbmfi->time_modified);
 
-  if (safe_atou32(dbmfi->song_length, &songlength) != 0)
-    {
-      DPRINTF(E_LOG, L_MPD, "Error converting song length to uint32_t: %s\n", dbmfi->song_length);
-      return -1;
-    }
+  songlength = dbmfi->song_length;
 
   ret = evbuffer_add_printf(evbuf,
       "file: %s\n"
@@ -630,10 +619,10 @@ mpd_add_db_media_file_info(struct evbuffer *evbuf, struct db_media_file_info *db
       "AlbumArtistSort: %s\n"
       "Album: %s\n"
       "Title: %s\n"
-      "Track: %s\n"
-      "Date: %s\n"
+      "Track: %" PRIi64 "\n"
+      "Date: %" PRIi64 "\n"
       "Genre: %s\n"
-      "Disc: %s\n",
+      "Disc: %" PRIi64 "\n",
       (dbmfi->virtual_path + 1),
       modified,
       (songlength / 1000),
@@ -652,6 +641,30 @@ mpd_add_db_media_file_info(struct evbuffer *evbuf, struct db_media_file_info *db
   return ret;
 }
 
+/*
+ * Adds "<tag>: <value>" for the given tag type to the response, empty strings
+ * are skipped
+ */
+static void
+mpd_add_tag(struct evbuffer *evbuf, const struct mpd_tagtype *tagtype, struct db_media_file_info *dbmfi)
+{
+  char *strval;
+  int64_t intval;
+
+  if (tagtype->type == MPD_TYPE_INT)
+    {
+      intval = *(int64_t *) ((char *)dbmfi + tagtype->mfi_offset);
+      evbuffer_add_printf(evbuf, "%s: %" PRIi64 "\n", tagtype->tag, intval);
+      return;
+    }
+
+  strval = *(char **) ((char *)dbmfi + tagtype->mfi_offset);
+  if (!strval || (*strval == '\0'))
+    return;
+
+  evbuffer_add_printf(evbuf, "%s: %s\n", tagtype->tag, strval);
+}
+
 static void
 append_string(char **a, const char *b, const char *separator)
 {
@@ -710,7 +723,7 @@ parse_filter_window_params(int argc, char **argv, bool exact_match, struct query
 	      if (exact_match)
 		c1 = db_mprintf("(%s = '%q')", tagtype->field, argv[i + 1]);
 	      else
-		c1 = db_mprintf("(%s LIKE '%%%q%%')", tagtype->field, argv[i + 1]);
+		c1 = db_search_filter(tagtype->field, argv[i + 1], DB_SEARCH_SUBSTRING);
 	    }
 	  else if (tagtype->type == MPD_TYPE_INT)
 	    {
@@ -724,7 +737,7 @@ parse_filter_window_params(int argc, char **argv, bool exact_match, struct query
 	    {
 	      if (0 == strcasecmp(tagtype->tag, "any"))
 	        {
-		  c1 = db_mprintf("(f.artist LIKE '%%%q%%' OR f.album LIKE '%%%q%%' OR f.title LIKE '%%%q%%')", argv[i + 1], argv[i + 1], argv[i + 1]);
+		  c1 = db_search_filter(NULL, argv[i + 1], DB_SEARCH_SUBSTRING);
 		}
 	      else if (0 == strcasecmp(tagtype->tag, "file"))
 	        {
@@ -2378,7 +2391,7 @@ mpd_command_listplaylistinfo(struct evbuffer *evbuf, int argc, char **argv, char
       ret = mpd_add_db_media_file_info(evbuf, &dbmfi);
       if (ret < 0)
 	{
-	  DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %s\n", dbmfi.id);
+	  DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %" PRIi64 "\n", dbmfi.id);
 	}
     }
 
@@ -2670,7 +2683,7 @@ mpd_command_find(struct evbuffer *evbuf, int argc, char **argv, char **errmsg, s
       ret = mpd_add_db_media_file_info(evbuf, &dbmfi);
       if (ret < 0)
 	{
-	  DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %s\n", dbmfi.id);
+	  DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %" PRIi64 "\n", dbmfi.id);
 	}
     }
 
@@ -2722,7 +2735,6 @@ mpd_command_list(struct evbuffer *evbuf, int argc, char **argv, char **errmsg, s
   struct mpd_tagtype **group;
   int groupsize;
   struct db_media_file_info dbmfi;
-  char **strval;
   int i;
   int ret;
 
@@ -2772,15 +2784,7 @@ mpd_command_list(struct evbuffer *evbuf, int argc, char **argv, char **errmsg, s
 
   while (((ret = db_query_fetch_file(&qp, &dbmfi)) == 0) && (dbmfi.id))
     {
-      strval = (char **) ((char *)&dbmfi + tagtype->mfi_offset);
-
-      if (!(*strval) || (**strval == '\0'))
-	continue;
-
-      evbuffer_add_printf(evbuf,
-			  "%s: %s\n",
-			  tagtype->tag,
-			  *strval);
+      mpd_add_tag(evbuf, tagtype, &dbmfi);
 
       if (group && groupsize > 0)
 	{
@@ -2789,15 +2793,7 @@ mpd_command_list(struct evbuffer *evbuf, int argc, char **argv, char **errmsg, s
 	      if (!group[i])
 		continue;
 
-	      strval = (char **) ((char *)&dbmfi + group[i]->mfi_offset);
-
-	      if (!(*strval) || (**strval == '\0'))
-		continue;
-
-	      evbuffer_add_printf(evbuf,
-	      			  "%s: %s\n",
-				  group[i]->tag,
-	      			  *strval);
+	      mpd_add_tag(evbuf, group[i], &dbmfi);
 	    }
 	}
     }
@@ -2917,7 +2913,7 @@ mpd_add_directory(struct evbuffer *evbuf, int directory_id, int listall, int lis
 	  ret = mpd_add_db_media_file_info(evbuf, &dbmfi);
 	  if (ret < 0)
 	    {
-	      DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %s\n", dbmfi.id);
+	      DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %" PRIi64 "\n", dbmfi.id);
 	    }
 	}
       else
@@ -3138,7 +3134,7 @@ mpd_command_search(struct evbuffer *evbuf, int argc, char **argv, char **errmsg,
       ret = mpd_add_db_media_file_info(evbuf, &dbmfi);
       if (ret < 0)
 	{
-	  DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %s\n", dbmfi.id);
+	  DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %" PRIi64 "\n", dbmfi.id);
 	}
     }
 
@@ -3387,22 +3383,14 @@ mpd_sticker_find(struct evbuffer *evbuf, int argc, char **argv, char **errmsg, c
 
   while (((ret = db_query_fetch_file(&qp, &dbmfi)) == 0) && (dbmfi.id))
     {
-      ret = safe_atou32(dbmfi.rating, &rating);
-      if (ret < 0)
-	{
-	  DPRINTF(E_LOG, L_MPD, "Error rating=%s doesn't convert to integer, song id: %s\n",
-		  dbmfi.rating, dbmfi.id);
-	  continue;
-	}
-
-      rating /= MPD_RATING_FACTOR;
+      rating = dbmfi.rating / MPD_RATING_FACTOR;
       ret = evbuffer_add_printf(evbuf,
 				"file: %s\n"
 				"sticker: rating=%d\n",
 				(dbmfi.virtual_path + 1),
 				rating);
       if (ret < 0)
-	DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %s\n", dbmfi.id);
+	DPRINTF(E_LOG, L_MPD, "Error adding song to the evbuffer, song id: %" PRIi64 "\n", dbmfi.id);
     }
 
   db_query_end(&qp);
@@ -4596,7 +4584,7 @@ mpd_notify_idle(void *arg, int *retval)
 }
 
 static void
-mpd_listener_cb(short event_mask)
+mpd_listener_cb(short event_mask, const struct listener_event_data *data)
 {
   short *ptr;
 
@@ -28,16 +28,19 @@
 #include <errno.h>
 #include <stdint.h>
 #include <inttypes.h>
+#include <pthread.h>
 
 #include <event2/event.h>
 
 #include "logger.h"
+#include "conffile.h"
 #include "misc.h"
 #include "transcode.h"
 #include "db.h"
 #include "player.h" //TODO remove me when player_pmap is removed again
 #include "worker.h"
 #include "outputs.h"
+#include "outputs/rtp_common.h"
 
 extern struct output_definition output_raop;
 extern struct output_definition output_streaming;
@@ -85,6 +88,10 @@ static struct output_definition *outputs[] = {
 
 #define OUTPUTS_MAX_CALLBACKS 64
 
+// Number of frames that can be queued for an output with a writer thread,
+// must be a power of two. With the player's usual 10 ms frames it is 640 ms.
+#define OUTPUTS_WRITER_QUEUE_LEN 64
+
 struct outputs_callback_register
 {
   output_status_cb cb;
@@ -105,6 +112,94 @@ struct output_quality_subscription
   struct encode_ctx *encode_ctx;
 };
 
+struct output_frame
+{
+  // Copy of output_buffer, but data[].buffer points to buf[]
+  struct output_buffer obuf;
+  uint8_t *buf[OUTPUTS_MAX_QUALITY_SUBSCRIPTIONS + 1];
+  size_t bufsize[OUTPUTS_MAX_QUALITY_SUBSCRIPTIONS + 1];
+
+  // Generation of the quality subscriptions when the frame was encoded
+  uint32_t quality_gen;
+};
+
+enum writer_op_type
+{
+  WRITER_OP_START,
+  WRITER_OP_PROBE,
+  WRITER_OP_STOP,
+  WRITER_OP_FLUSH,
+  WRITER_OP_VOLUME_SET,
+  WRITER_OP_QUALITY_SET,
+  WRITER_OP_AUTHORIZE,
+  WRITER_OP_CB_SET,
+};
+
+// A device function call that the player has handed over to a writer thread
+struct writer_op
+{
+  enum writer_op_type type;
+  uint64_t device_id;
+  int callback_id;
+  struct media_quality quality;
+  char *pin;
+
+  // The call is made before the writer gets to the frame at this position
+  uint32_t pos;
+
+  struct writer_op *next;
+};
+
+// If enabled with output_threads, the backends that allow it (write_threaded)
+// get a thread that makes their write() calls, so that a slow write can't delay
+// the player or the other outputs. The player puts frames in a single
+// producer/single consumer ring, head is only written by the player, tail only
+// by the writer thread. The player never calls such a backend itself, instead
+// it queues its device calls for the writer thread, so it doesn't have to wait
+// for a write() that is stuck.
+struct output_writer
+{
+  struct output_definition *def;
+  pthread_t tid;
+
+  // Protects ops and exit, and is used with cond for waking up the thread
+  pthread_mutex_t lck;
+  pthread_cond_t cond;
+  bool exit;
+
+  struct writer_op *ops;
+  struct writer_op *ops_last;
+
+  // Number of device calls queued or running (atomic)
+  int ops_pending;
+
+  // Set by the thread before it checks if there is anything to do, so that the
+  // player only needs to wake it up when it is (about to be) waiting (atomic)
+  bool waiting;
+
+  struct output_frame frames[OUTPUTS_WRITER_QUEUE_LEN];
+  uint32_t head;
+  uint32_t tail;
+
+  // Frames before this are discarded by the writer, set by the player on
+  // overruns and flushes
+  uint32_t discard;
+
+  // Frames encoded with older quality subscriptions are discarded, since they
+  // may not have the quality the backend just subscribed to (only used by the
+  // writer thread)
+  uint32_t quality_gen_min;
+
+  // Stats (atomic)
+  uint32_t depth_max;
+  uint64_t frames_written;
+  uint64_t overruns;
+  uint64_t resyncs;
+  uint64_t write_last_us;
+  uint64_t write_total_us;
+  uint64_t write_max_us;
+};
+
 // Buffer used to pass data to the backends
 static struct output_buffer output_buffer;
 
@@ -119,23 +214,48 @@ static struct timeval outputs_stop_timeout = { OUTPUTS_STOP_TIMEOUT, 0 };
 static struct output_quality_subscription output_quality_subscriptions[OUTPUTS_MAX_QUALITY_SUBSCRIPTIONS + 1];
 static bool outputs_got_new_subscription;
 
+// Backends on writer threads may call back, change their device sessions and
+// their quality subscriptions while the player is running, so these are
+// protected. The device list is only changed by the player, so the player
+// doesn't need to lock for reading it.
+static pthread_mutex_t outputs_cb_lck;
+static pthread_rwlock_t outputs_device_list_lck;
+static pthread_mutex_t outputs_quality_lck;
+static uint32_t outputs_quality_gen;
+static uint32_t output_buffer_quality_gen;
+
+// Indexed by output type, NULL if the output doesn't have a writer thread
+static struct output_writer *output_writers[ARRAY_SIZE(outputs)];
+
+// Set in the writer threads to their own writer
+static __thread struct output_writer *writer_current;
+
 
 /* ------------------------------- MISC HELPERS ----------------------------- */
 
 static output_status_cb
 callback_get(struct output_device *device)
 {
+  output_status_cb cb = NULL;
   int callback_id;
 
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&outputs_cb_lck));
+
   for (callback_id = 0; callback_id < ARRAY_SIZE(outputs_cb_register); callback_id++)
     {
       if (outputs_cb_register[callback_id].device == device)
-	return outputs_cb_register[callback_id].cb;
+	{
+	  cb = outputs_cb_register[callback_id].cb;
+	  break;
+	}
     }
 
-  return NULL;
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_cb_lck));
+
+  return cb;
 }
 
+// Caller must hold outputs_cb_lck
 static void
 callback_remove(struct output_device *device)
 {
@@ -162,6 +282,8 @@ callback_add(struct output_device *device, output_status_cb cb)
   if (!cb)
     return -1;
 
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&outputs_cb_lck));
+
   // We will replace any previously registered callbacks, since that's what the
   // player expects
   callback_remove(device);
@@ -176,6 +298,7 @@ callback_add(struct output_device *device, output_status_cb cb)
   if (callback_id == ARRAY_SIZE(outputs_cb_register))
     {
       DPRINTF(E_LOG, L_PLAYER, "Output callback queue is full! (size is %d)\n", OUTPUTS_MAX_CALLBACKS);
+      CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_cb_lck));
       return -1;
     }
 
@@ -191,6 +314,8 @@ callback_add(struct output_device *device, output_status_cb cb)
 
   DPRINTF(E_DBG, L_PLAYER, "Number of active callbacks: %d\n", active);
 
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_cb_lck));
+
   return callback_id;
 };
 
@@ -200,21 +325,31 @@ deferred_cb(int fd, short what, void *arg)
   struct output_device *device;
   output_status_cb cb;
   enum output_device_state state;
+  uint64_t device_id;
   int callback_id;
 
   for (callback_id = 0; callback_id < ARRAY_SIZE(outputs_cb_register); callback_id++)
     {
+      CHECK_ERR(L_PLAYER, pthread_mutex_lock(&outputs_cb_lck));
+
+      cb = NULL;
       if (outputs_cb_register[callback_id].ready)
 	{
 	  // Must copy before making callback, since you never know what the
 	  // callback might result in (could call back in)
 	  cb = outputs_cb_register[callback_id].cb;
 	  state = outputs_cb_register[callback_id].state;
-
-	  // Will be NULL if the device has disappeared
-	  device = outputs_device_get(outputs_cb_register[callback_id].device_id);
+	  device_id = outputs_cb_register[callback_id].device_id;
 
 	  memset(&outputs_cb_register[callback_id], 0, sizeof(struct outputs_callback_register));
+	}
+
+      CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_cb_lck));
+
+      if (cb)
+	{
+	  // Will be NULL if the device has disappeared
+	  device = outputs_device_get(device_id);
 
 	  // The device has left the building (stopped/failed), and the backend
 	  // is not using it any more
@@ -328,6 +463,8 @@ buffer_fill(struct output_buffer *obuf, void *buf, size_t bufsize, struct media_
 
   obuf->pts = *pts;
 
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&outputs_quality_lck));
+
   // The resampling/encoding (transcode) contexts work for a given input quality,
   // so if the quality changes we need to reset the contexts. We also do that if
   // we have received a subscription for a new quality.
@@ -337,10 +474,11 @@ buffer_fill(struct output_buffer *obuf, void *buf, size_t bufsize, struct media_
       outputs_got_new_subscription = false;
     }
 
-  // The first element of the output_buffer is always just the raw input data
-  // TODO can we avoid the copy below? we can't use evbuffer_add_buffer_reference,
-  // because then the outputs can't use it and we would need to copy there instead
-  evbuffer_add(obuf->data[0].evbuf, buf, bufsize);
+  output_buffer_quality_gen = outputs_quality_gen;
+
+  // The first element of the output_buffer is always just the raw input data.
+  // It is not copied, outputs_write() holds the data for the duration of the
+  // writes, and the outputs must copy what they need to keep.
   obuf->data[0].buffer = buf;
   obuf->data[0].bufsize = bufsize;
   obuf->data[0].quality = *quality;
@@ -369,6 +507,8 @@ buffer_fill(struct output_buffer *obuf, void *buf, size_t bufsize, struct media_
       obuf->data[n].samples = BTOS(obuf->data[n].bufsize, obuf->data[n].quality.bits_per_sample, obuf->data[n].quality.channels);
       n++;
     }
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_quality_lck));
 }
 
 static void
@@ -378,7 +518,10 @@ buffer_drain(struct output_buffer *obuf)
 
   for (i = 0; obuf->data[i].buffer; i++)
     {
-      evbuffer_drain(obuf->data[i].evbuf, obuf->data[i].bufsize);
+      // Element 0 is the player's data and not in the evbuf
+      if (i > 0)
+	evbuffer_drain(obuf->data[i].evbuf, obuf->data[i].bufsize);
+
       obuf->data[i].buffer  = NULL;
       obuf->data[i].bufsize = 0;
       // We don't reset quality and samples, would be a waste of time
@@ -545,6 +688,422 @@ vol_adjust(void)
 #endif
 }
 
+/* ------------------------------ WRITER THREADS ---------------------------- */
+
+// Makes the writer skip what has been queued so far. Called by the player on
+// stop, flush and overrun.
+static void
+writer_discard(struct output_writer *writer)
+{
+  __atomic_store_n(&writer->discard, writer->head, __ATOMIC_RELEASE);
+}
+
+static void
+writer_wakeup(struct output_writer *writer)
+{
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&writer->lck));
+  CHECK_ERR(L_PLAYER, pthread_cond_signal(&writer->cond));
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&writer->lck));
+}
+
+// If the writer has device calls queued, the session the player sees may be
+// about to change, so then the checks of it are left to the writer thread
+static bool
+device_session_known(struct output_device *device)
+{
+  struct output_writer *writer = output_writers[device->type];
+
+  return !writer || __atomic_load_n(&writer->ops_pending, __ATOMIC_ACQUIRE) == 0;
+}
+
+static void
+writer_op_free(struct writer_op *op)
+{
+  free(op->pin);
+  free(op);
+}
+
+// Player thread. The result of the call is always reported through the
+// callback, so the return value is 1 (pending), or 0 if there is no callback.
+static int
+writer_op_add(struct output_writer *writer, enum writer_op_type type, struct output_device *device, int callback_id, struct media_quality *quality, const char *pin)
+{
+  struct writer_op *op;
+
+  CHECK_NULL(L_PLAYER, op = calloc(1, sizeof(struct writer_op)));
+
+  op->type = type;
+  op->device_id = device->id;
+  op->callback_id = callback_id;
+  if (quality)
+    op->quality = *quality;
+  if (pin)
+    CHECK_NULL(L_PLAYER, op->pin = strdup(pin));
+  op->pos = writer->head;
+
+  __atomic_add_fetch(&writer->ops_pending, 1, __ATOMIC_RELAXED);
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&writer->lck));
+  if (writer->ops_last)
+    writer->ops_last->next = op;
+  else
+    writer->ops = op;
+  writer->ops_last = op;
+  CHECK_ERR(L_PLAYER, pthread_cond_signal(&writer->cond));
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&writer->lck));
+
+  return (callback_id < 0) ? 0 : 1;
+}
+
+// Writer thread, returns the next call that the player made before it queued
+// the frame at tail, or any call if all is true
+static struct writer_op *
+writer_op_next(struct output_writer *writer, bool all)
+{
+  struct writer_op *op;
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&writer->lck));
+
+  op = writer->ops;
+  if (op && (all || (int32_t)(op->pos - writer->tail) <= 0))
+    {
+      writer->ops = op->next;
+      if (!writer->ops)
+	writer->ops_last = NULL;
+    }
+  else
+    op = NULL;
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&writer->lck));
+
+  return op;
+}
+
+// Writer thread. Makes the backend call, and if the backend completed it right
+// away (or it wasn't needed) we make the callback that the player is waiting
+// for.
+static void
+writer_op_run(struct output_writer *writer, struct writer_op *op)
+{
+  struct output_definition *def = writer->def;
+  struct output_device *device;
+  enum output_device_state state;
+  int ret;
+
+  // The player only changes the device list with the write lock, so the device
+  // can't go away while we have the read lock
+  CHECK_ERR(L_PLAYER, pthread_rwlock_rdlock(&outputs_device_list_lck));
+
+  // If the device was removed before we got to the call there is nothing to
+  // call, the backend's deinit will clean up any session it had
+  device = outputs_device_get(op->device_id);
+  if (!device)
+    {
+      CHECK_ERR(L_PLAYER, pthread_rwlock_unlock(&outputs_device_list_lck));
+      outputs_cb(op->callback_id, op->device_id, OUTPUT_STATE_FAILED);
+      return;
+    }
+
+  state = device->state;
+  ret = 0;
+
+  switch (op->type)
+    {
+      case WRITER_OP_START:
+	if (!device->session)
+	  ret = def->device_start(device, op->callback_id);
+	break;
+
+      case WRITER_OP_PROBE:
+	if (!device->session)
+	  ret = def->device_probe(device, op->callback_id);
+	break;
+
+      case WRITER_OP_STOP:
+	if (device->session)
+	  ret = def->device_stop(device, op->callback_id);
+	else
+	  state = OUTPUT_STATE_STOPPED;
+	break;
+
+      case WRITER_OP_FLUSH:
+	if (device->session)
+	  ret = def->device_flush(device, op->callback_id);
+	break;
+
+      case WRITER_OP_VOLUME_SET:
+	if (device->session)
+	  ret = def->device_volume_set(device, op->callback_id);
+	break;
+
+      case WRITER_OP_QUALITY_SET:
+	ret = def->device_quality_set(device, &op->quality, op->callback_id);
+	break;
+
+      case WRITER_OP_AUTHORIZE:
+	if (!device->session)
+	  ret = def->device_authorize(device, op->pin, op->callback_id);
+	break;
+
+      case WRITER_OP_CB_SET:
+	if (device->session)
+	  def->device_cb_set(device, op->callback_id);
+	ret = 1; // The callback is for later
+	break;
+    }
+
+  CHECK_ERR(L_PLAYER, pthread_rwlock_unlock(&outputs_device_list_lck));
+
+  if (ret < 0)
+    outputs_cb(op->callback_id, op->device_id, OUTPUT_STATE_FAILED);
+  else if (ret == 0)
+    outputs_cb(op->callback_id, op->device_id, state);
+}
+
+static int
+frame_copy(struct output_frame *frame, struct output_buffer *obuf)
+{
+  uint8_t *buf;
+  int i;
+
+  frame->obuf.pts = obuf->pts;
+
+  for (i = 0; obuf->data[i].buffer; i++)
+    {
+      if (frame->bufsize[i] < obuf->data[i].bufsize)
+	{
+	  buf = realloc(frame->buf[i], obuf->data[i].bufsize);
+	  if (!buf)
+	    {
+	      DPRINTF(E_LOG, L_PLAYER, "Out of memory for output frame (size %zu)\n", obuf->data[i].bufsize);
+	      return -1;
+	    }
+
+	  frame->buf[i] = buf;
+	  frame->bufsize[i] = obuf->data[i].bufsize;
+	}
+
+      memcpy(frame->buf[i], obuf->data[i].buffer, obuf->data[i].bufsize);
+
+      frame->obuf.data[i] = obuf->data[i];
+      frame->obuf.data[i].evbuf = NULL;
+      frame->obuf.data[i].buffer = frame->buf[i];
+    }
+
+  frame->obuf.data[i].buffer = NULL;
+  frame->obuf.data[i].bufsize = 0;
+
+  return 0;
+}
+
+// Player thread, which is the only producer
+static void
+writer_push(struct output_writer *writer, struct output_buffer *obuf)
+{
+  struct output_frame *frame;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t depth;
+
+  head = writer->head;
+  tail = __atomic_load_n(&writer->tail, __ATOMIC_ACQUIRE);
+
+  // The backend is not keeping up, so we drop this frame and let it skip what
+  // it has queued, which is probably too late anyway
+  if (head - tail >= OUTPUTS_WRITER_QUEUE_LEN)
+    {
+      if (__atomic_add_fetch(&writer->overruns, 1, __ATOMIC_RELAXED) == 1)
+	DPRINTF(E_WARN, L_PLAYER, "Output '%s' is not keeping up, dropping audio to resync\n", writer->def->name);
+
+      writer_discard(writer);
+      return;
+    }
+
+  frame = &writer->frames[head & (OUTPUTS_WRITER_QUEUE_LEN - 1)];
+  if (frame_copy(frame, obuf) < 0)
+    return;
+
+  frame->quality_gen = output_buffer_quality_gen;
+
+  __atomic_store_n(&writer->head, head + 1, __ATOMIC_SEQ_CST);
+
+  depth = head + 1 - tail;
+  if (depth > __atomic_load_n(&writer->depth_max, __ATOMIC_RELAXED))
+    __atomic_store_n(&writer->depth_max, depth, __ATOMIC_RELAXED);
+
+  // The writer sets waiting before it checks head, so either it sees the new
+  // frame or we see that it is waiting. It only waits when the queue is empty,
+  // so normally we don't take the lock at all.
+  if (__atomic_load_n(&writer->waiting, __ATOMIC_SEQ_CST))
+    writer_wakeup(writer);
+}
+
+static void
+writer_frame_write(struct output_writer *writer, struct output_frame *frame)
+{
+  struct timespec start;
+  struct timespec end;
+  uint64_t elapsed_us;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  writer->def->write(&frame->obuf);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  elapsed_us = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+
+  __atomic_add_fetch(&writer->frames_written, 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&writer->write_last_us, elapsed_us, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&writer->write_total_us, elapsed_us, __ATOMIC_RELAXED);
+  if (elapsed_us > __atomic_load_n(&writer->write_max_us, __ATOMIC_RELAXED))
+    __atomic_store_n(&writer->write_max_us, elapsed_us, __ATOMIC_RELAXED);
+}
+
+static void *
+writer_thread(void *arg)
+{
+  struct output_writer *writer = arg;
+  struct output_frame *frame;
+  struct writer_op *op;
+  uint32_t discard;
+  bool exit;
+
+  writer_current = writer;
+
+  while (1)
+    {
+      CHECK_ERR(L_PLAYER, pthread_mutex_lock(&writer->lck));
+      __atomic_store_n(&writer->waiting, true, __ATOMIC_SEQ_CST);
+      while (!writer->exit && !writer->ops && writer->tail == __atomic_load_n(&writer->head, __ATOMIC_SEQ_CST))
+	CHECK_ERR(L_PLAYER, pthread_cond_wait(&writer->cond, &writer->lck));
+      __atomic_store_n(&writer->waiting, false, __ATOMIC_RELAXED);
+      exit = writer->exit;
+
+      // The player discards before queuing a stop or flush, so if we got the
+      // call we also see the discard
+      discard = __atomic_load_n(&writer->discard, __ATOMIC_ACQUIRE);
+      CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&writer->lck));
+
+      if ((int32_t)(discard - writer->tail) > 0)
+	{
+	  __atomic_add_fetch(&writer->resyncs, 1, __ATOMIC_RELAXED);
+	  __atomic_store_n(&writer->tail, discard, __ATOMIC_RELEASE);
+	}
+
+      // On exit we make all the remaining calls, so that sessions are stopped
+      while ((op = writer_op_next(writer, exit)))
+	{
+	  writer_op_run(writer, op);
+	  writer_op_free(op);
+	  __atomic_sub_fetch(&writer->ops_pending, 1, __ATOMIC_RELEASE);
+	}
+
+      if (exit)
+	break;
+
+      if (writer->tail == __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE))
+	continue;
+
+      frame = &writer->frames[writer->tail & (OUTPUTS_WRITER_QUEUE_LEN - 1)];
+
+      // If the backend just subscribed to a new quality we skip ahead to where
+      // the player started delivering it
+      if ((int32_t)(frame->quality_gen - writer->quality_gen_min) < 0)
+	__atomic_add_fetch(&writer->resyncs, 1, __ATOMIC_RELAXED);
+      else
+	writer_frame_write(writer, frame);
+
+      __atomic_store_n(&writer->tail, writer->tail + 1, __ATOMIC_RELEASE);
+    }
+
+  pthread_exit(NULL);
+}
+
+static void
+writer_free(struct output_writer *writer)
+{
+  struct writer_op *op;
+  int i;
+  int j;
+
+  if (!writer)
+    return;
+
+  for (i = 0; i < ARRAY_SIZE(writer->frames); i++)
+    for (j = 0; j < ARRAY_SIZE(writer->frames[i].buf); j++)
+      free(writer->frames[i].buf[j]);
+
+  while ((op = writer->ops))
+    {
+      writer->ops = op->next;
+      writer_op_free(op);
+    }
+
+  CHECK_ERR(L_PLAYER, pthread_cond_destroy(&writer->cond));
+  CHECK_ERR(L_PLAYER, pthread_mutex_destroy(&writer->lck));
+
+  free(writer);
+}
+
+static struct output_writer *
+writer_start(struct output_definition *def)
+{
+  struct output_writer *writer;
+  char name[16];
+  int ret;
+
+  CHECK_NULL(L_PLAYER, writer = calloc(1, sizeof(struct output_writer)));
+
+  writer->def = def;
+
+  CHECK_ERR(L_PLAYER, mutex_init(&writer->lck));
+  CHECK_ERR(L_PLAYER, pthread_cond_init(&writer->cond, NULL));
+
+  ret = pthread_create(&writer->tid, NULL, writer_thread, writer);
+  if (ret != 0)
+    {
+      DPRINTF(E_LOG, L_PLAYER, "Could not spawn writer thread for output '%s': %s\n", def->name, strerror(ret));
+      writer_free(writer);
+      return NULL;
+    }
+
+  snprintf(name, sizeof(name), "out-%s", def->name);
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+  pthread_setname_np(writer->tid, name);
+#elif defined(HAVE_PTHREAD_SET_NAME_NP)
+  pthread_set_name_np(writer->tid, name);
+#endif
+
+  DPRINTF(E_INFO, L_PLAYER, "Output '%s' will be written from its own thread\n", def->name);
+
+  return writer;
+}
+
+static void
+writer_stop(struct output_writer *writer)
+{
+  int ret;
+
+  if (!writer)
+    return;
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&writer->lck));
+  writer->exit = true;
+  CHECK_ERR(L_PLAYER, pthread_cond_signal(&writer->cond));
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&writer->lck));
+
+  ret = pthread_join(writer->tid, NULL);
+  if (ret != 0)
+    {
+      DPRINTF(E_LOG, L_PLAYER, "Could not join writer thread for output '%s': %s\n", writer->def->name, strerror(ret));
+      return;
+    }
+
+  writer_free(writer);
+}
+
+
 /* ----------------------------------- API ---------------------------------- */
 
 struct output_device *
@@ -570,13 +1129,19 @@ int
 outputs_device_session_add(uint64_t device_id, void *session)
 {
   struct output_device *device;
+  int ret;
+
+  CHECK_ERR(L_PLAYER, pthread_rwlock_rdlock(&outputs_device_list_lck));
 
   device = outputs_device_get(device_id);
-  if (!device)
-    return -1;
+  if (device)
+    device->session = session;
 
-  device->session = session;
-  return 0;
+  ret = device ? 0 : -1;
+
+  CHECK_ERR(L_PLAYER, pthread_rwlock_unlock(&outputs_device_list_lck));
+
+  return ret;
 }
 
 void
@@ -584,18 +1149,35 @@ outputs_device_session_remove(uint64_t device_id)
 {
   struct output_device *device;
 
+  CHECK_ERR(L_PLAYER, pthread_rwlock_rdlock(&outputs_device_list_lck));
+
   device = outputs_device_get(device_id);
   if (device)
     device->session = NULL;
 
+  CHECK_ERR(L_PLAYER, pthread_rwlock_unlock(&outputs_device_list_lck));
+
   return;
 }
 
+// Must be called with outputs_quality_lck held. If the backend is running on a
+// writer thread, the frames it has queued may not have the new quality yet.
+static void
+quality_gen_bump(void)
+{
+  outputs_quality_gen++;
+
+  if (writer_current)
+    writer_current->quality_gen_min = outputs_quality_gen;
+}
+
 int
 outputs_quality_subscribe(struct media_quality *quality)
 {
   int i;
 
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&outputs_quality_lck));
+
   // If someone else is already subscribing to this quality we just increase the
   // reference count.
   for (i = 0; output_quality_subscriptions[i].count > 0; i++)
@@ -608,12 +1190,14 @@ outputs_quality_subscribe(struct media_quality *quality)
       DPRINTF(E_DBG, L_PLAYER, "Subscription request for quality %d/%d/%d (now %d subscribers)\n",
 	quality->sample_rate, quality->bits_per_sample, quality->channels, output_quality_subscriptions[i].count);
 
+      CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_quality_lck));
       return 0;
     }
 
   if (i >= (ARRAY_SIZE(output_quality_subscriptions) - 1))
     {
       DPRINTF(E_LOG, L_PLAYER, "Bug! The number of different quality levels requested by outputs is too high\n");
+      CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_quality_lck));
       return -1;
     }
 
@@ -625,6 +1209,9 @@ outputs_quality_subscribe(struct media_quality *quality)
 
   // Better way of signaling this?
   outputs_got_new_subscription = true;
+  quality_gen_bump();
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_quality_lck));
 
   return 0;
 }
@@ -634,6 +1221,8 @@ outputs_quality_unsubscribe(struct media_quality *quality)
 {
   int i;
 
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&outputs_quality_lck));
+
   // Find subscription
   for (i = 0; output_quality_subscriptions[i].count > 0; i++)
     {
@@ -644,7 +1233,7 @@ outputs_quality_unsubscribe(struct media_quality *quality)
   if (output_quality_subscriptions[i].count == 0)
     {
       DPRINTF(E_LOG, L_PLAYER, "Bug! Unsubscription request for a quality level that there is no subscription for\n");
-      return;
+      goto out;
     }
 
   output_quality_subscriptions[i].count--;
@@ -653,13 +1242,16 @@ outputs_quality_unsubscribe(struct media_quality *quality)
     quality->sample_rate, quality->bits_per_sample, quality->channels, output_quality_subscriptions[i].count);
 
   if (output_quality_subscriptions[i].count > 0)
-    return;
+    goto out;
 
   transcode_encode_cleanup(&output_quality_subscriptions[i].encode_ctx);
 
   // Shift elements
   for (; i < ARRAY_SIZE(output_quality_subscriptions) - 1; i++)
     output_quality_subscriptions[i] = output_quality_subscriptions[i + 1];
+
+ out:
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_quality_lck));
 }
 
 // Output backends call back through the below wrapper to make sure that:
@@ -671,9 +1263,12 @@ outputs_cb(int callback_id, uint64_t device_id, enum output_device_state state)
   if (callback_id < 0)
     return;
 
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&outputs_cb_lck));
+
   if (!(callback_id < ARRAY_SIZE(outputs_cb_register)) || !outputs_cb_register[callback_id].cb)
     {
       DPRINTF(E_LOG, L_PLAYER, "Bug! Output backend called us with an illegal callback id (%d)\n", callback_id);
+      CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_cb_lck));
       return;
     }
 
@@ -682,10 +1277,70 @@ outputs_cb(int callback_id, uint64_t device_id, enum output_device_state state)
   outputs_cb_register[callback_id].ready = true;
   outputs_cb_register[callback_id].device_id = device_id;
   outputs_cb_register[callback_id].state = state;
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&outputs_cb_lck));
+
   event_active(outputs_deferredev, 0, 0);
 }
 
 
+void
+outputs_slicer_init(struct output_slicer *slicer, size_t packet_size)
+{
+  CHECK_NULL(L_PLAYER, slicer->buf = malloc(packet_size));
+  slicer->size = packet_size;
+  slicer->len = 0;
+}
+
+void
+outputs_slicer_deinit(struct output_slicer *slicer)
+{
+  free(slicer->buf);
+  memset(slicer, 0, sizeof(struct output_slicer));
+}
+
+// Returns the next packet from odata, starting at *offset, which is advanced.
+// The returned pointer is either into odata->buffer or into the slicer's own
+// buffer (if the packet spans two writes), and is only valid until the next
+// call. Returns NULL when there is not enough data left for a packet, in which
+// case the remainder has been saved for the next write.
+uint8_t *
+outputs_slicer_next(struct output_slicer *slicer, struct output_data *odata, size_t *offset)
+{
+  uint8_t *packet;
+  size_t remaining;
+  size_t len;
+
+  remaining = odata->bufsize - *offset;
+
+  if (slicer->len > 0)
+    {
+      len = MIN(slicer->size - slicer->len, remaining);
+      memcpy(slicer->buf + slicer->len, odata->buffer + *offset, len);
+      slicer->len += len;
+      *offset += len;
+
+      if (slicer->len < slicer->size)
+	return NULL;
+
+      slicer->len = 0;
+      return slicer->buf;
+    }
+
+  if (remaining >= slicer->size)
+    {
+      packet = odata->buffer + *offset;
+      *offset += slicer->size;
+      return packet;
+    }
+
+  memcpy(slicer->buf, odata->buffer + *offset, remaining);
+  slicer->len = remaining;
+  *offset += remaining;
+
+  return NULL;
+}
+
 /* ---------------------------- Called by player ---------------------------- */
 
 struct output_device *
@@ -722,8 +1377,10 @@ outputs_device_add(struct output_device *add, bool new_deselect)
       if (new_deselect)
 	device->selected = 0;
 
+      CHECK_ERR(L_PLAYER, pthread_rwlock_wrlock(&outputs_device_list_lck));
       device->next = outputs_device_list;
       outputs_device_list = device;
+      CHECK_ERR(L_PLAYER, pthread_rwlock_unlock(&outputs_device_list_lck));
     }
   // Update to a device already in the list
   else
@@ -760,7 +1417,9 @@ outputs_device_add(struct output_device *add, bool new_deselect)
       outputs_device_free(add);
     }
 
+  CHECK_ERR(L_PLAYER, pthread_rwlock_wrlock(&outputs_device_list_lck));
   device_list_sort();
+  CHECK_ERR(L_PLAYER, pthread_rwlock_unlock(&outputs_device_list_lck));
 
   vol_adjust();
 
@@ -801,10 +1460,12 @@ outputs_device_remove(struct output_device *remove)
 
   DPRINTF(E_INFO, L_PLAYER, "Removing %s device '%s'; stopped advertising\n", remove->type_name, remove->name);
 
+  CHECK_ERR(L_PLAYER, pthread_rwlock_wrlock(&outputs_device_list_lck));
   if (!prev)
     outputs_device_list = remove->next;
   else
     prev->next = remove->next;
+  CHECK_ERR(L_PLAYER, pthread_rwlock_unlock(&outputs_device_list_lck));
 
   outputs_device_free(remove);
 
@@ -848,9 +1509,12 @@ outputs_device_start(struct output_device *device, output_status_cb cb, bool onl
   if (outputs[device->type]->disabled || !outputs[device->type]->device_start || !outputs[device->type]->device_probe)
     return -1;
 
-  if (device->session)
+  if (device->session && device_session_known(device))
     return 0; // Device is already running, nothing to do
 
+  if (output_writers[device->type])
+    return writer_op_add(output_writers[device->type], only_probe ? WRITER_OP_PROBE : WRITER_OP_START, device, callback_add(device, cb), NULL, NULL);
+
   if (only_probe)
     ret = outputs[device->type]->device_probe(device, callback_add(device, cb));
   else
@@ -867,9 +1531,15 @@ outputs_device_stop(struct output_device *device, output_status_cb cb)
   if (outputs[device->type]->disabled || !outputs[device->type]->device_stop)
     return -1;
 
-  if (!device->session)
+  if (!device->session && device_session_known(device))
     return 0; // Device is already stopped, nothing to do
 
+  if (output_writers[device->type])
+    {
+      writer_discard(output_writers[device->type]);
+      return writer_op_add(output_writers[device->type], WRITER_OP_STOP, device, callback_add(device, cb), NULL, NULL);
+    }
+
   ret = outputs[device->type]->device_stop(device, callback_add(device, cb));
 
   return device_state_update(device, ret);
@@ -881,10 +1551,13 @@ outputs_device_stop_delayed(struct output_device *device, output_status_cb cb)
   if (outputs[device->type]->disabled || !outputs[device->type]->device_stop)
     return -1;
 
-  if (!device->session)
+  if (!device->session && device_session_known(device))
     return 0; // Device is already stopped, nothing to do
 
-  outputs[device->type]->device_cb_set(device, callback_add(device, cb));
+  if (output_writers[device->type])
+    writer_op_add(output_writers[device->type], WRITER_OP_CB_SET, device, callback_add(device, cb), NULL, NULL);
+  else
+    outputs[device->type]->device_cb_set(device, callback_add(device, cb));
 
   event_add(device->stop_timer, &outputs_stop_timeout);
 
@@ -899,9 +1572,17 @@ outputs_device_flush(struct output_device *device, output_status_cb cb)
   if (outputs[device->type]->disabled || !outputs[device->type]->device_flush)
     return -1;
 
-  if (!device->session)
+  if (!device->session && device_session_known(device))
     return 0; // Nothing to flush
 
+  // Also drop what the writer has queued, so that it isn't played after the
+  // flush
+  if (output_writers[device->type])
+    {
+      writer_discard(output_writers[device->type]);
+      return writer_op_add(output_writers[device->type], WRITER_OP_FLUSH, device, callback_add(device, cb), NULL, NULL);
+    }
+
   ret = outputs[device->type]->device_flush(device, callback_add(device, cb));
 
   return ret; // We don't change device state just because of a failed flush
@@ -926,9 +1607,12 @@ outputs_device_volume_set(struct output_device *device, output_status_cb cb)
   if (outputs[device->type]->disabled || !outputs[device->type]->device_volume_set)
     return -1;
 
-  if (!device->session)
+  if (!device->session && device_session_known(device))
     return 0; // Device isn't active
 
+  if (output_writers[device->type])
+    return writer_op_add(output_writers[device->type], WRITER_OP_VOLUME_SET, device, callback_add(device, cb), NULL, NULL);
+
   ret = outputs[device->type]->device_volume_set(device, callback_add(device, cb));
 
   return ret; // We don't change device state just because of a failed volume change
@@ -937,10 +1621,15 @@ outputs_device_volume_set(struct output_device *device, output_status_cb cb)
 int
 outputs_device_volume_to_pct(struct output_device *device, const char *volume)
 {
+  int ret;
+
   if (outputs[device->type]->disabled || !outputs[device->type]->device_volume_to_pct)
     return -1;
 
-  return outputs[device->type]->device_volume_to_pct(device, volume);
+  // Only a conversion, so it doesn't need to go through the writer
+  ret = outputs[device->type]->device_volume_to_pct(device, volume);
+
+  return ret;
 }
 
 int
@@ -951,6 +1640,9 @@ outputs_device_quality_set(struct output_device *device, struct media_quality *q
   if (outputs[device->type]->disabled || !outputs[device->type]->device_quality_set)
     return -1;
 
+  if (output_writers[device->type])
+    return writer_op_add(output_writers[device->type], WRITER_OP_QUALITY_SET, device, callback_add(device, cb), quality, NULL);
+
   ret = outputs[device->type]->device_quality_set(device, quality, callback_add(device, cb));
 
   return device_state_update(device, ret);
@@ -964,9 +1656,12 @@ outputs_device_authorize(struct output_device *device, const char *pin, output_s
   if (outputs[device->type]->disabled || !outputs[device->type]->device_authorize)
     return -1;
 
-  if (device->session)
+  if (device->session && device_session_known(device))
     return 0; // We are already connected to the device - no auth required
 
+  if (output_writers[device->type])
+    return writer_op_add(output_writers[device->type], WRITER_OP_AUTHORIZE, device, callback_add(device, cb), NULL, pin);
+
   ret = outputs[device->type]->device_authorize(device, pin, callback_add(device, cb));
 
   return device_state_update(device, ret); // If ret < 0 then we couldn't reach the speaker
@@ -978,10 +1673,13 @@ outputs_device_cb_set(struct output_device *device, output_status_cb cb)
   if (outputs[device->type]->disabled || !outputs[device->type]->device_cb_set)
     return;
 
-  if (!device->session)
+  if (!device->session && device_session_known(device))
     return;
 
-  outputs[device->type]->device_cb_set(device, callback_add(device, cb));
+  if (output_writers[device->type])
+    writer_op_add(output_writers[device->type], WRITER_OP_CB_SET, device, callback_add(device, cb), NULL, NULL);
+  else
+    outputs[device->type]->device_cb_set(device, callback_add(device, cb));
 }
 
 void
@@ -996,6 +1694,7 @@ outputs_device_free(struct output_device *device)
   if (device->session)
     DPRINTF(E_LOG, L_PLAYER, "BUG! Freeing device with active session?\n");
 
+  // A writer thread only uses devices that are in the list, so this is safe
   if (outputs[device->type]->device_free_extra)
     outputs[device->type]->device_free_extra(device);
 
@@ -1153,7 +1852,9 @@ outputs_write(void *buf, size_t bufsize, int nsamples, struct media_quality *qua
       if (outputs[i]->disabled)
 	continue;
 
-      if (outputs[i]->write)
+      if (output_writers[i])
+	writer_push(output_writers[i], &output_buffer);
+      else if (outputs[i]->write)
 	outputs[i]->write(&output_buffer);
     }
 
@@ -1206,6 +1907,46 @@ outputs_list(void)
   return outputs_device_list;
 }
 
+int
+outputs_writer_stats_get(struct outputs_writer_stats *stats, int size)
+{
+  struct output_writer *writer;
+  uint64_t frames;
+  uint32_t tail;
+  int n;
+  int i;
+
+  for (i = 0, n = 0; outputs[i] && n < size; i++)
+    {
+      writer = output_writers[i];
+      if (!writer)
+	continue;
+
+      frames = __atomic_load_n(&writer->frames_written, __ATOMIC_RELAXED);
+      // Tail first, since it can never pass head
+      tail = __atomic_load_n(&writer->tail, __ATOMIC_ACQUIRE);
+
+      stats[n].name = writer->def->name;
+      stats[n].depth = __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE) - tail;
+      stats[n].depth_max = __atomic_load_n(&writer->depth_max, __ATOMIC_RELAXED);
+      stats[n].frames = frames;
+      stats[n].overruns = __atomic_load_n(&writer->overruns, __ATOMIC_RELAXED);
+      stats[n].resyncs = __atomic_load_n(&writer->resyncs, __ATOMIC_RELAXED);
+      stats[n].write_last_us = __atomic_load_n(&writer->write_last_us, __ATOMIC_RELAXED);
+      stats[n].write_avg_us = frames ? __atomic_load_n(&writer->write_total_us, __ATOMIC_RELAXED) / frames : 0;
+      stats[n].write_max_us = __atomic_load_n(&writer->write_max_us, __ATOMIC_RELAXED);
+      n++;
+    }
+
+  return n;
+}
+
+int
+outputs_send_stats_get(struct outputs_send_stats *stats, int size)
+{
+  return rtp_send_stats_get(stats, size);
+}
+
 int
 outputs_init(void)
 {
@@ -1215,6 +1956,10 @@ outputs_init(void)
 
   outputs_master_volume = -1;
 
+  CHECK_ERR(L_PLAYER, mutex_init(&outputs_cb_lck));
+  CHECK_ERR(L_PLAYER, mutex_init(&outputs_quality_lck));
+  CHECK_ERR(L_PLAYER, pthread_rwlock_init(&outputs_device_list_lck, NULL));
+
   CHECK_NULL(L_PLAYER, outputs_deferredev = evtimer_new(evbase_player, deferred_cb, NULL));
 
   no_output = 1;
@@ -1245,6 +1990,18 @@ outputs_init(void)
   for (i = 0; i < ARRAY_SIZE(output_buffer.data); i++)
     output_buffer.data[i].evbuf = evbuffer_new();
 
+  if (cfg_getbool(cfg_getsec(cfg, "general"), "output_threads"))
+    {
+      for (i = 0; outputs[i]; i++)
+	{
+	  if (outputs[i]->disabled || !outputs[i]->write || !outputs[i]->write_threaded)
+	    continue;
+
+	  // If we can't get a thread the output is just written by the player
+	  output_writers[i] = writer_start(outputs[i]);
+	}
+    }
+
   return 0;
 }
 
@@ -1253,6 +2010,13 @@ outputs_deinit(void)
 {
   int i;
 
+  // Writers may still make callbacks while stopping
+  for (i = 0; outputs[i]; i++)
+    {
+      writer_stop(output_writers[i]);
+      output_writers[i] = NULL;
+    }
+
   event_free(outputs_deferredev);
 
   for (i = 0; outputs[i]; i++)
@@ -1274,5 +2038,9 @@ outputs_deinit(void)
 
   for (i = 0; i < ARRAY_SIZE(output_buffer.data); i++)
     evbuffer_free(output_buffer.data[i].evbuf);
+
+  CHECK_ERR(L_PLAYER, pthread_rwlock_destroy(&outputs_device_list_lck));
+  CHECK_ERR(L_PLAYER, pthread_mutex_destroy(&outputs_quality_lck));
+  CHECK_ERR(L_PLAYER, pthread_mutex_destroy(&outputs_cb_lck));
 }
 
@@ -176,6 +176,19 @@ struct output_data
   int samples;
 };
 
+// Used by outputs that send the audio in fixed size packets (e.g. RTP). The
+// packets are cut directly from the output_data buffer, so only a packet that
+// spans two writes from the player needs to be copied.
+struct output_slicer
+{
+  // Holds the start of a packet that spans two writes
+  uint8_t *buf;
+  // Packet size in bytes
+  size_t size;
+  // Number of bytes in buf
+  size_t len;
+};
+
 struct output_buffer
 {
   struct timespec pts;
@@ -200,6 +213,12 @@ struct output_definition
   // Set to 1 if the output initialization failed
   int disabled;
 
+  // Set to 1 if write() may run on a writer thread of its own (see the
+  // output_threads config option). The device functions are then also called
+  // from that thread, and the backend must only use its own state and the
+  // outputs_ functions for backends, not the player's evbase.
+  int write_threaded;
+
   // Initialization function called during startup
   // Output must call device_cb when an output device becomes available/unavailable
   int (*init)(void);
@@ -279,6 +298,15 @@ outputs_quality_unsubscribe(struct media_quality *quality);
 void
 outputs_cb(int callback_id, uint64_t device_id, enum output_device_state);
 
+void
+outputs_slicer_init(struct output_slicer *slicer, size_t packet_size);
+
+void
+outputs_slicer_deinit(struct output_slicer *slicer);
+
+uint8_t *
+outputs_slicer_next(struct output_slicer *slicer, struct output_data *odata, size_t *offset);
+
 /* ---------------------------- Called by player ---------------------------- */
 
 // Ownership of *add is transferred, so don't address after calling. Instead you
@@ -368,6 +396,58 @@ outputs_name(enum output_types type);
 struct output_device *
 outputs_list(void);
 
+struct outputs_writer_stats
+{
+  const char *name;
+  int depth;
+  int depth_max;
+  uint64_t frames;
+  uint64_t overruns;
+  uint64_t resyncs;
+  uint64_t write_last_us;
+  uint64_t write_avg_us;
+  uint64_t write_max_us;
+};
+
+/*
+ * Stats for the outputs that have a writer thread (only if output_threads is
+ * enabled). Depth is the number of frames waiting in the output's queue. An
+ * overrun is a frame that was dropped because the queue was full, after which
+ * the output is resynced by discarding what is queued.
+ *
+ * @out stats    Array that will be filled with the stats
+ * @in  size     Size of the array
+ * @return       Number of outputs in stats
+ */
+int
+outputs_writer_stats_get(struct outputs_writer_stats *stats, int size);
+
+struct outputs_send_stats
+{
+  const char *type_name;
+  char devname[64];
+  uint64_t packets;
+  uint64_t bytes;
+  uint64_t syscalls;
+  uint64_t eagain;
+  uint64_t errors;
+  uint64_t latency_avg_us;
+  uint64_t latency_max_us;
+};
+
+/*
+ * Stats for the devices that are sent RTP packets (AirPlay and Chromecast),
+ * counted from the start of the session with the device. Eagain is the number
+ * of packets dropped because the socket buffer was full, errors are those
+ * dropped because of other send errors. The latency is per send syscall.
+ *
+ * @out stats    Array that will be filled with the stats
+ * @in  size     Size of the array
+ * @return       Number of devices in stats
+ */
+int
+outputs_send_stats_get(struct outputs_send_stats *stats, int size);
+
 int
 outputs_init(void);
 
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2012-2020 Espen Jürgensen <espenjurgensen@gmail.com>
+ * Copyright (C) 2010-2011 Julien BLACHE <jb@jblache.org>
+ *
+ * ALAC encoding adapted from raop_play
+ *   Copyright (C) 2005 Shiro Ninomiya <shiron@snino.com>
+ *   GPLv2+
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdint.h>
+
+#include "alac.h"
+
+/* ALAC "uncompressed" frame writer
+ *
+ * The frame is a 23 bit header followed by the samples as 16 bit big endian,
+ * so every output byte is made of the last bit of one (byteswapped) input byte
+ * and the top 7 bits of the next one:
+ *
+ *   dst[0]     = 0x20            channel=1 (stereo), unknown bits
+ *   dst[1]     = 0x00            unknown bits, hassize=0, unused
+ *   dst[2 + k] = s[k-1] << 1 | s[k] >> 7, with s[-1] = 1 (is-not-compressed)
+ *   dst[2 + n] = s[n-1] << 1
+ *
+ * where s[k] = raw[k ^ 1] is the sample stream swapped to big endian. Since
+ * there is no dependency between output bytes other than s[k-1] we can do 16
+ * bytes at a time with SSE2/NEON. The output is len + 3 bytes.
+ */
+#if defined(__SSE2__)
+# include <emmintrin.h>
+
+static inline int
+alac_encode_simd(uint8_t *dst, uint8_t *raw, int len, uint8_t *carry)
+{
+  __m128i mask = _mm_set1_epi8(0x01);
+  __m128i prev = _mm_cvtsi32_si128(*carry);
+  __m128i x;
+  __m128i cur;
+  __m128i out;
+  int i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      x = _mm_loadu_si128((__m128i *)(raw + i));
+      cur = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+
+      // Shift in the last byte of the previous block to get s[k-1]
+      prev = _mm_or_si128(_mm_slli_si128(cur, 1), prev);
+
+      out = _mm_or_si128(_mm_add_epi8(prev, prev), _mm_and_si128(_mm_srli_epi16(cur, 7), mask));
+      _mm_storeu_si128((__m128i *)(dst + i), out);
+
+      prev = _mm_srli_si128(cur, 15);
+    }
+
+  *carry = _mm_cvtsi128_si32(prev);
+  return i;
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+
+static inline int
+alac_encode_simd(uint8_t *dst, uint8_t *raw, int len, uint8_t *carry)
+{
+  uint8x16_t prev = vdupq_n_u8(*carry);
+  uint8x16_t cur;
+  uint8x16_t out;
+  int i;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      cur = vrev16q_u8(vld1q_u8(raw + i));
+
+      // s[k-1]: last byte of the previous block followed by cur[0..14]
+      out = vorrq_u8(vshlq_n_u8(vextq_u8(prev, cur, 15), 1), vshrq_n_u8(cur, 7));
+      vst1q_u8(dst + i, out);
+
+      prev = cur;
+    }
+
+  *carry = vgetq_lane_u8(prev, 15);
+  return i;
+}
+#else
+static inline int
+alac_encode_simd(uint8_t *dst, uint8_t *raw, int len, uint8_t *carry)
+{
+  return 0;
+}
+#endif
+
+void
+alac_encode(uint8_t *dst, uint8_t *raw, int len)
+{
+  uint8_t carry;
+  uint8_t s;
+  int i;
+
+  dst[0] = 0x20; /* channel=1 (stereo), 4 bits unknown */
+  dst[1] = 0x00; /* 8+4 bits unknown, hassize=0, 2 bits unused */
+  dst += 2;
+
+  carry = 1; /* is-not-compressed */
+
+  i = alac_encode_simd(dst, raw, len, &carry);
+
+  for (; i < len; i++)
+    {
+      s = raw[i ^ 1];
+      dst[i] = (carry << 1) | (s >> 7);
+      carry = s;
+    }
+
+  dst[len] = carry << 1;
+}
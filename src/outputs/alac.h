@@ -0,0 +1,13 @@
+#ifndef __ALAC_H__
+#define __ALAC_H__
+
+#include <stdint.h>
+
+/* Writes raw as an ALAC "uncompressed" frame to dst, which must have room for
+ * len + 3 bytes. Raw data must be little endian, len a multiple of 4 (16 bit
+ * stereo).
+ */
+void
+alac_encode(uint8_t *dst, uint8_t *raw, int len);
+
+#endif /* !__ALAC_H__ */
@@ -1454,6 +1454,7 @@ struct output_definition output_alsa =
   .type = OUTPUT_TYPE_ALSA,
   .priority = 3,
   .disabled = 0,
+  .write_threaded = 1,
   .init = alsa_init,
   .deinit = alsa_deinit,
   .device_start = alsa_device_start,
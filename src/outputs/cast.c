@@ -166,14 +166,18 @@ enum cast_state
 
 struct cast_master_session
 {
-  struct evbuffer *evbuf;
-  int evbuf_samples;
+  // Cuts the player data into packets of rawbuf_size bytes, pending_samples is
+  // the number of samples waiting in it for a full packet
+  struct output_slicer slicer;
+  int pending_samples;
 
   struct rtp_session *rtp_session;
 
+  // Packets for a session, sent by packets_send()
+  struct rtp_batch *batch;
+
   struct media_quality quality;
 
-  uint8_t *rawbuf;
   size_t rawbuf_size;
   int samples_per_packet;
 };
@@ -232,6 +236,8 @@ struct cast_session
   int udp_fd;
   unsigned short udp_port;
 
+  struct rtp_send_stats send_stats;
+
   struct cast_session *next;
 };
 
@@ -544,8 +550,8 @@ master_session_free(struct cast_master_session *cms)
 
   outputs_quality_unsubscribe(&cms->rtp_session->quality);
   rtp_session_free(cms->rtp_session);
-  evbuffer_free(cms->evbuf);
-  free(cms->rawbuf);
+  rtp_batch_free(cms->batch);
+  outputs_slicer_deinit(&cms->slicer);
   free(cms);
 }
 
@@ -573,6 +579,9 @@ cast_session_free(struct cast_session *cs)
   if (!cs)
     return;
 
+  rtp_send_stats_unregister(&cs->send_stats);
+  rtp_send_stats_log(&cs->send_stats, L_CAST, cs->devname);
+
   master_session_cleanup(cs->master_session);
 
   event_free(cs->reply_timeout);
@@ -1446,12 +1455,13 @@ master_session_make(struct media_quality *quality)
       return NULL;
     }
 
+  cms->batch = rtp_batch_new(NULL);
+
   cms->quality = *quality;
   cms->samples_per_packet = CAST_SAMPLES_PER_PACKET;
   cms->rawbuf_size = STOB(cms->samples_per_packet, quality->bits_per_sample, quality->channels);
 
-  CHECK_NULL(L_CAST, cms->rawbuf = malloc(cms->rawbuf_size));
-  CHECK_NULL(L_CAST, cms->evbuf = evbuffer_new());
+  outputs_slicer_init(&cms->slicer, cms->rawbuf_size);
 
   cast_master_session = cms;
 
@@ -1570,6 +1580,8 @@ cast_session_make(struct output_device *device, int family, int callback_id)
 
   cs->devname = strdup(device->name);
   cs->address = strdup(address);
+
+  rtp_send_stats_register(&cs->send_stats, device->type_name, cs->devname);
   cs->family = family;
 
   cs->udp_fd = -1;
@@ -1764,22 +1776,11 @@ packet_prepare(struct rtp_packet *pkt, struct evbuffer *evbuf)
   return evbuffer_remove(evbuf, pkt->payload + CAST_HEADER_SIZE, pkt->payload_len - CAST_HEADER_SIZE);
 }
 
-static int
+// Queues the packet, the caller must flush the batch to actually send it
+static void
 packet_send(struct cast_session *cs, struct rtp_packet *pkt)
 {
-  int ret;
-
-  ret = send(cs->udp_fd, pkt->data, pkt->data_len, 0);
-  if (ret < 0)
-    {
-      DPRINTF(E_LOG, L_CAST, "Send error for '%s': %s\n", cs->devname, strerror(errno));
-      return -1;
-    }
-  else if (ret != pkt->data_len)
-    {
-      DPRINTF(E_WARN, L_CAST, "Partial send (%d) for '%s'\n", ret, cs->devname);
-      return 0;
-    }
+  rtp_batch_add(cs->master_session->batch, cs->udp_fd, NULL, 0, pkt, &cs->send_stats, cs);
 
 /*  DPRINTF(E_DBG, L_CAST, "RTP PACKET seqnum %u, rtptime %u, payload 0x%x, pktbuf_s %zu\n",
     cs->master_session->rtp_session->seqnum,
@@ -1788,7 +1789,6 @@ packet_send(struct cast_session *cs, struct rtp_packet *pkt)
     cs->master_session->rtp_session->pktbuf_len
     );
 */
-  return 0;
 }
 
 static inline int
@@ -1804,26 +1804,33 @@ packets_send(struct cast_session *cs, struct rtp_session *rtp_session)
       if (!pkt)
 	{
 	  DPRINTF(E_WARN, L_CAST, "Packet to '%s' is missing in our buffer\n", cs->devname);
-	  return 0; // Don't fail session over a missing packet (or should we?)
+	  break; // Don't fail session over a missing packet (or should we?)
 	}
 
-      ret = packet_send(cs, pkt);
-      if (ret < 0)
-	return -1;
+      packet_send(cs, pkt);
+    }
+
+  // Flushed per session (one syscall per device) since we might shut down the
+  // session on error, and then its packets must not be left in the batch
+  ret = rtp_batch_flush(cs->master_session->batch);
+  if (ret > 0)
+    {
+      DPRINTF(E_LOG, L_CAST, "Send error for '%s'\n", cs->devname);
+      return -1;
     }
 
   return 0;
 }
 
 static int
-packet_make(struct cast_master_session *cms)
+packet_make(struct cast_master_session *cms, uint8_t *rawbuf)
 {
   struct rtp_packet *pkt;
   int len;
   int ret;
 
   // Encode payload into cast_encoded_data
-  len = payload_encode(cast_encoded_data, cms->rawbuf, cms->rawbuf_size, cms->samples_per_packet, &cms->quality);
+  len = payload_encode(cast_encoded_data, rawbuf, cms->rawbuf_size, cms->samples_per_packet, &cms->quality);
   if (len < 0)
     return -1;
 
@@ -1844,21 +1851,21 @@ packet_make(struct cast_master_session *cms)
 static inline int
 packets_make(struct cast_master_session *cms, struct output_data *odata)
 {
+  uint8_t *rawbuf;
+  size_t offset;
   int ret;
   int npkts;
 
-  // TODO avoid this copy
-  evbuffer_add(cms->evbuf, odata->buffer, odata->bufsize);
-  cms->evbuf_samples += odata->samples;
+  cms->pending_samples += odata->samples;
 
   // Make as many packets as we have data for (one packet requires rawbuf_size bytes)
   npkts = 0;
-  while (evbuffer_get_length(cms->evbuf) >= cms->rawbuf_size)
+  offset = 0;
+  while ((rawbuf = outputs_slicer_next(&cms->slicer, odata, &offset)))
     {
-      evbuffer_remove(cms->evbuf, cms->rawbuf, cms->rawbuf_size);
-      cms->evbuf_samples -= cms->samples_per_packet;
+      cms->pending_samples -= cms->samples_per_packet;
 
-      ret = packet_make(cms);
+      ret = packet_make(cms, rawbuf);
       if (ret == 0)
 	npkts++;
     }
@@ -1886,7 +1893,7 @@ packets_sync_send(struct cast_master_session *cms, struct timespec pts)
 
   clock_gettime(CLOCK_MONOTONIC, &ts);
 
-  cur_stamp.pos = cms->rtp_session->pos + cms->evbuf_samples - cms->output_buffer_samples;
+  cur_stamp.pos = cms->rtp_session->pos + cms->pending_samples - cms->output_buffer_samples;
 
   for (cs = cast_sessions; cs; cs = cs->next)
     {
@@ -510,6 +510,7 @@ struct output_definition output_fifo =
   .type = OUTPUT_TYPE_FIFO,
   .priority = 98,
   .disabled = 0,
+  .write_threaded = 1,
   .init = fifo_init,
   .deinit = fifo_deinit,
   .device_start = fifo_device_start,
@@ -9,10 +9,6 @@
  *   Author: Michael Hanselmann
  *   GPLv2+
  *
- * ALAC encoding adapted from raop_play
- *   Copyright (C) 2005 Shiro Ninomiya <shiron@snino.com>
- *   GPLv2+
- *
  * This program is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
  * the Free Software Foundation; either version 2 of the License, or
@@ -75,6 +71,7 @@
 #include "dmap_common.h"
 #include "rtp_common.h"
 #include "outputs.h"
+#include "alac.h"
 
 #ifdef RAOP_VERIFICATION
 #include "raop_verification.h"
@@ -169,14 +166,18 @@ struct raop_extra
 
 struct raop_master_session
 {
-  struct evbuffer *evbuf;
-  int evbuf_samples;
+  // Cuts the player data into packets of rawbuf_size bytes, pending_samples is
+  // the number of samples waiting in it for a full packet
+  struct output_slicer slicer;
+  int pending_samples;
 
   struct rtp_session *rtp_session;
 
+  // Packets for all the sessions, sent at the end of each write
+  struct rtp_batch *batch;
+
   struct rtcp_timestamp cur_stamp;
 
-  uint8_t *rawbuf;
   size_t rawbuf_size;
   int samples_per_packet;
   bool encrypt;
@@ -244,6 +245,8 @@ struct raop_session
   struct raop_service *timing_svc;
   struct raop_service *control_svc;
 
+  struct rtp_send_stats send_stats;
+
   struct raop_session *next;
 };
 
@@ -355,86 +358,11 @@ static struct raop_session *raop_sessions;
 static int
 raop_device_start(struct output_device *rd, int callback_id);
 
-
-/* ------------------------------- MISC HELPERS ----------------------------- */
-
-/* ALAC bits writer - big endian
- * p    outgoing buffer pointer
- * val  bitfield value
- * blen bitfield length, max 8 bits
- * bpos bit position in the current byte (pointed by *p)
- */
-static inline void
-alac_write_bits(uint8_t **p, uint8_t val, int blen, int *bpos)
-{
-  int lb;
-  int rb;
-  int bd;
-
-  /* Remaining bits in the current byte */
-  lb = 7 - *bpos + 1;
-
-  /* Number of bits overflowing */
-  rb = lb - blen;
-
-  if (rb >= 0)
-    {
-      bd = val << rb;
-      if (*bpos == 0)
-	**p = bd;
-      else
-	**p |= bd;
-
-      /* No over- nor underflow, we're done with this byte */
-      if (rb == 0)
-	{
-	  *p += 1;
-	  *bpos = 0;
-	}
-      else
-	*bpos += blen;
-    }
-  else
-    {
-      /* Fill current byte */
-      bd = val >> -rb;
-      **p |= bd;
-
-      /* Overflow goes to the next byte */
-      *p += 1;
-      **p = val << (8 + rb);
-      *bpos = -rb;
-    }
-}
-
-/* Raw data must be little endian */
 static void
-alac_encode(uint8_t *dst, uint8_t *raw, int len)
-{
-  uint8_t *maxraw;
-  int bpos;
-
-  bpos = 0;
-  maxraw = raw + len;
-
-  alac_write_bits(&dst, 1, 3, &bpos); /* channel=1, stereo */
-  alac_write_bits(&dst, 0, 4, &bpos); /* unknown */
-  alac_write_bits(&dst, 0, 8, &bpos); /* unknown */
-  alac_write_bits(&dst, 0, 4, &bpos); /* unknown */
-  alac_write_bits(&dst, 0, 1, &bpos); /* hassize */
+packet_send_error_cb(void *owner);
 
-  alac_write_bits(&dst, 0, 2, &bpos); /* unused */
-  alac_write_bits(&dst, 1, 1, &bpos); /* is-not-compressed */
 
-  for (; raw < maxraw; raw += 4)
-    {
-      /* Byteswap to big endian */
-      alac_write_bits(&dst, *(raw + 1), 8, &bpos);
-      alac_write_bits(&dst, *raw, 8, &bpos);
-      alac_write_bits(&dst, *(raw + 3), 8, &bpos);
-      alac_write_bits(&dst, *(raw + 2), 8, &bpos);
-    }
-}
+/* ------------------------------- MISC HELPERS ----------------------------- */
 
 /* AirTunes v2 time synchronization helpers */
 static inline void
@@ -1788,13 +1716,14 @@ master_session_make(struct media_quality *quality, bool encrypt)
       return NULL;
     }
 
+  rms->batch = rtp_batch_new(packet_send_error_cb);
+
   rms->encrypt = encrypt;
   rms->samples_per_packet = RAOP_SAMPLES_PER_PACKET;
   rms->rawbuf_size = STOB(rms->samples_per_packet, quality->bits_per_sample, quality->channels);
   rms->output_buffer_samples = OUTPUTS_BUFFER_DURATION * quality->sample_rate;
 
-  CHECK_NULL(L_RAOP, rms->rawbuf = malloc(rms->rawbuf_size));
-  CHECK_NULL(L_RAOP, rms->evbuf = evbuffer_new());
+  outputs_slicer_init(&rms->slicer, rms->rawbuf_size);
 
   rms->next = raop_master_sessions;
   raop_master_sessions = rms;
@@ -1810,8 +1739,8 @@ master_session_free(struct raop_master_session *rms)
 
   outputs_quality_unsubscribe(&rms->rtp_session->quality);
   rtp_session_free(rms->rtp_session);
-  evbuffer_free(rms->evbuf);
-  free(rms->rawbuf);
+  rtp_batch_free(rms->batch);
+  outputs_slicer_deinit(&rms->slicer);
   free(rms);
 }
 
@@ -1850,6 +1779,9 @@ session_free(struct raop_session *rs)
   if (!rs)
     return;
 
+  rtp_send_stats_unregister(&rs->send_stats);
+  rtp_send_stats_log(&rs->send_stats, L_RAOP, rs->devname);
+
   if (rs->master_session)
     master_session_cleanup(rs->master_session);
 
@@ -2084,6 +2016,8 @@ session_make(struct output_device *rd, int callback_id, bool only_probe)
   rs->devname = strdup(rd->name);
   rs->volume = rd->volume;
 
+  rtp_send_stats_register(&rs->send_stats, rd->type_name, rs->devname);
+
   rs->state = RAOP_STATE_STOPPED;
   rs->only_probe = only_probe;
   rs->reqs_in_flight = 0;
@@ -2761,29 +2695,27 @@ packet_prepare(struct rtp_packet *pkt, uint8_t *rawbuf, size_t rawbuf_size, bool
   return 0;
 }
 
+static void
+packet_send_error_cb(void *owner)
+{
+  struct raop_session *rs = owner;
+
+  DPRINTF(E_LOG, L_RAOP, "Send error for '%s'\n", rs->devname);
+
+  // Can't free it right away, it would make the ->next in the calling
+  // master_session and session loops invalid
+  deferred_session_failure(rs);
+}
+
+// Queues the packet in the master session's batch, it will be sent when the
+// batch is flushed, which means the caller can reuse pkt->header right away
 static int
 packet_send(struct raop_session *rs, struct rtp_packet *pkt)
 {
-  int ret;
-
   if (!rs)
     return -1;
 
-  ret = send(rs->server_fd, pkt->data, pkt->data_len, 0);
-  if (ret < 0)
-    {
-      DPRINTF(E_LOG, L_RAOP, "Send error for '%s': %s\n", rs->devname, strerror(errno));
-
-      // Can't free it right away, it would make the ->next in the calling
-      // master_session and session loops invalid
-      deferred_session_failure(rs);
-      return -1;
-    }
-  else if (ret != pkt->data_len)
-    {
-      DPRINTF(E_WARN, L_RAOP, "Partial send (%d) for '%s'\n", ret, rs->devname);
-      return -1;
-    }
+  rtp_batch_add(rs->master_session->batch, rs->server_fd, NULL, 0, pkt, &rs->send_stats, rs);
 
 /*  DPRINTF(E_DBG, L_RAOP, "RTP PACKET seqnum %u, rtptime %u, payload 0x%x, pktbuf_s %zu\n",
     rs->master_session->rtp_session->seqnum,
@@ -2799,7 +2731,6 @@ static void
 control_packet_send(struct raop_session *rs, struct rtp_packet *pkt)
 {
   int len;
-  int ret;
 
   switch (rs->sa.ss.ss_family)
     {
@@ -2818,9 +2749,7 @@ control_packet_send(struct raop_session *rs, struct rtp_packet *pkt)
 	return;
     }
 
-  ret = sendto(rs->control_svc->fd, pkt->data, pkt->data_len, 0, &rs->sa.sa, len);
-  if (ret < 0)
-    DPRINTF(E_LOG, L_RAOP, "Could not send playback sync to device '%s': %s\n", rs->devname, strerror(errno));
+  rtp_batch_add(rs->master_session->batch, rs->control_svc->fd, &rs->sa.sa, len, pkt, &rs->send_stats, rs);
 }
 
 static void
@@ -2847,13 +2776,15 @@ packets_resend(struct raop_session *rs, uint16_t seqnum, int len)
 	pkt_missing = true;
     }
 
+  rtp_batch_flush(rs->master_session->batch);
+
   if (pkt_missing)
     DPRINTF(E_WARN, L_RAOP, "Device '%s' retransmit request for seqnum %" PRIu16 " (len %d) is outside buffer range (last seqnum %" PRIu16 ", len %zu)\n",
       rs->devname, seqnum, len, rtp_session->seqnum - 1, rtp_session->pktbuf_len);
 }
 
 static int
-packets_send(struct raop_master_session *rms)
+packets_send(struct raop_master_session *rms, uint8_t *rawbuf)
 {
   struct rtp_packet *pkt;
   struct raop_session *rs;
@@ -2861,7 +2792,7 @@ packets_send(struct raop_master_session *rms)
 
   pkt = rtp_packet_next(rms->rtp_session, ALAC_HEADER_LEN + rms->rawbuf_size, rms->samples_per_packet, 0x60);
 
-  ret = packet_prepare(pkt, rms->rawbuf, rms->rawbuf_size, rms->encrypt);
+  ret = packet_prepare(pkt, rawbuf, rms->rawbuf_size, rms->encrypt);
   if (ret < 0)
     return -1;
 
@@ -2916,15 +2847,15 @@ timestamp_set(struct raop_master_session *rms, struct timespec ts)
   //   -> we should be playing rtptime X + 600
   //
   // So how do we measure samples received from player? We know that from the
-  // pos, which says how much has been sent to the device, and from rms->evbuf,
-  // which is the unsent stuff being buffered:
-  //   - received = (pos - X) + rms->evbuf_samples
+  // pos, which says how much has been sent to the device, and from the slicer,
+  // which holds the unsent stuff being buffered:
+  //   - received = (pos - X) + rms->pending_samples
   //
   // This means the rtptime is computed as:
   //   - rtptime = X + received - rms->output_buffer_samples
-  //   -> rtptime = X + (pos - X) + rms->evbuf_samples - rms->out_buffer_samples
-  //   -> rtptime = pos + rms->evbuf_samples - rms->output_buffer_samples
-  rms->cur_stamp.pos = rms->rtp_session->pos + rms->evbuf_samples - rms->output_buffer_samples;
+  //   -> rtptime = X + (pos - X) + rms->pending_samples - rms->out_buffer_samples
+  //   -> rtptime = pos + rms->pending_samples - rms->output_buffer_samples
+  rms->cur_stamp.pos = rms->rtp_session->pos + rms->pending_samples - rms->output_buffer_samples;
 }
 
 static void
@@ -4798,6 +4729,8 @@ raop_write(struct output_buffer *obuf)
 {
   struct raop_master_session *rms;
   struct raop_session *rs;
+  uint8_t *rawbuf;
+  size_t offset;
   int i;
 
   for (rms = raop_master_sessions; rms; rms = rms->next)
@@ -4814,19 +4747,20 @@ raop_write(struct output_buffer *obuf)
 	  // Sends sync packets to new sessions, and if it is sync time then also to old sessions
 	  packets_sync_send(rms);
 
-	  // TODO avoid this copy
-	  evbuffer_add(rms->evbuf, obuf->data[i].buffer, obuf->data[i].bufsize);
-	  rms->evbuf_samples += obuf->data[i].samples;
+	  rms->pending_samples += obuf->data[i].samples;
 
 	  // Send as many packets as we have data for (one packet requires rawbuf_size bytes)
-	  while (evbuffer_get_length(rms->evbuf) >= rms->rawbuf_size)
+	  offset = 0;
+	  while ((rawbuf = outputs_slicer_next(&rms->slicer, &obuf->data[i], &offset)))
 	    {
-	      evbuffer_remove(rms->evbuf, rms->rawbuf, rms->rawbuf_size);
-	      rms->evbuf_samples -= rms->samples_per_packet;
+	      rms->pending_samples -= rms->samples_per_packet;
 
-	      packets_send(rms);
+	      packets_send(rms, rawbuf);
 	    }
 	}
+
+      // Sends the sync and audio packets for all the sessions
+      rtp_batch_flush(rms->batch);
     }
 
   // Check for devices that have joined since last write (we have already sent them
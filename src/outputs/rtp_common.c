@@ -29,7 +29,11 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <limits.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #ifdef HAVE_ENDIAN_H
 # include <endian.h>
@@ -46,11 +50,18 @@
 
 #include "logger.h"
 #include "misc.h"
+#include "outputs.h"
 #include "rtp_common.h"
 
 #define RTP_HEADER_LEN        12
 #define RTCP_SYNC_PACKET_LEN  20 
 
+// Max number of packets in a batch, if more are added we flush early. The head
+// is the part of the packet that is copied when added to a batch, it must hold
+// both a RTP header and a sync packet.
+#define RTP_BATCH_SIZE        64
+#define RTP_BATCH_HEAD_LEN    RTCP_SYNC_PACKET_LEN
+
 // NTP timestamp definitions
 #define FRAC             4294967296. // 2^32 as a double
 #define NTP_EPOCH_DELTA  0x83aa7e80  // 2208988800 - that's 1970 - 1900 in seconds
@@ -61,6 +72,32 @@ struct ntp_timestamp
   uint32_t frac;
 };
 
+struct rtp_batch_msg
+{
+  int fd;
+  struct sockaddr_storage ss;
+  socklen_t ss_len;
+
+  uint8_t head[RTP_BATCH_HEAD_LEN];
+  struct iovec iov[2];
+  size_t len;
+
+  struct rtp_send_stats *stats;
+  void *owner;
+};
+
+struct rtp_batch
+{
+  struct rtp_batch_msg msg[RTP_BATCH_SIZE];
+  int len;
+
+  rtp_batch_error_cb error_cb;
+};
+
+// Registered send stats, see rtp_send_stats_register()
+static struct rtp_send_stats *send_stats_list;
+static pthread_mutex_t send_stats_lck = PTHREAD_MUTEX_INITIALIZER;
+
 
 static inline void
 timespec_to_ntp(struct timespec *ts, struct ntp_timestamp *ns)
@@ -285,3 +322,294 @@ rtp_sync_packet_next(struct rtp_session *session, struct rtcp_timestamp cur_stam
   return &session->sync_packet_next;
 }
 
+
+/* ---------------------------- Batched sending ----------------------------- */
+
+#ifndef HAVE_SENDMMSG
+struct mmsghdr
+{
+  struct msghdr msg_hdr;
+  unsigned int msg_len;
+};
+
+static int
+sendmmsg(int fd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+  ssize_t ret;
+  int i;
+
+  for (i = 0; i < vlen; i++)
+    {
+      ret = sendmsg(fd, &msgvec[i].msg_hdr, flags);
+      if (ret < 0)
+	return (i > 0) ? i : -1;
+
+      msgvec[i].msg_len = ret;
+    }
+
+  return i;
+}
+#endif
+
+static inline uint64_t
+usec_since(struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+// Sends the messages given by idx, which must all be for the same fd. Returns
+// the number of messages that failed with other errors than EAGAIN.
+static int
+batch_send(struct rtp_batch *batch, int *idx, int n)
+{
+  struct mmsghdr mmsg[RTP_BATCH_SIZE];
+  struct rtp_batch_msg *msg;
+  struct timespec start;
+  uint64_t latency;
+  int nerrors;
+  int sent;
+  int ret;
+  int i;
+
+  memset(mmsg, 0, n * sizeof(struct mmsghdr));
+
+  for (i = 0; i < n; i++)
+    {
+      msg = &batch->msg[idx[i]];
+
+      mmsg[i].msg_hdr.msg_name = msg->ss_len ? &msg->ss : NULL;
+      mmsg[i].msg_hdr.msg_namelen = msg->ss_len;
+      mmsg[i].msg_hdr.msg_iov = msg->iov;
+      mmsg[i].msg_hdr.msg_iovlen = msg->iov[1].iov_len ? 2 : 1;
+    }
+
+  nerrors = 0;
+  sent = 0;
+  while (sent < n)
+    {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+
+      ret = sendmmsg(batch->msg[idx[sent]].fd, mmsg + sent, n - sent, 0);
+
+      latency = usec_since(&start);
+
+      // Only count the syscall for the receivers that were part of it
+      for (i = sent; i < n; i++)
+	{
+	  msg = &batch->msg[idx[i]];
+	  if (i > sent && msg->stats == batch->msg[idx[i - 1]].stats)
+	    continue;
+
+	  __atomic_add_fetch(&msg->stats->syscalls, 1, __ATOMIC_RELAXED);
+	  __atomic_add_fetch(&msg->stats->latency_us, latency, __ATOMIC_RELAXED);
+	  if (latency > __atomic_load_n(&msg->stats->latency_max_us, __ATOMIC_RELAXED))
+	    __atomic_store_n(&msg->stats->latency_max_us, latency, __ATOMIC_RELAXED);
+	}
+
+      if (ret < 0 && errno == EINTR)
+	continue;
+      else if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	{
+	  // Socket buffer is full, so no point trying the rest now. Dropping is
+	  // what the network would have done anyway, and the receivers can ask
+	  // for retransmission.
+	  for (i = sent; i < n; i++)
+	    __atomic_add_fetch(&batch->msg[idx[i]].stats->eagain, 1, __ATOMIC_RELAXED);
+
+	  break;
+	}
+      else if (ret < 0)
+	{
+	  // The first message failed, skip it and carry on with the rest
+	  msg = &batch->msg[idx[sent]];
+
+	  DPRINTF(E_LOG, L_PLAYER, "RTP send error: %s\n", strerror(errno));
+
+	  __atomic_add_fetch(&msg->stats->errors, 1, __ATOMIC_RELAXED);
+	  nerrors++;
+
+	  if (batch->error_cb)
+	    batch->error_cb(msg->owner);
+
+	  sent++;
+	  continue;
+	}
+
+      for (i = sent; i < sent + ret; i++)
+	{
+	  msg = &batch->msg[idx[i]];
+
+	  if (mmsg[i].msg_len != msg->len)
+	    DPRINTF(E_WARN, L_PLAYER, "Partial RTP send (%u of %zu bytes)\n", mmsg[i].msg_len, msg->len);
+
+	  __atomic_add_fetch(&msg->stats->packets, 1, __ATOMIC_RELAXED);
+	  __atomic_add_fetch(&msg->stats->bytes, mmsg[i].msg_len, __ATOMIC_RELAXED);
+	}
+
+      sent += ret;
+    }
+
+  return nerrors;
+}
+
+struct rtp_batch *
+rtp_batch_new(rtp_batch_error_cb error_cb)
+{
+  struct rtp_batch *batch;
+
+  CHECK_NULL(L_PLAYER, batch = calloc(1, sizeof(struct rtp_batch)));
+
+  batch->error_cb = error_cb;
+
+  return batch;
+}
+
+void
+rtp_batch_free(struct rtp_batch *batch)
+{
+  if (!batch)
+    return;
+
+  free(batch);
+}
+
+void
+rtp_batch_add(struct rtp_batch *batch, int fd, struct sockaddr *sa, socklen_t sa_len, struct rtp_packet *pkt, struct rtp_send_stats *stats, void *owner)
+{
+  struct rtp_batch_msg *msg;
+  size_t head_len;
+
+  if (batch->len == RTP_BATCH_SIZE)
+    rtp_batch_flush(batch);
+
+  msg = &batch->msg[batch->len];
+
+  msg->fd = fd;
+  msg->ss_len = (sa && sa_len <= sizeof(msg->ss)) ? sa_len : 0;
+  if (msg->ss_len)
+    memcpy(&msg->ss, sa, sa_len);
+
+  // The head is copied, since the caller will often modify it for the next
+  // receiver (e.g. RTP marker or sync packet type), but the payload, which is
+  // the same for all receivers, we just point to
+  head_len = MIN(pkt->data_len, RTP_BATCH_HEAD_LEN);
+  memcpy(msg->head, pkt->data, head_len);
+
+  msg->iov[0].iov_base = msg->head;
+  msg->iov[0].iov_len = head_len;
+  msg->iov[1].iov_base = pkt->data + head_len;
+  msg->iov[1].iov_len = pkt->data_len - head_len;
+  msg->len = pkt->data_len;
+
+  msg->stats = stats;
+  msg->owner = owner;
+
+  batch->len++;
+}
+
+int
+rtp_batch_flush(struct rtp_batch *batch)
+{
+  int idx[RTP_BATCH_SIZE];
+  bool done[RTP_BATCH_SIZE] = { false };
+  int nerrors;
+  int n;
+  int i;
+  int j;
+
+  nerrors = 0;
+
+  // sendmmsg() is per socket, so we group the messages by fd, keeping the
+  // order of the packets for each fd
+  for (i = 0; i < batch->len; i++)
+    {
+      if (done[i])
+	continue;
+
+      for (j = i, n = 0; j < batch->len; j++)
+	{
+	  if (done[j] || batch->msg[j].fd != batch->msg[i].fd)
+	    continue;
+
+	  idx[n++] = j;
+	  done[j] = true;
+	}
+
+      nerrors += batch_send(batch, idx, n);
+    }
+
+  batch->len = 0;
+
+  return nerrors;
+}
+
+void
+rtp_send_stats_register(struct rtp_send_stats *stats, const char *type_name, const char *devname)
+{
+  stats->type_name = type_name;
+  stats->devname = devname;
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&send_stats_lck));
+  stats->next = send_stats_list;
+  send_stats_list = stats;
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&send_stats_lck));
+}
+
+void
+rtp_send_stats_unregister(struct rtp_send_stats *stats)
+{
+  struct rtp_send_stats **s;
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&send_stats_lck));
+  for (s = &send_stats_list; *s; s = &(*s)->next)
+    {
+      if (*s != stats)
+	continue;
+
+      *s = stats->next;
+      break;
+    }
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&send_stats_lck));
+
+  stats->next = NULL;
+}
+
+int
+rtp_send_stats_get(struct outputs_send_stats *stats, int size)
+{
+  struct rtp_send_stats *s;
+  int n;
+
+  CHECK_ERR(L_PLAYER, pthread_mutex_lock(&send_stats_lck));
+  for (s = send_stats_list, n = 0; s && n < size; s = s->next, n++)
+    {
+      stats[n].type_name = s->type_name;
+      snprintf(stats[n].devname, sizeof(stats[n].devname), "%s", s->devname);
+      stats[n].packets = __atomic_load_n(&s->packets, __ATOMIC_RELAXED);
+      stats[n].bytes = __atomic_load_n(&s->bytes, __ATOMIC_RELAXED);
+      stats[n].syscalls = __atomic_load_n(&s->syscalls, __ATOMIC_RELAXED);
+      stats[n].eagain = __atomic_load_n(&s->eagain, __ATOMIC_RELAXED);
+      stats[n].errors = __atomic_load_n(&s->errors, __ATOMIC_RELAXED);
+      stats[n].latency_avg_us = stats[n].syscalls ? __atomic_load_n(&s->latency_us, __ATOMIC_RELAXED) / stats[n].syscalls : 0;
+      stats[n].latency_max_us = __atomic_load_n(&s->latency_max_us, __ATOMIC_RELAXED);
+    }
+  CHECK_ERR(L_PLAYER, pthread_mutex_unlock(&send_stats_lck));
+
+  return n;
+}
+
+void
+rtp_send_stats_log(struct rtp_send_stats *stats, int domain, const char *devname)
+{
+  if (!stats->syscalls)
+    return;
+
+  DPRINTF(E_DBG, domain, "Sent %" PRIu64 " packets (%" PRIu64 " bytes) to '%s' in %" PRIu64 " syscalls, avg/max send latency %" PRIu64 "/%" PRIu64 " us, "
+    "%" PRIu64 " dropped on EAGAIN, %" PRIu64 " send errors\n",
+    stats->packets, stats->bytes, devname, stats->syscalls, stats->latency_us / stats->syscalls, stats->latency_max_us,
+    stats->eagain, stats->errors);
+}
@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <sys/types.h>
+#include <sys/socket.h>
 
 struct rtcp_timestamp
 {
@@ -52,6 +54,31 @@ struct rtp_session
   struct rtp_packet sync_packet_next;
 };
 
+// Per receiver counters for packets sent through a batch
+struct rtp_send_stats
+{
+  uint64_t packets;
+  uint64_t bytes;
+  uint64_t syscalls;
+  uint64_t eagain;     // Packets dropped because the socket buffer was full
+  uint64_t errors;     // Packets dropped because of other send errors
+  uint64_t latency_us; // Sum of time spent in the send syscalls
+  uint64_t latency_max_us;
+
+  // Set by rtp_send_stats_register(), for outputs_send_stats_get()
+  const char *type_name;
+  const char *devname;
+  struct rtp_send_stats *next;
+};
+
+struct outputs_send_stats;
+
+typedef void (*rtp_batch_error_cb)(void *owner);
+
+// Packets queued for all receivers in an RTP session during one write, sent
+// with as few syscalls as possible by rtp_batch_flush()
+struct rtp_batch;
+
 
 struct rtp_session *
 rtp_session_new(struct media_quality *quality, int pktbuf_size, int sync_each_nsamples);
@@ -77,4 +104,38 @@ rtp_sync_is_time(struct rtp_session *session);
 struct rtp_packet *
 rtp_sync_packet_next(struct rtp_session *session, struct rtcp_timestamp cur_stamp, char type);
 
+struct rtp_batch *
+rtp_batch_new(rtp_batch_error_cb error_cb);
+
+void
+rtp_batch_free(struct rtp_batch *batch);
+
+// Queues pkt for sending on fd (to sa, if the socket isn't connected). The
+// start of the packet is copied, so the caller may modify the RTP header or a
+// sync packet for the next receiver, but the rest of pkt->data must remain
+// valid until the batch is flushed. The stats and owner are for the receiver,
+// the latter is what will be given to the error callback if sending fails.
+void
+rtp_batch_add(struct rtp_batch *batch, int fd, struct sockaddr *sa, socklen_t sa_len, struct rtp_packet *pkt, struct rtp_send_stats *stats, void *owner);
+
+// Sends all queued packets. Returns the number of packets that failed with an
+// error other than EAGAIN, for each of these the error callback is also made.
+int
+rtp_batch_flush(struct rtp_batch *batch);
+
+// The counters are updated by the thread that flushes the batch, registered
+// stats can also be read from other threads with rtp_send_stats_get(). The
+// names must remain valid until the stats are unregistered.
+void
+rtp_send_stats_register(struct rtp_send_stats *stats, const char *type_name, const char *devname);
+
+void
+rtp_send_stats_unregister(struct rtp_send_stats *stats);
+
+int
+rtp_send_stats_get(struct outputs_send_stats *stats, int size);
+
+void
+rtp_send_stats_log(struct rtp_send_stats *stats, int domain, const char *devname);
+
 #endif  /* !__RTP_COMMON_H__ */
@@ -35,10 +35,11 @@
  *
  * Listener events
  * ---------------
- * Events will be signaled via listener_notify(). The following rules apply to
- * how this must be done in the code:
- * - always use status_update() to make sure the callbacks that the listener
- *   makes do not block the player thread, and to avoid any risk of deadlocks
+ * Events will be signaled via listener_notify(). The callbacks run in the
+ * listener thread, not in the player thread. The following rules apply to how
+ * this must be done in the code:
+ * - always use status_update() to make sure the status snapshot that the
+ *   listeners will read has been updated first
  * - if the event is a result of an external command then trigger it when the
  *   command is completed, so generally in a bottom half
  *
@@ -346,11 +347,38 @@ struct metadata_pending_register
 } metadata_pending[16];
 
 
+// The player publishes its status and the speaker list after each change, and
+// the status also on each playback tick. Other threads read them from these
+// snapshots (see the seqlock helpers), so status polls don't need to make a
+// command and wake up the player thread.
+#define PLAYER_SNAPSHOT_SPEAKERS_MAX 64
+
+struct player_status_snapshot
+{
+  uint32_t seq;
+  struct player_status status;
+};
+
+struct player_speakers_snapshot
+{
+  uint32_t seq;
+  // -1 if there were more speakers than we have room for
+  int count;
+  struct player_speaker_info spk[PLAYER_SNAPSHOT_SPEAKERS_MAX];
+};
+
+static struct player_status_snapshot status_snapshot;
+static struct player_speakers_snapshot speakers_snapshot;
+
+
 /* -------------------------------- Forwards -------------------------------- */
 
 static void
 pb_abort(void);
 
+static void
+device_to_speaker_info(struct player_speaker_info *spk, struct output_device *device);
+
 static int
 pb_suspend(void);
 
@@ -385,6 +413,71 @@ scrobble_cb(void *arg)
 }
 #endif
 
+static void
+status_fill(struct player_status *status)
+{
+  memset(status, 0, sizeof(struct player_status));
+
+  status->shuffle = shuffle;
+  status->consume = consume;
+  status->repeat = repeat;
+
+  status->volume = outputs_volume_get();
+
+  status->plid = cur_plid;
+
+  if (player_state == PLAY_STOPPED || !pb_session.playing_now)
+    {
+      status->status = PLAY_STOPPED;
+      return;
+    }
+
+  // While buffering we report that we are paused
+  if (player_state == PLAY_PLAYING && pb_session.playing_now->play_start != 0 && pb_session.pos >= pb_session.playing_now->play_start)
+    status->status = PLAY_PLAYING;
+  else
+    status->status = PLAY_PAUSED;
+
+  status->id      = pb_session.playing_now->id;
+  status->item_id = pb_session.playing_now->item_id;
+
+  status->pos_ms  = pb_session.playing_now->pos_ms;
+  status->len_ms  = pb_session.playing_now->len_ms;
+}
+
+static void
+snapshot_status_publish(void)
+{
+  struct player_status status;
+
+  status_fill(&status);
+
+  seqlock_write_begin(&status_snapshot.seq);
+  status_snapshot.status = status;
+  seqlock_write_end(&status_snapshot.seq);
+}
+
+static void
+snapshot_speakers_publish(void)
+{
+  struct output_device *device;
+  int count;
+
+  seqlock_write_begin(&speakers_snapshot.seq);
+
+  for (device = outputs_list(), count = 0; device; device = device->next, count++)
+    {
+      if (count == ARRAY_SIZE(speakers_snapshot.spk))
+	break;
+
+      device_to_speaker_info(&speakers_snapshot.spk[count], device);
+    }
+
+  speakers_snapshot.count = device ? -1 : count;
+
+  seqlock_write_end(&speakers_snapshot.seq);
+}
+
 // This is just to be able to log the caller in a simple way
 #define status_update(x, y) status_update_impl((x), (y), __func__)
 static void
@@ -394,6 +487,11 @@ status_update_impl(enum play_status status, short listener_events, const char *c
 
   player_state = status;
 
+  // Publish before notifying, so listeners will read the new state
+  snapshot_status_publish();
+  if (listener_events & (LISTENER_SPEAKER | LISTENER_VOLUME))
+    snapshot_speakers_publish();
+
   listener_notify(listener_events);
 }
 
@@ -679,9 +777,35 @@ source_stop(void)
   input_stop();
 }
 
+/*
+ * Tells the input what will follow the given source, so it can be opened
+ * before the source ends. Like queue_item_next(), except it doesn't wrap
+ * around a shuffled queue, since that would reshuffle it.
+ */
+static void
+source_preopen(struct player_source *ps)
+{
+  struct db_queue_item *queue_item;
+
+  if (repeat == REPEAT_SONG)
+    queue_item = db_queue_fetch_byitemid(ps->item_id);
+  else
+    {
+      queue_item = db_queue_fetch_next(ps->item_id, shuffle);
+      if (!queue_item && repeat == REPEAT_ALL && !shuffle)
+	queue_item = db_queue_fetch_bypos(0, shuffle);
+    }
+
+  input_preopen(queue_item ? queue_item->id : 0);
+
+  free_queue_item(queue_item, 0);
+}
+
 static int
 source_start(struct player_source *ps)
 {
+  int ret;
+
   if (!ps)
     return 0;
 
@@ -689,7 +813,11 @@ source_start(struct player_source *ps)
 
   input_flush(NULL);
 
-  return input_seek(ps->item_id, (int)ps->seek_ms);
+  ret = input_seek(ps->item_id, (int)ps->seek_ms);
+  if (ret >= 0)
+    source_preopen(ps);
+
+  return ret;
 }
 
 static void
@@ -701,6 +829,8 @@ source_next(struct player_source *ps)
   DPRINTF(E_DBG, L_PLAYER, "Opening next track: '%s' (id=%d)\n", ps->path, ps->item_id);
 
   input_start(ps->item_id);
+
+  source_preopen(ps);
 }
 
 static int
@@ -713,6 +843,8 @@ source_restart(struct player_source *ps)
   // source_restart() -> input_resume()
   input_resume(ps->item_id, ps->pos_ms);
 
+  source_preopen(ps);
+
   return 0;
 }
 
@@ -1169,9 +1301,11 @@ event_read(int nsamples)
 
 /* ---- Main playback stuff: Start, read, write and playback timer event ---- */
 
-// Returns -1 on error or bytes read (possibly 0)
+// Returns -1 on error or bytes read (possibly 0). Sets *buf to point at the
+// data, which is either in the input buffer or, when streaming silence, in the
+// session buffer.
 static inline int
-source_read(int *nbytes, int *nsamples, uint8_t *buf, int len)
+source_read(int *nbytes, int *nsamples, uint8_t **buf, int len)
 {
   short flag;
   void *flagdata;
@@ -1198,12 +1332,13 @@ source_read(int *nbytes, int *nsamples, uint8_t *buf, int len)
 	}
 
       // Stream silence if playback didn't end yet
-      memset(buf, 0, len);
+      memset(pb_session.buffer, 0, len);
+      *buf = pb_session.buffer;
       return 0;
     }
 
   *nsamples = 0;
-  *nbytes = input_read(buf, len, &flag, &flagdata);
+  *nbytes = input_read_ptr(buf, len, &flag, &flagdata);
   if ((*nbytes < 0) || (flag == INPUT_FLAG_ERROR))
     {
       DPRINTF(E_LOG, L_PLAYER, "Error reading source '%s' (id=%d)\n", pb_session.reading_now->path, pb_session.reading_now->id);
@@ -1245,6 +1380,7 @@ playback_cb(int fd, short what, void *arg)
 {
   struct timespec ts;
   uint64_t overrun;
+  uint8_t *buf;
   int nbytes;
   int nsamples;
   int i;
@@ -1307,7 +1443,7 @@ playback_cb(int fd, short what, void *arg)
   // should not bring us further behind, even if there is no data.
   for (i = 1 + overrun; i > 0; i--)
     {
-      ret = source_read(&nbytes, &nsamples, pb_session.buffer, pb_session.bufsize);
+      ret = source_read(&nbytes, &nsamples, &buf, pb_session.bufsize);
       if (ret < 0)
 	{
 	  DPRINTF(E_LOG, L_PLAYER, "Error reading from source\n");
@@ -1321,7 +1457,7 @@ playback_cb(int fd, short what, void *arg)
 
       pb_session.read_deficit -= nbytes;
 
-      outputs_write(pb_session.buffer, nbytes, nsamples, &pb_session.quality, &pb_session.pts);
+      outputs_write(buf, nbytes, nsamples, &pb_session.quality, &pb_session.pts);
 
       if (nbytes < pb_session.bufsize)
 	{
@@ -1355,6 +1491,9 @@ playback_cb(int fd, short what, void *arg)
       if (player_flush_pending == 0)
 	input_buffer_full_cb(player_playback_start);
     }
+
+  // Position has changed
+  snapshot_status_publish();
 }
 
 
@@ -1879,58 +2018,7 @@ get_status(void *arg, int *retval)
 {
   struct player_status *status = arg;
 
-  memset(status, 0, sizeof(struct player_status));
-
-  status->shuffle = shuffle;
-  status->consume = consume;
-  status->repeat = repeat;
-
-  status->volume = outputs_volume_get();
-
-  status->plid = cur_plid;
-
-  switch (player_state)
-    {
-      case PLAY_STOPPED:
-	DPRINTF(E_DBG, L_PLAYER, "Player status: stopped\n");
-
-	status->status  = PLAY_STOPPED;
-	break;
-
-      case PLAY_PAUSED:
-	DPRINTF(E_DBG, L_PLAYER, "Player status: paused\n");
-
-	status->status  = PLAY_PAUSED;
-	status->id      = pb_session.playing_now->id;
-	status->item_id = pb_session.playing_now->item_id;
-
-	status->pos_ms  = pb_session.playing_now->pos_ms;
-	status->len_ms  = pb_session.playing_now->len_ms;
-
-	break;
-
-      case PLAY_PLAYING:
-	if (pb_session.playing_now->play_start == 0 || pb_session.pos < pb_session.playing_now->play_start)
-	  {
-	    DPRINTF(E_DBG, L_PLAYER, "Player status: playing (buffering)\n");
-
-	    status->status = PLAY_PAUSED;
-	  }
-	else
-	  {
-	    DPRINTF(E_DBG, L_PLAYER, "Player status: playing\n");
-
-	    status->status = PLAY_PLAYING;
-	  }
-
-	status->id      = pb_session.playing_now->id;
-	status->item_id = pb_session.playing_now->item_id;
-
-	status->pos_ms  = pb_session.playing_now->pos_ms;
-	status->len_ms  = pb_session.playing_now->len_ms;
-
-	break;
-    }
+  status_fill(status);
 
   *retval = 0;
   return COMMAND_END;
@@ -3041,6 +3129,9 @@ playerqueue_plid(void *arg, int *retval)
   union player_arg *cmdarg = arg;
   cur_plid = cmdarg->id;
 
+  // The plid is part of the status, so readers must see the new one
+  snapshot_status_publish();
+
   *retval = 0;
   return COMMAND_END;
 }
@@ -3057,10 +3148,16 @@ playerqueue_generic_bh(void *arg, int *retval)
 int
 player_get_status(struct player_status *status)
 {
-  int ret;
+  uint32_t seq;
 
-  ret = commands_exec_sync(cmdbase, get_status, NULL, status);
-  return ret;
+  do
+    {
+      seq = seqlock_read_begin(&status_snapshot.seq);
+      *status = status_snapshot.status;
+    }
+  while (seqlock_read_retry(&status_snapshot.seq, seq));
+
+  return 0;
 }
 
 
@@ -3075,10 +3172,14 @@ player_get_status(struct player_status *status)
 int
 player_playing_now(uint32_t *id)
 {
-  int ret;
+  struct player_status status;
 
-  ret = commands_exec_sync(cmdbase, playing_now, NULL, id);
-  return ret;
+  player_get_status(&status);
+  if (status.status == PLAY_STOPPED)
+    return -1;
+
+  *id = status.id;
+  return 0;
 }
 
 /*
@@ -3211,7 +3312,32 @@ void
 player_speaker_enumerate(spk_enum_cb cb, void *arg)
 {
   struct spk_enum spk_enum;
+  struct player_speaker_info *spk;
+  uint32_t seq;
+  int count;
+  int i;
 
+  CHECK_NULL(L_PLAYER, spk = malloc(sizeof(speakers_snapshot.spk)));
+
+  do
+    {
+      seq = seqlock_read_begin(&speakers_snapshot.seq);
+      count = speakers_snapshot.count;
+      if (count > 0)
+	memcpy(spk, speakers_snapshot.spk, count * sizeof(struct player_speaker_info));
+    }
+  while (seqlock_read_retry(&speakers_snapshot.seq, seq));
+
+  // Callbacks are made after copying, so they can take their time
+  for (i = 0; i < count; i++)
+    cb(&spk[i], arg);
+
+  free(spk);
+
+  if (count >= 0)
+    return;
+
+  // Too many speakers for the snapshot, so we have to ask the player
   spk_enum.cb = cb;
   spk_enum.arg = arg;
 
@@ -3635,6 +3761,9 @@ player_init(void)
       goto error_outputs_deinit;
     }
 
+  snapshot_status_publish();
+  snapshot_speakers_publish();
+
   ret = pthread_create(&tid_player, NULL, player, NULL);
   if (ret < 0)
     {
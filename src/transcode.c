@@ -22,6 +22,7 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -230,6 +231,20 @@ init_settings(struct settings_ctx *settings, enum transcode_profile profile, str
 	settings->sample_format = AV_SAMPLE_FMT_S16; // Only libopus support
 	break;
 
+      case XCODE_OGG:
+	settings->encode_audio = 1;
+	settings->format = "ogg";
+	settings->audio_codec = AV_CODEC_ID_OPUS;
+	settings->sample_format = AV_SAMPLE_FMT_S16; // Only libopus support
+	break;
+
+      case XCODE_FLAC:
+	settings->encode_audio = 1;
+	settings->format = "flac";
+	settings->audio_codec = AV_CODEC_ID_FLAC;
+	settings->sample_format = AV_SAMPLE_FMT_S16;
+	break;
+
       case XCODE_JPEG:
 	settings->encode_video = 1;
 	settings->silent = 1;
@@ -1577,6 +1592,20 @@ transcode_encode(struct evbuffer *evbuf, struct encode_ctx *ctx, transcode_frame
   return ret;
 }
 
+int
+transcode_encode_header(struct evbuffer *evbuf, struct encode_ctx *ctx)
+{
+  int ret;
+
+  avio_flush(ctx->ofmt_ctx->pb);
+
+  ret = evbuffer_get_length(ctx->obuf);
+
+  evbuffer_add_buffer(evbuf, ctx->obuf);
+
+  return ret;
+}
+
 int
 transcode(struct evbuffer *evbuf, int *icy_timer, struct transcode_ctx *ctx, int want_bytes)
 {
@@ -1666,15 +1695,15 @@ transcode_frame_free(transcode_frame *frame)
 
 /*                                  Seeking                                  */
 
-int
-transcode_seek(struct transcode_ctx *ctx, int ms)
+// Seeks to the packet at or before ms, so that read_packet() will resume with
+// it. Returns the pts of that packet relative to the stream start, in the time
+// base of the stream.
+static int
+seek_packet(struct decode_ctx *dec_ctx, int ms, int64_t *got_pts)
 {
-  struct decode_ctx *dec_ctx = ctx->decode_ctx;
   struct stream_ctx *s;
   int64_t start_time;
   int64_t target_pts;
-  int64_t got_pts;
-  int got_ms;
   int ret;
 
   s = &dec_ctx->audio_stream;
@@ -1731,13 +1760,28 @@ transcode_seek(struct transcode_ctx *ctx, int ms)
   // Tell read_packet() to resume with dec_ctx->packet
   dec_ctx->resume = 1;
 
-  // Compute position in ms from pts
-  got_pts = dec_ctx->packet->pts;
+  *got_pts = dec_ctx->packet->pts;
 
   if ((start_time != AV_NOPTS_VALUE) && (start_time > 0))
-    got_pts -= start_time;
+    *got_pts -= start_time;
 
-  got_pts = av_rescale_q(got_pts, s->stream->time_base, AV_TIME_BASE_Q);
+  return 0;
+}
+
+int
+transcode_seek(struct transcode_ctx *ctx, int ms)
+{
+  struct decode_ctx *dec_ctx = ctx->decode_ctx;
+  int64_t got_pts;
+  int got_ms;
+  int ret;
+
+  ret = seek_packet(dec_ctx, ms, &got_pts);
+  if (ret < 0)
+    return -1;
+
+  // Compute position in ms from pts
+  got_pts = av_rescale_q(got_pts, dec_ctx->audio_stream.stream->time_base, AV_TIME_BASE_Q);
   got_ms = got_pts / (AV_TIME_BASE / 1000);
 
   // Since negative return would mean error, we disallow it here
@@ -1749,6 +1793,67 @@ transcode_seek(struct transcode_ctx *ctx, int ms)
   return got_ms;
 }
 
+int64_t
+transcode_seek_samples(struct transcode_ctx *ctx, int ms, int sample_rate)
+{
+  struct decode_ctx *dec_ctx = ctx->decode_ctx;
+  int64_t got_pts;
+  int64_t got_samples;
+  int ret;
+
+  ret = seek_packet(dec_ctx, ms, &got_pts);
+  if (ret < 0)
+    return -1;
+
+  // Exact if the stream time base is 1/sample_rate, which it usually is for
+  // audio files
+  got_samples = av_rescale_q(got_pts, dec_ctx->audio_stream.stream->time_base, (AVRational){ 1, sample_rate });
+  if (got_samples < 0)
+    got_samples = 0;
+
+  DPRINTF(E_DBG, L_XCODE, "Seek wanted %d ms, got sample %" PRIi64 " (%d Hz)\n", ms, got_samples, sample_rate);
+
+  return got_samples;
+}
+
+int
+transcode_seek_bytes(struct transcode_ctx *ctx, int64_t offset, int preroll_ms, int64_t *skip)
+{
+  struct settings_ctx *settings = &ctx->encode_ctx->settings;
+  int64_t header_len;
+  int64_t target;
+  int64_t got;
+  int bpf;
+  int ms;
+
+  header_len = settings->wavheader ? sizeof(ctx->encode_ctx->header) : 0;
+  bpf = settings->channels * av_get_bytes_per_sample(settings->sample_format);
+
+  // By default everything up to the offset is transcoded and dropped
+  *skip = offset;
+
+  if ((offset < header_len) || (bpf <= 0))
+    return 0;
+
+  target = (offset - header_len) / bpf;
+  ms = target * 1000 / settings->sample_rate - preroll_ms;
+  if (ms <= preroll_ms)
+    return 0;
+
+  got = transcode_seek_samples(ctx, ms, settings->sample_rate);
+  if ((got < 0) || (got > target))
+    {
+      DPRINTF(E_WARN, L_XCODE, "Seek to sample %" PRIi64 " failed, transcoding from the start\n", target);
+
+      return (transcode_seek(ctx, 0) < 0) ? -1 : 0;
+    }
+
+  // The WAV header is still first in the output, and then comes sample "got"
+  *skip = header_len + (target - got) * bpf + (offset - header_len) % bpf;
+
+  return 0;
+}
+
 /*                                  Querying                                 */
 
 int
@@ -23,6 +23,10 @@ enum transcode_profile
   XCODE_MP3,
   // Transcodes the best audio stream into OPUS
   XCODE_OPUS,
+  // Transcodes the best audio stream into OPUS in an Ogg container
+  XCODE_OGG,
+  // Transcodes the best audio stream into FLAC
+  XCODE_FLAC,
   // Transcodes the best video stream into JPEG/PNG
   XCODE_JPEG,
   XCODE_PNG,
@@ -88,6 +92,16 @@ transcode_decode(transcode_frame **frame, struct decode_ctx *ctx);
 int
 transcode_encode(struct evbuffer *evbuf, struct encode_ctx *ctx, transcode_frame *frame, int eof);
 
+/* Gets the stream header that the muxer wrote when the encoder was set up, e.g.
+ * the Ogg or FLAC headers. Must be called before the first transcode_encode().
+ *
+ * @out evbuf      An evbuffer filled with the header
+ * @in  ctx        Encode context
+ * @return         Bytes added
+ */
+int
+transcode_encode_header(struct evbuffer *evbuf, struct encode_ctx *ctx);
+
 /* Demuxes, decodes, encodes and remuxes from the input.
  *
  * @out evbuf      An evbuffer filled with remuxed data
@@ -125,6 +139,34 @@ transcode_frame_free(transcode_frame *frame);
 int
 transcode_seek(struct transcode_ctx *ctx, int ms);
 
+/* Like transcode_seek(), but returns the actual position as a sample count at
+ * the given (output) sample rate. Lets the caller position PCM output exactly
+ * by discarding the samples between the returned and the wanted position.
+ *
+ * @in  ctx         Transcode context
+ * @in  ms          Requested seek position in ms
+ * @in  sample_rate Sample rate that the position should be returned in
+ * @return          Negative if error, otherwise actual seek position
+ */
+int64_t
+transcode_seek_samples(struct transcode_ctx *ctx, int ms, int sample_rate);
+
+/* Positions PCM output (XCODE_PCM* profiles) at a byte offset of the output of
+ * a transcode from the start, without transcoding everything before it. The
+ * decoder seeks to preroll_ms before the offset, so the caller must drop the
+ * first *skip bytes of the following output, which include the WAV header. If
+ * the offset is too close to the start, or if seeking fails, the transcode
+ * starts from the beginning and *skip is the offset.
+ *
+ * @in  ctx         Transcode context
+ * @in  offset      Wanted byte offset in the output
+ * @in  preroll_ms  How far before the offset the decoder should start
+ * @out skip        Number of bytes to drop from the output
+ * @return          Negative if error, otherwise 0
+ */
+int
+transcode_seek_bytes(struct transcode_ctx *ctx, int64_t offset, int preroll_ms, int64_t *skip);
+
 /* Query for information about a media file opened by transcode_decode_setup()
  *
  * @in  ctx        Decode context
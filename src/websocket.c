@@ -28,12 +28,16 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <sys/stat.h>
 
 #include "conffile.h"
+#include "httpd_jsonapi.h"
 #include "listener.h"
 #include "logger.h"
+#include "misc.h"
 
 
 static struct lws_context *context;
@@ -41,22 +45,33 @@ static pthread_t tid_websocket;
 
 static int websocket_port;
 static bool websocket_exit = false;
+// Events are held back this long, so that bursts are sent as one message
+static int websocket_debounce_ms;
 
-// Event mask of events to notify websocket clients
+// Event mask of events to notify websocket clients, set by the listener thread
 static short websocket_events;
-// Event mask of events processed by the writeable callback
-static short websocket_write_events;
+// Queue version from the last LISTENER_QUEUE event, set by the listener thread
+static int websocket_queue_version;
+// The message for the last events, made once and written to all sessions. It
+// is preceded by LWS_PRE bytes of headroom for lws_write().
+static unsigned char *websocket_msg;
+static size_t websocket_msg_len;
 // Counter for events to keep track of when to write
 static unsigned short websocket_write_events_counter;
 
 
 
-/* Thread: library (the thread the event occurred) */
+/* Thread: listener */
 static void
-listener_cb(short event_mask)
+listener_cb(short event_mask, const struct listener_event_data *data)
 {
-  // Add event to the event mask, clients will be notified at the next break of the libwebsockets service loop
-  websocket_events |= event_mask;
+  if ((event_mask & LISTENER_QUEUE) && data->queue_version)
+    __atomic_store_n(&websocket_queue_version, data->queue_version, __ATOMIC_RELAXED);
+
+  // Add event to the event mask, clients will be notified at the next break of
+  // the libwebsockets service loop, which we wake up
+  __atomic_or_fetch(&websocket_events, event_mask, __ATOMIC_RELEASE);
+  lws_cancel_service(context);
 }
 
 /*
@@ -180,21 +195,30 @@ process_notify_request(struct ws_session_data_notify *session_data, void *in, si
 }
 
 /*
- * Notify clients of the notify-protocol about occurred events
- *
- * Sends a JSON message of the form:
+ * Makes the message for the given events, which is then written to all
+ * clients of the notify-protocol. The message is a JSON object of the form:
  *
  * {
- *   "notify": [ "update" ]
+ *   "notify": [ "update", "player", "outputs", "volume", "queue" ],
+ *   "player": { ... },
+ *   "outputs": [ { ... } ],
+ *   "queue": { "version": 12 }
  * }
+ *
+ * Only "notify" is always present. "player" has the same fields as
+ * /api/player, "outputs" has all outputs like /api/outputs, and "queue" has
+ * the new queue version. They hold the full state, not changes, so a client
+ * that missed a message is still up to date after the next one. If one of
+ * them is missing, the client must fetch the state from the JSON API.
  */
 static void
-send_notify_reply(short events, struct lws* wsi)
+notify_msg_make(short events)
 {
-  unsigned char* buf;
-  const char* json_response;
-  json_object* reply;
-  json_object* notify;
+  const char *json_response;
+  json_object *reply;
+  json_object *notify;
+  json_object *obj;
+  int queue_version;
 
   notify = json_object_new_array();
   if (events & LISTENER_UPDATE)
@@ -241,13 +265,27 @@ send_notify_reply(short events, struct lws* wsi)
   reply = json_object_new_object();
   json_object_object_add(reply, "notify", notify);
 
+  if ((events & (LISTENER_PLAYER | LISTENER_OPTIONS | LISTENER_VOLUME)) && (obj = jsonapi_player_to_json(false)))
+    json_object_object_add(reply, "player", obj);
+
+  if (events & (LISTENER_SPEAKER | LISTENER_VOLUME))
+    json_object_object_add(reply, "outputs", jsonapi_outputs_to_json());
+
+  queue_version = __atomic_load_n(&websocket_queue_version, __ATOMIC_RELAXED);
+  if ((events & LISTENER_QUEUE) && queue_version)
+    {
+      obj = json_object_new_object();
+      json_object_object_add(obj, "version", json_object_new_int(queue_version));
+      json_object_object_add(reply, "queue", obj);
+    }
+
   json_response = json_object_to_json_string(reply);
 
-  buf = malloc(LWS_PRE + strlen(json_response));
-  memcpy(&buf[LWS_PRE], json_response, strlen(json_response));
-  lws_write(wsi, &buf[LWS_PRE], strlen(json_response), LWS_WRITE_TEXT);
+  free(websocket_msg);
+  websocket_msg_len = strlen(json_response);
+  CHECK_NULL(L_WEB, websocket_msg = malloc(LWS_PRE + websocket_msg_len));
+  memcpy(&websocket_msg[LWS_PRE], json_response, websocket_msg_len);
 
-  free(buf);
   json_object_put(reply);
 }
 
@@ -274,9 +312,11 @@ callback_notify(struct lws *wsi, enum lws_callback_reasons reason, void *user, v
 	break;
 
       case LWS_CALLBACK_SERVER_WRITEABLE:
-	if (websocket_write_events && (websocket_write_events_counter != session_data->counter))
+	// lws_write() only uses the headroom before the message, so all sessions
+	// can write the same message
+	if (websocket_msg && (websocket_write_events_counter != session_data->counter))
 	  {
-	    send_notify_reply(websocket_write_events, wsi);
+	    lws_write(wsi, &websocket_msg[LWS_PRE], websocket_msg_len, LWS_WRITE_TEXT);
 	    session_data->counter = websocket_write_events_counter;
 	  }
 	break;
@@ -316,26 +356,64 @@ static struct lws_protocols protocols[] =
 };
 
 
+static uint64_t
+now_ms(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
 /* Thread: websocket */
 static void *
 websocket(void *arg)
 {
+  uint64_t pending_since;
+  uint64_t now;
+  short events;
+  int timeout;
+
   listener_add(listener_cb, LISTENER_UPDATE | LISTENER_DATABASE | LISTENER_PAIRING | LISTENER_SPOTIFY | LISTENER_LASTFM | LISTENER_SPEAKER
 	       | LISTENER_PLAYER | LISTENER_OPTIONS | LISTENER_VOLUME | LISTENER_QUEUE);
 
+  pending_since = 0;
+  timeout = 1000;
   while(!websocket_exit)
     {
-      lws_service(context, 1000);
-      if (websocket_events)
+      lws_service(context, timeout);
+
+      timeout = 1000;
+      if (!__atomic_load_n(&websocket_events, __ATOMIC_ACQUIRE))
+	continue;
+
+      now = now_ms();
+      if (!pending_since)
+	pending_since = now;
+
+      if (now < pending_since + websocket_debounce_ms)
 	{
-	  websocket_write_events = websocket_events;
-	  websocket_write_events_counter++;
-	  websocket_events = 0;
-	  lws_callback_on_writable_all_protocol(context, &protocols[WS_PROTOCOL_NOTIFY]);
+	  timeout = pending_since + websocket_debounce_ms - now;
+	  continue;
 	}
+
+      events = __atomic_exchange_n(&websocket_events, 0, __ATOMIC_ACQUIRE);
+      pending_since = 0;
+
+      notify_msg_make(events);
+      websocket_write_events_counter++;
+      lws_callback_on_writable_all_protocol(context, &protocols[WS_PROTOCOL_NOTIFY]);
     }
 
+  // Makes sure listener_cb() won't touch the context after it is destroyed
+  listener_remove(listener_cb);
+
   lws_context_destroy(context);
+
+  free(websocket_msg);
+  websocket_msg = NULL;
+
   pthread_exit(NULL);
 }
 
@@ -378,6 +456,7 @@ websocket_init(void)
   int ret;
 
   websocket_port = cfg_getint(cfg_getsec(cfg, "general"), "websocket_port");
+  websocket_debounce_ms = cfg_getint(cfg_getsec(cfg, "general"), "websocket_debounce_ms");
 
   if (websocket_port <= 0)
     {
@@ -0,0 +1,217 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Times the ALAC frame writer on RAOP packets (352 samples of 44100/16/2):
+ *
+ *  - bit writer: the writer from raop.c before it was vectorized (same as the
+ *    reference in check_alac.c)
+ *  - scalar: one output byte per input byte, i.e. alac_encode() without SSE2
+ *    or NEON
+ *  - alac_encode: 16 bytes at a time where SSE2/NEON is available
+ *
+ * Usage: bench_alac [<seconds of audio>]
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "outputs/alac.h"
+
+#define BENCH_SECONDS 600
+#define BENCH_RUNS 5
+#define BENCH_SAMPLE_RATE 44100
+#define BENCH_PACKET_SAMPLES 352
+#define BENCH_PACKET_LEN (4 * BENCH_PACKET_SAMPLES)
+
+typedef void (*bench_cb)(uint8_t *dst, uint8_t *raw, int len);
+
+
+/* ----------------------------- Frame writers ------------------------------ */
+
+static void
+bits_write(uint8_t **p, uint8_t val, int blen, int *bpos)
+{
+  int lb;
+  int rb;
+  int bd;
+
+  lb = 7 - *bpos + 1;
+  rb = lb - blen;
+
+  if (rb >= 0)
+    {
+      bd = val << rb;
+      if (*bpos == 0)
+	**p = bd;
+      else
+	**p |= bd;
+
+      if (rb == 0)
+	{
+	  *p += 1;
+	  *bpos = 0;
+	}
+      else
+	*bpos += blen;
+    }
+  else
+    {
+      bd = val >> -rb;
+      **p |= bd;
+
+      *p += 1;
+      **p = val << (8 + rb);
+      *bpos = -rb;
+    }
+}
+
+static void
+encode_bits(uint8_t *dst, uint8_t *raw, int len)
+{
+  uint8_t *maxraw;
+  int bpos;
+
+  bpos = 0;
+  maxraw = raw + len;
+
+  bits_write(&dst, 1, 3, &bpos); /* channel=1, stereo */
+  bits_write(&dst, 0, 4, &bpos); /* unknown */
+  bits_write(&dst, 0, 8, &bpos); /* unknown */
+  bits_write(&dst, 0, 4, &bpos); /* unknown */
+  bits_write(&dst, 0, 1, &bpos); /* hassize */
+
+  bits_write(&dst, 0, 2, &bpos); /* unused */
+  bits_write(&dst, 1, 1, &bpos); /* is-not-compressed */
+
+  for (; raw < maxraw; raw += 4)
+    {
+      bits_write(&dst, *(raw + 1), 8, &bpos);
+      bits_write(&dst, *raw, 8, &bpos);
+      bits_write(&dst, *(raw + 3), 8, &bpos);
+      bits_write(&dst, *(raw + 2), 8, &bpos);
+    }
+}
+
+// The tail loop of alac_encode()
+static void
+encode_scalar(uint8_t *dst, uint8_t *raw, int len)
+{
+  uint8_t carry;
+  uint8_t s;
+  int i;
+
+  dst[0] = 0x20;
+  dst[1] = 0x00;
+  dst += 2;
+
+  carry = 1;
+
+  for (i = 0; i < len; i++)
+    {
+      s = raw[i ^ 1];
+      dst[i] = (carry << 1) | (s >> 7);
+      carry = s;
+    }
+
+  dst[len] = carry << 1;
+}
+
+
+/* ------------------------------- Helpers ---------------------------------- */
+
+static void
+bench_run(const char *name, bench_cb cb, uint8_t *raw, int npackets, int seconds, uint32_t *sum)
+{
+  uint8_t dst[BENCH_PACKET_LEN + 3];
+  struct timespec start;
+  struct timespec end;
+  double secs;
+  double best;
+  int run;
+  int i;
+
+  best = 0;
+  for (run = 0; run < BENCH_RUNS; run++)
+    {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+
+      for (i = 0; i < npackets; i++)
+	{
+	  cb(dst, raw + (i % 64) * BENCH_PACKET_LEN, BENCH_PACKET_LEN);
+	  *sum += dst[i % sizeof(dst)];
+	}
+
+      clock_gettime(CLOCK_MONOTONIC, &end);
+
+      secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+      if (run == 0 || secs < best)
+	best = secs;
+    }
+
+  printf("%-12s %8.1f ms, %6.2f us/s of audio, %8.0f MB/s (best of %d)\n",
+    name, best * 1e3, best * 1e6 / seconds, (double)npackets * BENCH_PACKET_LEN / best / 1e6, BENCH_RUNS);
+}
+
+int
+main(int argc, char **argv)
+{
+  uint8_t *raw;
+  uint32_t sum;
+  int seconds;
+  int npackets;
+  int i;
+
+  seconds = (argc > 1) ? atoi(argv[1]) : BENCH_SECONDS;
+  if (seconds <= 0)
+    {
+      fprintf(stderr, "Usage: %s [<seconds of audio>]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  npackets = (int)((int64_t)seconds * BENCH_SAMPLE_RATE / BENCH_PACKET_SAMPLES);
+
+  // A few packets of noise, cycled through so they stay in the cache
+  raw = malloc(64 * BENCH_PACKET_LEN);
+  if (!raw)
+    return EXIT_FAILURE;
+
+  srand(1);
+  for (i = 0; i < 64 * BENCH_PACKET_LEN; i++)
+    raw[i] = rand() & 0xff;
+
+  printf("%d packets of %d samples (%d s of audio)\n", npackets, BENCH_PACKET_SAMPLES, seconds);
+
+  sum = 0;
+  bench_run("bit writer", encode_bits, raw, npackets, seconds, &sum);
+  bench_run("scalar", encode_scalar, raw, npackets, seconds, &sum);
+  bench_run("alac_encode", alac_encode, raw, npackets, seconds, &sum);
+
+  free(raw);
+
+  // Printed so the frames are kept
+  printf("(checksum %" PRIu32 ")\n", sum);
+
+  return EXIT_SUCCESS;
+}
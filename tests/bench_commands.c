@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measures round-trip latency of sync commands and throughput of sync and
+ * async commands between caller threads and an event loop thread.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <event2/event.h>
+#include <event2/thread.h>
+
+#include "logger.h"
+#include "misc.h"
+#include "commands.h"
+
+#define BENCH_ROUNDS 20000
+#define BENCH_THREADS_MAX 4
+
+struct bench_arg
+{
+  struct commands_base *cmdbase;
+  int rounds;
+  int sync;
+};
+
+static enum command_state
+bench_noop(void *arg, int *retval)
+{
+  *retval = 0;
+  return COMMAND_END;
+}
+
+static void *
+bench_loop(void *arg)
+{
+  struct event_base *evbase = arg;
+
+  event_base_dispatch(evbase);
+
+  pthread_exit(NULL);
+}
+
+static void *
+bench_caller(void *arg)
+{
+  struct bench_arg *barg = arg;
+  int i;
+
+  for (i = 0; i < barg->rounds; i++)
+    {
+      if (barg->sync)
+	commands_exec_sync(barg->cmdbase, bench_noop, NULL, NULL);
+      else
+	commands_exec_async(barg->cmdbase, bench_noop, NULL);
+    }
+
+  // Makes sure the async commands have been executed before we return
+  if (!barg->sync)
+    commands_exec_sync(barg->cmdbase, bench_noop, NULL, NULL);
+
+  pthread_exit(NULL);
+}
+
+static double
+bench_run(struct commands_base *cmdbase, int nthreads, int sync)
+{
+  struct bench_arg barg = { cmdbase, BENCH_ROUNDS, sync };
+  pthread_t tid[BENCH_THREADS_MAX];
+  struct timespec start;
+  struct timespec end;
+  int i;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0; i < nthreads; i++)
+    CHECK_ERR(L_MAIN, pthread_create(&tid[i], NULL, bench_caller, &barg));
+
+  for (i = 0; i < nthreads; i++)
+    CHECK_ERR(L_MAIN, pthread_join(tid[i], NULL));
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int
+main(int argc, char **argv)
+{
+  struct event_base *evbase;
+  struct commands_base *cmdbase;
+  pthread_t tid;
+  double secs;
+  int calls;
+  int n;
+
+  if (logger_init(NULL, NULL, E_LOG) != 0)
+    return EXIT_FAILURE;
+
+  evthread_use_pthreads();
+
+  CHECK_NULL(L_MAIN, evbase = event_base_new());
+  CHECK_NULL(L_MAIN, cmdbase = commands_base_new(evbase, NULL));
+  CHECK_ERR(L_MAIN, pthread_create(&tid, NULL, bench_loop, evbase));
+
+  for (n = 1; n <= BENCH_THREADS_MAX; n *= 2)
+    {
+      calls = n * BENCH_ROUNDS;
+
+      secs = bench_run(cmdbase, n, 1);
+      printf("%d caller thread(s), sync: %.2f us per round-trip, %.0f calls/s\n",
+	n, secs * 1e6 / BENCH_ROUNDS, calls / secs);
+
+      secs = bench_run(cmdbase, n, 0);
+      printf("%d caller thread(s), async: %.0f calls/s\n", n, calls / secs);
+    }
+
+  commands_base_destroy(cmdbase);
+  CHECK_ERR(L_MAIN, pthread_join(tid, NULL));
+  event_base_free(evbase);
+
+  logger_deinit();
+
+  return EXIT_SUCCESS;
+}
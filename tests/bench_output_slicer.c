@@ -0,0 +1,315 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Feeds player ticks of 44100/16/2 audio through the output fan-out to a
+ * number of packet based sessions (RAOP and Cast packet sizes), first the way
+ * it was done before output_slicer, and then with outputs_slicer_next().
+ * Reports the bytes copied and the time taken per second of audio.
+ *
+ * Before: buffer_fill() copied the player data to the evbuffer of element 0,
+ * each session appended it to its own evbuffer and then removed it again into
+ * a packet buffer, i.e. three copies of everything. After: packets are cut
+ * from the player data, and only the ones spanning two ticks are copied.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include <event2/event.h>
+#include <event2/buffer.h>
+#include <libavformat/avformat.h>
+
+#include "logger.h"
+#include "misc.h"
+#include "http.h"
+#include "db.h"
+#include "player.h"
+#include "worker.h"
+#include "outputs.h"
+
+#define BENCH_SAMPLE_RATE 44100
+#define BENCH_SECONDS 600
+#define BENCH_SESSIONS_MAX 8
+// Samples per player tick (PLAYER_TICK_INTERVAL is 10 ms)
+#define BENCH_TICK_SAMPLES 441
+
+struct bench_result
+{
+  uint64_t copied;
+  uint64_t packets;
+  double secs;
+};
+
+
+/* -------------------------------- Stubs ----------------------------------- */
+
+// The bench only uses the slicer, these are what the rest of outputs.c refers to
+struct output_definition output_raop;
+struct output_definition output_streaming;
+struct output_definition output_dummy;
+struct output_definition output_fifo;
+#ifdef HAVE_ALSA
+struct output_definition output_alsa;
+#endif
+#ifdef HAVE_LIBPULSE
+struct output_definition output_pulse;
+#endif
+#ifdef CHROMECAST
+struct output_definition output_cast;
+#endif
+
+struct event_base *evbase_player;
+
+// Needed by transcode.c, see check_transcode_seek
+struct http_icy_metadata *
+http_icy_metadata_get(AVFormatContext *fmtctx, int packet_only)
+{
+  return NULL;
+}
+
+int
+db_speaker_save(struct output_device *device)
+{
+  return 0;
+}
+
+int
+db_speaker_get(struct output_device *device, uint64_t id)
+{
+  return -1;
+}
+
+const char *
+player_pmap(void *p)
+{
+  return NULL;
+}
+
+void
+worker_execute(void (*cb)(void *), void *cb_arg, size_t arg_size, int delay)
+{
+}
+
+int
+rtp_send_stats_get(struct outputs_send_stats *stats, int size)
+{
+  return 0;
+}
+
+
+/* ------------------------------- Helpers ---------------------------------- */
+
+static double
+elapsed(struct timespec *start)
+{
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Sums up the packets, so the compiler can't skip reading them
+static uint32_t
+packet_consume(uint8_t *packet, size_t len)
+{
+  uint32_t sum = 0;
+  size_t i;
+
+  for (i = 0; i < len; i += 64)
+    sum += packet[i];
+
+  return sum;
+}
+
+static void
+bench_before(struct bench_result *res, uint8_t *pcm, size_t tick_len, size_t packet_len, int nsessions, uint32_t *sum)
+{
+  struct evbuffer *obuf_evbuf;
+  struct evbuffer *evbuf[BENCH_SESSIONS_MAX];
+  struct timespec start;
+  uint8_t *rawbuf;
+  int ticks;
+  int i;
+  int j;
+
+  CHECK_NULL(L_MAIN, obuf_evbuf = evbuffer_new());
+  CHECK_NULL(L_MAIN, rawbuf = malloc(packet_len));
+  for (j = 0; j < nsessions; j++)
+    CHECK_NULL(L_MAIN, evbuf[j] = evbuffer_new());
+
+  memset(res, 0, sizeof(struct bench_result));
+  ticks = BENCH_SECONDS * BENCH_SAMPLE_RATE / BENCH_TICK_SAMPLES;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0; i < ticks; i++)
+    {
+      // buffer_fill()
+      evbuffer_add(obuf_evbuf, pcm, tick_len);
+      res->copied += tick_len;
+
+      // The sessions' write(), reading from element 0
+      for (j = 0; j < nsessions; j++)
+	{
+	  evbuffer_add(evbuf[j], evbuffer_pullup(obuf_evbuf, -1), tick_len);
+	  res->copied += tick_len;
+
+	  while (evbuffer_get_length(evbuf[j]) >= packet_len)
+	    {
+	      evbuffer_remove(evbuf[j], rawbuf, packet_len);
+	      res->copied += packet_len;
+	      res->packets++;
+	      *sum += packet_consume(rawbuf, packet_len);
+	    }
+	}
+
+      // buffer_drain()
+      evbuffer_drain(obuf_evbuf, tick_len);
+    }
+
+  res->secs = elapsed(&start);
+
+  for (j = 0; j < nsessions; j++)
+    evbuffer_free(evbuf[j]);
+  free(rawbuf);
+  evbuffer_free(obuf_evbuf);
+}
+
+static void
+bench_after(struct bench_result *res, uint8_t *pcm, size_t tick_len, size_t packet_len, int nsessions, uint32_t *sum)
+{
+  struct output_slicer slicer[BENCH_SESSIONS_MAX];
+  struct output_data odata;
+  struct timespec start;
+  uint8_t *packet;
+  size_t offset;
+  size_t pending;
+  int ticks;
+  int i;
+  int j;
+
+  for (j = 0; j < nsessions; j++)
+    outputs_slicer_init(&slicer[j], packet_len);
+
+  memset(res, 0, sizeof(struct bench_result));
+  memset(&odata, 0, sizeof(struct output_data));
+  ticks = BENCH_SECONDS * BENCH_SAMPLE_RATE / BENCH_TICK_SAMPLES;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0; i < ticks; i++)
+    {
+      // buffer_fill() only points element 0 at the player's data
+      odata.buffer = pcm;
+      odata.bufsize = tick_len;
+
+      for (j = 0; j < nsessions; j++)
+	{
+	  offset = 0;
+	  while (1)
+	    {
+	      pending = slicer[j].len;
+	      packet = outputs_slicer_next(&slicer[j], &odata, &offset);
+	      if (!packet)
+		{
+		  // The remainder was saved for the next tick
+		  res->copied += slicer[j].len - pending;
+		  break;
+		}
+
+	      // Assembled from two ticks
+	      if (packet == slicer[j].buf)
+		res->copied += packet_len - pending;
+
+	      res->packets++;
+	      *sum += packet_consume(packet, packet_len);
+	    }
+	}
+    }
+
+  res->secs = elapsed(&start);
+
+  for (j = 0; j < nsessions; j++)
+    outputs_slicer_deinit(&slicer[j]);
+}
+
+static void
+bench_print(const char *name, struct bench_result *res)
+{
+  printf("  %-7s %10.0f bytes copied/s of audio, %6.0f packets/s, %6.2f us/s of audio\n",
+    name, (double)res->copied / BENCH_SECONDS, (double)res->packets / BENCH_SECONDS, res->secs * 1e6 / BENCH_SECONDS);
+}
+
+int
+main(int argc, char **argv)
+{
+  struct bench_result before;
+  struct bench_result after;
+  size_t packet_sizes[] = { 352, 960 };
+  size_t tick_len;
+  size_t packet_len;
+  uint8_t *pcm;
+  uint32_t sum;
+  int nsessions;
+  int i;
+  int j;
+
+  if (logger_init(NULL, NULL, E_LOG) != 0)
+    return EXIT_FAILURE;
+
+  tick_len = STOB(BENCH_TICK_SAMPLES, 16, 2);
+  CHECK_NULL(L_MAIN, pcm = malloc(tick_len));
+  for (i = 0; i < tick_len; i++)
+    pcm[i] = i;
+
+  sum = 0;
+  for (i = 0; i < ARRAY_SIZE(packet_sizes); i++)
+    {
+      packet_len = STOB(packet_sizes[i], 16, 2);
+
+      for (nsessions = 1; nsessions <= BENCH_SESSIONS_MAX; nsessions *= 2)
+	{
+	  bench_before(&before, pcm, tick_len, packet_len, nsessions, &sum);
+	  bench_after(&after, pcm, tick_len, packet_len, nsessions, &sum);
+
+	  printf("%zu samples per packet, %d session(s):\n", packet_sizes[i], nsessions);
+	  bench_print("before", &before);
+	  bench_print("after", &after);
+
+	  j = before.copied ? (int)(100 * after.copied / before.copied) : 0;
+	  printf("  copies reduced to %d%%\n", j);
+	}
+    }
+
+  free(pcm);
+
+  logger_deinit();
+
+  // Printed so the packet reads are kept
+  printf("(checksum %" PRIu32 ")\n", sum);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Polls a simulated player for its status, now playing and speakers from a
+ * number of client threads, first through seqlock snapshots like the player
+ * publishes them, and then through commands to the player thread. Reports the
+ * poll rate and how often the player thread was woken up. The player thread
+ * has a playback tick that updates the status, so wakeups during the snapshot
+ * run are from the ticks.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <event2/event.h>
+#include <event2/thread.h>
+
+#include "logger.h"
+#include "misc.h"
+#include "commands.h"
+#include "player.h"
+
+#define BENCH_CLIENTS 100
+#define BENCH_POLLS 100
+#define BENCH_SPEAKERS 8
+#define BENCH_TICK_USEC 10000
+
+struct status_snapshot
+{
+  uint32_t seq;
+  struct player_status status;
+};
+
+struct speakers_snapshot
+{
+  uint32_t seq;
+  int count;
+  struct player_speaker_info spk[BENCH_SPEAKERS];
+};
+
+static struct event_base *evbase;
+static struct commands_base *cmdbase;
+static struct event *tickev;
+
+// Owned by the player thread
+static struct player_status player_status;
+static struct player_speaker_info player_speakers[BENCH_SPEAKERS];
+
+static struct status_snapshot status_snapshot;
+static struct speakers_snapshot speakers_snapshot;
+
+
+/* ----------------------------- Player thread ------------------------------ */
+
+static void
+snapshot_status_publish(void)
+{
+  seqlock_write_begin(&status_snapshot.seq);
+  status_snapshot.status = player_status;
+  seqlock_write_end(&status_snapshot.seq);
+}
+
+static void
+snapshot_speakers_publish(void)
+{
+  seqlock_write_begin(&speakers_snapshot.seq);
+  memcpy(speakers_snapshot.spk, player_speakers, sizeof(player_speakers));
+  speakers_snapshot.count = BENCH_SPEAKERS;
+  seqlock_write_end(&speakers_snapshot.seq);
+}
+
+static void
+playback_tick_cb(int fd, short what, void *arg)
+{
+  player_status.pos_ms += BENCH_TICK_USEC / 1000;
+  if (player_status.pos_ms >= player_status.len_ms)
+    {
+      player_status.pos_ms = 0;
+      player_status.id++;
+      player_status.item_id++;
+    }
+
+  snapshot_status_publish();
+}
+
+static enum command_state
+get_status(void *arg, int *retval)
+{
+  struct player_status *status = arg;
+
+  *status = player_status;
+
+  *retval = 0;
+  return COMMAND_END;
+}
+
+static enum command_state
+playing_now(void *arg, int *retval)
+{
+  uint32_t *id = arg;
+
+  *id = player_status.id;
+
+  *retval = 0;
+  return COMMAND_END;
+}
+
+static enum command_state
+speaker_enumerate(void *arg, int *retval)
+{
+  struct player_speaker_info *spk = arg;
+
+  memcpy(spk, player_speakers, sizeof(player_speakers));
+
+  *retval = 0;
+  return COMMAND_END;
+}
+
+static void *
+player(void *arg)
+{
+  event_base_dispatch(evbase);
+
+  pthread_exit(NULL);
+}
+
+static void
+player_setup(void)
+{
+  struct timeval tv = { 0, BENCH_TICK_USEC };
+  int i;
+
+  memset(&player_status, 0, sizeof(player_status));
+  player_status.status = PLAY_PLAYING;
+  player_status.volume = 50;
+  player_status.id = 1;
+  player_status.item_id = 1;
+  player_status.len_ms = 180000;
+
+  memset(player_speakers, 0, sizeof(player_speakers));
+  for (i = 0; i < BENCH_SPEAKERS; i++)
+    {
+      player_speakers[i].id = i + 1;
+      snprintf(player_speakers[i].name, sizeof(player_speakers[i].name), "Speaker %d", i + 1);
+      snprintf(player_speakers[i].output_type, sizeof(player_speakers[i].output_type), "AirPlay");
+      player_speakers[i].selected = (i == 0);
+      player_speakers[i].absvol = 50;
+      player_speakers[i].relvol = 100;
+    }
+
+  snapshot_status_publish();
+  snapshot_speakers_publish();
+
+  CHECK_NULL(L_MAIN, evbase = event_base_new());
+  CHECK_NULL(L_MAIN, cmdbase = commands_base_new(evbase, NULL));
+  CHECK_NULL(L_MAIN, tickev = event_new(evbase, -1, EV_PERSIST, playback_tick_cb, NULL));
+  event_add(tickev, &tv);
+}
+
+
+/* ----------------------------- Client threads ----------------------------- */
+
+// Each poll is what e.g. a DACP playstatusupdate or a MPD status asks for
+static void *
+client(void *arg)
+{
+  bool use_commands = *(bool *)arg;
+  struct player_status status;
+  struct player_speaker_info *spk;
+  uint32_t id;
+  uint32_t seq;
+  int count;
+  int i;
+
+  CHECK_NULL(L_MAIN, spk = malloc(sizeof(player_speakers)));
+
+  for (i = 0; i < BENCH_POLLS; i++)
+    {
+      if (use_commands)
+	{
+	  commands_exec_sync(cmdbase, get_status, NULL, &status);
+	  commands_exec_sync(cmdbase, playing_now, NULL, &id);
+	  commands_exec_sync(cmdbase, speaker_enumerate, NULL, spk);
+	  continue;
+	}
+
+      do
+	{
+	  seq = seqlock_read_begin(&status_snapshot.seq);
+	  status = status_snapshot.status;
+	}
+      while (seqlock_read_retry(&status_snapshot.seq, seq));
+
+      do
+	{
+	  seq = seqlock_read_begin(&status_snapshot.seq);
+	  id = status_snapshot.status.id;
+	}
+      while (seqlock_read_retry(&status_snapshot.seq, seq));
+
+      do
+	{
+	  seq = seqlock_read_begin(&speakers_snapshot.seq);
+	  count = speakers_snapshot.count;
+	  memcpy(spk, speakers_snapshot.spk, count * sizeof(struct player_speaker_info));
+	}
+      while (seqlock_read_retry(&speakers_snapshot.seq, seq));
+    }
+
+  free(spk);
+
+  pthread_exit(NULL);
+}
+
+static void
+bench_run(bool use_commands)
+{
+  pthread_t tid[BENCH_CLIENTS];
+  struct timespec start;
+  struct timespec end;
+  uint64_t wakeups_start;
+  uint64_t wakeups_end;
+  uint64_t executed_start;
+  uint64_t executed_end;
+  double secs;
+  int n;
+  int i;
+
+  commands_stats_get(cmdbase, &wakeups_start, &executed_start);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (i = 0, n = 0; i < BENCH_CLIENTS; i++, n++)
+    {
+      if (pthread_create(&tid[i], NULL, client, &use_commands) != 0)
+	break;
+    }
+
+  for (i = 0; i < n; i++)
+    pthread_join(tid[i], NULL);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  commands_stats_get(cmdbase, &wakeups_end, &executed_end);
+
+  secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+  printf("%d clients x %d polls %s: %.0f polls/s, %" PRIu64 " player wakeups, %" PRIu64 " commands\n",
+    n, BENCH_POLLS, use_commands ? "via commands" : "via snapshot", n * BENCH_POLLS / secs,
+    wakeups_end - wakeups_start, executed_end - executed_start);
+}
+
+int
+main(int argc, char **argv)
+{
+  pthread_t tid;
+
+  if (logger_init(NULL, NULL, E_LOG) != 0)
+    return EXIT_FAILURE;
+
+  evthread_use_pthreads();
+
+  player_setup();
+
+  CHECK_ERR(L_MAIN, pthread_create(&tid, NULL, player, NULL));
+
+  bench_run(false);
+  bench_run(true);
+
+  // Stops the loop, since the tick event would keep it running
+  event_del(tickev);
+  commands_base_destroy(cmdbase);
+  CHECK_ERR(L_MAIN, pthread_join(tid, NULL));
+
+  event_free(tickev);
+  event_base_free(evbase);
+
+  logger_deinit();
+
+  return EXIT_SUCCESS;
+}
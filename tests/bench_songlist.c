@@ -0,0 +1,343 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Times a full library songlist (like a DAAP client's initial sync) over a
+ * temporary database with a generated library:
+ *
+ *  - fetch as text: steps the query and reads every column as text, parsing
+ *    the integer ones, like db_query_fetch_file() and its users did before
+ *    integer columns were fetched natively
+ *  - fetch: db_query_fetch_file()
+ *  - songlist: db_query_fetch_file() and DMAP encoding of all fields
+ *
+ * Usage: bench_songlist [<number of files>]
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <pwd.h>
+
+#include <sqlite3.h>
+#include <event2/buffer.h>
+
+#include "logger.h"
+#include "conffile.h"
+#include "misc.h"
+#include "db.h"
+#include "httpd.h"
+#include "dmap_common.h"
+#include "cache.h"
+#include "listener.h"
+#include "library.h"
+#include "worker.h"
+
+#define BENCH_FILES 20000
+#define BENCH_RUNS 5
+
+typedef void (*bench_cb)(uint64_t *sum);
+
+
+/* -------------------------------- Stubs ----------------------------------- */
+
+void
+cache_daap_suspend(void)
+{
+}
+
+void
+cache_daap_resume(void)
+{
+}
+
+void
+library_update_trigger(short update_events)
+{
+}
+
+void
+listener_notify_data(short event_mask, const struct listener_event_data *data)
+{
+}
+
+void
+worker_execute(void (*cb)(void *), void *cb_arg, size_t arg_size, int delay)
+{
+}
+
+void
+httpd_send_reply(struct evhttp_request *req, int code, const char *reason, struct evbuffer *evbuf, enum httpd_send_flags flags)
+{
+}
+
+void
+httpd_send_error(struct evhttp_request *req, int error, const char *reason)
+{
+}
+
+
+/* ------------------------------- Helpers ---------------------------------- */
+
+static int
+library_make(int nfiles)
+{
+  struct media_file_info mfi;
+  char path[64];
+  int i;
+  int ret;
+
+  db_transaction_begin();
+
+  for (i = 0; i < nfiles; i++)
+    {
+      snprintf(path, sizeof(path), "/music/%d/%d/%d.mp3", i / 1000, i / 12, i);
+
+      // The strings are owned by mfi, since db_file_add() may fix them up
+      memset(&mfi, 0, sizeof(struct media_file_info));
+      mfi.path = strdup(path);
+      mfi.virtual_path = safe_asprintf("/file:%s", path);
+      mfi.fname = strdup(strrchr(path, '/') + 1);
+      mfi.title = safe_asprintf("Song %d", i);
+      mfi.artist = safe_asprintf("Artist %d", i / 120);
+      mfi.album = safe_asprintf("Album %d", i / 12);
+      mfi.genre = strdup("Rock");
+      mfi.type = strdup("mp3");
+      mfi.codectype = strdup("mpeg");
+      mfi.description = strdup("MPEG audio file");
+      mfi.bitrate = 320;
+      mfi.samplerate = 44100;
+      mfi.channels = 2;
+      mfi.song_length = 180000 + i % 60000;
+      mfi.file_size = 7000000 + i;
+      mfi.year = 1970 + i % 50;
+      mfi.track = 1 + i % 12;
+      mfi.total_tracks = 12;
+      mfi.disc = 1;
+      mfi.total_discs = 1;
+      mfi.rating = (i % 5) * 20;
+      mfi.play_count = i % 7;
+      mfi.time_modified = 1500000000 + i;
+      mfi.data_kind = DATA_KIND_FILE;
+      mfi.media_kind = MEDIA_KIND_MUSIC;
+      mfi.item_kind = 2;
+
+      ret = db_file_add(&mfi);
+      free_mfi(&mfi, 1);
+      if (ret < 0)
+	{
+	  db_transaction_rollback();
+	  return -1;
+	}
+    }
+
+  db_transaction_end();
+
+  return 0;
+}
+
+static int
+query_start(struct query_params *qp)
+{
+  memset(qp, 0, sizeof(struct query_params));
+  qp->type = Q_ITEMS;
+
+  return db_query_start(qp);
+}
+
+static void
+bench_fetch_text(uint64_t *sum)
+{
+  struct query_params qp;
+  const char *val;
+  int64_t intval;
+  int ncols;
+  int i;
+
+  if (query_start(&qp) < 0)
+    return;
+
+  ncols = sqlite3_column_count(qp.stmt);
+  while (sqlite3_step(qp.stmt) == SQLITE_ROW)
+    {
+      for (i = 0; i < ncols; i++)
+	{
+	  val = (const char *)sqlite3_column_text(qp.stmt, i);
+	  if (val && sqlite3_column_type(qp.stmt, i) == SQLITE_INTEGER && safe_atoi64(val, &intval) == 0)
+	    *sum += intval;
+	  else if (val)
+	    *sum += val[0];
+	}
+    }
+
+  db_query_end(&qp);
+}
+
+static void
+bench_fetch(uint64_t *sum)
+{
+  struct query_params qp;
+  struct db_media_file_info dbmfi;
+
+  if (query_start(&qp) < 0)
+    return;
+
+  while ((db_query_fetch_file(&qp, &dbmfi) == 0) && dbmfi.id)
+    *sum += dbmfi.id + dbmfi.song_length + (dbmfi.title ? dbmfi.title[0] : 0);
+
+  db_query_end(&qp);
+}
+
+static void
+bench_songlist(uint64_t *sum)
+{
+  struct query_params qp;
+  struct db_media_file_info dbmfi;
+  struct evbuffer *songlist;
+  struct evbuffer *song;
+
+  CHECK_NULL(L_MAIN, songlist = evbuffer_new());
+  CHECK_NULL(L_MAIN, song = evbuffer_new());
+
+  if (query_start(&qp) < 0)
+    goto out;
+
+  while ((db_query_fetch_file(&qp, &dbmfi) == 0) && dbmfi.id)
+    dmap_encode_file_metadata(songlist, song, &dbmfi, NULL, 0, 0, 0);
+
+  db_query_end(&qp);
+
+  *sum += evbuffer_get_length(songlist);
+
+ out:
+  evbuffer_free(song);
+  evbuffer_free(songlist);
+}
+
+static void
+bench_run(const char *name, bench_cb cb, int nfiles, uint64_t *sum)
+{
+  struct timespec start;
+  struct timespec end;
+  double secs;
+  double best;
+  int i;
+
+  best = 0;
+  for (i = 0; i < BENCH_RUNS; i++)
+    {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      cb(sum);
+      clock_gettime(CLOCK_MONOTONIC, &end);
+
+      secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+      if (i == 0 || secs < best)
+	best = secs;
+    }
+
+  printf("%-14s %8.1f ms, %8.0f files/s (best of %d)\n", name, best * 1e3, nfiles / best, BENCH_RUNS);
+}
+
+int
+main(int argc, char **argv)
+{
+  char dir[] = "/tmp/bench_songlist.XXXXXX";
+  char conf_path[64];
+  char db_path[64];
+  struct passwd *pw;
+  FILE *f;
+  uint64_t sum;
+  int nfiles;
+  int ret;
+
+  nfiles = (argc > 1) ? atoi(argv[1]) : BENCH_FILES;
+
+  if (logger_init(NULL, NULL, E_LOG) != 0)
+    return EXIT_FAILURE;
+
+  pw = getpwuid(getuid());
+  if (!pw || !mkdtemp(dir))
+    {
+      fprintf(stderr, "Could not make a temporary directory\n");
+      return EXIT_FAILURE;
+    }
+
+  snprintf(conf_path, sizeof(conf_path), "%s/forked-daapd.conf", dir);
+  snprintf(db_path, sizeof(db_path), "%s/songs3.db", dir);
+
+  f = fopen(conf_path, "w");
+  if (!f)
+    {
+      fprintf(stderr, "Could not write '%s'\n", conf_path);
+      rmdir(dir);
+      return EXIT_FAILURE;
+    }
+
+  fprintf(f, "general {\n\tuid = \"%s\"\n\tdb_path = \"%s\"\n}\nlibrary {\n\tdirectories = { \"%s\" }\n}\n", pw->pw_name, db_path, dir);
+  fclose(f);
+
+  ret = conffile_load(conf_path);
+  if (ret < 0)
+    goto out_files;
+
+  ret = db_init();
+  if (ret < 0)
+    goto out_conf;
+
+  ret = db_perthread_init();
+  if (ret < 0)
+    goto out_db;
+
+  ret = library_make(nfiles);
+  if (ret < 0)
+    {
+      fprintf(stderr, "Could not add files to the library\n");
+      goto out_thread;
+    }
+
+  printf("Library with %d files\n", nfiles);
+
+  sum = 0;
+  bench_run("fetch as text", bench_fetch_text, nfiles, &sum);
+  bench_run("fetch", bench_fetch, nfiles, &sum);
+  bench_run("songlist", bench_songlist, nfiles, &sum);
+
+  // Printed so the reads are kept
+  printf("(checksum %" PRIu64 ")\n", sum);
+
+ out_thread:
+  db_perthread_deinit();
+ out_db:
+  db_deinit();
+ out_conf:
+  conffile_unload();
+ out_files:
+  unlink(db_path);
+  unlink(conf_path);
+  rmdir(dir);
+
+  logger_deinit();
+
+  return (ret < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
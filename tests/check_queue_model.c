@@ -0,0 +1,291 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Checks the in-memory queue order of db.c (two implicit treaps) against a
+ * plain array model. Random adds, removes and moves are applied to both, some
+ * of them inside a transaction that is then committed or rolled back, and
+ * after each step every position and rank is compared.
+ *
+ * The treaps are static, so db.c is built into this program, and the few
+ * functions it calls from other modules are stubbed out below.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "db.c"
+
+#define CHECK_STEPS 10000
+#define CHECK_ITEMS_MAX 300
+#define CHECK_TXN_STEPS_MAX 20
+
+struct array_model
+{
+  uint32_t ids[2][CHECK_ITEMS_MAX];
+  uint32_t count;
+};
+
+static uint32_t rnd_state = 0x2545f491;
+
+
+/* -------------------------------- Stubs ----------------------------------- */
+
+void
+cache_daap_suspend(void)
+{
+}
+
+void
+cache_daap_resume(void)
+{
+}
+
+void
+library_update_trigger(short update_events)
+{
+}
+
+void
+listener_notify_data(short event_mask, const struct listener_event_data *data)
+{
+}
+
+void
+worker_execute(void (*cb)(void *), void *cb_arg, size_t arg_size, int delay)
+{
+}
+
+
+/* ------------------------------- Helpers ---------------------------------- */
+
+static uint32_t
+rnd(uint32_t n)
+{
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+
+  return n ? rnd_state % n : 0;
+}
+
+static void
+array_insert(uint32_t *ids, uint32_t count, uint32_t pos, uint32_t id)
+{
+  memmove(&ids[pos + 1], &ids[pos], (count - pos) * sizeof(uint32_t));
+  ids[pos] = id;
+}
+
+static uint32_t
+array_remove(uint32_t *ids, uint32_t count, uint32_t pos)
+{
+  uint32_t id = ids[pos];
+
+  memmove(&ids[pos], &ids[pos + 1], (count - pos - 1) * sizeof(uint32_t));
+  return id;
+}
+
+static uint32_t
+array_find(uint32_t *ids, uint32_t count, uint32_t id)
+{
+  uint32_t i;
+
+  for (i = 0; i < count; i++)
+    {
+      if (ids[i] == id)
+	return i;
+    }
+
+  return UINT32_MAX;
+}
+
+static int
+compare(struct array_model *am, int step)
+{
+  struct queue_model_pos *positions;
+  struct queue_node *node;
+  uint32_t count;
+  uint32_t i;
+  int order;
+
+  if (queue_model.count != am->count)
+    {
+      printf("Step %d: count is %u, expected %u\n", step, queue_model.count, am->count);
+      return -1;
+    }
+
+  for (order = QUEUE_ORDER_POS; order <= QUEUE_ORDER_SHUFFLE; order++)
+    {
+      if (queue_node_size(queue_model.root[order], order) != am->count)
+	{
+	  printf("Step %d: tree %d has size %u, expected %u\n", step, order, queue_node_size(queue_model.root[order], order), am->count);
+	  return -1;
+	}
+
+      for (i = 0; i < am->count; i++)
+	{
+	  node = queue_tree_at(i, order);
+	  if (!node || node->id != am->ids[order][i])
+	    {
+	      printf("Step %d: item at %u in order %d is %u, expected %u\n", step, i, order, node ? node->id : 0, am->ids[order][i]);
+	      return -1;
+	    }
+
+	  if (queue_model_lookup(node->id) != node || queue_tree_rank(node, order) != i)
+	    {
+	      printf("Step %d: lookup or rank of item %u in order %d is wrong\n", step, node->id, order);
+	      return -1;
+	    }
+	}
+    }
+
+  positions = queue_model_positions(&count, false);
+  for (i = 0; i < count; i++)
+    {
+      if (positions[i].pos[QUEUE_ORDER_POS] != array_find(am->ids[QUEUE_ORDER_POS], am->count, positions[i].id)
+	  || positions[i].pos[QUEUE_ORDER_SHUFFLE] != array_find(am->ids[QUEUE_ORDER_SHUFFLE], am->count, positions[i].id))
+	{
+	  printf("Step %d: numbered positions of item %u are wrong\n", step, positions[i].id);
+	  free(positions);
+	  return -1;
+	}
+    }
+  free(positions);
+
+  if (count != am->count)
+    {
+      printf("Step %d: got positions of %u items, expected %u\n", step, count, am->count);
+      return -1;
+    }
+
+  return 0;
+}
+
+static void
+step_add(struct array_model *am, uint32_t id)
+{
+  uint32_t pos;
+  uint32_t shuffle_pos;
+
+  pos = rnd(am->count + 1);
+  shuffle_pos = rnd(am->count + 1);
+
+  queue_model_add(id, pos, shuffle_pos);
+
+  array_insert(am->ids[QUEUE_ORDER_POS], am->count, pos, id);
+  array_insert(am->ids[QUEUE_ORDER_SHUFFLE], am->count, shuffle_pos, id);
+  am->count++;
+}
+
+static void
+step_remove(struct array_model *am)
+{
+  uint32_t id;
+
+  id = array_remove(am->ids[QUEUE_ORDER_POS], am->count, rnd(am->count));
+  array_remove(am->ids[QUEUE_ORDER_SHUFFLE], am->count, array_find(am->ids[QUEUE_ORDER_SHUFFLE], am->count, id));
+  am->count--;
+
+  queue_model_remove(queue_model_lookup(id));
+}
+
+static void
+step_move(struct array_model *am)
+{
+  uint32_t from;
+  uint32_t to;
+  uint32_t id;
+  int order;
+
+  order = rnd(2);
+  from = rnd(am->count);
+  to = rnd(am->count);
+
+  id = array_remove(am->ids[order], am->count, from);
+  array_insert(am->ids[order], am->count - 1, to, id);
+
+  queue_model_move(queue_model_lookup(id), to, order);
+}
+
+int
+main(int argc, char **argv)
+{
+  struct array_model am;
+  struct array_model saved;
+  uint32_t next_id;
+  int txn_steps;
+  int step;
+  uint32_t r;
+
+  if (logger_init(NULL, NULL, E_LOG) != 0)
+    return EXIT_FAILURE;
+
+  memset(&am, 0, sizeof(struct array_model));
+  queue_model.prio_state = 0x9e3779b9;
+  next_id = 1;
+  txn_steps = 0;
+
+  for (step = 0; step < CHECK_STEPS; step++)
+    {
+      if (!queue_model.undo_active && rnd(50) == 0)
+	{
+	  queue_undo_begin();
+	  saved = am;
+	  txn_steps = 1 + rnd(CHECK_TXN_STEPS_MAX);
+	}
+
+      // Grow towards the middle of the range, so all operations get exercised
+      r = rnd(100);
+      if (am.count == 0 || (am.count < CHECK_ITEMS_MAX && r < 35))
+	step_add(&am, next_id++);
+      else if (r < 65)
+	step_remove(&am);
+      else
+	step_move(&am);
+
+      if (queue_model.undo_active && --txn_steps == 0)
+	{
+	  if (rnd(2))
+	    {
+	      queue_undo_commit();
+	    }
+	  else
+	    {
+	      queue_undo_rollback();
+	      am = saved;
+	    }
+	}
+
+      if (compare(&am, step) < 0)
+	{
+	  printf("Queue order differs from the array model\n");
+	  return EXIT_FAILURE;
+	}
+    }
+
+  if (queue_model.undo_active)
+    queue_undo_commit();
+
+  queue_model_reset();
+  free(queue_model.undo);
+
+  logger_deinit();
+
+  printf("Queue order matches the array model after %d steps\n", CHECK_STEPS);
+
+  return EXIT_SUCCESS;
+}
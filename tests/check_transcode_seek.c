@@ -0,0 +1,375 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Checks that a byte range of a transcoded stream, made by seeking with
+ * transcode_seek_bytes() like the HTTP streaming does for range requests, is
+ * the same as that range of a transcode from the start.
+ *
+ * Usage: check_transcode_seek [<media file> [<preroll ms>]]
+ *
+ * Without a file, a few seconds of synthetic PCM are encoded to a temporary
+ * FLAC file with libav, so the check can run from "make check". FLAC frames
+ * have varying sizes, so the byte offsets don't map linearly to time.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include <event2/buffer.h>
+#include <libavformat/avformat.h>
+#include <libavfilter/avfilter.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
+
+#include "logger.h"
+#include "misc.h"
+#include "http.h"
+#include "transcode.h"
+
+#define CHECK_PREROLL_MS 1000
+#define CHECK_RANGE_LEN (256 * 1024)
+#define FIXTURE_SAMPLE_RATE 44100
+#define FIXTURE_SECONDS 8
+
+/* Only used for ICY metadata of http streams, which we don't check, so this
+ * saves linking http.c and everything it needs.
+ */
+struct http_icy_metadata *
+http_icy_metadata_get(AVFormatContext *fmtctx, int packet_only)
+{
+  return NULL;
+}
+
+// Sends the frame (or NULL to flush) to the encoder and writes what comes out
+static int
+fixture_encode(AVFormatContext *ofmt_ctx, AVCodecContext *enc, AVStream *stream, AVFrame *frame, AVPacket *pkt)
+{
+  int ret;
+
+  ret = avcodec_send_frame(enc, frame);
+  if (ret < 0)
+    return ret;
+
+  while ((ret = avcodec_receive_packet(enc, pkt)) == 0)
+    {
+      pkt->stream_index = stream->index;
+      av_packet_rescale_ts(pkt, enc->time_base, stream->time_base);
+
+      ret = av_interleaved_write_frame(ofmt_ctx, pkt);
+      if (ret < 0)
+	return ret;
+    }
+
+  return (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) ? 0 : ret;
+}
+
+/* Writes a stereo FLAC file with a sweeping tone and some noise, so that the
+ * encoded frames are neither silent nor all of the same size. The output is a
+ * file (not an evbuffer) so the muxer can go back and complete the header.
+ */
+static int
+fixture_write(const char *path)
+{
+  const AVCodec *codec;
+  AVFormatContext *ofmt_ctx;
+  AVCodecContext *enc;
+  AVStream *stream;
+  AVFrame *frame;
+  AVPacket *pkt;
+  int16_t *samples;
+  uint32_t noise;
+  int64_t pts;
+  int64_t total;
+  int64_t t;
+  int64_t period;
+  int ret;
+  int i;
+
+  ofmt_ctx = NULL;
+  enc = NULL;
+  frame = NULL;
+  pkt = NULL;
+
+  codec = avcodec_find_encoder(AV_CODEC_ID_FLAC);
+  if (!codec)
+    return -1;
+
+  ret = avformat_alloc_output_context2(&ofmt_ctx, NULL, "flac", path);
+  if (ret < 0)
+    return -1;
+
+  CHECK_NULL(L_MAIN, stream = avformat_new_stream(ofmt_ctx, NULL));
+  CHECK_NULL(L_MAIN, enc = avcodec_alloc_context3(codec));
+  CHECK_NULL(L_MAIN, frame = av_frame_alloc());
+  CHECK_NULL(L_MAIN, pkt = av_packet_alloc());
+
+  enc->sample_rate    = FIXTURE_SAMPLE_RATE;
+  enc->channel_layout = AV_CH_LAYOUT_STEREO;
+  enc->channels       = 2;
+  enc->sample_fmt     = AV_SAMPLE_FMT_S16;
+  enc->time_base      = (AVRational){1, FIXTURE_SAMPLE_RATE};
+
+  ret = avcodec_open2(enc, codec, NULL);
+  if (ret < 0)
+    goto out;
+
+  ret = avcodec_parameters_from_context(stream->codecpar, enc);
+  if (ret < 0)
+    goto out;
+
+  stream->time_base = enc->time_base;
+
+  ret = avio_open(&ofmt_ctx->pb, path, AVIO_FLAG_WRITE);
+  if (ret < 0)
+    goto out;
+
+  ret = avformat_write_header(ofmt_ctx, NULL);
+  if (ret < 0)
+    goto out;
+
+  frame->format         = enc->sample_fmt;
+  frame->channel_layout = enc->channel_layout;
+  frame->sample_rate    = enc->sample_rate;
+  frame->nb_samples     = enc->frame_size;
+
+  ret = av_frame_get_buffer(frame, 0);
+  if (ret < 0)
+    goto out;
+
+  noise = 1;
+  total = (int64_t)FIXTURE_SECONDS * FIXTURE_SAMPLE_RATE;
+  for (pts = 0; pts < total; pts += frame->nb_samples)
+    {
+      ret = av_frame_make_writable(frame);
+      if (ret < 0)
+	goto out;
+
+      frame->nb_samples = MIN(enc->frame_size, total - pts);
+      frame->pts = pts;
+
+      samples = (int16_t *)frame->data[0];
+      for (i = 0; i < frame->nb_samples; i++)
+	{
+	  noise ^= noise << 13;
+	  noise ^= noise >> 17;
+	  noise ^= noise << 5;
+
+	  // Square wave with a period going from 1 to 21 ms over each second
+	  t = (pts + i) % FIXTURE_SAMPLE_RATE;
+	  period = 44 + t / 50;
+
+	  samples[2 * i] = ((t % period) < period / 2) ? 8000 : -8000;
+	  samples[2 * i] += (int)(noise & 0x3ff) - 0x200;
+	  samples[2 * i + 1] = samples[2 * i] / 2;
+	}
+
+      ret = fixture_encode(ofmt_ctx, enc, stream, frame, pkt);
+      if (ret < 0)
+	goto out;
+    }
+
+  ret = fixture_encode(ofmt_ctx, enc, stream, NULL, pkt);
+  if (ret < 0)
+    goto out;
+
+  ret = av_write_trailer(ofmt_ctx);
+
+ out:
+  if (ofmt_ctx->pb)
+    avio_closep(&ofmt_ctx->pb);
+  avformat_free_context(ofmt_ctx);
+  avcodec_free_context(&enc);
+  av_frame_free(&frame);
+  av_packet_free(&pkt);
+
+  return (ret < 0) ? -1 : 0;
+}
+
+static struct evbuffer *
+transcode_all(const char *path, int64_t offset, int preroll_ms, int64_t *skip)
+{
+  struct media_quality quality = { 44100, 16, 2, 0 };
+  struct transcode_ctx *ctx;
+  struct evbuffer *evbuf;
+  int ret;
+
+  ctx = transcode_setup(XCODE_PCM16_HEADER, &quality, DATA_KIND_FILE, path, 0, NULL);
+  if (!ctx)
+    return NULL;
+
+  *skip = 0;
+  if (offset > 0 && transcode_seek_bytes(ctx, offset, preroll_ms, skip) < 0)
+    {
+      transcode_cleanup(&ctx);
+      return NULL;
+    }
+
+  CHECK_NULL(L_MAIN, evbuf = evbuffer_new());
+
+  while ((ret = transcode(evbuf, NULL, ctx, 64 * 1024)) > 0)
+    ;
+
+  transcode_cleanup(&ctx);
+
+  if (ret < 0)
+    {
+      evbuffer_free(evbuf);
+      return NULL;
+    }
+
+  return evbuf;
+}
+
+static int
+check_offset(const char *path, uint8_t *full, size_t full_len, int64_t offset, int preroll_ms)
+{
+  struct evbuffer *evbuf;
+  uint8_t *got;
+  int64_t skip;
+  size_t len;
+  size_t i;
+
+  evbuf = transcode_all(path, offset, preroll_ms, &skip);
+  if (!evbuf)
+    {
+      fprintf(stderr, "Offset %" PRIi64 ": transcode failed\n", offset);
+      return -1;
+    }
+
+  evbuffer_drain(evbuf, skip);
+
+  len = evbuffer_get_length(evbuf);
+  if (len != full_len - offset)
+    {
+      fprintf(stderr, "Offset %" PRIi64 ": got %zu bytes after skipping %" PRIi64 ", expected %zu\n",
+	offset, len, skip, (size_t)(full_len - offset));
+      evbuffer_free(evbuf);
+      return -1;
+    }
+
+  if (len > CHECK_RANGE_LEN)
+    len = CHECK_RANGE_LEN;
+
+  got = evbuffer_pullup(evbuf, len);
+
+  for (i = 0; i < len && got[i] == full[offset + i]; i++)
+    ;
+
+  evbuffer_free(evbuf);
+
+  if (i < len)
+    {
+      fprintf(stderr, "Offset %" PRIi64 ": mismatch at byte %zu of the range (skipped %" PRIi64 ")\n", offset, i, skip);
+      return -1;
+    }
+
+  printf("Offset %" PRIi64 ": ok, skipped %" PRIi64 " bytes\n", offset, skip);
+  return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+  char fixture[] = "/tmp/check_transcode_seek.XXXXXX";
+  struct evbuffer *evbuf;
+  const char *path;
+  uint8_t *full;
+  size_t full_len;
+  int64_t offset;
+  int64_t skip;
+  int preroll_ms;
+  int failed;
+  int fd;
+  int i;
+
+  preroll_ms = (argc > 2) ? atoi(argv[2]) : CHECK_PREROLL_MS;
+
+  if (logger_init(NULL, NULL, E_LOG) != 0)
+    return EXIT_FAILURE;
+
+#if (LIBAVFORMAT_VERSION_MAJOR < 58) || ((LIBAVFORMAT_VERSION_MAJOR == 58) && (LIBAVFORMAT_VERSION_MINOR < 12))
+  av_register_all();
+#endif
+#if (LIBAVFILTER_VERSION_MAJOR < 7) || ((LIBAVFILTER_VERSION_MAJOR == 7) && (LIBAVFILTER_VERSION_MINOR < 16))
+  avfilter_register_all();
+#endif
+
+  if (argc > 1)
+    {
+      path = argv[1];
+    }
+  else
+    {
+      fd = mkstemp(fixture);
+      if (fd < 0)
+	{
+	  perror("mkstemp");
+	  return EXIT_FAILURE;
+	}
+      close(fd);
+
+      if (fixture_write(fixture) < 0)
+	{
+	  fprintf(stderr, "Could not write FLAC fixture '%s'\n", fixture);
+	  unlink(fixture);
+	  return EXIT_FAILURE;
+	}
+
+      path = fixture;
+    }
+
+  evbuf = transcode_all(path, 0, preroll_ms, &skip);
+  if (!evbuf)
+    {
+      fprintf(stderr, "Could not transcode '%s'\n", path);
+      if (path == fixture)
+	unlink(fixture);
+      return EXIT_FAILURE;
+    }
+
+  full_len = evbuffer_get_length(evbuf);
+  full = evbuffer_pullup(evbuf, -1);
+
+  printf("Transcoded '%s' from the start: %zu bytes\n", path, full_len);
+
+  // Offsets at several points of the file, including some that are not at a
+  // sample frame boundary
+  failed = 0;
+  for (i = 1; i < 10; i++)
+    {
+      offset = full_len / 10 * i + (i % 4);
+      if (check_offset(path, full, full_len, offset, preroll_ms) < 0)
+	failed++;
+    }
+
+  evbuffer_free(evbuf);
+
+  if (path == fixture)
+    unlink(fixture);
+
+  logger_deinit();
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
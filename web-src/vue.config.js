@@ -18,6 +18,9 @@ module.exports = {
   // build
   filenameHashing: false,
 
+  // No source maps for the js files in htdocs
+  productionSourceMap: false,
+
   css: {
     sourceMap: true
   },